@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+"""Ingest latency benchmark for the Control Unit.
+
+Posts readings to /readings at a fixed rate, like a group of Sensor Units,
+while the backend stand-in receives the uploads. Every post is classified as
+idle or upload depending on whether a backend upload was in flight while it
+was served, and the two latency distributions are compared.
+
+The stand-in is started by this script so its log shares the clock with the
+posts. Run the Control Unit (device or host build) separately.
+
+Author: Erik Dahl (erik@iunderlandet.se)
+License: MIT
+"""
+
+import argparse
+import csv
+import json
+import os
+import signal
+import socket
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import urllib.request
+
+READINGS_ENDPOINT = "/api/v1/control-unit"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--cu-url", default="http://127.0.0.1:8080",
+                        help="base URL of the Control Unit REST server")
+    parser.add_argument("--backend", required=True,
+                        help="path to the backendserver binary")
+    parser.add_argument("--backend-addr", default="127.0.0.1:8081",
+                        help="listen address for the backend stand-in")
+    parser.add_argument("--backend-args", default="-latency 800",
+                        help="extra backendserver options, quoted")
+    parser.add_argument("--unit", action="append", default=[],
+                        help="sensor unit id to post as, repeatable")
+    parser.add_argument("--units", type=int, default=8,
+                        help="generated unit ids when no --unit is given")
+    parser.add_argument("--rate", type=float, default=10,
+                        help="posts per second over all units")
+    parser.add_argument("--batch", type=int, default=10,
+                        help="readings per post")
+    parser.add_argument("--seconds", type=float, default=60,
+                        help="length of the run")
+    parser.add_argument("--workers", type=int, default=4,
+                        help="posts in flight at the same time")
+    parser.add_argument("--max-ratio", type=float, default=1.5,
+                        help="allowed upload/idle ratio of p95 latency")
+    parser.add_argument("--slack-ms", type=float, default=5,
+                        help="absolute p95 difference that always passes")
+    parser.add_argument("--csv", help="write one line per post to this file")
+    return parser.parse_args()
+
+
+def unit_ids(args):
+    if args.unit:
+        return args.unit
+    return ["5e750000-0000-4000-8000-%012d" % (i + 1)
+            for i in range(args.units)]
+
+
+def wait_for_port(addr, timeout_s=10):
+    host, port = addr.rsplit(":", 1)
+    deadline = time.monotonic() + timeout_s
+    while time.monotonic() < deadline:
+        try:
+            with socket.create_connection((host or "127.0.0.1", int(port)),
+                                          timeout=0.2):
+                return True
+        except OSError:
+            time.sleep(0.05)
+    return False
+
+
+class Poster:
+    """Posts batches at a fixed rate and records when each one ran."""
+
+    def __init__(self, args, units):
+        self.url = args.cu_url.rstrip("/") + "/readings"
+        self.units = units
+        self.batch = args.batch
+        self.interval = 1 / args.rate
+        self.deadline = 0
+        self.next_post = 0
+        self.sequence = 0
+        self.base_ts = int(time.time()) - 10 * 24 * 3600
+        self.lock = threading.Lock()
+        self.samples = []  # (start, end, status)
+
+    def body(self, sequence):
+        unit = self.units[sequence % len(self.units)]
+        # Unique timestamps per unit so the backlog grows with every post
+        first = self.base_ts + (sequence // len(self.units)) * self.batch
+        readings = [{"timestamp": first + i,
+                     "temperature": 20 + (sequence + i) % 50 / 10,
+                     "humidity": 40 + (sequence + i) % 200 / 10}
+                    for i in range(self.batch)]
+        return json.dumps({"sensor_unit_id": unit,
+                           "readings": readings}).encode()
+
+    def take_slot(self):
+        with self.lock:
+            if self.next_post >= self.deadline:
+                return None
+            slot, sequence = self.next_post, self.sequence
+            self.next_post += self.interval
+            self.sequence += 1
+            return slot, sequence
+
+    def worker(self, clock_zero):
+        while True:
+            taken = self.take_slot()
+            if taken is None:
+                return
+            slot, sequence = taken
+            delay = slot - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            request = urllib.request.Request(
+                self.url, data=self.body(sequence),
+                headers={"Content-Type": "application/json"})
+            start = time.monotonic()
+            try:
+                with urllib.request.urlopen(request, timeout=10) as response:
+                    response.read()
+                    status = response.status
+            except Exception:  # timeouts and refused connections count too
+                status = 0
+            end = time.monotonic()
+            with self.lock:
+                self.samples.append((start - clock_zero, end - clock_zero,
+                                     status))
+
+    def run(self, seconds, workers, clock_zero):
+        now = time.monotonic()
+        self.next_post = now
+        self.deadline = now + seconds
+        threads = [threading.Thread(target=self.worker, args=(clock_zero,))
+                   for _ in range(workers)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        return sorted(self.samples)
+
+
+def read_uploads(log_path):
+    """Returns (start_s, end_s, bytes) of every readings upload."""
+    uploads = []
+    with open(log_path, newline="") as file:
+        for row in csv.DictReader(file):
+            if row["endpoint"] != READINGS_ENDPOINT:
+                continue
+            end = float(row["time_s"])
+            start = end - float(row["latency_ms"]) / 1000
+            uploads.append((start, end, int(row["bytes"])))
+    return uploads
+
+
+def percentile(values, share):
+    if not values:
+        return float("nan")
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(share * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def summarize(name, latencies_ms):
+    print("%-7s %6d %9.1f %9.1f %9.1f %9.1f" % (
+        name, len(latencies_ms), percentile(latencies_ms, 0.5),
+        percentile(latencies_ms, 0.95), percentile(latencies_ms, 0.99),
+        max(latencies_ms, default=float("nan"))))
+
+
+def main():
+    args = parse_args()
+    units = unit_ids(args)
+    log_file = tempfile.NamedTemporaryFile(suffix=".csv", delete=False)
+    log_file.close()
+
+    # The stand-in measures time_s from its start, so this is the shared zero
+    clock_zero = time.monotonic()
+    backend = subprocess.Popen(
+        [args.backend, "-addr", args.backend_addr, "-log", log_file.name]
+        + args.backend_args.split(),
+        stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    try:
+        if not wait_for_port(args.backend_addr):
+            sys.exit("backendserver did not start on %s" % args.backend_addr)
+        print("Posting %d readings %.1f times/s as %d units for %.0f s" % (
+            args.batch, args.rate, len(units), args.seconds))
+        samples = Poster(args, units).run(args.seconds, args.workers,
+                                          clock_zero)
+    finally:
+        backend.send_signal(signal.SIGINT)
+        backend.wait(timeout=10)
+
+    uploads = read_uploads(log_file.name)
+    os.unlink(log_file.name)
+
+    idle, during = [], []
+    failed = 0
+    rows = []
+    for start, end, status in samples:
+        overlap = any(u_start < end and start < u_end
+                      for u_start, u_end, _ in uploads)
+        latency_ms = (end - start) * 1000
+        if status != 200:
+            failed += 1
+        (during if overlap else idle).append(latency_ms)
+        rows.append((round(start, 4), round(latency_ms, 2), status,
+                     "upload" if overlap else "idle"))
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as file:
+            writer = csv.writer(file)
+            writer.writerow(["start_s", "latency_ms", "status", "phase"])
+            writer.writerows(rows)
+
+    biggest = max((size for _, _, size in uploads), default=0)
+    busy = sum(u_end - u_start for u_start, u_end, _ in uploads)
+    print("Uploads: %d, largest %d bytes, in flight %.0f%% of the run" % (
+        len(uploads), biggest, 100 * busy / max(args.seconds, 1e-9)))
+    print("%-7s %6s %9s %9s %9s %9s" % (
+        "phase", "posts", "p50 ms", "p95 ms", "p99 ms", "max ms"))
+    summarize("idle", idle)
+    summarize("upload", during)
+    if failed:
+        print("Failed posts: %d" % failed)
+
+    if not idle or not during:
+        print("Not enough posts in both phases to compare")
+        return 2
+    idle_p95, upload_p95 = percentile(idle, 0.95), percentile(during, 0.95)
+    passed = (failed == 0 and (upload_p95 <= idle_p95 * args.max_ratio
+                               or upload_p95 - idle_p95 <= args.slack_ms))
+    print("%s: upload p95 %.1f ms vs idle p95 %.1f ms (limit x%.2f or +%.0f ms)"
+          % ("PASS" if passed else "FAIL", upload_p95, idle_p95,
+             args.max_ratio, args.slack_ms))
+    return 0 if passed else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,120 @@
+/**
+ * @file AllocTracker.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the heap accounting used by the host benchmarks
+ *
+ * The allocator functions are replaced at link time and forward to the glibc
+ * implementation. Sizes are taken from malloc_usable_size() so that free()
+ * can subtract exactly what was added.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "AllocTracker.h"
+#include <atomic>
+#include <malloc.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void  __libc_free(void* ptr);
+}
+
+namespace {
+std::atomic<size_t> s_allocations{0};
+std::atomic<size_t> s_bytesAllocated{0};
+std::atomic<size_t> s_liveBytes{0};
+std::atomic<size_t> s_peakBytes{0};
+
+void recordAlloc(void* ptr) {
+    if (!ptr)
+        return;
+    size_t size = malloc_usable_size(ptr);
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    size_t live = s_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = s_peakBytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !s_peakBytes.compare_exchange_weak(
+               peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void recordFree(void* ptr) {
+    if (!ptr)
+        return;
+    s_liveBytes.fetch_sub(malloc_usable_size(ptr), std::memory_order_relaxed);
+}
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    recordAlloc(ptr);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    recordAlloc(ptr);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    recordFree(ptr);
+    void* result = __libc_realloc(ptr, size);
+    if (result) {
+        recordAlloc(result);
+    } else if (ptr && size != 0) {
+        // realloc failed and the old block is still valid
+        recordAlloc(ptr);
+    }
+    return result;
+}
+
+void* memalign(size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    recordAlloc(ptr);
+    return ptr;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    void* ptr = memalign(alignment, size);
+    if (!ptr)
+        return 12; // ENOMEM
+    *out = ptr;
+    return 0;
+}
+
+void free(void* ptr) {
+    recordFree(ptr);
+    __libc_free(ptr);
+}
+
+} // extern "C"
+
+namespace alloc_tracker {
+
+Snapshot snapshot() {
+    return {s_allocations.load(std::memory_order_relaxed),
+            s_bytesAllocated.load(std::memory_order_relaxed),
+            s_liveBytes.load(std::memory_order_relaxed),
+            s_peakBytes.load(std::memory_order_relaxed)};
+}
+
+void resetPeak() {
+    s_peakBytes.store(s_liveBytes.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+}
+
+} // namespace alloc_tracker
@@ -0,0 +1,48 @@
+/**
+ * @file AllocTracker.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Process wide heap accounting for the host benchmarks
+ *
+ * malloc, calloc, realloc, free and the aligned variants are wrapped so that
+ * every allocation is counted, no matter if it comes from cJSON, ArduinoJson
+ * or the C++ standard library. The numbers are used to report allocations per
+ * operation and peak heap usage per benchmark case.
+ *
+ * Relies on the glibc __libc_* entry points and is therefore Linux only.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <cstddef>
+
+namespace alloc_tracker {
+
+/**
+ * @brief Heap counters at a given point in time
+ */
+struct Snapshot {
+    size_t allocations;    /**< Number of successful allocations so far */
+    size_t bytesAllocated; /**< Total number of bytes handed out so far */
+    size_t liveBytes;      /**< Bytes currently allocated */
+    size_t peakBytes;      /**< Highest value of liveBytes since resetPeak() */
+};
+
+/**
+ * @brief Read the current counters
+ *
+ * @return Snapshot
+ */
+Snapshot snapshot();
+
+/**
+ * @brief Set the peak to the current amount of live bytes
+ *
+ * Call before the code you want to measure and read peakBytes afterwards.
+ */
+void resetPeak();
+
+} // namespace alloc_tracker
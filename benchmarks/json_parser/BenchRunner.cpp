@@ -0,0 +1,110 @@
+/**
+ * @file BenchRunner.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the benchmark harness reporting
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "BenchRunner.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace {
+void printUsage(const char* program) {
+    std::printf("Usage: %s [--filter <text>] [--min-time-ms <ms>] "
+                "[--csv <file>] [--dump-corpus <dir>] [--quick]\n",
+                program);
+}
+} // namespace
+
+BenchRunner::BenchRunner(int           argc,
+                         char**        argv,
+                         const char*   title,
+                         const size_t* logCounter)
+    : m_title{title}, m_logCounter{logCounter} {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg     = argv[i];
+        bool        hasNext = i + 1 < argc;
+        if (arg == "--filter" && hasNext) {
+            m_filter = argv[++i];
+        } else if (arg == "--min-time-ms" && hasNext) {
+            m_minTime = std::chrono::milliseconds(std::atoi(argv[++i]));
+        } else if (arg == "--csv" && hasNext) {
+            m_csvPath = argv[++i];
+        } else if (arg == "--dump-corpus" && hasNext) {
+            m_corpusDir = argv[++i];
+            mkdir(m_corpusDir.c_str(), 0755);
+        } else if (arg == "--quick") {
+            m_quick = true;
+        } else {
+            printUsage(argv[0]);
+            std::exit(arg == "--help" ? 0 : 1);
+        }
+    }
+}
+
+bool BenchRunner::selected(const std::string& name,
+                           const std::string& corpus) const {
+    if (m_filter.empty())
+        return true;
+    return (name + " " + corpus).find(m_filter) != std::string::npos;
+}
+
+void BenchRunner::dumpCorpus(const std::string& fileName,
+                             const std::string& json) const {
+    if (m_corpusDir.empty())
+        return;
+    std::ofstream out(m_corpusDir + "/" + fileName);
+    out << json;
+}
+
+int BenchRunner::finish() const {
+    std::printf("\n%s\n\n", m_title.c_str());
+    std::printf("%-32s %-28s %12s %12s %9s %8s %10s %10s %8s %6s\n",
+                "function",
+                "corpus",
+                "ns/op",
+                "ops/s",
+                "MB/s",
+                "allocs",
+                "bytes",
+                "peak",
+                "leak",
+                "logs");
+    for (const auto& r : m_results) {
+        std::printf(
+            "%-32s %-28s %12.0f %12.0f %9.2f %8zu %10zu %10zu %8zu %6zu\n",
+            r.name.c_str(),
+            r.corpus.c_str(),
+            r.nsPerOp,
+            r.opsPerSec,
+            r.mbPerSec,
+            r.allocsPerOp,
+            r.bytesPerOp,
+            r.peakHeap,
+            r.leakedBytes,
+            r.logCallsPerOp);
+    }
+
+    if (!m_csvPath.empty()) {
+        std::ofstream csv(m_csvPath);
+        csv << "function,corpus,iterations,ns_per_op,ops_per_sec,mb_per_sec,"
+               "json_bytes,allocs_per_op,bytes_per_op,peak_heap,leaked_bytes,"
+               "log_calls_per_op\n";
+        for (const auto& r : m_results) {
+            csv << r.name << ',' << r.corpus << ',' << r.iterations << ','
+                << r.nsPerOp << ',' << r.opsPerSec << ',' << r.mbPerSec << ','
+                << r.jsonBytes << ',' << r.allocsPerOp << ',' << r.bytesPerOp
+                << ',' << r.peakHeap << ',' << r.leakedBytes << ','
+                << r.logCallsPerOp << '\n';
+        }
+        std::printf("\nResults written to %s\n", m_csvPath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file BenchRunner.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Small benchmark harness shared by the JsonParser benchmarks
+ *
+ * Each benchmark case is a callable that performs one operation, e.g. one
+ * call to composeGroupedReadings. The runner repeats it until the configured
+ * minimum time has passed and reports:
+ * - throughput in operations per second and MB/s of JSON
+ * - allocations and allocated bytes per operation
+ * - peak heap above the baseline during one operation
+ * - bytes still allocated after one operation (leaks)
+ *
+ * Command line options:
+ * - `--filter <text>`      only run cases whose name contains text
+ * - `--min-time-ms <ms>`   minimum measuring time per case (default 200)
+ * - `--csv <file>`         also write the results as CSV
+ * - `--dump-corpus <dir>`  write the generated JSON corpora to dir
+ * - `--quick`              only run the small corpora
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "AllocTracker.h"
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Prevent the compiler from optimizing away a benchmark result
+ *
+ * @param value result of the measured operation
+ */
+template <typename T> inline void keepAlive(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief Result of a single benchmark case
+ */
+struct BenchResult {
+    std::string name;         /**< Function under test */
+    std::string corpus;       /**< Description of the input */
+    size_t      iterations;   /**< Number of measured operations */
+    double      nsPerOp;      /**< Mean time per operation in ns */
+    double      opsPerSec;    /**< Operations per second */
+    double      mbPerSec;     /**< JSON bytes per second in MB */
+    size_t      jsonBytes;    /**< JSON bytes consumed or produced per op */
+    size_t      allocsPerOp;  /**< Heap allocations per operation */
+    size_t      bytesPerOp;   /**< Heap bytes allocated per operation */
+    size_t      peakHeap;     /**< Peak heap above baseline for one op */
+    size_t      leakedBytes;  /**< Bytes still allocated after one op */
+    size_t      logCallsPerOp; /**< Log calls per operation (if counted) */
+};
+
+class BenchRunner {
+  public:
+    /**
+     * @brief Parse the command line. Unknown options print usage and exit.
+     *
+     * @param title printed above the result table
+     * @param logCounter optional counter incremented by the logging stub
+     */
+    BenchRunner(int                  argc,
+                char**               argv,
+                const char*          title,
+                const size_t*        logCounter = nullptr);
+
+    /**
+     * @brief Run a benchmark case
+     *
+     * @param name function under test
+     * @param corpus short description of the input
+     * @param jsonBytes JSON bytes consumed or produced by one operation
+     * @param op callable performing exactly one operation
+     */
+    template <typename Op>
+    void run(const std::string& name,
+             const std::string& corpus,
+             size_t             jsonBytes,
+             Op&&               op);
+
+    /**
+     * @brief Check if the small corpora only option was given
+     */
+    bool quick() const { return m_quick; }
+
+    /**
+     * @brief Directory to dump the corpora to, empty if not requested
+     */
+    const std::string& corpusDir() const { return m_corpusDir; }
+
+    /**
+     * @brief Write a generated corpus file if --dump-corpus was given
+     *
+     * @param fileName name of the file inside the corpus directory
+     * @param json the corpus
+     */
+    void dumpCorpus(const std::string& fileName, const std::string& json) const;
+
+    /**
+     * @brief Print the result table and write the CSV file if requested
+     *
+     * @return int process exit code
+     */
+    int finish() const;
+
+  private:
+    bool   selected(const std::string& name, const std::string& corpus) const;
+    size_t logCalls() const { return m_logCounter ? *m_logCounter : 0; }
+
+    std::string              m_title;
+    std::string              m_filter;
+    std::string              m_csvPath;
+    std::string              m_corpusDir;
+    bool                     m_quick{false};
+    std::chrono::nanoseconds m_minTime{std::chrono::milliseconds(200)};
+    const size_t*            m_logCounter;
+    std::vector<BenchResult> m_results;
+};
+
+template <typename Op>
+void BenchRunner::run(const std::string& name,
+                      const std::string& corpus,
+                      size_t             jsonBytes,
+                      Op&&               op) {
+    if (!selected(name, corpus))
+        return;
+
+    using clock = std::chrono::steady_clock;
+    BenchResult result{};
+    result.name      = name;
+    result.corpus    = corpus;
+    result.jsonBytes = jsonBytes;
+
+    // Warm up and measure the heap profile of one single operation
+    keepAlive(op());
+    alloc_tracker::resetPeak();
+    alloc_tracker::Snapshot before   = alloc_tracker::snapshot();
+    size_t                  logStart = logCalls();
+    {
+        auto value = op();
+        keepAlive(value);
+        alloc_tracker::Snapshot during = alloc_tracker::snapshot();
+        result.allocsPerOp = during.allocations - before.allocations;
+        result.bytesPerOp  = during.bytesAllocated - before.bytesAllocated;
+    }
+    alloc_tracker::Snapshot after = alloc_tracker::snapshot();
+    result.peakHeap               = after.peakBytes - before.liveBytes;
+    result.leakedBytes            = after.liveBytes > before.liveBytes
+                                        ? after.liveBytes - before.liveBytes
+                                        : 0;
+    result.logCallsPerOp          = logCalls() - logStart;
+
+    // Timed loop. Batches grow until the minimum time is reached.
+    size_t                   iterations = 0;
+    size_t                   batch      = 1;
+    std::chrono::nanoseconds elapsed{0};
+    while (elapsed < m_minTime) {
+        auto start = clock::now();
+        for (size_t i = 0; i < batch; ++i) {
+            keepAlive(op());
+        }
+        elapsed += clock::now() - start;
+        iterations += batch;
+        if (batch < (1u << 20))
+            batch *= 2;
+    }
+
+    result.iterations = iterations;
+    result.nsPerOp =
+        static_cast<double>(elapsed.count()) / static_cast<double>(iterations);
+    result.opsPerSec = 1e9 / result.nsPerOp;
+    result.mbPerSec =
+        result.opsPerSec * static_cast<double>(jsonBytes) / (1024.0 * 1024.0);
+    m_results.push_back(result);
+}
@@ -0,0 +1,68 @@
+/**
+ * @file CorpusCommon.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Deterministic helpers for generating benchmark corpora
+ *
+ * The same seed always gives the same corpus so results are comparable
+ * between runs and between branches.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <random>
+#include <string>
+
+namespace corpus {
+
+constexpr time_t   kStartTimestamp = 1726995600;
+constexpr uint32_t kSeed           = 20251007;
+
+/**
+ * @brief Create a UUID string for sensor unit number index
+ *
+ * @param index number of the sensor unit
+ * @return std::string formatted like 00000000-0000-4000-8000-000000000017
+ */
+inline std::string makeUuid(size_t index) {
+    char buf[64];
+    std::snprintf(buf,
+                  sizeof(buf),
+                  "%08zx-0000-4000-8000-%012zx",
+                  index,
+                  index);
+    return buf;
+}
+
+/**
+ * @brief Generates plausible temperature and humidity values
+ *
+ * Values are rounded to one decimal and passed through float, the same way a
+ * DHT11 reading travels through the Sensor Unit. This gives the same number
+ * of digits in the JSON as real traffic.
+ */
+class ValueGenerator {
+  public:
+    ValueGenerator() : m_rng{kSeed} {}
+    double temperature() { return asSensorValue(18.0 + m_temperature(m_rng)); }
+    double humidity() { return asSensorValue(30.0 + m_humidity(m_rng)); }
+
+  private:
+    static double asSensorValue(double value) {
+        return static_cast<double>(
+            static_cast<float>(std::round(value * 10.0) / 10.0));
+    }
+
+    std::mt19937                           m_rng;
+    std::uniform_real_distribution<double> m_temperature{0.0, 10.0};
+    std::uniform_real_distribution<double> m_humidity{0.0, 40.0};
+};
+
+} // namespace corpus
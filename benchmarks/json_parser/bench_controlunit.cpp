@@ -0,0 +1,247 @@
+/**
+ * @file bench_controlunit.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host benchmarks for the Control Unit JsonParser
+ *
+ * Covers every compose/parse function in
+ * controlunit/components/json_parser. The grouped readings corpora span
+ * 1-10k readings from 1-200 sensor units with different group sizes:
+ * - aligned:   every unit reports on the same timestamp (group = units)
+ * - partial:   a quarter of the units share each timestamp
+ * - scattered: every reading has its own timestamp (group = 1)
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "BenchRunner.h"
+#include "CorpusCommon.h"
+#include "JsonParser.h"
+#include "esp_log.h"
+#include <map>
+#include <vector>
+
+namespace {
+
+using GroupedReadings = std::map<time_t, std::vector<ca_sensorunit_snapshot>>;
+
+/**
+ * @brief Build grouped readings the way SensorUnitManager returns them
+ *
+ * @param readings total number of readings
+ * @param units number of sensor units
+ * @param groupSize number of readings that share each timestamp
+ */
+GroupedReadings
+makeGroupedReadings(size_t readings, size_t units, size_t groupSize) {
+    std::vector<std::shared_ptr<Uuid>> uuids;
+    for (size_t i = 0; i < units; ++i) {
+        uuids.push_back(std::make_shared<Uuid>(corpus::makeUuid(i)));
+    }
+
+    corpus::ValueGenerator values;
+    GroupedReadings        grouped;
+    for (size_t i = 0; i < readings; ++i) {
+        ca_sensorunit_snapshot snapshot;
+        snapshot.uuid        = uuids[i % units];
+        snapshot.timestamp   = corpus::kStartTimestamp +
+                             static_cast<time_t>(i / groupSize) * 5;
+        snapshot.temperature = values.temperature();
+        snapshot.humidity    = values.humidity();
+        grouped[snapshot.timestamp].push_back(snapshot);
+    }
+    return grouped;
+}
+
+/**
+ * @brief Build a /readings body as posted by a Sensor Unit
+ *
+ * @param readings number of readings in the batch
+ */
+std::string makeSensorReadingsBody(size_t readings) {
+    corpus::ValueGenerator values;
+    std::string json = R"({"sensor_unit_id":")" + corpus::makeUuid(1) +
+                       R"(","readings":[)";
+    for (size_t i = 0; i < readings; ++i) {
+        char entry[96];
+        std::snprintf(entry,
+                      sizeof(entry),
+                      R"(%s{"timestamp":%lld,"temperature":%.15g,"humidity":%.15g})",
+                      i == 0 ? "" : ",",
+                      static_cast<long long>(corpus::kStartTimestamp + i * 5),
+                      values.temperature(),
+                      values.humidity());
+        json += entry;
+    }
+    json += "]}";
+    return json;
+}
+
+void benchGroupedReadings(BenchRunner& runner) {
+    const std::string controlUnitId = "f47ac10b-58cc-4372-a567-0e02b2c3d479";
+    const std::vector<size_t> readingCounts =
+        runner.quick() ? std::vector<size_t>{1, 100}
+                       : std::vector<size_t>{1, 100, 1000, 10000};
+    const std::vector<size_t> unitCounts =
+        runner.quick() ? std::vector<size_t>{1, 10}
+                       : std::vector<size_t>{1, 10, 50, 200};
+
+    runner.run("composeGroupedReadings", "empty", 0, [&] {
+        return JsonParser::composeGroupedReadings({}, controlUnitId);
+    });
+
+    for (size_t readings : readingCounts) {
+        for (size_t units : unitCounts) {
+            struct Layout {
+                const char* name;
+                size_t      groupSize;
+            };
+            const Layout layouts[] = {
+                {"aligned", units},
+                {"partial", units / 4},
+                {"scattered", 1},
+            };
+            for (const auto& layout : layouts) {
+                // Skip layouts that don't fit or duplicate "scattered"
+                if (layout.groupSize == 0 || layout.groupSize > readings ||
+                    (layout.groupSize == 1 &&
+                     std::string(layout.name) != "scattered")) {
+                    continue;
+                }
+                GroupedReadings grouped =
+                    makeGroupedReadings(readings, units, layout.groupSize);
+                std::string json =
+                    JsonParser::composeGroupedReadings(grouped, controlUnitId);
+                std::string corpusName = std::to_string(readings) + "r/" +
+                                         std::to_string(units) + "u/" +
+                                         layout.name;
+                std::string fileName = "grouped_" + std::to_string(readings) +
+                                       "r_" + std::to_string(units) + "u_" +
+                                       layout.name + ".json";
+                runner.dumpCorpus(fileName, json);
+                runner.run("composeGroupedReadings",
+                           corpusName,
+                           json.size(),
+                           [&] {
+                               return JsonParser::composeGroupedReadings(
+                                   grouped, controlUnitId);
+                           });
+            }
+        }
+    }
+}
+
+void benchSensorReadings(BenchRunner& runner) {
+    const std::vector<size_t> batchSizes =
+        runner.quick() ? std::vector<size_t>{1, 10}
+                       : std::vector<size_t>{1, 5, 10, 100};
+    for (size_t batch : batchSizes) {
+        std::string body = makeSensorReadingsBody(batch);
+        runner.dumpCorpus("readings_" + std::to_string(batch) + ".json", body);
+        runner.run("parseSensorSnapshotGroup",
+                   std::to_string(batch) + " readings",
+                   body.size(),
+                   [&] { return JsonParser::parseSensorSnapshotGroup(body); });
+    }
+}
+
+void benchSmallMessages(BenchRunner& runner) {
+    const std::string controlUnitId = "f47ac10b-58cc-4372-a567-0e02b2c3d479";
+    const std::string sensorUnitId  = corpus::makeUuid(1);
+
+    std::string statusRequest = JsonParser::composeStatusRequest(controlUnitId);
+    runner.run("composeStatusRequest", "control unit id", statusRequest.size(),
+               [&] { return JsonParser::composeStatusRequest(controlUnitId); });
+
+    const std::string statusResponse = R"({"sensor_unit_id":")" +
+                                       sensorUnitId +
+                                       R"(","status":"in_transit"})";
+    runner.dumpCorpus("status_response.json", statusResponse);
+    runner.run("parseStatusResponse", "in_transit", statusResponse.size(), [&] {
+        return JsonParser::parseStatusResponse(statusResponse);
+    });
+
+    const std::string readingsResponse = R"({"status":"ok","saved":6})";
+    runner.dumpCorpus("readings_response.json", readingsResponse);
+    runner.run("parseBackendReadingsResponse",
+               "saved 6",
+               readingsResponse.size(),
+               [&] {
+                   return JsonParser::parseBackendReadingsResponse(
+                       readingsResponse);
+               });
+
+    const std::string connectRequest = R"({"sensor_unit_id":")" +
+                                       sensorUnitId +
+                                       R"(","token":"benchmark-token"})";
+    runner.dumpCorpus("sensor_connect_request.json", connectRequest);
+    runner.run("parseSensorConnectRequest",
+               "with token",
+               connectRequest.size(),
+               [&] {
+                   return JsonParser::parseSensorConnectRequest(
+                       connectRequest, requestType::CONNECT);
+               });
+
+    SensorConnectResponse connectResponse{std::make_shared<Uuid>(sensorUnitId),
+                                          connectionStatus::CONNECTED};
+    std::string composedConnectResponse =
+        JsonParser::composeSensorConnectResponse(connectResponse,
+                                                 controlUnitId);
+    runner.run("composeSensorConnectResponse",
+               "connected",
+               composedConnectResponse.size(),
+               [&] {
+                   return JsonParser::composeSensorConnectResponse(
+                       connectResponse, controlUnitId);
+               });
+
+    const std::string unitConnect =
+        R"({"sensor_unit_id":")" + sensorUnitId + R"("})";
+    runner.dumpCorpus("sensorunit_connect_request.json", unitConnect);
+    runner.run("parseSensorunitConnectRequest",
+               "sensor unit id",
+               unitConnect.size(),
+               [&] { return JsonParser::parseSensorunitConnectRequest(unitConnect); });
+
+    std::string statusPayload =
+        JsonParser::composeSensorunitStatusPayload("connected");
+    runner.run("composeSensorunitStatusPayload",
+               "connected",
+               statusPayload.size(),
+               [&] {
+                   return JsonParser::composeSensorunitStatusPayload(
+                       "connected");
+               });
+
+    std::string timestampPayload =
+        JsonParser::composeTimestampPayload(corpus::kStartTimestamp);
+    runner.run("composeTimestampPayload",
+               "unix time",
+               timestampPayload.size(),
+               [&] {
+                   return JsonParser::composeTimestampPayload(
+                       corpus::kStartTimestamp);
+               });
+
+    std::string errorResponse =
+        JsonParser::composeErrorResponse("Benchmark error", controlUnitId);
+    runner.run("composeErrorResponse", "short message", errorResponse.size(),
+               [&] {
+                   return JsonParser::composeErrorResponse("Benchmark error",
+                                                           controlUnitId);
+               });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchRunner runner(
+        argc, argv, "Control Unit JsonParser (cJSON)", &g_benchLogCalls);
+    benchGroupedReadings(runner);
+    benchSensorReadings(runner);
+    benchSmallMessages(runner);
+    return runner.finish();
+}
@@ -0,0 +1,101 @@
+/**
+ * @file bench_sensorunit.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host benchmarks for the Sensor Unit JsonParser
+ *
+ * Covers every compose/parse function in sensorunit/lib/json_parser.
+ * Readings batches are limited by json_config::max_batch_size.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "BenchRunner.h"
+#include "CorpusCommon.h"
+#include "JsonParser.h"
+
+namespace {
+
+using ReadingsBatch =
+    etl::vector<CaSensorunitReading, json_config::max_batch_size>;
+
+ReadingsBatch makeBatch(size_t readings) {
+    corpus::ValueGenerator values;
+    ReadingsBatch          batch;
+    for (size_t i = 0; i < readings && !batch.full(); ++i) {
+        batch.push_back({corpus::kStartTimestamp + static_cast<time_t>(i) * 5,
+                         values.temperature(),
+                         values.humidity()});
+    }
+    return batch;
+}
+
+void benchReadings(BenchRunner& runner) {
+    const std::string uuid = corpus::makeUuid(1);
+    const std::vector<size_t> batchSizes =
+        runner.quick() ? std::vector<size_t>{1, json_config::max_batch_size}
+                       : std::vector<size_t>{1, 5, json_config::max_batch_size};
+    for (size_t size : batchSizes) {
+        ReadingsBatch batch = makeBatch(size);
+        etl::string<json_config::max_json_size> json =
+            JsonParser::composeSensorSnapshotGroup(batch, uuid.c_str());
+        runner.dumpCorpus("su_readings_" + std::to_string(size) + ".json",
+                          json.c_str());
+        runner.run("composeSensorSnapshotGroup",
+                   std::to_string(size) + " readings",
+                   json.size(),
+                   [&] {
+                       return JsonParser::composeSensorSnapshotGroup(
+                           batch, uuid.c_str());
+                   });
+    }
+}
+
+void benchSmallMessages(BenchRunner& runner) {
+    const std::string uuid = corpus::makeUuid(1);
+
+    etl::string<json_config::max_small_json_size> connectRequest =
+        JsonParser::composeConnectRequest(uuid.c_str());
+    runner.run("composeConnectRequest",
+               "sensor unit id",
+               connectRequest.size(),
+               [&] { return JsonParser::composeConnectRequest(uuid.c_str()); });
+
+    const etl::string<json_config::max_small_json_size> connected{
+        R"({"status":"connected"})"};
+    const etl::string<json_config::max_small_json_size> pending{
+        R"({"status":"pending"})"};
+    runner.run("parseConnectResponse", "connected", connected.size(), [&] {
+        return JsonParser::parseConnectResponse(connected);
+    });
+    runner.run("parseConnectResponse", "pending", pending.size(), [&] {
+        return JsonParser::parseConnectResponse(pending);
+    });
+
+    const etl::string<json_config::max_small_json_size> disconnected{
+        R"({"status":"disconnected"})"};
+    runner.run("parseDispatchResponse", "connected", connected.size(), [&] {
+        return JsonParser::parseDispatchResponse(connected);
+    });
+    runner.run("parseDispatchResponse",
+               "disconnected",
+               disconnected.size(),
+               [&] { return JsonParser::parseDispatchResponse(disconnected); });
+
+    const etl::string<json_config::max_small_json_size> time{
+        R"({"timestamp":1726995600})"};
+    runner.run("parseGetTimeResponse", "unix time", time.size(), [&] {
+        return JsonParser::parseGetTimeResponse(time);
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchRunner runner(argc, argv, "Sensor Unit JsonParser (ArduinoJson)");
+    benchReadings(runner);
+    benchSmallMessages(runner);
+    return runner.finish();
+}
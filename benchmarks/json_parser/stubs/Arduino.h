@@ -0,0 +1,23 @@
+/**
+ * @file Arduino.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Minimal Arduino stand-in for building Sensor Unit code on the host
+ *
+ * Only what logging.h and JsonParser need is provided.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+inline unsigned long millis() {
+    using namespace std::chrono;
+    static const auto start = steady_clock::now();
+    return static_cast<unsigned long>(
+        duration_cast<milliseconds>(steady_clock::now() - start).count());
+}
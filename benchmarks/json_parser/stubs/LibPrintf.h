@@ -0,0 +1,12 @@
+/**
+ * @file LibPrintf.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host stand-in for LibPrintf. printf comes from the C library.
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <cstdio>
@@ -0,0 +1,22 @@
+/**
+ * @file config.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Sensor Unit config used by the host benchmarks
+ *
+ * Logging is disabled so that the measurements only include JSON work.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+
+#define LOG_LEVEL LOG_NONE
+
+constexpr const char* SENSOR_UNIT_ID = "550e8400-e29b-41d4-a716-446655440000";
+
+#define CONTROL_UNIT_IP_ADDR "127.0.0.1"
+#define CONTROL_UNIT_PASSWORD "benchmark"
+#define CONTROL_UNIT_PORT 8080
@@ -0,0 +1,35 @@
+/**
+ * @file esp_log.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Stub of the ESP-IDF logging API for host benchmarks
+ *
+ * The Control Unit JsonParser logs through ESP_LOGx. On the host we don't
+ * want formatting or console output in the measurements, so every call is
+ * reduced to a counter increment. The counter is reported by the benchmark
+ * so heavy logging on a hot path is still visible.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief Number of log calls made since program start
+ */
+inline size_t g_benchLogCalls = 0;
+
+#define BENCH_LOG_STUB(tag, fmt, ...)                                          \
+    do {                                                                       \
+        (void) (tag);                                                          \
+        ++g_benchLogCalls;                                                     \
+    } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) BENCH_LOG_STUB(tag, fmt)
+#define ESP_LOGW(tag, fmt, ...) BENCH_LOG_STUB(tag, fmt)
+#define ESP_LOGI(tag, fmt, ...) BENCH_LOG_STUB(tag, fmt)
+#define ESP_LOGD(tag, fmt, ...) BENCH_LOG_STUB(tag, fmt)
+#define ESP_LOGV(tag, fmt, ...) BENCH_LOG_STUB(tag, fmt)
@@ -11,6 +11,7 @@
  */
 #pragma once
 #include "sensor_data_types.h"
+#include <cstdint>
 
 /**
  * @brief Valid request for connecting/disconnecting a Sensor Unit
@@ -63,4 +64,17 @@ std::string connectionStatusToString(connectionStatus status);
 struct SensorConnectResponse {
     std::shared_ptr<Uuid> sensorUuid;
     connectionStatus      status;
-};
\ No newline at end of file
+};
+
+/**
+ * @brief Upload window of a Sensor Unit, in Unix seconds of the Control Unit
+ *
+ * The unit associates with the access point at the start of its window,
+ * uploads and disassociates, so more units than AP connections are served.
+ * A periodS of 0 means no window, the unit then stays associated.
+ */
+struct UploadSlot {
+    uint32_t periodS = 0; /**< Time between two windows of the unit */
+    uint32_t offsetS = 0; /**< Start of the window, Unix time % periodS */
+    uint32_t windowS = 0; /**< Length of the window */
+};
@@ -0,0 +1,333 @@
+/**
+ * @file JobScheduler.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the timer wheel job scheduler
+ *
+ * The esp_timer callback only advances the wheel and queues due runs, the
+ * workers run the jobs. One mutex guards the wheel and the job table, it is
+ * never held while a job runs.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "JobScheduler.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include <algorithm>
+
+/// Run queue item that tells a worker to exit
+static constexpr uint32_t STOP_WORKER = UINT32_MAX;
+
+JobScheduler::JobScheduler(const JobSchedulerConfig& config, RandomFn random)
+    : m_config{config}, m_random{random ? random : esp_random},
+      m_wheel{config.wheelSlots, config.maxJobs}, m_jobs(config.maxJobs),
+      m_startUs{static_cast<uint64_t>(esp_timer_get_time())} {
+    m_config.tickUs  = std::max<uint64_t>(m_config.tickUs, 1);
+    m_config.workers = std::max<size_t>(m_config.workers, 1);
+    m_mutex          = xSemaphoreCreateMutex();
+    if (m_mutex == nullptr) {
+        ESP_LOGE(TAG, "Failed to create mutex");
+    }
+}
+
+JobScheduler::~JobScheduler() {
+    stop();
+    if (m_runs) {
+        vQueueDelete(m_runs);
+    }
+    if (m_stopped) {
+        vSemaphoreDelete(m_stopped);
+    }
+    if (m_mutex) {
+        vSemaphoreDelete(m_mutex);
+    }
+}
+
+esp_err_t JobScheduler::start() {
+    if (m_mutex == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+    // Every job can have one run queued, plus one stop item per worker
+    m_runs    = xQueueCreate(m_config.maxJobs + m_config.workers, sizeof(Run));
+    m_stopped = xSemaphoreCreateCounting(m_config.workers, 0);
+    if (m_runs == nullptr || m_stopped == nullptr) {
+        ESP_LOGE(TAG, "Failed to create run queue");
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_timer_create_args_t timer_args{};
+    timer_args.callback        = &JobScheduler::timerCallback;
+    timer_args.arg             = this;
+    timer_args.dispatch_method = ESP_TIMER_TASK;
+    timer_args.name            = "JobScheduler";
+    esp_err_t err              = esp_timer_create(&timer_args, &m_timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create timer: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    for (size_t i = 0; i < m_config.workers; ++i) {
+        if (createTask(m_config.workerTask, workerEntry, this) != pdPASS) {
+            break;
+        }
+        ++m_startedWorkers;
+    }
+    if (m_startedWorkers == 0) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    m_running = true;
+    advance();
+    arm();
+    xSemaphoreGive(m_mutex);
+    ESP_LOGI(TAG,
+             "Started with %zu workers, tick %llu us",
+             m_startedWorkers,
+             m_config.tickUs);
+    return ESP_OK;
+}
+
+void JobScheduler::stop() {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    bool wasRunning = m_running;
+    m_running       = false;
+    xSemaphoreGive(m_mutex);
+    if (!wasRunning) {
+        return;
+    }
+
+    // Outside the mutex, esp_timer_delete() waits for a running callback
+    esp_timer_stop(m_timer);
+    esp_timer_delete(m_timer);
+    m_timer = nullptr;
+
+    Run stop{STOP_WORKER, 0, 0};
+    for (size_t i = 0; i < m_startedWorkers; ++i) {
+        xQueueSend(m_runs, &stop, portMAX_DELAY);
+    }
+    for (size_t i = 0; i < m_startedWorkers; ++i) {
+        xSemaphoreTake(m_stopped, portMAX_DELAY);
+    }
+    m_startedWorkers = 0;
+
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    for (auto& job : m_jobs) {
+        job.busy = false;
+    }
+    xSemaphoreGive(m_mutex);
+    ESP_LOGI(TAG, "Stopped");
+}
+
+JobId JobScheduler::schedule(const JobConfig& config) {
+    if (config.run == nullptr || m_mutex == nullptr) {
+        return INVALID_JOB;
+    }
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    // Free slots first, so cancelled jobs keep their stats as long as possible
+    auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [](const Job& job) {
+        return job.state == JobState::Free;
+    });
+    if (it == m_jobs.end()) {
+        it = std::find_if(m_jobs.begin(), m_jobs.end(), [](const Job& job) {
+            return (job.state == JobState::Done ||
+                    job.state == JobState::Cancelled) &&
+                   !job.busy;
+        });
+    }
+    if (it == m_jobs.end()) {
+        xSemaphoreGive(m_mutex);
+        ESP_LOGE(TAG, "No room for job %s", config.name);
+        return INVALID_JOB;
+    }
+
+    size_t   index    = it - m_jobs.begin();
+    uint64_t delayUs  = config.delayUs ? config.delayUs : config.periodUs;
+    uint64_t nowUs    = esp_timer_get_time() - m_startUs;
+    Job&     job      = *it;
+    job.config        = config;
+    job.state         = JobState::Scheduled;
+    job.busy          = false;
+    job.stats         = {};
+    job.stats.name    = config.name;
+    job.stats.active  = true;
+    // Rounded up, a job never runs before it is due
+    job.baseTick = (nowUs + delayUs + m_config.tickUs - 1) / m_config.tickUs;
+    ++job.generation;
+    m_wheel.insert(index, job.baseTick + jitterTicks(config));
+    JobId id = static_cast<JobId>(index) | (job.generation << 8);
+    arm();
+    xSemaphoreGive(m_mutex);
+    return id;
+}
+
+void JobScheduler::cancel(JobId id) {
+    if (id == INVALID_JOB || m_mutex == nullptr) {
+        return;
+    }
+    size_t   index      = id & 0xff;
+    uint32_t generation = id >> 8;
+    if (index >= m_jobs.size()) {
+        return;
+    }
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    Job& job = m_jobs[index];
+    if (job.generation != generation || job.state == JobState::Free) {
+        xSemaphoreGive(m_mutex);
+        return;
+    }
+    if (job.state != JobState::Cancelled) {
+        job.state        = JobState::Cancelled;
+        job.stats.active = false;
+        m_wheel.remove(index);
+        arm();
+    }
+    // A queued run is dropped by the worker, a running one has to finish
+    while (job.busy) {
+        xSemaphoreGive(m_mutex);
+        vTaskDelay(1);
+        xSemaphoreTake(m_mutex, portMAX_DELAY);
+    }
+    xSemaphoreGive(m_mutex);
+}
+
+std::vector<JobStats> JobScheduler::stats() const {
+    std::vector<JobStats> stats;
+    if (m_mutex == nullptr) {
+        return stats;
+    }
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    for (const auto& job : m_jobs) {
+        if (job.state != JobState::Free) {
+            stats.push_back(job.stats);
+        }
+    }
+    xSemaphoreGive(m_mutex);
+    return stats;
+}
+
+void JobScheduler::timerCallback(void* arg) {
+    auto* self = static_cast<JobScheduler*>(arg);
+    xSemaphoreTake(self->m_mutex, portMAX_DELAY);
+    if (self->m_running) {
+        self->m_armedTick = TimerWheel::NO_EXPIRY;
+        self->advance();
+        self->arm();
+    }
+    xSemaphoreGive(self->m_mutex);
+}
+
+void JobScheduler::advance() {
+    uint64_t now = nowTick();
+    m_wheel.advance(now, [this, now](size_t index, uint64_t expiryTick) {
+        Job& job = m_jobs[index];
+        if (job.state != JobState::Scheduled) {
+            return;
+        }
+        Run run{static_cast<uint32_t>(index), job.generation,
+                tickToUs(expiryTick)};
+        if (job.busy || xQueueSend(m_runs, &run, 0) != pdTRUE) {
+            ++job.stats.overruns;
+        } else {
+            job.busy = true;
+        }
+
+        if (job.config.periodUs == 0) {
+            job.state        = JobState::Done;
+            job.stats.active = false;
+            return;
+        }
+        // Fixed rate, runs that were missed entirely count as overruns
+        uint64_t period =
+            std::max<uint64_t>(job.config.periodUs / m_config.tickUs, 1);
+        job.baseTick += period;
+        if (job.baseTick <= now) {
+            uint64_t missed = (now - job.baseTick) / period + 1;
+            job.stats.overruns += missed;
+            job.baseTick += missed * period;
+        }
+        m_wheel.insert(index, job.baseTick + jitterTicks(job.config));
+    });
+}
+
+void JobScheduler::arm() {
+    if (!m_running || m_timer == nullptr) {
+        return;
+    }
+    uint64_t next = m_wheel.nextExpiry();
+    if (next == m_armedTick) {
+        return;
+    }
+    esp_timer_stop(m_timer);
+    m_armedTick = next;
+    if (next == TimerWheel::NO_EXPIRY) {
+        return;
+    }
+    int64_t delayUs = static_cast<int64_t>(tickToUs(next)) - esp_timer_get_time();
+    esp_timer_start_once(m_timer, std::max<int64_t>(delayUs, 1));
+}
+
+uint64_t JobScheduler::nowTick() const {
+    return (esp_timer_get_time() - m_startUs) / m_config.tickUs;
+}
+
+uint64_t JobScheduler::tickToUs(uint64_t tick) const {
+    return m_startUs + tick * m_config.tickUs;
+}
+
+uint64_t JobScheduler::jitterTicks(const JobConfig& config) {
+    if (config.jitterUs == 0) {
+        return 0;
+    }
+    return (m_random() % (config.jitterUs + 1)) / m_config.tickUs;
+}
+
+void JobScheduler::workerEntry(void* pvParameters) {
+    auto* self = static_cast<JobScheduler*>(pvParameters);
+    self->workerLoop();
+    untrackTask();
+    xSemaphoreGive(self->m_stopped);
+    vTaskDelete(nullptr);
+}
+
+void JobScheduler::workerLoop() {
+    Run run{};
+    while (xQueueReceive(m_runs, &run, portMAX_DELAY) == pdTRUE) {
+        if (run.index == STOP_WORKER) {
+            return;
+        }
+        xSemaphoreTake(m_mutex, portMAX_DELAY);
+        Job& job = m_jobs[run.index];
+        if (job.generation != run.generation) {
+            // Stale run of a slot that was reused after stop()
+            xSemaphoreGive(m_mutex);
+            continue;
+        }
+        if (job.state == JobState::Cancelled) {
+            job.busy = false;
+            xSemaphoreGive(m_mutex);
+            continue;
+        }
+        JobConfig config = job.config;
+        xSemaphoreGive(m_mutex);
+
+        uint64_t startUs = esp_timer_get_time();
+        config.run(config.context);
+        uint64_t endUs = esp_timer_get_time();
+
+        xSemaphoreTake(m_mutex, portMAX_DELAY);
+        if (job.generation == run.generation) {
+            uint64_t latencyUs = startUs > run.dueUs ? startUs - run.dueUs : 0;
+            JobStats& stats    = job.stats;
+            ++stats.runs;
+            stats.totalLatencyUs += latencyUs;
+            stats.maxLatencyUs = std::max(stats.maxLatencyUs, latencyUs);
+            stats.maxRunUs     = std::max(stats.maxRunUs, endUs - startUs);
+            job.busy           = false;
+        }
+        xSemaphoreGive(m_mutex);
+    }
+}
@@ -0,0 +1,188 @@
+/**
+ * @file JobScheduler.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief One timer and a small worker pool for all periodic work
+ *
+ * Replaces the esp_timer + task pair every component used to have:
+ *
+ * - Jobs are one-shot or periodic, optionally with random jitter added to
+ *   every run. Periodic jobs run at a fixed rate, late runs do not shift the
+ *   ones after them
+ * - Due times live in a TimerWheel. One one-shot esp_timer is armed for the
+ *   earliest due time, so nothing wakes up between jobs
+ * - Due jobs are queued to the workers. A job that is due while its previous
+ *   run is still queued or running is skipped and counted as an overrun
+ * - Every job keeps its run count, overruns, start latency and run time
+ *
+ * Jobs run on the worker tasks and should be short. Blocking I/O belongs on
+ * the BackendIoTask.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "TaskProfile.h"
+#include "TimerWheel.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Settings for a JobScheduler, times in microseconds
+ */
+struct JobSchedulerConfig {
+    uint64_t    tickUs     = 10'000;          /**< Wheel resolution */
+    size_t      wheelSlots = 64;              /**< One revolution in ticks */
+    size_t      maxJobs    = 8;               /**< Max 255 at the same time */
+    size_t      workers    = 1;               /**< Worker tasks */
+    TaskProfile workerTask = JOB_WORKER_TASK; /**< Placement of every worker */
+};
+
+/**
+ * @brief A job to schedule. name must outlive the job.
+ */
+struct JobConfig {
+    const char* name           = "job";
+    void (*run)(void* context) = nullptr;
+    void*       context        = nullptr;
+    uint64_t    delayUs  = 0; /**< First run after this, one period if 0 */
+    uint64_t    periodUs = 0; /**< 0 for a one-shot job */
+    uint64_t    jitterUs = 0; /**< Random extra delay up to this, every run */
+};
+
+/**
+ * @brief Counters of one job
+ */
+struct JobStats {
+    const char* name;
+    bool        active;         /**< Still scheduled */
+    uint32_t    runs;           /**< Runs finished */
+    uint32_t    overruns;       /**< Runs skipped because the last was busy */
+    uint64_t    totalLatencyUs; /**< Sum of due time to start time */
+    uint64_t    maxLatencyUs;   /**< Longest due time to start time */
+    uint64_t    maxRunUs;       /**< Longest run */
+};
+
+using JobId = uint32_t;
+static constexpr JobId INVALID_JOB = UINT32_MAX;
+
+/**
+ * @class JobScheduler
+ * @brief Timer wheel driven scheduler with a fixed pool of worker tasks
+ */
+class JobScheduler {
+  public:
+    using RandomFn = uint32_t (*)();
+
+    /**
+     * @brief Constructs the scheduler, all job storage is allocated here
+     *
+     * @param config Wheel, job and worker settings
+     * @param random Source for the jitter, esp_random by default
+     */
+    explicit JobScheduler(const JobSchedulerConfig& config = {},
+                          RandomFn                  random = nullptr);
+
+    /**
+     * @brief Stops the scheduler, see stop()
+     */
+    ~JobScheduler();
+
+    /**
+     * @brief Creates the timer, the run queue and the workers
+     *
+     * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM or the esp_timer
+     * error on failure.
+     */
+    esp_err_t start();
+
+    /**
+     * @brief Stops the timer and lets the workers finish the runs already
+     * queued. Jobs stay scheduled but never run again.
+     */
+    void stop();
+
+    /**
+     * @brief Schedules a job. Safe to call from any task, also before start()
+     *
+     * @return JobId to cancel the job with, INVALID_JOB if maxJobs are
+     * scheduled already or run is missing.
+     */
+    JobId schedule(const JobConfig& job);
+
+    /**
+     * @brief Cancels a job and waits for a run in progress to finish, so the
+     * context can be destroyed afterwards. Must not be called from the job
+     * itself. Cancelling a job twice does nothing.
+     */
+    void cancel(JobId id);
+
+    /**
+     * @brief Returns the counters of every job scheduled since start
+     */
+    std::vector<JobStats> stats() const;
+
+  private:
+    enum class JobState : uint8_t { Free, Scheduled, Done, Cancelled };
+
+    struct Job {
+        JobConfig config;
+        JobState  state      = JobState::Free;
+        uint32_t  generation = 0; /**< Bumped on reuse, part of the JobId */
+        uint64_t  baseTick   = 0; /**< Due tick without jitter */
+        bool      busy       = false; /**< Queued or running */
+        JobStats  stats{};
+    };
+
+    /**
+     * @brief Run queue item
+     */
+    struct Run {
+        uint32_t index;
+        uint32_t generation;
+        uint64_t dueUs;
+    };
+
+    static void timerCallback(void* arg);
+    static void workerEntry(void* pvParameters);
+    void        workerLoop();
+
+    /**
+     * @brief Queues due runs and re-inserts periodic jobs, called with
+     * m_mutex held
+     */
+    void advance();
+
+    /**
+     * @brief Arms the esp_timer for the earliest job, called with m_mutex held
+     */
+    void arm();
+
+    uint64_t nowTick() const;
+    uint64_t tickToUs(uint64_t tick) const;
+    uint64_t jitterTicks(const JobConfig& config);
+
+    JobSchedulerConfig m_config;
+    RandomFn           m_random;
+    TimerWheel         m_wheel;
+    std::vector<Job>   m_jobs;
+    uint64_t           m_startUs;
+    uint64_t           m_armedTick = TimerWheel::NO_EXPIRY;
+
+    mutable SemaphoreHandle_t m_mutex   = nullptr; /**< Guards everything */
+    QueueHandle_t             m_runs    = nullptr;
+    SemaphoreHandle_t         m_stopped = nullptr; /**< Given by each worker */
+    esp_timer_handle_t        m_timer   = nullptr;
+    size_t                    m_startedWorkers = 0;
+    bool                      m_running        = false;
+
+    static constexpr const char* TAG = "JobScheduler";
+};
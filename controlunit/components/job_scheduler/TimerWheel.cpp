@@ -0,0 +1,101 @@
+/**
+ * @file TimerWheel.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the hashed timer wheel
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(size_t slots, size_t capacity)
+    : m_slots(std::max<size_t>(slots, 1), NONE), m_entries(capacity) {}
+
+bool TimerWheel::insert(size_t id, uint64_t expiryTick) {
+    if (id >= m_entries.size()) {
+        return false;
+    }
+    remove(id);
+    // Overdue timers go into the next slot so the next advance() sees them
+    size_t slot  = slotOf(std::max(expiryTick, m_currentTick + 1));
+    Entry& entry = m_entries[id];
+    entry.expiryTick = expiryTick;
+    entry.slot       = slot;
+    entry.prev       = NONE;
+    entry.next       = m_slots[slot];
+    entry.armed      = true;
+    if (entry.next != NONE) {
+        m_entries[entry.next].prev = id;
+    }
+    m_slots[slot] = id;
+    return true;
+}
+
+void TimerWheel::remove(size_t id) {
+    if (id >= m_entries.size() || !m_entries[id].armed) {
+        return;
+    }
+    Entry& entry = m_entries[id];
+    if (entry.prev != NONE) {
+        m_entries[entry.prev].next = entry.next;
+    } else {
+        m_slots[entry.slot] = entry.next;
+    }
+    if (entry.next != NONE) {
+        m_entries[entry.next].prev = entry.prev;
+    }
+    entry.prev  = NONE;
+    entry.next  = NONE;
+    entry.armed = false;
+}
+
+bool TimerWheel::armed(size_t id) const {
+    return id < m_entries.size() && m_entries[id].armed;
+}
+
+void TimerWheel::collectExpired(uint64_t nowTick) {
+    if (nowTick <= m_currentTick) {
+        return;
+    }
+    // After a long gap every slot is visited once, not once per tick
+    uint64_t steps = std::min<uint64_t>(nowTick - m_currentTick, m_slots.size());
+    size_t   tail  = NONE;
+    for (uint64_t step = 1; step <= steps; ++step) {
+        size_t id = m_slots[slotOf(m_currentTick + step)];
+        while (id != NONE) {
+            size_t next = m_entries[id].next;
+            if (m_entries[id].expiryTick <= nowTick) {
+                remove(id);
+                // Keep firing order by appending to the expired list
+                if (tail == NONE) {
+                    m_expired = id;
+                } else {
+                    m_entries[tail].next = id;
+                }
+                tail = id;
+            }
+            id = next;
+        }
+    }
+    m_currentTick = nowTick;
+}
+
+uint64_t TimerWheel::nextExpiry() const {
+    uint64_t earliest = NO_EXPIRY;
+    for (size_t step = 1; step <= m_slots.size(); ++step) {
+        uint64_t tick = m_currentTick + step;
+        for (size_t id = m_slots[slotOf(tick)]; id != NONE;
+             id        = m_entries[id].next) {
+            earliest = std::min(earliest, m_entries[id].expiryTick);
+        }
+        // Timers in later slots expire after this tick
+        if (earliest <= tick) {
+            break;
+        }
+    }
+    return earliest;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file TimerWheel.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Hashed timer wheel used by JobScheduler
+ *
+ * Timers are ids in the range [0, capacity) with an expiry tick. A timer goes
+ * into slot expiry % slots, so insert and remove are O(1) and advancing one
+ * tick only looks at one slot. Timers further away than one revolution stay
+ * in their slot until their tick comes around.
+ *
+ * All storage is allocated in the constructor. Plain logic, the caller
+ * passes the ticks and serializes the calls.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class TimerWheel
+ * @brief Fixed capacity timer wheel with intrusive slot lists
+ */
+class TimerWheel {
+  public:
+    static constexpr uint64_t NO_EXPIRY = UINT64_MAX;
+
+    /**
+     * @brief Constructs an empty wheel at tick 0
+     *
+     * @param slots Number of slots, one revolution is this many ticks
+     * @param capacity Number of timer ids
+     */
+    TimerWheel(size_t slots, size_t capacity);
+
+    /**
+     * @brief Arms a timer, re-arms it if it is already armed
+     *
+     * @param id Timer id below capacity
+     * @param expiryTick Tick the timer fires at, a tick not after the
+     * current one fires on the next advance()
+     * @return false if id is out of range
+     */
+    bool insert(size_t id, uint64_t expiryTick);
+
+    /**
+     * @brief Disarms a timer, does nothing if it is not armed
+     */
+    void remove(size_t id);
+
+    /**
+     * @brief Returns true if the timer is armed
+     */
+    bool armed(size_t id) const;
+
+    /**
+     * @brief Moves the wheel to nowTick and fires every timer that expired
+     *
+     * Fired timers are disarmed before onExpired(id, expiryTick) is called,
+     * so the callback may insert them again.
+     */
+    template <typename F> void advance(uint64_t nowTick, F&& onExpired) {
+        collectExpired(nowTick);
+        while (m_expired != NONE) {
+            size_t id = m_expired;
+            m_expired = m_entries[id].next;
+            m_entries[id].next = NONE;
+            onExpired(id, m_entries[id].expiryTick);
+        }
+    }
+
+    /**
+     * @brief Earliest expiry tick of the armed timers, NO_EXPIRY if none
+     */
+    uint64_t nextExpiry() const;
+
+    /**
+     * @brief Tick of the last advance()
+     */
+    uint64_t currentTick() const { return m_currentTick; }
+
+  private:
+    static constexpr size_t NONE = SIZE_MAX;
+
+    struct Entry {
+        uint64_t expiryTick = 0;
+        size_t   slot       = 0;
+        size_t   prev       = NONE;
+        size_t   next       = NONE;
+        bool     armed      = false;
+    };
+
+    /**
+     * @brief Unlinks all expired timers into the m_expired list
+     */
+    void collectExpired(uint64_t nowTick);
+
+    size_t slotOf(uint64_t tick) const { return tick % m_slots.size(); }
+
+    std::vector<size_t> m_slots;   /**< Head id of each slot list */
+    std::vector<Entry>  m_entries; /**< Indexed by id */
+    size_t   m_expired     = NONE; /**< Fired timers waiting for the callback */
+    uint64_t m_currentTick = 0;
+};
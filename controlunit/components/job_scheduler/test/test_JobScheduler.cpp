@@ -0,0 +1,97 @@
+/**
+ * @brief Test file for JobScheduler.cpp
+ *
+ * Runs real workers and esp_timer, the timing bounds are loose on purpose.
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "JobScheduler.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+
+static uint32_t fixedJitter() {
+    return 30'000;
+}
+
+struct Counter {
+    std::atomic<uint32_t> runs{0};
+    std::atomic<int64_t>  lastRunUs{0};
+    uint32_t              sleepMs = 0;
+};
+
+static void countRun(void* context) {
+    auto* counter      = static_cast<Counter*>(context);
+    counter->lastRunUs = esp_timer_get_time();
+    ++counter->runs;
+    if (counter->sleepMs > 0) {
+        vTaskDelay(pdMS_TO_TICKS(counter->sleepMs));
+    }
+}
+
+static JobConfig counterJob(Counter& counter, uint64_t periodUs) {
+    JobConfig job{};
+    job.name     = "counter";
+    job.run      = &countRun;
+    job.context  = &counter;
+    job.periodUs = periodUs;
+    return job;
+}
+
+extern "C" void when_jobs_scheduled_then_periodic_repeat_and_one_shot_runs_once(
+    void) {
+    JobSchedulerConfig config;
+    config.tickUs = 1000;
+    JobScheduler scheduler(config, fixedJitter);
+    TEST_ASSERT_EQUAL(ESP_OK, scheduler.start());
+
+    Counter   periodic, oneShot;
+    JobConfig shot = counterJob(oneShot, 0);
+    shot.delayUs   = 20'000;
+    shot.jitterUs  = 30'000; // fixedJitter, so exactly 50 ms
+    int64_t startUs = esp_timer_get_time();
+    JobId   id      = scheduler.schedule(counterJob(periodic, 20'000));
+    TEST_ASSERT_NOT_EQUAL(INVALID_JOB, id);
+    TEST_ASSERT_NOT_EQUAL(INVALID_JOB, scheduler.schedule(shot));
+
+    vTaskDelay(pdMS_TO_TICKS(210));
+    scheduler.cancel(id);
+    uint32_t runs = periodic.runs;
+    TEST_ASSERT_TRUE(runs >= 8 && runs <= 11);
+    TEST_ASSERT_EQUAL_UINT32(1, oneShot.runs);
+    TEST_ASSERT_TRUE(oneShot.lastRunUs - startUs >= 50'000);
+
+    // Cancelled, nothing runs any more
+    vTaskDelay(pdMS_TO_TICKS(60));
+    TEST_ASSERT_EQUAL_UINT32(runs, periodic.runs);
+
+    std::vector<JobStats> stats = scheduler.stats();
+    TEST_ASSERT_EQUAL(2, stats.size());
+    TEST_ASSERT_FALSE(stats[0].active);
+    TEST_ASSERT_EQUAL_UINT32(runs, stats[0].runs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats[0].overruns);
+    scheduler.stop();
+}
+
+extern "C" void when_job_outlasts_its_period_then_overruns_are_counted(void) {
+    JobSchedulerConfig config;
+    config.tickUs = 1000;
+    JobScheduler scheduler(config);
+    TEST_ASSERT_EQUAL(ESP_OK, scheduler.start());
+
+    Counter slow;
+    slow.sleepMs = 50;
+    JobId id     = scheduler.schedule(counterJob(slow, 20'000));
+    vTaskDelay(pdMS_TO_TICKS(300));
+    scheduler.cancel(id);
+
+    std::vector<JobStats> stats = scheduler.stats();
+    TEST_ASSERT_EQUAL(1, stats.size());
+    // Every run takes 2.5 periods, so most periods are skipped
+    TEST_ASSERT_TRUE(stats[0].runs >= 4 && stats[0].runs <= 7);
+    TEST_ASSERT_TRUE(stats[0].overruns >= 6);
+    TEST_ASSERT_TRUE(stats[0].maxRunUs >= 50'000);
+    scheduler.stop();
+}
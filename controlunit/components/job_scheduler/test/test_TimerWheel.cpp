@@ -0,0 +1,77 @@
+/**
+ * @brief Test file for TimerWheel.cpp
+ *
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "TimerWheel.h"
+#include <vector>
+
+extern "C" void when_timers_expire_then_they_fire_once_in_tick_order(void) {
+    TimerWheel          wheel(8, 4);
+    std::vector<size_t> fired;
+    auto record = [&](size_t id, uint64_t) { fired.push_back(id); };
+
+    wheel.insert(0, 5);
+    wheel.insert(1, 3);
+    wheel.insert(2, 4);
+    TEST_ASSERT_EQUAL_UINT64(3, wheel.nextExpiry());
+
+    wheel.advance(2, record);
+    TEST_ASSERT_EQUAL(0, fired.size());
+    wheel.advance(5, record);
+    TEST_ASSERT_EQUAL(3, fired.size());
+    TEST_ASSERT_EQUAL(1, fired[0]);
+    TEST_ASSERT_EQUAL(2, fired[1]);
+    TEST_ASSERT_EQUAL(0, fired[2]);
+    TEST_ASSERT_FALSE(wheel.armed(0));
+
+    wheel.advance(100, record);
+    TEST_ASSERT_EQUAL(3, fired.size());
+    TEST_ASSERT_EQUAL_UINT64(TimerWheel::NO_EXPIRY, wheel.nextExpiry());
+}
+
+extern "C" void when_timer_is_rounds_away_then_it_waits_for_its_round(void) {
+    TimerWheel          wheel(8, 2);
+    std::vector<size_t> fired;
+    auto record = [&](size_t id, uint64_t) { fired.push_back(id); };
+
+    // Same slot as tick 3, but two revolutions later
+    wheel.insert(0, 19);
+    TEST_ASSERT_EQUAL_UINT64(19, wheel.nextExpiry());
+    wheel.advance(3, record);
+    wheel.advance(11, record);
+    TEST_ASSERT_EQUAL(0, fired.size());
+    wheel.advance(19, record);
+    TEST_ASSERT_EQUAL(1, fired.size());
+}
+
+extern "C" void when_timer_removed_or_overdue_then_wheel_handles_it(void) {
+    TimerWheel            wheel(8, 3);
+    std::vector<uint64_t> expiries;
+    auto record = [&](size_t, uint64_t tick) { expiries.push_back(tick); };
+
+    wheel.insert(0, 4);
+    wheel.insert(1, 6);
+    wheel.remove(0);
+    TEST_ASSERT_FALSE(wheel.armed(0));
+    TEST_ASSERT_EQUAL_UINT64(6, wheel.nextExpiry());
+
+    // Re-armed from the callback, like a periodic job
+    wheel.advance(10, [&](size_t id, uint64_t tick) {
+        expiries.push_back(tick);
+        wheel.insert(id, tick + 8);
+    });
+    TEST_ASSERT_EQUAL(1, expiries.size());
+    TEST_ASSERT_EQUAL_UINT64(14, wheel.nextExpiry());
+
+    // Already due when armed, fires on the next advance
+    wheel.insert(2, 7);
+    TEST_ASSERT_EQUAL_UINT64(7, wheel.nextExpiry());
+    wheel.advance(11, record);
+    TEST_ASSERT_EQUAL(2, expiries.size());
+    TEST_ASSERT_EQUAL_UINT64(7, expiries[1]);
+    TEST_ASSERT_FALSE(wheel.insert(3, 20));
+}
@@ -22,6 +22,7 @@
  */
 #include "JsonParser.h"
 #include "cJSON.h"
+#include "LogRateLimit.h"
 #include "esp_log.h"
 #include <memory>
 
@@ -49,7 +50,8 @@ JsonParser::parseStatusResponse(const std::string& json) {
     std::vector<SensorConnectRequest> result;
     cJSON* root = cJSON_Parse(json.c_str());
     if (!root) {
-        ESP_LOGE(TAG, "Failed to parse JSON: %s", json.c_str());
+        CU_LOGE_RATELIMITED(
+            TAG, LOG_RATE_LIMIT_MS, "Failed to parse JSON: %s", json.c_str());
         return result;
     }
 
@@ -96,7 +98,8 @@ JsonParser::parseStatusResponse(const std::string& json) {
 size_t JsonParser::parseBackendReadingsResponse(const std::string& json){
     cJSON* root = cJSON_Parse(json.c_str());
     if (!root) {
-        ESP_LOGE(TAG, "Failed to parse JSON: %s", json.c_str());
+        CU_LOGE_RATELIMITED(
+            TAG, LOG_RATE_LIMIT_MS, "Failed to parse JSON: %s", json.c_str());
         return 0;
     }
     cJSON* statusItem = cJSON_GetObjectItem(root, "status");
@@ -132,7 +135,8 @@ JsonParser::parseSensorSnapshotGroup(const std::string& json) {
 
     cJSON* root = cJSON_Parse(json.c_str());
     if (!root) {
-        ESP_LOGE(TAG, "Failed to parse JSON: %s", json.c_str());
+        CU_LOGE_RATELIMITED(
+            TAG, LOG_RATE_LIMIT_MS, "Failed to parse JSON: %s", json.c_str());
         return snapshots;
     }
 
@@ -156,7 +160,8 @@ JsonParser::parseSensorSnapshotGroup(const std::string& json) {
     cJSON* reading = nullptr;
     cJSON_ArrayForEach(reading, readingsArray) {
         if (!cJSON_IsObject(reading)) {
-            ESP_LOGW(TAG, "Skipping non-object reading");
+            CU_LOGW_RATELIMITED(
+                TAG, LOG_RATE_LIMIT_MS, "Skipping non-object reading");
             continue;
         }
 
@@ -166,7 +171,8 @@ JsonParser::parseSensorSnapshotGroup(const std::string& json) {
 
         if (!cJSON_IsNumber(timestampItem) ||
             !cJSON_IsNumber(temperatureItem) || !cJSON_IsNumber(humidityItem)) {
-            ESP_LOGW(TAG, "Skipping invalid reading entry");
+            CU_LOGW_RATELIMITED(
+                TAG, LOG_RATE_LIMIT_MS, "Skipping invalid reading entry");
             continue;
         }
 
@@ -194,9 +200,9 @@ std::string JsonParser::composeGroupedReadings(
     // Timestamp Groups
     cJSON* timestampGroups = cJSON_CreateArray();
     if (readings.empty()) {
-        ESP_LOGI(TAG, "No new readings — sending timestamp_groups: []");
+        ESP_LOGD(TAG, "No new readings — sending timestamp_groups: []");
     } else {
-        ESP_LOGI(
+        ESP_LOGD(
             TAG, "Composing JSON with %zu timestamp groups", readings.size());
     }
     for (const auto& [timestamp, snapshots] : readings) {
@@ -245,7 +251,8 @@ JsonParser::parseSensorConnectRequest(const std::string& json,
 
     cJSON* root = cJSON_Parse(json.c_str());
     if (!root) {
-        ESP_LOGE(TAG, "Failed to parse JSON: %s", json.c_str());
+        CU_LOGE_RATELIMITED(
+            TAG, LOG_RATE_LIMIT_MS, "Failed to parse JSON: %s", json.c_str());
         return request;
     }
 
@@ -309,7 +316,8 @@ Uuid JsonParser::parseSensorunitConnectRequest(const std::string& json) {
 
     cJSON* root = cJSON_Parse(json.c_str());
     if (!root) {
-        ESP_LOGE(TAG, "Failed to parse JSON: %s", json.c_str());
+        CU_LOGE_RATELIMITED(
+            TAG, LOG_RATE_LIMIT_MS, "Failed to parse JSON: %s", json.c_str());
         return Uuid("");
     }
 
@@ -321,7 +329,8 @@ Uuid JsonParser::parseSensorunitConnectRequest(const std::string& json) {
     }
 
     Uuid sensorUnitId(uuidItem->valuestring);
-    ESP_LOGI(TAG, "Parsed Sensor Unit Id:%s ", sensorUnitId.toString().c_str());
+    ESP_LOGD(TAG, "Parsed Sensor Unit Id:%s ", sensorUnitId.toString().c_str());
+    cJSON_Delete(root);
     return sensorUnitId;
 }
 
@@ -336,7 +345,28 @@ JsonParser::composeSensorunitStatusPayload(const std::string& status) {
     cJSON_free(jsonStr);
     cJSON_Delete(root);
 
-    ESP_LOGI(TAG, "Json Payload created with status %s", status.c_str());
+    ESP_LOGD(TAG, "Json Payload created with status %s", status.c_str());
+    return payload;
+}
+
+std::string
+JsonParser::composeSensorunitConnectPayload(const std::string& status,
+                                            const UploadSlot&  slot) {
+
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "status", status.c_str());
+    if (slot.periodS > 0) {
+        cJSON_AddNumberToObject(root, "upload_period_s", slot.periodS);
+        cJSON_AddNumberToObject(root, "upload_offset_s", slot.offsetS);
+        cJSON_AddNumberToObject(root, "upload_window_s", slot.windowS);
+    }
+
+    char*       jsonStr = cJSON_PrintUnformatted(root);
+    std::string payload(jsonStr);
+    cJSON_free(jsonStr);
+    cJSON_Delete(root);
+
+    ESP_LOGD(TAG, "Json Payload created with status %s", status.c_str());
     return payload;
 }
 
@@ -351,7 +381,48 @@ std::string JsonParser::composeTimestampPayload(time_t now) {
     cJSON_free(jsonStr);
     cJSON_Delete(root);
 
-    ESP_LOGI(TAG, "Json Payload created with timestamp %.0f", timestamp);
+    ESP_LOGD(TAG, "Json Payload created with timestamp %.0f", timestamp);
+    return payload;
+}
+
+std::string
+JsonParser::composeResourcesPayload(const ResourceSnapshot& snapshot) {
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(
+        root, "uptime_s", static_cast<double>(snapshot.uptimeUs / 1'000'000));
+
+    cJSON* heap = cJSON_AddObjectToObject(root, "heap");
+    cJSON_AddNumberToObject(heap, "free", snapshot.heap.freeBytes);
+    cJSON_AddNumberToObject(heap, "min_free", snapshot.heap.minFreeBytes);
+    cJSON_AddNumberToObject(
+        heap, "largest_block", snapshot.heap.largestFreeBlock);
+
+    cJSON* tasks = cJSON_AddArrayToObject(root, "tasks");
+    for (const auto& task : snapshot.tasks) {
+        cJSON* item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "name", task.name);
+        cJSON_AddNumberToObject(item, "core", task.core);
+        cJSON_AddNumberToObject(item, "priority", task.priority);
+        cJSON_AddNumberToObject(item, "stack", task.stackBytes);
+        cJSON_AddNumberToObject(item, "stack_min_free", task.minFreeBytes);
+        cJSON_AddItemToArray(tasks, item);
+    }
+
+    cJSON* allocs = cJSON_AddArrayToObject(root, "allocs");
+    for (const auto& alloc : snapshot.allocs) {
+        cJSON* item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "name", alloc.name);
+        cJSON_AddNumberToObject(item, "allocs", alloc.allocs);
+        cJSON_AddNumberToObject(item, "frees", alloc.frees);
+        cJSON_AddNumberToObject(item, "live_bytes", alloc.liveBytes);
+        cJSON_AddNumberToObject(item, "peak_bytes", alloc.peakBytes);
+        cJSON_AddItemToArray(allocs, item);
+    }
+
+    char*       jsonStr = cJSON_PrintUnformatted(root);
+    std::string payload(jsonStr);
+    cJSON_free(jsonStr);
+    cJSON_Delete(root);
     return payload;
 }
 
@@ -16,6 +16,7 @@
  * @license MIT
  */
 #pragma once
+#include "ResourceTypes.h"
 #include "connection_data_types.h"
 #include "sensor_data_types.h"
 #include <map>
@@ -128,6 +129,24 @@ class JsonParser {
     static std::string
     composeSensorunitStatusPayload(const std::string& status);
 
+    /**
+     * @brief Composes the /connect response to a Sensor Unit
+     *
+     * Example:
+     * {"status":"connected","upload_period_s":60,"upload_offset_s":15,
+     * "upload_window_s":5}
+     *
+     * The upload fields are left out when slot.periodS is 0, which is what
+     * older Control Units sent.
+     *
+     * @param status connected, pending or invalid
+     * @param slot Upload window of the unit
+     * @return std::string JSON payload to send to Sensor Unit
+     */
+    static std::string
+    composeSensorunitConnectPayload(const std::string& status,
+                                    const UploadSlot&  slot);
+
     /**
      * @brief Composes a JSON payload containing a Unix timestamp.
      *
@@ -138,6 +157,20 @@ class JsonParser {
      */
     static std::string composeTimestampPayload(time_t now);
 
+    /**
+     * @brief Composes the GET /resources payload from a ResourceMonitor sample
+     *
+     * Example: {"uptime_s":120,"heap":{"free":...,"min_free":...,
+     * "largest_block":...},"tasks":[{"name":"httpd","core":0,"priority":6,
+     * "stack":6144,"stack_min_free":3120}],"allocs":[{"name":"readings",
+     * "allocs":9,"frees":8,"live_bytes":4096,"peak_bytes":6144}]}
+     *
+     * @param snapshot Sample to compose
+     * @return JSON payload, sizes in bytes
+     */
+    static std::string
+    composeResourcesPayload(const ResourceSnapshot& snapshot);
+
     /**
      * @brief Composes a generic error response in JSON format. (Unused)
      * @param message Error message to include.
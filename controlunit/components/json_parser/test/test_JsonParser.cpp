@@ -287,6 +287,22 @@ when_connection_status_is_pending_then_composeSensorConnectResponse_serializes_s
                           json.find("\"connection_status\":\"pending\""));
 }
 
+extern "C" void
+when_slot_is_given_then_composeSensorunitConnectPayload_adds_upload_window(
+    void) {
+    UploadSlot slot{60, 15, 5};
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"status\":\"connected\",\"upload_period_s\":60,"
+        "\"upload_offset_s\":15,\"upload_window_s\":5}",
+        JsonParser::composeSensorunitConnectPayload("connected", slot)
+            .c_str());
+    // No window, the same payload as before windows existed
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"status\":\"pending\"}",
+        JsonParser::composeSensorunitConnectPayload("pending", UploadSlot{})
+            .c_str());
+}
+
 extern "C" void
 when_passing_message_to_composeErrorResponse_then_it_should_return_valid_json_string(
     void) {
@@ -305,4 +321,29 @@ when_passing_message_to_composeErrorResponse_then_it_should_return_valid_json_st
         "\"control_unit_id\":\"" + controlunit_uuid + "\"";
     TEST_ASSERT_NOT_EQUAL(std::string::npos,
                           result.find(expected_controlunit_uuid));
-}
\ No newline at end of file
+}
+extern "C" void
+when_resource_snapshot_is_given_then_composeResourcesPayload_returns_expected_json(
+    void) {
+    ResourceSnapshot snapshot;
+    snapshot.uptimeUs = 125'000'000;
+    snapshot.heap     = {180'000, 150'000, 90'000};
+    snapshot.tasks.push_back({"httpd", 0, 6, 6144, 3120});
+    snapshot.allocs.push_back({"readings", 9, 8, 4096, 6144});
+
+    std::string json = JsonParser::composeResourcesPayload(snapshot);
+
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, json.find("\"uptime_s\":125"));
+    TEST_ASSERT_NOT_EQUAL(
+        std::string::npos,
+        json.find("\"heap\":{\"free\":180000,\"min_free\":150000,"
+                  "\"largest_block\":90000}"));
+    TEST_ASSERT_NOT_EQUAL(
+        std::string::npos,
+        json.find("{\"name\":\"httpd\",\"core\":0,\"priority\":6,"
+                  "\"stack\":6144,\"stack_min_free\":3120}"));
+    TEST_ASSERT_NOT_EQUAL(
+        std::string::npos,
+        json.find("{\"name\":\"readings\",\"allocs\":9,\"frees\":8,"
+                  "\"live_bytes\":4096,\"peak_bytes\":6144}"));
+}
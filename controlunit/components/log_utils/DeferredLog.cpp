@@ -0,0 +1,166 @@
+/**
+ * @file DeferredLog.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the deferred log backend
+ *
+ * Items in the no-split ring buffer are whole lines, so the buffer keeps the
+ * length of every line and the drain task never sees half a line. A single
+ * NUL byte item tells the task to stop, it is queued behind every line
+ * logged before stop().
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "DeferredLog.h"
+#include "TaskProfile.h"
+#include <algorithm>
+#include <cstdio>
+
+/// The started backend, nullptr while none is
+static std::atomic<DeferredLog*> s_active{nullptr};
+/// Backend in use before start(), in-flight writes fall back to it
+static std::atomic<vprintf_like_t> s_previous{nullptr};
+/// Calls inside write(), stop() waits for them before the buffer goes
+static std::atomic<uint32_t> s_writers{0};
+
+static constexpr char STOP_ITEM = '\0';
+
+/// Calls a vprintf-like function with printf arguments
+static int callVprintf(vprintf_like_t function, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = function(format, args);
+    va_end(args);
+    return length;
+}
+
+DeferredLog::DeferredLog(size_t bufferBytes) : m_bufferBytes{bufferBytes} {}
+
+DeferredLog::~DeferredLog() {
+    stop();
+    if (m_stopped) {
+        vSemaphoreDelete(m_stopped);
+    }
+}
+
+esp_err_t DeferredLog::start() {
+    if (s_active.load() != nullptr || m_task != nullptr) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (m_stopped == nullptr) {
+        m_stopped = xSemaphoreCreateBinary();
+    }
+    m_ring = xRingbufferCreate(m_bufferBytes, RINGBUF_TYPE_NOSPLIT);
+    if (m_stopped == nullptr || m_ring == nullptr) {
+        ESP_LOGE(TAG, "Failed to create buffer");
+        return ESP_ERR_NO_MEM;
+    }
+    if (createTask(LOG_DRAIN_TASK, taskEntry, this, &m_task) != pdPASS) {
+        m_task = nullptr;
+        vRingbufferDelete(m_ring);
+        m_ring = nullptr;
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Logging through a %zu byte buffer", m_bufferBytes);
+    // m_previous and the buffer are set before write() can see this
+    m_previous = esp_log_set_vprintf(&DeferredLog::write);
+    s_previous.store(m_previous);
+    s_active.store(this);
+    return ESP_OK;
+}
+
+void DeferredLog::stop() {
+    if (m_task == nullptr) {
+        return;
+    }
+    esp_log_set_vprintf(m_previous);
+    s_active.store(nullptr);
+    // New lines go straight to m_previous, wait for the ones being buffered
+    while (s_writers.load() > 0) {
+        vTaskDelay(1);
+    }
+    xRingbufferSend(m_ring, &STOP_ITEM, 1, portMAX_DELAY);
+    xSemaphoreTake(m_stopped, portMAX_DELAY);
+    m_task = nullptr;
+    vRingbufferDelete(m_ring);
+    m_ring = nullptr;
+}
+
+DeferredLogStats DeferredLog::stats() const {
+    return {m_written.load(), m_dropped.load()};
+}
+
+int DeferredLog::write(const char* format, va_list args) {
+    s_writers.fetch_add(1);
+    DeferredLog* self = s_active.load();
+    if (self == nullptr) {
+        int length = s_previous.load()(format, args);
+        s_writers.fetch_sub(1);
+        return length;
+    }
+
+    char line[DEFERRED_LOG_LINE_BYTES];
+    int  length = std::vsnprintf(line, sizeof(line), format, args);
+    if (length > 0) {
+        size_t size = std::min(static_cast<size_t>(length), sizeof(line) - 1);
+        if (size < static_cast<size_t>(length)) {
+            line[size - 1] = '\n';
+        }
+        if (xRingbufferSend(self->m_ring, line, size, 0) != pdTRUE) {
+            self->m_dropped.fetch_add(1);
+        }
+    }
+    s_writers.fetch_sub(1);
+    return length;
+}
+
+void DeferredLog::taskEntry(void* arg) {
+    auto* self = static_cast<DeferredLog*>(arg);
+    self->run();
+    untrackTask();
+    xSemaphoreGive(self->m_stopped);
+    vTaskDelete(nullptr);
+}
+
+void DeferredLog::run() {
+    uint32_t reported = 0;
+    for (;;) {
+        size_t size = 0;
+        auto*  item = static_cast<char*>(
+            xRingbufferReceive(m_ring, &size, portMAX_DELAY));
+        if (item == nullptr) {
+            continue;
+        }
+        bool stopping = size == 1 && item[0] == STOP_ITEM;
+        if (!stopping) {
+            print(item, size);
+            m_written.fetch_add(1);
+        }
+        vRingbufferReturnItem(m_ring, item);
+
+        uint32_t dropped = m_dropped.load();
+        if (dropped != reported) {
+            char note[80];
+            int  length = std::snprintf(note,
+                                       sizeof(note),
+                                       "W (%" PRIu32 ") %s: %" PRIu32
+                                       " lines dropped\n",
+                                       esp_log_timestamp(),
+                                       TAG,
+                                       dropped - reported);
+            print(note, std::min(static_cast<size_t>(length), sizeof(note) - 1));
+            reported = dropped;
+        }
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void DeferredLog::print(const char* text, size_t length) const {
+    callVprintf(m_previous, "%.*s", static_cast<int>(length), text);
+}
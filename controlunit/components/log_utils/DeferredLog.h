@@ -0,0 +1,105 @@
+/**
+ * @file DeferredLog.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Log backend that takes the console write off the logging task
+ *
+ * Installed with esp_log_set_vprintf(). A task that logs formats the line
+ * into a ring buffer item and returns, the LogDrain task writes the items to
+ * the function that was installed before, normally vprintf to the UART. A
+ * line that does not fit is dropped and counted, logging never blocks.
+ *
+ * Lines still in the buffer are lost on a crash, use the panic output for
+ * those.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+/// Longer lines are cut, ending in a newline
+inline constexpr size_t DEFERRED_LOG_LINE_BYTES = 256;
+
+/**
+ * @brief Counters since start
+ */
+struct DeferredLogStats {
+    uint32_t written; /**< Lines written to the console */
+    uint32_t dropped; /**< Lines lost because the buffer was full */
+};
+
+/**
+ * @class DeferredLog
+ * @brief Ring buffer log backend, only one can be started at a time
+ */
+class DeferredLog {
+  public:
+    /**
+     * @param bufferBytes Ring buffer size, each line takes its length plus
+     * an 8 byte header
+     */
+    explicit DeferredLog(size_t bufferBytes = 8192);
+
+    /**
+     * @brief Stops the backend, see stop().
+     */
+    ~DeferredLog();
+
+    /**
+     * @brief Creates the buffer and the LogDrain task and installs the
+     * backend.
+     *
+     * @return ESP_OK, ESP_ERR_INVALID_STATE if a DeferredLog is already
+     * started, ESP_ERR_NO_MEM if the buffer or task could not be created.
+     */
+    esp_err_t start();
+
+    /**
+     * @brief Restores the previous backend and ends the task once every
+     * buffered line is written.
+     */
+    void stop();
+
+    DeferredLogStats stats() const;
+
+  private:
+    /**
+     * @brief The vprintf replacement, runs on the task that logs.
+     */
+    static int write(const char* format, va_list args);
+
+    static void taskEntry(void* arg);
+
+    /**
+     * @brief Drain loop, runs until stop() sends the empty item.
+     */
+    void run();
+
+    /**
+     * @brief Writes text through the previous backend.
+     */
+    void print(const char* text, size_t length) const;
+
+    size_t            m_bufferBytes;
+    RingbufHandle_t   m_ring     = nullptr;
+    vprintf_like_t    m_previous = nullptr; /**< Backend the lines go to */
+    TaskHandle_t      m_task     = nullptr;
+    SemaphoreHandle_t m_stopped  = nullptr; /**< Given when run() ends */
+
+    std::atomic<uint32_t> m_written{0};
+    std::atomic<uint32_t> m_dropped{0};
+
+    static constexpr const char* TAG = "DeferredLog";
+};
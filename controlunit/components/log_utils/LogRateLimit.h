@@ -0,0 +1,125 @@
+/**
+ * @file LogRateLimit.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Rate limited and sampled log macros for hot paths
+ *
+ * Every call site gets its own state, so one noisy line does not silence
+ * another. The state is lock free and the macros check LOG_LOCAL_LEVEL
+ * first, so a level compiled out costs nothing.
+ *
+ * - CU_LOGW_RATELIMITED(TAG, 10'000, "...") writes at most one line per
+ *   period and appends how many lines were suppressed in between
+ * - CU_LOGI_EVERY_N(TAG, 100, "...") writes the first of every n calls and
+ *   appends how many calls there have been
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_log.h"
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+
+/// Period for errors that repeat every tick while a link is down
+inline constexpr uint32_t LOG_RATE_LIMIT_MS = 10'000;
+
+/**
+ * @class LogRateLimiter
+ * @brief Lets one line through per period
+ */
+class LogRateLimiter {
+  public:
+    /**
+     * @param suppressed Set to the lines refused since the last one allowed
+     * @return true if a line may be written now
+     */
+    bool allow(uint32_t periodMs, uint32_t& suppressed) {
+        uint32_t now  = esp_log_timestamp();
+        uint32_t last = m_lastMs.load(std::memory_order_relaxed);
+        bool     due  = !m_logged.load(std::memory_order_relaxed) ||
+                   now - last >= periodMs;
+        if (!due || !m_lastMs.compare_exchange_strong(
+                        last, now, std::memory_order_relaxed)) {
+            m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_logged.store(true, std::memory_order_relaxed);
+        suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+  private:
+    std::atomic<uint32_t> m_lastMs{0};
+    std::atomic<bool>     m_logged{false};
+    std::atomic<uint32_t> m_suppressed{0};
+};
+
+/**
+ * @class LogSampler
+ * @brief Lets the first of every n calls through
+ */
+class LogSampler {
+  public:
+    /**
+     * @param calls Set to the calls so far, this one included
+     * @return true for call 1, n + 1, 2n + 1 ...
+     */
+    bool allow(uint32_t every, uint32_t& calls) {
+        uint32_t previous = m_calls.fetch_add(1, std::memory_order_relaxed);
+        calls             = previous + 1;
+        return every <= 1 || previous % every == 0;
+    }
+
+  private:
+    std::atomic<uint32_t> m_calls{0};
+};
+
+#define CU_LOG_RATELIMITED(level, tag, periodMs, format, ...)                  \
+    do {                                                                       \
+        if (LOG_LOCAL_LEVEL >= (level)) {                                      \
+            static LogRateLimiter cuLimiter_;                                  \
+            uint32_t              cuSuppressed_ = 0;                           \
+            if (cuLimiter_.allow((periodMs), cuSuppressed_)) {                 \
+                if (cuSuppressed_ > 0) {                                       \
+                    ESP_LOG_LEVEL((level),                                     \
+                                  tag,                                         \
+                                  format " (%" PRIu32 " suppressed)",          \
+                                  ##__VA_ARGS__,                               \
+                                  cuSuppressed_);                              \
+                } else {                                                       \
+                    ESP_LOG_LEVEL((level), tag, format, ##__VA_ARGS__);        \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+#define CU_LOG_EVERY_N(level, tag, every, format, ...)                         \
+    do {                                                                       \
+        if (LOG_LOCAL_LEVEL >= (level)) {                                      \
+            static LogSampler cuSampler_;                                      \
+            uint32_t          cuCalls_ = 0;                                    \
+            if (cuSampler_.allow((every), cuCalls_)) {                         \
+                ESP_LOG_LEVEL((level),                                         \
+                              tag,                                             \
+                              format " (%" PRIu32 " so far)",                  \
+                              ##__VA_ARGS__,                                   \
+                              cuCalls_);                                       \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+#define CU_LOGE_RATELIMITED(tag, periodMs, format, ...)                        \
+    CU_LOG_RATELIMITED(ESP_LOG_ERROR, tag, periodMs, format, ##__VA_ARGS__)
+#define CU_LOGW_RATELIMITED(tag, periodMs, format, ...)                        \
+    CU_LOG_RATELIMITED(ESP_LOG_WARN, tag, periodMs, format, ##__VA_ARGS__)
+#define CU_LOGI_RATELIMITED(tag, periodMs, format, ...)                        \
+    CU_LOG_RATELIMITED(ESP_LOG_INFO, tag, periodMs, format, ##__VA_ARGS__)
+
+#define CU_LOGW_EVERY_N(tag, every, format, ...)                               \
+    CU_LOG_EVERY_N(ESP_LOG_WARN, tag, every, format, ##__VA_ARGS__)
+#define CU_LOGI_EVERY_N(tag, every, format, ...)                               \
+    CU_LOG_EVERY_N(ESP_LOG_INFO, tag, every, format, ##__VA_ARGS__)
@@ -0,0 +1,10 @@
+# Compiles a component with the log level of one of the CONFIG_CU_LOG_LEVEL_*
+# options in Kconfig. Levels above it are left out of the binary, levels up to
+# it are still filtered at runtime by esp_log_level_set().
+#
+#   cu_log_level(CONFIG_CU_LOG_LEVEL_REST_SERVER)
+function(cu_log_level option)
+    if(DEFINED ${option})
+        target_compile_definitions(${COMPONENT_LIB} PRIVATE LOG_LOCAL_LEVEL=${${option}})
+    endif()
+endfunction()
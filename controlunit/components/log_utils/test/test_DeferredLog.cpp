@@ -0,0 +1,85 @@
+/**
+ * @brief Test file for DeferredLog.cpp
+ *
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "DeferredLog.h"
+#include <cstdio>
+#include <string>
+
+static constexpr const char* TAG        = "DeferredLogTest";
+static constexpr int         TEST_LINES = 200;
+
+/// Written by the drain task only while the backend is started
+static std::string s_console;
+static int         s_consoleLines = 0;
+
+static int captureVprintf(const char* format, va_list args) {
+    char line[DEFERRED_LOG_LINE_BYTES + 64];
+    int  length = std::vsnprintf(line, sizeof(line), format, args);
+    s_console += line;
+    ++s_consoleLines;
+    return length;
+}
+
+static uint32_t countLines() {
+    uint32_t count = 0;
+    for (size_t at = s_console.find(" line "); at != std::string::npos;
+         at        = s_console.find(" line ", at + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+extern "C" void when_lines_logged_then_deferred_log_writes_them_in_order(
+    void) {
+    s_console.clear();
+    s_consoleLines          = 0;
+    vprintf_like_t original = esp_log_set_vprintf(&captureVprintf);
+
+    {
+        // Small enough that a burst can overflow it
+        DeferredLog log(2048);
+        TEST_ASSERT_EQUAL(ESP_OK, log.start());
+        DeferredLog second(2048);
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, second.start());
+
+        for (int i = 0; i < TEST_LINES; ++i) {
+            ESP_LOGW(TAG, "line %03d", i);
+        }
+        log.stop();
+
+        DeferredLogStats stats = log.stats();
+        // Every line is either written or counted
+        TEST_ASSERT_EQUAL_UINT32(TEST_LINES, stats.written + stats.dropped);
+        TEST_ASSERT_EQUAL_UINT32(stats.written, countLines());
+        if (stats.dropped > 0) {
+            TEST_ASSERT_TRUE(s_console.find("lines dropped") !=
+                             std::string::npos);
+        }
+    }
+
+    // Lines that made it are in the order they were logged
+    size_t previous = 0;
+    int    last     = -1;
+    for (int i = 0; i < TEST_LINES; ++i) {
+        char text[16];
+        std::snprintf(text, sizeof(text), "line %03d", i);
+        size_t at = s_console.find(text);
+        if (at != std::string::npos) {
+            TEST_ASSERT_TRUE(last < 0 || at > previous);
+            previous = at;
+            last     = i;
+        }
+    }
+    TEST_ASSERT_TRUE(last >= 0);
+
+    // Stopped, lines go straight to the original backend again
+    int lines = s_consoleLines;
+    ESP_LOGW(TAG, "after stop");
+    TEST_ASSERT_EQUAL(lines + 1, s_consoleLines);
+    esp_log_set_vprintf(original);
+}
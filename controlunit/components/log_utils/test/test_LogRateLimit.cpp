@@ -0,0 +1,37 @@
+/**
+ * @brief Test file for LogRateLimit.h
+ *
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "LogRateLimit.h"
+
+extern "C" void when_lines_repeat_then_limiter_and_sampler_count_them(void) {
+    LogRateLimiter limiter;
+    uint32_t       suppressed = 99;
+    TEST_ASSERT_TRUE(limiter.allow(60'000, suppressed));
+    TEST_ASSERT_EQUAL_UINT32(0, suppressed);
+    for (int i = 0; i < 3; ++i) {
+        TEST_ASSERT_FALSE(limiter.allow(60'000, suppressed));
+    }
+    // A zero period is always due, the refused lines are handed over once
+    TEST_ASSERT_TRUE(limiter.allow(0, suppressed));
+    TEST_ASSERT_EQUAL_UINT32(3, suppressed);
+    TEST_ASSERT_TRUE(limiter.allow(0, suppressed));
+    TEST_ASSERT_EQUAL_UINT32(0, suppressed);
+
+    LogSampler sampler;
+    uint32_t   calls   = 0;
+    bool       allowed[5];
+    for (bool& allow : allowed) {
+        allow = sampler.allow(3, calls);
+    }
+    TEST_ASSERT_TRUE(allowed[0]);
+    TEST_ASSERT_FALSE(allowed[1]);
+    TEST_ASSERT_FALSE(allowed[2]);
+    TEST_ASSERT_TRUE(allowed[3]);
+    TEST_ASSERT_FALSE(allowed[4]);
+    TEST_ASSERT_EQUAL_UINT32(5, calls);
+}
@@ -0,0 +1,211 @@
+/**
+ * @file Metrics.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the metric types and the Prometheus exposition
+ *
+ * Metrics are pushed onto the list with a compare and swap, so they can be
+ * created from any task while /metrics is being served.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "Metrics.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+/// Constant initialized, so it is valid before any metric is constructed
+static std::atomic<const Metric*> s_first{nullptr};
+
+Metric::Metric(const char* name,
+               const char* help,
+               MetricType  type,
+               const char* labels)
+    : m_name{name}, m_help{help}, m_labels{labels}, m_type{type} {}
+
+void Metric::link() {
+    const Metric* head = s_first.load(std::memory_order_relaxed);
+    do {
+        m_next = head;
+    } while (!s_first.compare_exchange_weak(
+        head, this, std::memory_order_release, std::memory_order_relaxed));
+}
+
+const Metric* Metric::first() {
+    return s_first.load(std::memory_order_acquire);
+}
+
+Counter::Counter(const char* name, const char* help, const char* labels)
+    : Metric{name, help, MetricType::Counter, labels} {
+    link();
+}
+
+Gauge::Gauge(const char* name, const char* help, const char* labels)
+    : Metric{name, help, MetricType::Gauge, labels} {
+    link();
+}
+
+Gauge::Gauge(const char* name,
+             const char* help,
+             double      scale,
+             const char* labels)
+    : Metric{name, help, MetricType::Gauge, labels}, m_scale{scale} {
+    link();
+}
+
+Histogram::Histogram(const char*     name,
+                     const char*     help,
+                     const uint32_t* bounds,
+                     size_t          boundCount,
+                     double          scale,
+                     const char*     labels)
+    : Metric{name, help, MetricType::Histogram, labels}, m_bounds{bounds},
+      m_boundCount{boundCount < MAX_HISTOGRAM_BUCKETS ? boundCount
+                                                      : MAX_HISTOGRAM_BUCKETS},
+      m_scale{scale} {
+    link();
+}
+
+uint32_t Histogram::count() const {
+    uint32_t total = 0;
+    for (size_t i = 0; i <= m_boundCount; ++i) {
+        total += bucketCount(i);
+    }
+    return total;
+}
+
+/// Appends printf style output to out
+template <typename... Args>
+static void appendf(std::string& out, const char* format, Args... args) {
+    char   line[160];
+    int    length = std::snprintf(line, sizeof(line), format, args...);
+    size_t used =
+        length < 0 ? 0
+                   : (static_cast<size_t>(length) < sizeof(line)
+                          ? static_cast<size_t>(length)
+                          : sizeof(line) - 1);
+    out.append(line, used);
+}
+
+/// Writes name, the labels and an optional extra label, e.g. le="+Inf"
+static void appendSeries(std::string& out,
+                         const Metric& metric,
+                         const char*   suffix,
+                         const char*   extra = nullptr) {
+    out += metric.name();
+    out += suffix;
+    bool hasLabels = metric.labels() && metric.labels()[0] != '\0';
+    if (hasLabels || extra) {
+        out += '{';
+        if (hasLabels) {
+            out += metric.labels();
+        }
+        if (extra) {
+            if (hasLabels) {
+                out += ',';
+            }
+            out += extra;
+        }
+        out += '}';
+    }
+    out += ' ';
+}
+
+/// Integer values stay integers, scaled ones are printed as decimals
+static void appendValue(std::string& out, uint64_t value, double scale) {
+    if (scale == 1.0) {
+        appendf(out, "%" PRIu64 "\n", value);
+    } else {
+        appendf(out, "%.9g\n", static_cast<double>(value) * scale);
+    }
+}
+
+static void writeHistogram(std::string& out, const Histogram& histogram) {
+    uint32_t cumulative = 0;
+    char     le[40];
+    for (size_t i = 0; i < histogram.boundCount(); ++i) {
+        cumulative += histogram.bucketCount(i);
+        std::snprintf(le,
+                      sizeof(le),
+                      "le=\"%.9g\"",
+                      histogram.bound(i) * histogram.scale());
+        appendSeries(out, histogram, "_bucket", le);
+        appendValue(out, cumulative, 1.0);
+    }
+    cumulative += histogram.bucketCount(histogram.boundCount());
+    appendSeries(out, histogram, "_bucket", "le=\"+Inf\"");
+    appendValue(out, cumulative, 1.0);
+    appendSeries(out, histogram, "_sum");
+    appendValue(out, histogram.sum(), histogram.scale());
+    appendSeries(out, histogram, "_count");
+    appendValue(out, cumulative, 1.0);
+}
+
+static void writeSamples(std::string& out, const Metric& metric) {
+    switch (metric.type()) {
+    case MetricType::Counter:
+        appendSeries(out, metric, "");
+        appendValue(out, static_cast<const Counter&>(metric).value(), 1.0);
+        break;
+    case MetricType::Gauge: {
+        const Gauge& gauge = static_cast<const Gauge&>(metric);
+        appendSeries(out, metric, "");
+        if (gauge.scale() == 1.0) {
+            appendf(out, "%" PRId32 "\n", gauge.value());
+        } else {
+            appendf(out, "%.9g\n", gauge.value() * gauge.scale());
+        }
+        break;
+    }
+    case MetricType::Histogram:
+        writeHistogram(out, static_cast<const Histogram&>(metric));
+        break;
+    }
+}
+
+static const char* typeName(MetricType type) {
+    switch (type) {
+    case MetricType::Counter:
+        return "counter";
+    case MetricType::Gauge:
+        return "gauge";
+    case MetricType::Histogram:
+        return "histogram";
+    }
+    return "untyped";
+}
+
+void writePrometheus(std::string& out) {
+    const Metric* first = Metric::first();
+    for (const Metric* metric = first; metric; metric = metric->next()) {
+        // A family is written when its first member comes up
+        bool written = false;
+        for (const Metric* earlier = first; earlier != metric;
+             earlier               = earlier->next()) {
+            if (std::strcmp(earlier->name(), metric->name()) == 0) {
+                written = true;
+                break;
+            }
+        }
+        if (written) {
+            continue;
+        }
+        out += "# HELP ";
+        out += metric->name();
+        out += ' ';
+        out += metric->help();
+        out += "\n# TYPE ";
+        out += metric->name();
+        out += ' ';
+        out += typeName(metric->type());
+        out += '\n';
+        for (const Metric* member = metric; member; member = member->next()) {
+            if (std::strcmp(member->name(), metric->name()) == 0) {
+                writeSamples(out, *member);
+            }
+        }
+    }
+}
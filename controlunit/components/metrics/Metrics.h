@@ -0,0 +1,210 @@
+/**
+ * @file Metrics.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Counters, gauges and fixed-bucket histograms served as Prometheus
+ * text on GET /metrics
+ *
+ * A component declares its metrics with static storage and updates them
+ * where things happen. Every metric links itself into a global list when it
+ * is constructed and is never removed, writePrometheus() walks the list.
+ *
+ * Updates are one relaxed atomic add per value, histograms add a scan over at
+ * most MAX_HISTOGRAM_BUCKETS bounds, so they are cheap enough for the ingest
+ * path and safe from any task. Values are 32 bits wide like the other
+ * counters in the Control Unit. A counter that wraps looks like a restart to
+ * Prometheus, which rate() already handles.
+ *
+ * Histogram sums are 64 bits. A sum of microseconds would wrap after 71
+ * minutes while _count and _bucket go on, and rate(_sum) / rate(_count)
+ * would give wrong averages. On the ESP32 the 64 bit add is not lock free,
+ * ESP-IDF makes it a short critical section.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "Metric updates rely on lock free 32 bit atomics");
+
+/// Histogram bounds, the +Inf bucket comes on top
+inline constexpr size_t MAX_HISTOGRAM_BUCKETS = 12;
+
+/// Scale for histograms observed in microseconds and exported in seconds
+inline constexpr double MICROS_TO_SECONDS = 1e-6;
+
+/// Scale for gauges set in milliseconds and exported in seconds
+inline constexpr double MILLIS_TO_SECONDS = 1e-3;
+
+enum class MetricType : uint8_t { Counter, Gauge, Histogram };
+
+/**
+ * @class Metric
+ * @brief Name, help and labels of a metric and its link in the global list
+ */
+class Metric {
+  public:
+    Metric(const Metric&)            = delete;
+    Metric& operator=(const Metric&) = delete;
+
+    const char* name() const { return m_name; }
+    const char* help() const { return m_help; }
+    /** Label pairs without braces, e.g. `path="/time"`, or nullptr */
+    const char* labels() const { return m_labels; }
+    MetricType  type() const { return m_type; }
+
+    /** First registered metric, nullptr if there are none */
+    static const Metric* first();
+    const Metric*        next() const { return m_next; }
+
+  protected:
+    /**
+     * @param name Metric name, the same name with other labels is exported
+     * as one family
+     * @param help One line description
+     * @param labels Label pairs without braces or nullptr
+     *
+     * All strings must outlive the metric.
+     */
+    Metric(const char* name,
+           const char* help,
+           MetricType  type,
+           const char* labels);
+    ~Metric() = default;
+
+    /**
+     * @brief Makes the metric visible to writePrometheus(). Called last in
+     * the constructor of every metric type, so readers never see a
+     * half-constructed metric.
+     */
+    void link();
+
+  private:
+    const char*   m_name;
+    const char*   m_help;
+    const char*   m_labels;
+    MetricType    m_type;
+    const Metric* m_next = nullptr;
+};
+
+/**
+ * @class Counter
+ * @brief Value that only goes up
+ */
+class Counter : public Metric {
+  public:
+    Counter(const char* name, const char* help, const char* labels = nullptr);
+
+    void add(uint32_t amount = 1) {
+        m_value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    uint32_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<uint32_t> m_value{0};
+};
+
+/**
+ * @class Gauge
+ * @brief Value that goes up and down, like a queue depth
+ */
+class Gauge : public Metric {
+  public:
+    Gauge(const char* name, const char* help, const char* labels = nullptr);
+    /**
+     * @param scale Factor applied to the value when exported, e.g.
+     * MILLIS_TO_SECONDS
+     */
+    Gauge(const char* name,
+          const char* help,
+          double      scale,
+          const char* labels = nullptr);
+
+    void set(int32_t value) {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+    void add(int32_t amount) {
+        m_value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    int32_t value() const { return m_value.load(std::memory_order_relaxed); }
+    double  scale() const { return m_scale; }
+
+  private:
+    double               m_scale = 1.0;
+    std::atomic<int32_t> m_value{0};
+};
+
+/**
+ * @class Histogram
+ * @brief Counts observations into fixed buckets
+ *
+ * Each observation lands in the first bucket whose upper bound is at least
+ * the value. Buckets are stored per bound and made cumulative when exported.
+ */
+class Histogram : public Metric {
+  public:
+    /**
+     * @param bounds Upper bounds in increasing order, at most
+     * MAX_HISTOGRAM_BUCKETS, must outlive the histogram
+     * @param scale Factor applied to bounds and sum when exported, e.g.
+     * MICROS_TO_SECONDS
+     */
+    template <size_t N>
+    Histogram(const char* name,
+              const char* help,
+              const uint32_t (&bounds)[N],
+              double      scale  = 1.0,
+              const char* labels = nullptr)
+        : Histogram(name, help, bounds, N, scale, labels) {
+        static_assert(N <= MAX_HISTOGRAM_BUCKETS, "Too many buckets");
+    }
+
+    Histogram(const char*     name,
+              const char*     help,
+              const uint32_t* bounds,
+              size_t          boundCount,
+              double          scale  = 1.0,
+              const char*     labels = nullptr);
+
+    void observe(uint32_t value) {
+        size_t bucket = 0;
+        while (bucket < m_boundCount && value > m_bounds[bucket]) {
+            ++bucket;
+        }
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    size_t   boundCount() const { return m_boundCount; }
+    uint32_t bound(size_t index) const { return m_bounds[index]; }
+    double   scale() const { return m_scale; }
+
+    /** Observations in bucket index alone, index boundCount() is +Inf */
+    uint32_t bucketCount(size_t index) const {
+        return m_buckets[index].load(std::memory_order_relaxed);
+    }
+    /** All observations, the sum of every bucket */
+    uint32_t count() const;
+    uint64_t sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+  private:
+    const uint32_t*       m_bounds;
+    size_t                m_boundCount;
+    double                m_scale;
+    std::atomic<uint32_t> m_buckets[MAX_HISTOGRAM_BUCKETS + 1] = {};
+    std::atomic<uint64_t> m_sum{0};
+};
+
+/**
+ * @brief Appends every registered metric in the Prometheus text format 0.0.4
+ *
+ * Metrics sharing a name are written as one family under one HELP and TYPE.
+ */
+void writePrometheus(std::string& out);
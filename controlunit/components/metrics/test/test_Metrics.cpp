@@ -0,0 +1,111 @@
+/**
+ * @brief Test file for Metrics.cpp
+ *
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "Metrics.h"
+#include <string>
+
+static constexpr uint32_t TEST_BOUNDS_US[] = {1'000, 10'000};
+
+static Counter   s_testRequests{"test_requests_total",
+                              "Test requests",
+                              "path=\"/a\""};
+static Counter   s_testRequestsB{"test_requests_total",
+                               "Test requests",
+                               "path=\"/b\""};
+static Gauge     s_testDepth{"test_depth", "Test depth"};
+static Gauge     s_testInterval{"test_interval_seconds",
+                            "Test interval",
+                            MILLIS_TO_SECONDS};
+static Histogram s_testDuration{"test_duration_seconds",
+                                "Test duration",
+                                TEST_BOUNDS_US,
+                                MICROS_TO_SECONDS};
+
+static Histogram s_testLongDuration{"test_long_duration_seconds",
+                                    "Test duration summed past 32 bits",
+                                    TEST_BOUNDS_US,
+                                    MICROS_TO_SECONDS};
+
+static bool contains(const std::string& text, const char* part) {
+    return text.find(part) != std::string::npos;
+}
+
+extern "C" void when_values_observed_then_histogram_buckets_them_by_bound(
+    void) {
+    uint32_t before[3];
+    for (size_t i = 0; i < 3; ++i) {
+        before[i] = s_testDuration.bucketCount(i);
+    }
+    uint64_t sumBefore = s_testDuration.sum();
+
+    s_testDuration.observe(500);
+    s_testDuration.observe(1'000); // Bounds are inclusive
+    s_testDuration.observe(5'000);
+    s_testDuration.observe(50'000);
+
+    TEST_ASSERT_EQUAL_UINT32(before[0] + 2, s_testDuration.bucketCount(0));
+    TEST_ASSERT_EQUAL_UINT32(before[1] + 1, s_testDuration.bucketCount(1));
+    TEST_ASSERT_EQUAL_UINT32(before[2] + 1, s_testDuration.bucketCount(2));
+    TEST_ASSERT_EQUAL_UINT64(sumBefore + 56'500, s_testDuration.sum());
+
+    s_testDepth.set(3);
+    s_testDepth.add(-1);
+    TEST_ASSERT_EQUAL(2, s_testDepth.value());
+}
+
+extern "C" void when_sum_passes_32_bits_then_histogram_sum_keeps_counting(
+    void) {
+    // 4295 s of uploads in microseconds, then a bit more
+    s_testLongDuration.observe(UINT32_MAX);
+    s_testLongDuration.observe(UINT32_MAX);
+    s_testLongDuration.observe(2);
+    TEST_ASSERT_EQUAL_UINT64(uint64_t{1} << 33, s_testLongDuration.sum());
+    TEST_ASSERT_EQUAL_UINT32(3, s_testLongDuration.count());
+
+    std::string out;
+    writePrometheus(out);
+    TEST_ASSERT_TRUE(
+        contains(out, "test_long_duration_seconds_sum 8589.93459\n"));
+}
+
+extern "C" void when_metrics_written_then_output_is_prometheus_text(void) {
+    uint32_t requests = s_testRequests.value();
+    s_testRequests.add();
+    s_testRequestsB.add(2);
+    s_testDepth.set(-4);
+    s_testInterval.set(1500);
+
+    std::string out;
+    writePrometheus(out);
+
+    // One family for both series, under a single HELP and TYPE
+    size_t help = out.find("# HELP test_requests_total Test requests\n");
+    TEST_ASSERT_TRUE(help != std::string::npos);
+    TEST_ASSERT_EQUAL(std::string::npos,
+                      out.find("# HELP test_requests_total", help + 1));
+    TEST_ASSERT_TRUE(contains(out, "# TYPE test_requests_total counter\n"));
+    std::string lineA = "test_requests_total{path=\"/a\"} " +
+                        std::to_string(requests + 1) + "\n";
+    TEST_ASSERT_TRUE(contains(out, lineA.c_str()));
+    TEST_ASSERT_TRUE(contains(out, "test_requests_total{path=\"/b\"} "));
+
+    TEST_ASSERT_TRUE(contains(out, "# TYPE test_depth gauge\ntest_depth -4\n"));
+    // Scaled gauges are exported in the unit of their name
+    TEST_ASSERT_TRUE(contains(out, "test_interval_seconds 1.5\n"));
+
+    // Bounds in seconds, buckets cumulative, +Inf equals _count
+    TEST_ASSERT_TRUE(contains(out, "# TYPE test_duration_seconds histogram\n"));
+    TEST_ASSERT_TRUE(contains(out, "test_duration_seconds_bucket{le=\"0.001\"} "));
+    TEST_ASSERT_TRUE(contains(out, "test_duration_seconds_bucket{le=\"0.01\"} "));
+    std::string count = std::to_string(s_testDuration.count()) + "\n";
+    TEST_ASSERT_TRUE(contains(
+        out, ("test_duration_seconds_bucket{le=\"+Inf\"} " + count).c_str()));
+    TEST_ASSERT_TRUE(
+        contains(out, ("test_duration_seconds_count " + count).c_str()));
+    TEST_ASSERT_TRUE(contains(out, "test_duration_seconds_sum "));
+}
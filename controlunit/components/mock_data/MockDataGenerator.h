@@ -1,7 +1,7 @@
 /**
  * @file MockDataGenerator.h
  * @author Erik Dahl (erik@iunderlandet.se)
- * @brief Class for creating a task that generates MockData 
+ * @brief Class for scheduling a job that generates MockData 
  * simulating Sensor readings from a Sensor Unit 
  * @date 2025-10-03
  *
@@ -10,62 +10,30 @@
  */
 #pragma once
 #include "ControlUnitManager.h"
-#include "RestClient.h"
+#include "JobScheduler.h"
 #include "esp_log.h"
-#include "esp_timer.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include <memory>
 
 /**
- * @brief Trigger for Generating Mock Values
+ * @brief Periodic JobScheduler job that generates Mock Values and adds them
+ * to ControlUnitManager
  *
  */
-class MockDataGeneratorTrigger {
+class MockDataGenerator {
   public:
-    MockDataGeneratorTrigger(TaskHandle_t target_task, uint64_t interval_us);
+    MockDataGenerator(JobScheduler&       scheduler,
+                      ControlUnitManager& manager,
+                      uint64_t            interval_us);
     esp_err_t start();
     void      stop();
 
   private:
-    static void timerCallback(void* arg);
-
-    TaskHandle_t       m_taskHandle;
-    uint64_t           m_interval;
-    esp_timer_handle_t m_timer;
-
-    static constexpr const char* TAG = "MockDataGeneratorTrigger";
-};
-
-/**
- * @brief Task that Generates Mock Values and add them to ControlUnitManager
- *
- */
-class MockDataGeneratorTask {
-  public:
-    explicit MockDataGeneratorTask(ControlUnitManager& manager);
-    void         start();
-    TaskHandle_t getHandle() const;
-
-  private:
-    static void taskEntry(void* pvParameters);
-    void        run();
+    static void run(void* arg);
+    void        generate();
 
+    JobScheduler&       m_scheduler;
     ControlUnitManager& m_manager;
-    TaskHandle_t        m_taskHandle;
+    uint64_t            m_interval;
+    JobId               m_jobId;
 
-    static constexpr const char* TAG = "MockDataGeneratorTask";
+    static constexpr const char* TAG = "MockDataGenerator";
 };
-
-class MockDataGenerator {
-  public:
-    MockDataGenerator(ControlUnitManager& manager, uint64_t interval_us);
-    esp_err_t start();
-    void      stop();
-
-  private:
-    ControlUnitManager&                     m_manager;
-    std::unique_ptr<MockDataGeneratorTask>  m_task;
-    std::unique_ptr<MockDataGeneratorTrigger> m_trigger;
-    uint64_t                                m_interval;
-};
\ No newline at end of file
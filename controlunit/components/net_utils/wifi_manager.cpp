@@ -161,7 +161,7 @@ void init_wifi() {
     std::string ap_ssid     = CONTROL_UNIT_SSID;
     std::string ap_password = CONTROL_UNIT_PASSWORD;
 
-    ap_config.ap.max_connection  = 4;
+    ap_config.ap.max_connection  = AP_MAX_CONNECTIONS;
     ap_config.ap.beacon_interval = 100; // maybe not needed
     ap_config.ap.channel =
         6; // 1, 6 and 9 good for Arduino. But maybe not needed.
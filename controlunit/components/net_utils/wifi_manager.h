@@ -18,6 +18,10 @@
  * @license MIT
  */
 #pragma once
+#include <cstdint>
+
+/// Stations the AP takes at once, sensor units share it through upload windows
+constexpr uint8_t AP_MAX_CONNECTIONS = 4;
 
 /**
  * @brief Initializes the ESP32 Wi-Fi stack in dual-mode (Access Point + Station).
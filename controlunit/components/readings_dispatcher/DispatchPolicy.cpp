@@ -0,0 +1,74 @@
+/**
+ * @file DispatchPolicy.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the adaptive dispatch policy
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "DispatchPolicy.h"
+#include "esp_system.h"
+#include <algorithm>
+
+DispatchPolicy::DispatchPolicy(const DispatchPolicyConfig& config,
+                               RandomFn                    random)
+    : m_config{config}, m_random{random ? random : esp_random} {
+    m_config.minIntervalUs =
+        std::min(m_config.minIntervalUs, m_config.baseIntervalUs);
+    m_config.maxIntervalUs =
+        std::max(m_config.maxIntervalUs, m_config.baseIntervalUs);
+    m_intervalUs = m_config.baseIntervalUs;
+}
+
+bool DispatchPolicy::shouldDispatch(uint64_t nowUs, size_t backlog) const {
+    if (backlog == 0) {
+        return false;
+    }
+    if (!m_posted) {
+        return backlog >= m_config.backlogThreshold ||
+               nowUs >= m_intervalUs;
+    }
+    uint64_t elapsed = nowUs - m_lastPostUs;
+    if (elapsed >= m_intervalUs) {
+        return true;
+    }
+    return m_failures == 0 && backlog >= m_config.backlogThreshold &&
+           elapsed >= m_config.minIntervalUs;
+}
+
+void DispatchPolicy::onSuccess(uint64_t nowUs,
+                               uint64_t latencyUs,
+                               size_t   backlogLeft) {
+    m_posted     = true;
+    m_lastPostUs = nowUs;
+    m_failures   = 0;
+    if (backlogLeft >= m_config.backlogThreshold) {
+        // Catching up, but never faster than the backend answers
+        m_intervalUs = std::clamp(
+            latencyUs, m_config.minIntervalUs, m_config.baseIntervalUs);
+    } else {
+        m_intervalUs = m_config.baseIntervalUs;
+    }
+}
+
+void DispatchPolicy::onFailure(uint64_t nowUs) {
+    m_posted     = true;
+    m_lastPostUs = nowUs;
+    if (m_failures < 32) {
+        ++m_failures;
+    }
+    // base * 2^failures, stops doubling once it reaches max
+    uint64_t backoff = m_config.baseIntervalUs;
+    for (uint32_t i = 0; i < m_failures && backoff < m_config.maxIntervalUs;
+         ++i) {
+        backoff *= 2;
+    }
+    backoff = std::min(backoff, m_config.maxIntervalUs);
+    // Equal jitter, half fixed and half random, so Control Units that lost
+    // the backend at the same time do not come back at the same time
+    uint64_t half = backoff / 2;
+    m_intervalUs  = half + m_random() % (half + 1);
+}
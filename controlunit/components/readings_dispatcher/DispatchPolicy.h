@@ -0,0 +1,101 @@
+/**
+ * @file DispatchPolicy.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Decides when ReadingDispatchJob posts readings in adaptive mode
+ *
+ * The policy is plain logic with no FreeRTOS or timer calls, the job asks
+ * it on every check tick and reports the result of every post back:
+ *
+ * - Nothing is posted while the backlog is empty
+ * - Readings are posted when the current interval has passed since the last
+ *   post, or right away when the backlog reaches the threshold
+ * - After a failed post the interval doubles per failure, with jitter,
+ *   up to the max interval. The threshold is ignored while backing off
+ * - After a post that leaves a backlog above the threshold, the next post
+ *   waits at least as long as the backend took to answer
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Settings for the adaptive dispatch mode, all times in microseconds
+ */
+struct DispatchPolicyConfig {
+    uint64_t baseIntervalUs = 30'000'000;  /**< Interval when all is well */
+    uint64_t minIntervalUs  = 2'000'000;   /**< Shortest time between posts */
+    uint64_t maxIntervalUs  = 300'000'000; /**< Longest backoff */
+    uint64_t checkIntervalUs  = 1'000'000; /**< How often the job checks */
+    size_t   backlogThreshold = 200; /**< Readings that trigger a post */
+};
+
+/**
+ * @class DispatchPolicy
+ * @brief Adaptive interval with backlog threshold and exponential backoff
+ */
+class DispatchPolicy {
+  public:
+    using RandomFn = uint32_t (*)();
+
+    /**
+     * @brief Constructs the policy, min and max are clamped around base
+     *
+     * @param config Intervals and threshold
+     * @param random Source for the backoff jitter, esp_random by default
+     */
+    explicit DispatchPolicy(const DispatchPolicyConfig& config,
+                            RandomFn                    random = nullptr);
+
+    /**
+     * @brief Returns true if the job should post now
+     *
+     * @param nowUs Current time, e.g. esp_timer_get_time()
+     * @param backlog Number of readings waiting to be posted
+     */
+    bool shouldDispatch(uint64_t nowUs, size_t backlog) const;
+
+    /**
+     * @brief Reports a post the backend saved readings from
+     *
+     * @param nowUs Time the post finished
+     * @param latencyUs Time the post took
+     * @param backlogLeft Readings still waiting after clearing the saved ones
+     */
+    void onSuccess(uint64_t nowUs, uint64_t latencyUs, size_t backlogLeft);
+
+    /**
+     * @brief Reports a post that failed or saved nothing, backs off
+     *
+     * @param nowUs Time the post finished
+     */
+    void onFailure(uint64_t nowUs);
+
+    /**
+     * @brief Interval until the next post, in microseconds
+     */
+    uint64_t currentIntervalUs() const { return m_intervalUs; }
+
+    /**
+     * @brief Number of failed posts in a row
+     */
+    uint32_t consecutiveFailures() const { return m_failures; }
+
+    /**
+     * @brief The settings after clamping
+     */
+    const DispatchPolicyConfig& config() const { return m_config; }
+
+  private:
+    DispatchPolicyConfig m_config;
+    RandomFn             m_random;
+    uint64_t             m_intervalUs;
+    uint64_t             m_lastPostUs = 0;
+    uint32_t             m_failures   = 0;
+    bool                 m_posted     = false; /**< false until first post */
+};
@@ -6,17 +6,19 @@
  * This file contains the implementation of the classes declared in
  * ReadingsDispatcher.h:
  *
- * - `ReadingsDispatcher` sets up and coordinates the task and timer trigger.
- * - `ReadingDispatchTask` defines the FreeRTOS task that collects sensor data
- * and sends it via HTTP.
- * - `ReadingDispatchTrigger` manages the periodic timer that notifies the task.
+ * - `ReadingsDispatcher` sets up and coordinates the job and timer trigger.
+ * - `ReadingDispatchJob` collects sensor data for the BackendIoTask to send
+ * via HTTP and handles the response.
+ * - `ReadingDispatchTrigger` manages the periodic scheduler job that submits
+ * the job.
  *
  * The system is designed to periodically gather grouped sensor readings from
  * the ControlUnitManager, format them into JSON, and transmit them to a remote
- * endpoint using the RestClient.
+ * endpoint through the BackendIoTask.
  *
  * Usage typically involves instantiating a `ReadingsDispatcher`, calling
- * `start()`, and optionally `stop()`
+ * `start()`, and optionally `stop()`. Passing a `DispatchPolicyConfig` instead
+ * of an interval selects the adaptive mode.
  *
  * @date 2025-10-07
  *
@@ -25,100 +27,207 @@
  *
  */
 #include "ReadingsDispatcher.h"
+#include "LogRateLimit.h"
 #include "JsonParser.h"
-
-ReadingsDispatcher::ReadingsDispatcher(RestClient&         client,
+#include "Metrics.h"
+
+/// Backend round trip of a readings post, a slow link takes seconds
+static constexpr uint32_t UPLOAD_BOUNDS_US[] = {
+    10'000, 25'000, 50'000, 100'000, 250'000, 500'000, 1'000'000,
+    2'500'000, 5'000'000, 10'000'000, 30'000'000};
+
+static Counter   s_uploadPosts{"cu_upload_posts_total",
+                             "Readings posts completed, failed ones included"};
+static Counter   s_uploadFailures{"cu_upload_failures_total",
+                                "Readings posts the backend did not save"};
+static Counter   s_readingsUploaded{"cu_readings_uploaded_total",
+                                  "Readings the backend reported as saved"};
+static Histogram s_uploadDuration{"cu_upload_duration_seconds",
+                                  "Round trip of a readings post",
+                                  UPLOAD_BOUNDS_US,
+                                  MICROS_TO_SECONDS};
+static Gauge     s_dispatchInterval{"cu_dispatch_interval_seconds",
+                                "Current time between readings posts",
+                                MILLIS_TO_SECONDS};
+
+ReadingsDispatcher::ReadingsDispatcher(BackendIoTask&      io,
+                                       JobScheduler&       scheduler,
                                        ControlUnitManager& manager,
                                        uint64_t            interval_us)
-    : m_client{client}, m_manager{manager}, m_interval{interval_us} {}
+    : m_io{io}, m_scheduler{scheduler}, m_manager{manager},
+      m_interval{interval_us} {}
+
+ReadingsDispatcher::ReadingsDispatcher(BackendIoTask&              io,
+                                       JobScheduler&               scheduler,
+                                       ControlUnitManager&         manager,
+                                       const DispatchPolicyConfig& policy)
+    : m_io{io}, m_scheduler{scheduler}, m_manager{manager},
+      m_interval{policy.checkIntervalUs}, m_policyConfig{policy} {}
 
 esp_err_t ReadingsDispatcher::start() {
-    m_task = std::make_unique<ReadingDispatchTask>(m_client, m_manager);
-    m_task->start();
+    if (m_policyConfig) {
+        m_job = std::make_unique<ReadingDispatchJob>(
+            m_io, m_manager, *m_policyConfig);
+    } else {
+        m_job = std::make_unique<ReadingDispatchJob>(m_io, m_manager);
+        s_dispatchInterval.set(static_cast<int32_t>(m_interval / 1000));
+    }
 
-    TaskHandle_t handle = m_task->getHandle();
-    m_trigger = std::make_unique<ReadingDispatchTrigger>(handle, m_interval);
+    m_trigger = std::make_unique<ReadingDispatchTrigger>(
+        m_scheduler, *m_job, m_interval);
     return m_trigger->start();
 }
 
 void ReadingsDispatcher::stop() {
     if (m_trigger)
         m_trigger->stop();
-    // Task not stopped immediately. Can be added if necessary
+    // A submitted job still runs, stop the BackendIoTask to cancel it
 }
 
-ReadingDispatchTask::ReadingDispatchTask(RestClient&         client,
-                                         ControlUnitManager& manager)
-    : m_httpClient{client}, m_manager{manager}, m_taskHandle{nullptr} {}
+DispatchMetrics ReadingsDispatcher::metrics() const {
+    if (!m_job) {
+        return {};
+    }
+    return m_job->metrics(m_interval);
+}
 
-void ReadingDispatchTask::start() {
-    ESP_LOGI(TAG, "Starting task...");
-    xTaskCreate(taskEntry, "ReadingDispatchTask", 8192, this, 5, &m_taskHandle);
-    ESP_LOGI(TAG, "Task created, handle: %p", m_taskHandle);
+ReadingDispatchJob::ReadingDispatchJob(BackendIoTask&      io,
+                                       ControlUnitManager& manager)
+    : m_io{io}, m_manager{manager} {}
+
+ReadingDispatchJob::ReadingDispatchJob(BackendIoTask&              io,
+                                       ControlUnitManager&         manager,
+                                       const DispatchPolicyConfig& policy)
+    : m_io{io}, m_manager{manager},
+      m_policy{std::make_unique<DispatchPolicy>(policy)} {
+    m_intervalUs = m_policy->currentIntervalUs();
+    s_dispatchInterval.set(static_cast<int32_t>(m_intervalUs / 1000));
 }
 
-TaskHandle_t ReadingDispatchTask::getHandle() const {
-    return m_taskHandle;
+void ReadingDispatchJob::submit() {
+    if (m_pending.exchange(true)) {
+        ESP_LOGD(TAG, "Previous job still pending, skipping tick");
+        return;
+    }
+    BackendJob job{};
+    job.endpoint = ENDPOINT;
+    job.priority = RequestPriority::Bulk;
+    job.prepare  = &ReadingDispatchJob::prepareEntry;
+    job.complete = &ReadingDispatchJob::completeEntry;
+    job.context  = this;
+    if (!m_io.submit(job)) {
+        m_pending = false;
+    }
 }
 
-void ReadingDispatchTask::taskEntry(void* pvParameters) {
-    auto* self = static_cast<ReadingDispatchTask*>(pvParameters);
-    self->run();
+DispatchMetrics ReadingDispatchJob::metrics(uint64_t fixedIntervalUs) const {
+    DispatchMetrics metrics{};
+    metrics.intervalUs          = m_policy ? m_intervalUs.load() : fixedIntervalUs;
+    metrics.backlog             = m_backlog;
+    metrics.consecutiveFailures = m_consecutiveFailures;
+    metrics.posts               = m_posts;
+    metrics.failedPosts         = m_failedPosts;
+    metrics.lastLatencyUs       = m_lastLatencyUs;
+    return metrics;
 }
 
-void ReadingDispatchTask::run() {
-    ESP_LOGI(TAG, "ReadingDispatchTask is running");
-    while (true) {
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        std::string json = JsonParser::composeGroupedReadings(
-            m_manager.sensorManager.getGroupedReadings(),
-            m_manager.getControlunitUuidString());
-        RestClientResponse response =
-            m_httpClient.postTo("/api/v1/control-unit", json);
-        if (response.err != ESP_OK) {
-            ESP_LOGW(TAG, "POST to /api/v1/control-unit failed");
-        } else {
-            size_t savedReadings =
-                JsonParser::parseBackendReadingsResponse(response.payload);
-            if (savedReadings == 0) {
-                ESP_LOGW(TAG, "Successful posting but saved readings 0");
-            } else {
-                ESP_LOGI(
-                    TAG,
-                    "Successful posting. Clearing %zu readings from buffer",
-                    savedReadings);
-                m_manager.sensorManager.clearReadings(savedReadings);
-            }
-        }
-    }
+bool ReadingDispatchJob::prepareEntry(void* context, std::string& payload) {
+    return static_cast<ReadingDispatchJob*>(context)->prepare(payload);
 }
 
-ReadingDispatchTrigger::ReadingDispatchTrigger(TaskHandle_t target_task,
-                                               uint64_t     interval_us)
-    : m_taskHandle{target_task}, m_interval{interval_us}, m_timer{nullptr} {}
+void ReadingDispatchJob::completeEntry(void*                     context,
+                                       const RestClientResponse& response) {
+    static_cast<ReadingDispatchJob*>(context)->complete(response);
+}
 
-esp_err_t ReadingDispatchTrigger::start() {
-    if (m_taskHandle == nullptr) {
-        ESP_LOGE(TAG, "Invalid task handle — trigger not started");
-        return ESP_ERR_INVALID_ARG;
+bool ReadingDispatchJob::prepare(std::string& payload) {
+    size_t backlog = m_manager.sensorManager.readingsCount();
+    m_backlog      = backlog;
+    if (m_policy && !m_policy->shouldDispatch(esp_timer_get_time(), backlog)) {
+        m_pending = false;
+        return false;
     }
+    m_postedBacklog = backlog;
+    payload         = JsonParser::composeGroupedReadings(
+        m_manager.sensorManager.getGroupedReadings(),
+        m_manager.getControlunitUuidString());
+    return true;
+}
 
-    esp_timer_create_args_t timer_args{};
-    timer_args.callback        = &ReadingDispatchTrigger::timerCallback;
-    timer_args.arg             = this;
-    timer_args.dispatch_method = ESP_TIMER_TASK;
-    timer_args.name            = "ReadingDispatchTrigger";
+void ReadingDispatchJob::complete(const RestClientResponse& response) {
+    bool     saved   = handleResponse(response);
+    uint64_t endUs   = esp_timer_get_time();
+    m_lastLatencyUs  = response.latencyUs;
+    ++m_posts;
+    s_uploadPosts.add();
+    if (response.latencyUs > 0) { // Zero when the post never went out
+        s_uploadDuration.observe(static_cast<uint32_t>(response.latencyUs));
+    }
+    if (saved) {
+        m_consecutiveFailures = 0;
+    } else if (m_postedBacklog > 0) {
+        ++m_failedPosts;
+        ++m_consecutiveFailures;
+        s_uploadFailures.add();
+    }
 
-    esp_err_t err = esp_timer_create(&timer_args, &m_timer);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create timer: %s", esp_err_to_name(err));
-        return err;
+    if (m_policy) {
+        if (saved) {
+            m_backlog = m_manager.sensorManager.readingsCount();
+            m_policy->onSuccess(endUs, response.latencyUs, m_backlog);
+        } else {
+            m_policy->onFailure(endUs);
+        }
+        m_intervalUs = m_policy->currentIntervalUs();
+        s_dispatchInterval.set(static_cast<int32_t>(m_intervalUs / 1000));
+        ESP_LOGD(TAG,
+                 "Next post in %llu ms, backlog %zu",
+                 m_intervalUs / 1000,
+                 m_backlog.load());
     }
+    m_pending = false;
+}
 
-    err = esp_timer_start_periodic(m_timer, m_interval);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start timer: %s", esp_err_to_name(err));
-        return err;
+bool ReadingDispatchJob::handleResponse(const RestClientResponse& response) {
+    if (response.err != ESP_OK) {
+        CU_LOGW_RATELIMITED(
+            TAG, LOG_RATE_LIMIT_MS, "POST to %s failed", ENDPOINT);
+        return false;
+    }
+    size_t savedReadings =
+        JsonParser::parseBackendReadingsResponse(response.payload);
+    if (savedReadings == 0) {
+        CU_LOGW_RATELIMITED(TAG,
+                            LOG_RATE_LIMIT_MS,
+                            "Successful posting but saved readings 0");
+        return false;
+    }
+    // Readings stored while the post was in flight come after the posted
+    // ones, so clearing from the front only removes what was saved
+    ESP_LOGD(TAG,
+             "Successful posting. Clearing %zu readings from buffer",
+             savedReadings);
+    m_manager.sensorManager.clearReadings(savedReadings);
+    s_readingsUploaded.add(static_cast<uint32_t>(savedReadings));
+    return true;
+}
+
+ReadingDispatchTrigger::ReadingDispatchTrigger(JobScheduler&       scheduler,
+                                               ReadingDispatchJob& job,
+                                               uint64_t            interval_us)
+    : m_scheduler{scheduler}, m_job{job}, m_interval{interval_us},
+      m_jobId{INVALID_JOB} {}
+
+esp_err_t ReadingDispatchTrigger::start() {
+    JobConfig job{};
+    job.name     = "ReadingDispatchTrigger";
+    job.run      = &ReadingDispatchTrigger::run;
+    job.context  = this;
+    job.periodUs = m_interval;
+    m_jobId      = m_scheduler.schedule(job);
+    if (m_jobId == INVALID_JOB) {
+        ESP_LOGE(TAG, "Failed to schedule trigger");
+        return ESP_ERR_NO_MEM;
     }
 
     ESP_LOGI(TAG,
@@ -128,22 +237,15 @@ esp_err_t ReadingDispatchTrigger::start() {
 }
 
 void ReadingDispatchTrigger::stop() {
-    if (m_timer) {
-        esp_timer_stop(m_timer);
-        esp_timer_delete(m_timer);
-        m_timer = nullptr;
+    if (m_jobId != INVALID_JOB) {
+        m_scheduler.cancel(m_jobId);
+        m_jobId = INVALID_JOB;
         ESP_LOGI(TAG, "ReadingDispatchTrigger stopped");
     }
 }
 
-void ReadingDispatchTrigger::timerCallback(void* arg) {
-    ESP_LOGI(TAG, "Timer callback triggered");
+void ReadingDispatchTrigger::run(void* arg) {
+    ESP_LOGD(TAG, "Trigger run");
     auto* self = static_cast<ReadingDispatchTrigger*>(arg);
-    ESP_LOGI(TAG,
-             "Timer callback: self=%p, taskHandle=%p",
-             self,
-             self->m_taskHandle);
-    if (self->m_taskHandle) {
-        xTaskNotifyGive(self->m_taskHandle);
-    }
-}
\ No newline at end of file
+    self->m_job.submit();
+}
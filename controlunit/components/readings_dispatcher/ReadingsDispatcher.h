@@ -7,13 +7,19 @@
  * collect sensor readings and send them to a remote server.
  *
  * - `ReadingsDispatcher` is the public-facing orchestrator. It initializes and
- * connects the task and timer components.
+ * connects the job and timer components.
  *
- * - `ReadingDispatchTask` is a FreeRTOS task that waits for notifications and
- * performs the actual data collection and HTTP posting.
+ * - `ReadingDispatchJob` composes the JSON payload from the stored readings
+ * and handles the backend response. It runs on the BackendIoTask, which
+ * sends it together with all other backend requests.
  *
- * - `ReadingDispatchTrigger` sets up a periodic timer that notifies the task at
- * a configured interval.
+ * - `ReadingDispatchTrigger` schedules a periodic JobScheduler job that
+ * submits the job at a configured interval.
+ *
+ * In fixed mode the job posts on every tick. In adaptive mode the trigger
+ * ticks at the check interval and a `DispatchPolicy` decides whether to post,
+ * see DispatchPolicy.h. A tick while the previous job is still queued or in
+ * flight is skipped.
  *
  * Together, these classes form a modular and reusable system for timed sensor
  * data transmission in embedded environments.
@@ -25,46 +31,76 @@
  *
  */
 #pragma once
+#include "BackendIoTask.h"
 #include "ControlUnitManager.h"
-#include "RestClient.h"
+#include "DispatchPolicy.h"
+#include "JobScheduler.h"
 #include "esp_log.h"
 #include "esp_timer.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
+#include <atomic>
 #include <memory>
+#include <optional>
 
 // Forward declarations for types used in ReadingsDispatcher
-class ReadingDispatchTask;
+class ReadingDispatchJob;
 class ReadingDispatchTrigger;
 
+/**
+ * @brief Snapshot of the dispatcher state, for logging and metrics
+ */
+struct DispatchMetrics {
+    uint64_t intervalUs;          /**< Current time between posts */
+    size_t   backlog;             /**< Readings waiting at the last tick */
+    uint32_t consecutiveFailures; /**< Failed posts in a row */
+    uint32_t posts;               /**< Posts since start */
+    uint32_t failedPosts;         /**< Failed posts since start */
+    uint64_t lastLatencyUs;       /**< Duration of the last post */
+};
+
 /**
  * @class ReadingsDispatcher
  * @brief High-level orchestrator for periodic sensor data dispatch.
  *
- * Combines a task and a timer trigger to periodically collect and send sensor
- * data. Responsible for initializing and coordinating the ReadingDispatchTask
+ * Combines a job and a timer trigger to periodically collect and send sensor
+ * data. Responsible for initializing and coordinating the ReadingDispatchJob
  * and ReadingDispatchTrigger.
  */
 class ReadingsDispatcher {
   public:
     /**
-     * @brief Constructs a ReadingsDispatcher with client, manager, and
+     * @brief Constructs a ReadingsDispatcher with I/O task, manager, and
      * interval.
      *
-     * @param client Reference to the REST client used for posting data.
+     * @param io Reference to the backend I/O task used for posting data.
+     * @param scheduler Reference to the scheduler running the trigger.
      * @param manager Reference to the control unit manager providing sensor
      * data.
      * @param interval_us Timer interval in microseconds.
      */
-    ReadingsDispatcher(RestClient&         client,
+    ReadingsDispatcher(BackendIoTask&      io,
+                       JobScheduler&       scheduler,
                        ControlUnitManager& manager,
                        uint64_t            interval_us);
 
     /**
-     * @brief Starts the readings dispatcher by launching the task and trigger.
+     * @brief Constructs a ReadingsDispatcher in adaptive mode.
+     *
+     * @param io Reference to the backend I/O task used for posting data.
+     * @param scheduler Reference to the scheduler running the trigger.
+     * @param manager Reference to the control unit manager providing sensor
+     * data.
+     * @param policy Intervals and backlog threshold for the DispatchPolicy.
+     */
+    ReadingsDispatcher(BackendIoTask&              io,
+                       JobScheduler&               scheduler,
+                       ControlUnitManager&         manager,
+                       const DispatchPolicyConfig& policy);
+
+    /**
+     * @brief Starts the readings dispatcher by creating the job and trigger.
      *
-     * Creates a ReadingDispatchTask and a ReadingDispatchTrigger, and starts
-     * both.
+     * Creates a ReadingDispatchJob and a ReadingDispatchTrigger, and starts
+     * the trigger.
      *
      * @return esp_err_t ESP_OK on success, or an error code on failure.
      */
@@ -73,140 +109,174 @@ class ReadingsDispatcher {
     /**
      * @brief Stops the readings dispatcher trigger.
      *
-     * Stops the periodic timer. The task is not stopped immediately.
+     * Cancels the periodic trigger. A job already submitted still runs.
      */
     void stop();
     // esp_err_t restart(uint64_t new_interval_us);
 
+    /**
+     * @brief Returns the current interval, backlog and post counters.
+     *
+     * Safe to call from any task. All zero before start().
+     */
+    DispatchMetrics metrics() const;
+
   private:
-    RestClient&
-        m_client; /**< Reference to the REST client used for posting data. */
+    BackendIoTask&
+        m_io; /**< Reference to the I/O task used for posting data. */
+    JobScheduler&
+        m_scheduler; /**< Reference to the scheduler running the trigger. */
     ControlUnitManager&
         m_manager; /**< Reference to the control unit manager. */
-    std::unique_ptr<ReadingDispatchTask>
-        m_task; /**< Task responsible for data dispatch. */
+    std::unique_ptr<ReadingDispatchJob>
+        m_job; /**< Job responsible for data dispatch. */
     std::unique_ptr<ReadingDispatchTrigger>
-             m_trigger;  /**< Timer trigger for periodic task activation. */
+             m_trigger;  /**< Trigger for periodic job submission. */
     uint64_t m_interval; /**< Timer interval in microseconds. */
+    std::optional<DispatchPolicyConfig>
+        m_policyConfig; /**< Set in adaptive mode. */
 };
 
 /**
- * @class ReadingDispatchTask
- * @brief FreeRTOS task responsible for collecting and posting sensor data.
+ * @class ReadingDispatchJob
+ * @brief Backend job that posts the stored sensor readings.
  *
- * This task waits for notifications triggered by a timer, composes a JSON
- * payload from grouped sensor readings, and sends the data to a remote server
- * using a REST client.
+ * Submitted to the BackendIoTask by the trigger. Composes a JSON payload from
+ * grouped sensor readings right before it is sent and clears the readings the
+ * backend saved when the response is in. At most one job is queued or in
+ * flight at a time.
  */
-class ReadingDispatchTask {
+class ReadingDispatchJob {
   public:
     /**
-     * @brief Constructs a ReadingDispatchTask with HTTP client and control unit
+     * @brief Constructs a ReadingDispatchJob with I/O task and control unit
      * manager.
      *
-     * @param client Reference to the REST client used for posting data.
+     * @param io Reference to the backend I/O task the job is submitted to.
+     * @param manager Reference to the control unit manager providing sensor
+     * data.
+     */
+    ReadingDispatchJob(BackendIoTask& io, ControlUnitManager& manager);
+
+    /**
+     * @brief Constructs a ReadingDispatchJob in adaptive mode, posting only
+     * when the policy says so.
+     *
+     * @param io Reference to the backend I/O task the job is submitted to.
      * @param manager Reference to the control unit manager providing sensor
      * data.
+     * @param policy Intervals and backlog threshold for the DispatchPolicy.
      */
-    ReadingDispatchTask(RestClient& client, ControlUnitManager& manager);
+    ReadingDispatchJob(BackendIoTask&              io,
+                       ControlUnitManager&         manager,
+                       const DispatchPolicyConfig& policy);
 
     /**
-     * @brief Starts the ReadingDispatchTask by creating a FreeRTOS task.
+     * @brief Submits the job unless the previous one is still pending.
      *
-     * Creates a task with the specified name and priority, and stores its
-     * handle.
+     * Safe to call from esp_timer callbacks, never blocks.
      */
-    void start();
+    void submit();
 
     /**
-     * @brief Returns the handle of the created task.
+     * @brief Returns the current interval, backlog and post counters.
      *
-     * @return TaskHandle_t Handle to the FreeRTOS task.
+     * @param fixedIntervalUs Interval to report in fixed mode.
      */
-    TaskHandle_t getHandle() const;
+    DispatchMetrics metrics(uint64_t fixedIntervalUs) const;
 
   private:
+    static bool prepareEntry(void* context, std::string& payload);
+    static void completeEntry(void* context, const RestClientResponse& response);
+
     /**
-     * @brief Entry point for the ReadingDispatchTask.
+     * @brief Asks the policy and composes the payload, runs on the I/O task.
      *
-     * Casts the parameter to a ReadingDispatchTask instance and invokes its
-     * run() method.
-     *
-     * @param pvParameters Pointer to the ReadingDispatchTask instance.
+     * @return false if nothing should be posted this tick.
+     */
+    bool prepare(std::string& payload);
+
+    /**
+     * @brief Updates counters and policy from the response, runs on the I/O
+     * task.
      */
-    static void taskEntry(void* pvParameters);
+    void complete(const RestClientResponse& response);
 
     /**
-     * @brief Main loop of the ReadingDispatchTask.
+     * @brief Clears the readings the backend saved.
      *
-     * Waits for task notifications, composes a JSON payload from grouped sensor
-     * readings, and posts the data to the server using the REST client.
+     * @return true if the backend saved at least one reading.
      */
-    void run();
+    bool handleResponse(const RestClientResponse& response);
 
-    RestClient& m_httpClient; /**< Reference to the REST client used for HTTP
-                                 communication. */
+    BackendIoTask& m_io; /**< Reference to the I/O task sending the job. */
     ControlUnitManager& m_manager; /**< Reference to the control unit manager
                                       providing sensor data. */
-    TaskHandle_t m_taskHandle;     /**< Handle to the created FreeRTOS task. */
+    std::unique_ptr<DispatchPolicy>
+           m_policy; /**< Adaptive mode policy, nullptr in fixed mode. */
+    size_t m_postedBacklog = 0; /**< Backlog when the payload was composed */
+    std::atomic<bool> m_pending{false}; /**< Submitted and not completed */
 
-    static constexpr const char* TAG = "ReadingDispatchTask";
+    // Written by the I/O task, read by metrics() from other tasks
+    std::atomic<uint64_t> m_intervalUs{0};
+    std::atomic<size_t>   m_backlog{0};
+    std::atomic<uint32_t> m_consecutiveFailures{0};
+    std::atomic<uint32_t> m_posts{0};
+    std::atomic<uint32_t> m_failedPosts{0};
+    std::atomic<uint64_t> m_lastLatencyUs{0};
+
+    static constexpr const char* ENDPOINT = "/api/v1/control-unit";
+    static constexpr const char* TAG      = "ReadingDispatchJob";
 };
 
 /**
  * @class ReadingDispatchTrigger
- * @brief Periodically triggers a task to dispatch sensor readings.
+ * @brief Periodically submits the job that dispatches sensor readings.
  *
- * This class sets up a periodic timer using the ESP-IDF timer API. When the
- * timer expires, it notifies a target FreeRTOS task to perform data
- * dispatching.
+ * This class schedules a periodic job on the JobScheduler. Every run submits
+ * the ReadingDispatchJob to the BackendIoTask.
  */
 class ReadingDispatchTrigger {
   public:
     /**
-     * @brief Constructs a ReadingDispatchTrigger with a target task and
-     * interval.
+     * @brief Constructs a ReadingDispatchTrigger with a job and interval.
      *
-     * @param target_task Handle to the task that will be notified periodically.
-     * @param interval_us Timer interval in microseconds.
+     * @param scheduler Scheduler the trigger runs on.
+     * @param job Job that will be submitted periodically.
+     * @param interval_us Interval in microseconds.
      */
-    ReadingDispatchTrigger(TaskHandle_t target_task, uint64_t interval_us);
+    ReadingDispatchTrigger(JobScheduler&       scheduler,
+                           ReadingDispatchJob& job,
+                           uint64_t            interval_us);
 
     /**
-     * @brief Initializes and starts the periodic timer for dispatching
-     * readings.
-     *
-     * Verifies that a valid task handle is available, creates a timer with the
-     * specified interval, and starts it. The timer will notify the target task
-     * on each tick.
+     * @brief Schedules the periodic scheduler job for dispatching readings.
      *
-     * @return esp_err_t ESP_OK on success, or an error code on failure.
+     * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the scheduler
+     * has no room for the job.
      */
     esp_err_t start();
 
     /**
-     * @brief Stops and deletes the active timer.
-     *
-     * If the timer is running, it is stopped and deleted. The internal timer
-     * handle is reset to nullptr.
+     * @brief Cancels the scheduler job, waits for a run in progress.
      */
     void stop();
 
   private:
     /**
-     * @brief Callback function triggered by the periodic timer.
+     * @brief Scheduler job callback.
      *
-     * Casts the argument to a ReadingDispatchTrigger instance and sends a task
-     * notification to the associated task handle, if available.
+     * Casts the argument to a ReadingDispatchTrigger instance and submits the
+     * associated job.
      *
      * @param arg Pointer to the ReadingDispatchTrigger instance.
      */
-    static void timerCallback(void* arg);
+    static void run(void* arg);
 
-    TaskHandle_t m_taskHandle;     /**< Handle to the task that will be notified
-                                      periodically. */
-    uint64_t           m_interval; /**< Timer interval in microseconds. */
-    esp_timer_handle_t m_timer;    /**< Handle to the ESP-IDF timer instance. */
+    JobScheduler&       m_scheduler; /**< Scheduler the trigger runs on. */
+    ReadingDispatchJob& m_job;       /**< Job submitted periodically. */
+    uint64_t            m_interval;  /**< Interval in microseconds. */
+    JobId               m_jobId;     /**< Scheduler job, INVALID_JOB if off */
 
     static constexpr const char* TAG = "ReadingDispatchTrigger";
 };
\ No newline at end of file
@@ -0,0 +1,102 @@
+/**
+ * @brief Test file for DispatchPolicy.cpp
+ *
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "DispatchPolicy.h"
+
+static constexpr uint64_t SECOND = 1'000'000;
+
+static uint32_t noJitter() {
+    return 0;
+}
+
+static DispatchPolicyConfig testConfig() {
+    DispatchPolicyConfig config;
+    config.baseIntervalUs   = 30 * SECOND;
+    config.minIntervalUs    = 2 * SECOND;
+    config.maxIntervalUs    = 300 * SECOND;
+    config.backlogThreshold = 100;
+    return config;
+}
+
+extern "C" void when_backlog_empty_then_policy_skips_dispatch(void) {
+    DispatchPolicy policy(testConfig(), noJitter);
+    TEST_ASSERT_FALSE(policy.shouldDispatch(10 * 60 * SECOND, 0));
+
+    policy.onSuccess(100 * SECOND, SECOND, 0);
+    TEST_ASSERT_FALSE(policy.shouldDispatch(200 * SECOND, 0));
+    TEST_ASSERT_TRUE(policy.shouldDispatch(200 * SECOND, 1));
+}
+
+extern "C" void when_interval_passed_then_policy_dispatches(void) {
+    DispatchPolicy policy(testConfig(), noJitter);
+    policy.onSuccess(100 * SECOND, SECOND, 0);
+
+    TEST_ASSERT_FALSE(policy.shouldDispatch(129 * SECOND, 5));
+    TEST_ASSERT_TRUE(policy.shouldDispatch(130 * SECOND, 5));
+}
+
+extern "C" void when_backlog_reaches_threshold_then_policy_dispatches_early(
+    void) {
+    DispatchPolicy policy(testConfig(), noJitter);
+    TEST_ASSERT_TRUE(policy.shouldDispatch(SECOND, 100));
+
+    policy.onSuccess(100 * SECOND, SECOND, 0);
+    // Still held back by the min interval
+    TEST_ASSERT_FALSE(policy.shouldDispatch(101 * SECOND, 100));
+    TEST_ASSERT_TRUE(policy.shouldDispatch(102 * SECOND, 100));
+    TEST_ASSERT_FALSE(policy.shouldDispatch(102 * SECOND, 99));
+}
+
+extern "C" void when_posts_fail_then_policy_backs_off_up_to_max(void) {
+    DispatchPolicy policy(testConfig(), noJitter);
+
+    // Without jitter the interval is half the doubled backoff
+    policy.onFailure(100 * SECOND);
+    TEST_ASSERT_EQUAL_UINT32(30, policy.currentIntervalUs() / SECOND);
+    policy.onFailure(130 * SECOND);
+    TEST_ASSERT_EQUAL_UINT32(60, policy.currentIntervalUs() / SECOND);
+    for (int i = 0; i < 40; ++i) {
+        policy.onFailure(200 * SECOND);
+    }
+    TEST_ASSERT_EQUAL_UINT32(150, policy.currentIntervalUs() / SECOND);
+    TEST_ASSERT_EQUAL_UINT32(32, policy.consecutiveFailures());
+
+    // The backlog threshold does not cut the backoff short
+    TEST_ASSERT_FALSE(policy.shouldDispatch(210 * SECOND, 1000));
+    TEST_ASSERT_TRUE(policy.shouldDispatch(350 * SECOND, 1));
+}
+
+extern "C" void when_jitter_is_max_then_backoff_is_full_interval(void) {
+    DispatchPolicy policy(testConfig(), [] { return UINT32_MAX; });
+    policy.onFailure(100 * SECOND);
+    TEST_ASSERT_TRUE(policy.currentIntervalUs() >= 30 * SECOND);
+    TEST_ASSERT_TRUE(policy.currentIntervalUs() <= 60 * SECOND);
+}
+
+extern "C" void when_post_succeeds_after_failures_then_interval_resets(void) {
+    DispatchPolicy policy(testConfig(), noJitter);
+    policy.onFailure(100 * SECOND);
+    policy.onFailure(130 * SECOND);
+
+    policy.onSuccess(200 * SECOND, SECOND, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, policy.consecutiveFailures());
+    TEST_ASSERT_EQUAL_UINT32(30, policy.currentIntervalUs() / SECOND);
+}
+
+extern "C" void when_catching_up_then_interval_follows_backend_latency(void) {
+    DispatchPolicy policy(testConfig(), noJitter);
+
+    policy.onSuccess(100 * SECOND, 5 * SECOND, 500);
+    TEST_ASSERT_EQUAL_UINT32(5, policy.currentIntervalUs() / SECOND);
+
+    policy.onSuccess(105 * SECOND, SECOND / 10, 400);
+    TEST_ASSERT_EQUAL_UINT32(2, policy.currentIntervalUs() / SECOND);
+
+    policy.onSuccess(107 * SECOND, 60 * SECOND, 300);
+    TEST_ASSERT_EQUAL_UINT32(30, policy.currentIntervalUs() / SECOND);
+}
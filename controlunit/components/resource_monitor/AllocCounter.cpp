@@ -0,0 +1,58 @@
+/**
+ * @file AllocCounter.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the component allocation counters
+ *
+ * The list is built during static initialization, before any task runs, and
+ * never changes afterwards, so reading it needs no lock.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "AllocCounter.h"
+
+/// Constant initialized, so it is valid before any counter is constructed
+static AllocCounter* s_first = nullptr;
+
+AllocCounter::AllocCounter(const char* name) : m_name{name}, m_next{s_first} {
+    s_first = this;
+}
+
+void AllocCounter::allocated(size_t bytes) {
+    ++m_allocs;
+    uint32_t live = m_liveBytes.fetch_add(bytes) + bytes;
+    uint32_t peak = m_peakBytes.load();
+    while (live > peak && !m_peakBytes.compare_exchange_weak(peak, live)) {
+    }
+}
+
+void AllocCounter::freed(size_t bytes) {
+    ++m_frees;
+    m_liveBytes.fetch_sub(bytes);
+}
+
+void AllocCounter::replaced(size_t oldBytes, size_t newBytes) {
+    // The new buffer exists before the old one is freed
+    if (newBytes > 0) {
+        allocated(newBytes);
+    }
+    if (oldBytes > 0) {
+        freed(oldBytes);
+    }
+}
+
+AllocStats AllocCounter::stats() const {
+    return {m_name, m_allocs, m_frees, m_liveBytes, m_peakBytes};
+}
+
+size_t AllocCounter::all(AllocStats* stats, size_t maxStats) {
+    size_t count = 0;
+    for (AllocCounter* counter = s_first; counter && count < maxStats;
+         counter               = counter->m_next) {
+        stats[count++] = counter->stats();
+    }
+    return count;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file AllocCounter.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Allocation counter a component keeps for its own buffers
+ *
+ * A component declares one counter with static storage and reports what it
+ * allocates and frees. Every counter links itself into a global list at
+ * construction, ResourceMonitor reads them all. Counting is lock free, so it
+ * is safe from any task.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "ResourceTypes.h"
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class AllocCounter
+ * @brief Counts allocations, frees, live and peak bytes of one component
+ */
+class AllocCounter {
+  public:
+    /**
+     * @brief Registers the counter, only use with static storage duration
+     *
+     * @param name Shown in logs and /resources, must outlive the counter
+     */
+    explicit AllocCounter(const char* name);
+
+    AllocCounter(const AllocCounter&)            = delete;
+    AllocCounter& operator=(const AllocCounter&) = delete;
+
+    void allocated(size_t bytes);
+    void freed(size_t bytes);
+
+    /**
+     * @brief Records a buffer of oldBytes replaced by one of newBytes, like a
+     * growing std::vector. Zero means no buffer on that side.
+     */
+    void replaced(size_t oldBytes, size_t newBytes);
+
+    AllocStats stats() const;
+
+    /**
+     * @brief Copies the counters of every registered AllocCounter
+     *
+     * @return Number of counters written, at most maxStats
+     */
+    static size_t all(AllocStats* stats, size_t maxStats);
+
+  private:
+    const char*           m_name;
+    std::atomic<uint32_t> m_allocs{0};
+    std::atomic<uint32_t> m_frees{0};
+    std::atomic<uint32_t> m_liveBytes{0};
+    std::atomic<uint32_t> m_peakBytes{0};
+    AllocCounter*         m_next; /**< Next registered counter */
+};
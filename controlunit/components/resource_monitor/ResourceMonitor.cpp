@@ -0,0 +1,163 @@
+/**
+ * @file ResourceMonitor.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the resource monitor
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "ResourceMonitor.h"
+#include "AllocCounter.h"
+#include "TaskProfile.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <cstdio>
+
+/// AllocCounters read per sample, more are left out
+static constexpr size_t MAX_ALLOC_COUNTERS = 16;
+
+ResourceMonitor::ResourceMonitor(JobScheduler&                scheduler,
+                                 const ResourceMonitorConfig& config)
+    : m_scheduler{scheduler}, m_config{config},
+      m_mutex{xSemaphoreCreateMutex()} {
+    if (m_mutex == nullptr) {
+        ESP_LOGE(TAG, "Failed to create mutex");
+    }
+}
+
+ResourceMonitor::~ResourceMonitor() {
+    stop();
+    if (m_mutex) {
+        vSemaphoreDelete(m_mutex);
+    }
+}
+
+esp_err_t ResourceMonitor::start() {
+    if (m_mutex == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+    run(this);
+
+    JobConfig job{};
+    job.name     = "ResourceMonitor";
+    job.run      = &ResourceMonitor::run;
+    job.context  = this;
+    job.periodUs = m_config.intervalUs;
+    m_jobId      = m_scheduler.schedule(job);
+    if (m_jobId == INVALID_JOB) {
+        ESP_LOGE(TAG, "Failed to schedule monitor");
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Sampling every %llu ms", m_config.intervalUs / 1000);
+    return ESP_OK;
+}
+
+void ResourceMonitor::stop() {
+    if (m_jobId != INVALID_JOB) {
+        m_scheduler.cancel(m_jobId);
+        m_jobId = INVALID_JOB;
+    }
+}
+
+ResourceSnapshot ResourceMonitor::sample() {
+    ResourceSnapshot snapshot;
+    snapshot.uptimeUs = esp_timer_get_time();
+
+    snapshot.heap.freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    snapshot.heap.minFreeBytes =
+        heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    snapshot.heap.largestFreeBlock =
+        heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+
+    TaskRecord records[MAX_TRACKED_TASKS];
+    size_t     taskCount = trackedTasks(records, MAX_TRACKED_TASKS);
+    snapshot.tasks.reserve(taskCount);
+    for (size_t i = 0; i < taskCount; ++i) {
+        const TaskProfile& profile = *records[i].profile;
+        // Stack depths are in bytes on ESP-IDF
+        snapshot.tasks.push_back(
+            {profile.name,
+             static_cast<int32_t>(taskCore(profile)),
+             static_cast<uint32_t>(profile.priority),
+             profile.stackBytes,
+             static_cast<uint32_t>(
+                 uxTaskGetStackHighWaterMark(records[i].handle))});
+    }
+
+    AllocStats allocs[MAX_ALLOC_COUNTERS];
+    size_t     allocCount = AllocCounter::all(allocs, MAX_ALLOC_COUNTERS);
+    snapshot.allocs.assign(allocs, allocs + allocCount);
+    return snapshot;
+}
+
+ResourceSnapshot ResourceMonitor::latest() const {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    ResourceSnapshot snapshot = m_latest;
+    xSemaphoreGive(m_mutex);
+    return snapshot;
+}
+
+void ResourceMonitor::run(void* arg) {
+    auto*            self     = static_cast<ResourceMonitor*>(arg);
+    ResourceSnapshot snapshot = self->sample();
+    self->log(snapshot);
+    xSemaphoreTake(self->m_mutex, portMAX_DELAY);
+    self->m_latest = std::move(snapshot);
+    xSemaphoreGive(self->m_mutex);
+}
+
+void ResourceMonitor::log(const ResourceSnapshot& snapshot) const {
+    // One line per sample: heap free/min/block, free stack per task and
+    // live/peak bytes per counter
+    char   line[384];
+    size_t used = std::snprintf(line,
+                                sizeof(line),
+                                "heap %lu/%lu/%lu stack",
+                                (unsigned long) snapshot.heap.freeBytes,
+                                (unsigned long) snapshot.heap.minFreeBytes,
+                                (unsigned long) snapshot.heap.largestFreeBlock);
+    for (const auto& task : snapshot.tasks) {
+        if (used < sizeof(line)) {
+            used += std::snprintf(line + used,
+                                  sizeof(line) - used,
+                                  " %s %lu/%lu",
+                                  task.name,
+                                  (unsigned long) task.minFreeBytes,
+                                  (unsigned long) task.stackBytes);
+        }
+    }
+    if (used < sizeof(line)) {
+        used += std::snprintf(line + used, sizeof(line) - used, " alloc");
+    }
+    for (const auto& alloc : snapshot.allocs) {
+        if (used < sizeof(line)) {
+            used += std::snprintf(line + used,
+                                  sizeof(line) - used,
+                                  " %s %lu/%lu",
+                                  alloc.name,
+                                  (unsigned long) alloc.liveBytes,
+                                  (unsigned long) alloc.peakBytes);
+        }
+    }
+    ESP_LOGI(TAG, "%s", line);
+
+    for (const auto& task : snapshot.tasks) {
+        if (task.minFreeBytes < m_config.stackWarnBytes) {
+            ESP_LOGW(TAG,
+                     "Task %s has %lu of %lu stack bytes left",
+                     task.name,
+                     (unsigned long) task.minFreeBytes,
+                     (unsigned long) task.stackBytes);
+        }
+    }
+    if (snapshot.heap.largestFreeBlock < m_config.blockWarnBytes) {
+        ESP_LOGW(TAG,
+                 "Largest free block is %lu bytes, %lu bytes free",
+                 (unsigned long) snapshot.heap.largestFreeBlock,
+                 (unsigned long) snapshot.heap.freeBytes);
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * @file ResourceMonitor.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Periodic sample of task stacks, heap and component allocations
+ *
+ * Runs as a JobScheduler job and samples:
+ *
+ * - the stack high water mark of every task tracked by TaskProfile
+ * - free heap, lowest free heap and the largest free block
+ * - every AllocCounter
+ *
+ * Every sample is logged as one compact line, with a warning when a stack
+ * or the largest free block runs low. The last sample is served on
+ * GET /resources.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "JobScheduler.h"
+#include "ResourceTypes.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <cstdint>
+
+/**
+ * @brief Settings for a ResourceMonitor
+ */
+struct ResourceMonitorConfig {
+    uint64_t intervalUs     = 30'000'000; /**< Between samples */
+    uint32_t stackWarnBytes = 512;        /**< Warn below this free stack */
+    /** Warn below this largest free block, a TLS record needs 16 KB */
+    uint32_t blockWarnBytes = 16 * 1024;
+};
+
+/**
+ * @class ResourceMonitor
+ * @brief Samples resources on a schedule and keeps the last sample
+ */
+class ResourceMonitor {
+  public:
+    ResourceMonitor(JobScheduler&                scheduler,
+                    const ResourceMonitorConfig& config = {});
+    ~ResourceMonitor();
+
+    /**
+     * @brief Takes a first sample and schedules the rest
+     *
+     * @return esp_err_t ESP_OK, or ESP_ERR_NO_MEM if the scheduler is full
+     */
+    esp_err_t start();
+    void      stop();
+
+    /**
+     * @brief Takes a sample now without logging it, safe from any task
+     */
+    ResourceSnapshot sample();
+
+    /**
+     * @brief Returns the last scheduled sample
+     */
+    ResourceSnapshot latest() const;
+
+  private:
+    static void run(void* arg);
+    void        log(const ResourceSnapshot& snapshot) const;
+
+    JobScheduler&         m_scheduler;
+    ResourceMonitorConfig m_config;
+    JobId                 m_jobId = INVALID_JOB;
+
+    mutable SemaphoreHandle_t m_mutex = nullptr; /**< Guards m_latest */
+    ResourceSnapshot          m_latest;
+
+    static constexpr const char* TAG = "ResourceMonitor";
+};
@@ -0,0 +1,57 @@
+/**
+ * @file ResourceTypes.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Plain data types of a ResourceMonitor sample
+ *
+ * Kept free of FreeRTOS so JsonParser can compose them.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Heap of 8 bit capable memory, in bytes
+ */
+struct HeapStats {
+    uint32_t freeBytes;
+    uint32_t minFreeBytes;     /**< Lowest free heap since boot */
+    uint32_t largestFreeBlock; /**< Biggest allocation that can succeed */
+};
+
+/**
+ * @brief Stack of one tracked task, in bytes
+ */
+struct TaskStackStats {
+    const char* name;
+    int32_t     core; /**< 0, 1 or tskNO_AFFINITY */
+    uint32_t    priority;
+    uint32_t    stackBytes;
+    uint32_t    minFreeBytes; /**< High water mark, lowest free stack so far */
+};
+
+/**
+ * @brief Counters of one AllocCounter
+ */
+struct AllocStats {
+    const char* name;
+    uint32_t    allocs;
+    uint32_t    frees;
+    uint32_t    liveBytes;
+    uint32_t    peakBytes;
+};
+
+/**
+ * @brief One sample of everything ResourceMonitor watches
+ */
+struct ResourceSnapshot {
+    uint64_t                    uptimeUs = 0;
+    HeapStats                   heap{};
+    std::vector<TaskStackStats> tasks;
+    std::vector<AllocStats>     allocs;
+};
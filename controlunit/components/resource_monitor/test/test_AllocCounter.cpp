@@ -0,0 +1,44 @@
+/**
+ * @brief Test file for AllocCounter.cpp
+ *
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "AllocCounter.h"
+#include <cstring>
+
+static AllocCounter s_testAllocs{"test_allocs"};
+
+extern "C" void when_buffers_allocated_and_freed_then_live_and_peak_follow(
+    void) {
+    AllocStats before = s_testAllocs.stats();
+
+    s_testAllocs.allocated(100);
+    s_testAllocs.allocated(50);
+    s_testAllocs.freed(100);
+    AllocStats stats = s_testAllocs.stats();
+    TEST_ASSERT_EQUAL_UINT32(before.allocs + 2, stats.allocs);
+    TEST_ASSERT_EQUAL_UINT32(before.frees + 1, stats.frees);
+    TEST_ASSERT_EQUAL_UINT32(before.liveBytes + 50, stats.liveBytes);
+    TEST_ASSERT_TRUE(stats.peakBytes >= before.liveBytes + 150);
+
+    // Grows like a vector, both buffers exist for a moment
+    s_testAllocs.replaced(50, 200);
+    stats = s_testAllocs.stats();
+    TEST_ASSERT_EQUAL_UINT32(before.liveBytes + 200, stats.liveBytes);
+    TEST_ASSERT_TRUE(stats.peakBytes >= before.liveBytes + 250);
+    s_testAllocs.freed(200);
+}
+
+extern "C" void when_counters_listed_then_every_counter_is_included(void) {
+    AllocStats stats[16];
+    size_t     count = AllocCounter::all(stats, 16);
+    bool       found = false;
+    for (size_t i = 0; i < count; ++i) {
+        found |= std::strcmp(stats[i].name, "test_allocs") == 0;
+    }
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_EQUAL(0, AllocCounter::all(stats, 0));
+}
@@ -0,0 +1,47 @@
+/**
+ * @brief Test file for ResourceMonitor.cpp
+ *
+ * Samples the workers of a real JobScheduler, so it runs on the device and
+ * the host.
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "ResourceMonitor.h"
+#include <cstring>
+
+extern "C" void when_scheduler_runs_then_sample_has_worker_stack_and_heap(
+    void) {
+    JobScheduler scheduler;
+    TEST_ASSERT_EQUAL(ESP_OK, scheduler.start());
+    ResourceMonitor monitor(scheduler);
+    TEST_ASSERT_EQUAL(ESP_OK, monitor.start());
+
+    // Let the worker reach its queue wait
+    vTaskDelay(pdMS_TO_TICKS(50));
+    ResourceSnapshot snapshot = monitor.sample();
+    TEST_ASSERT_TRUE(monitor.latest().uptimeUs > 0);
+    TEST_ASSERT_TRUE(snapshot.heap.freeBytes > 0);
+    TEST_ASSERT_TRUE(snapshot.heap.minFreeBytes <= snapshot.heap.freeBytes);
+    TEST_ASSERT_TRUE(snapshot.heap.largestFreeBlock <=
+                     snapshot.heap.freeBytes);
+
+    const TaskStackStats* worker = nullptr;
+    for (const auto& task : snapshot.tasks) {
+        if (std::strcmp(task.name, JOB_WORKER_TASK.name) == 0) {
+            worker = &task;
+        }
+    }
+    TEST_ASSERT_NOT_NULL(worker);
+    TEST_ASSERT_EQUAL_UINT32(JOB_WORKER_TASK.stackBytes, worker->stackBytes);
+    TEST_ASSERT_TRUE(worker->minFreeBytes > 0);
+    TEST_ASSERT_TRUE(worker->minFreeBytes < worker->stackBytes);
+
+    monitor.stop();
+    scheduler.stop();
+    // Stopped workers are no longer tracked
+    for (const auto& task : monitor.sample().tasks) {
+        TEST_ASSERT_FALSE(std::strcmp(task.name, JOB_WORKER_TASK.name) == 0);
+    }
+}
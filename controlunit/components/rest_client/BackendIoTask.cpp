@@ -0,0 +1,196 @@
+/**
+ * @file BackendIoTask.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the backend I/O task
+ *
+ * Submitters only touch the queues and the task notification. The task
+ * sleeps on the notification while there is nothing to do and polls the
+ * request in flight once per tick, or sooner when a job is submitted.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "BackendIoTask.h"
+#include "AllocCounter.h"
+#include "LogRateLimit.h"
+#include "Metrics.h"
+#include "TaskProfile.h"
+#include <utility>
+
+static AllocCounter s_payloadAllocs{"io_payload"};
+
+static Gauge   s_queueDepth{"cu_backend_queue_depth",
+                          "Backend jobs queued and not yet taken by the task"};
+static Counter s_jobsRejected{"cu_backend_jobs_rejected_total",
+                              "Backend jobs refused because the queue was full"};
+
+/// Heap bytes held by a string, none while it fits the inline buffer
+static size_t heapBytes(const std::string& text) {
+    static const size_t inlineCapacity = std::string().capacity();
+    return text.capacity() > inlineCapacity ? text.capacity() + 1 : 0;
+}
+
+BackendIoTask::BackendIoTask(RestClient& client, size_t queueLength)
+    : m_client{client}, m_queueLength{queueLength} {}
+
+BackendIoTask::~BackendIoTask() {
+    stop();
+    for (auto& queue : m_queues) {
+        if (queue) {
+            vQueueDelete(queue);
+        }
+    }
+    if (m_stopped) {
+        vSemaphoreDelete(m_stopped);
+    }
+}
+
+esp_err_t BackendIoTask::start() {
+    for (auto& queue : m_queues) {
+        queue = xQueueCreate(m_queueLength, sizeof(BackendJob));
+        if (queue == nullptr) {
+            ESP_LOGE(TAG, "Failed to create queue");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    m_stopped = xSemaphoreCreateBinary();
+    if (m_stopped == nullptr) {
+        ESP_LOGE(TAG, "Failed to create semaphore");
+        return ESP_ERR_NO_MEM;
+    }
+    if (createTask(BACKEND_IO_TASK, taskEntry, this, &m_taskHandle) != pdPASS) {
+        m_taskHandle = nullptr;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Task created, handle: %p", m_taskHandle);
+    return ESP_OK;
+}
+
+void BackendIoTask::stop() {
+    if (m_taskHandle == nullptr || m_stopping.exchange(true)) {
+        return;
+    }
+    xTaskNotifyGive(m_taskHandle);
+    xSemaphoreTake(m_stopped, portMAX_DELAY);
+    ESP_LOGI(TAG, "Task stopped");
+}
+
+bool BackendIoTask::submit(const BackendJob& job) {
+    if (m_taskHandle == nullptr || m_stopping) {
+        ++m_rejected;
+        return false;
+    }
+    QueueHandle_t queue = m_queues[static_cast<size_t>(job.priority)];
+    // Counted before the send, the task may take the job right away
+    s_queueDepth.add(1);
+    if (xQueueSend(queue, &job, 0) != pdTRUE) {
+        s_queueDepth.add(-1);
+        ++m_rejected;
+        s_jobsRejected.add();
+        CU_LOGW_RATELIMITED(TAG,
+                            LOG_RATE_LIMIT_MS,
+                            "Queue full, rejecting job for %s",
+                            job.endpoint);
+        return false;
+    }
+    ++m_submitted;
+    xTaskNotifyGive(m_taskHandle);
+    return true;
+}
+
+BackendIoStats BackendIoTask::stats() const {
+    BackendIoStats stats{};
+    stats.submitted  = m_submitted;
+    stats.rejected   = m_rejected;
+    stats.dropped    = m_dropped;
+    stats.completed  = m_completed;
+    stats.overlapped = m_overlapped;
+    return stats;
+}
+
+void BackendIoTask::taskEntry(void* pvParameters) {
+    auto* self = static_cast<BackendIoTask*>(pvParameters);
+    self->run();
+    untrackTask();
+    xSemaphoreGive(self->m_stopped);
+    vTaskDelete(nullptr);
+}
+
+void BackendIoTask::run() {
+    ESP_LOGI(TAG, "BackendIoTask is running");
+    BackendJob next{};
+    bool       hasNext = false;
+    while (!m_stopping) {
+        BackendJob job{};
+        bool       commandWaiting =
+            uxQueueMessagesWaiting(
+                m_queues[static_cast<size_t>(RequestPriority::Command)]) > 0;
+        if (hasNext &&
+            (next.priority == RequestPriority::Command || !commandWaiting)) {
+            job     = next;
+            hasNext = false;
+            std::swap(m_payload, m_nextPayload);
+        } else if (takeNext(job)) {
+            // A prepared Bulk job waits in m_nextPayload for this one
+            if (!prepare(job, m_payload)) {
+                continue;
+            }
+        } else {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        execute(job, next, hasNext);
+    }
+}
+
+bool BackendIoTask::takeNext(BackendJob& job) {
+    for (auto& queue : m_queues) {
+        if (xQueueReceive(queue, &job, 0) == pdTRUE) {
+            s_queueDepth.add(-1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BackendIoTask::prepare(const BackendJob& job, std::string& payload) {
+    payload.clear();
+    const char* buffer      = payload.data();
+    size_t      bufferBytes = heapBytes(payload);
+    bool        prepared = !job.prepare || job.prepare(job.context, payload);
+    // Jobs usually assign a freshly composed string
+    if (payload.data() != buffer) {
+        s_payloadAllocs.replaced(bufferBytes, heapBytes(payload));
+    }
+    if (!prepared) {
+        ++m_dropped;
+    }
+    return prepared;
+}
+
+void BackendIoTask::execute(const BackendJob& job,
+                            BackendJob&       next,
+                            bool&             hasNext) {
+    RestClientResponse response{};
+    response.err = m_client.beginPost(job.endpoint, m_payload, job.priority);
+    if (response.err == ESP_OK) {
+        while (!m_client.pollPost(response)) {
+            if (!hasNext && takeNext(next)) {
+                hasNext = prepare(next, m_nextPayload);
+                if (hasNext) {
+                    ++m_overlapped;
+                }
+                continue;
+            }
+            // Woken early by submit(), otherwise polls again next tick
+            ulTaskNotifyTake(pdTRUE, 1);
+        }
+    }
+    if (job.complete) {
+        job.complete(job.context, response);
+    }
+    ++m_completed;
+}
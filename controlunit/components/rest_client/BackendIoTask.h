@@ -0,0 +1,151 @@
+/**
+ * @file BackendIoTask.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief One task that drives all backend requests through the RestClient
+ *
+ * Components submit a BackendJob instead of running their own HTTP task.
+ * The task takes jobs in priority order, Command before Bulk, and calls
+ * back into the job twice:
+ *
+ * - prepare() right before the job is sent, to build the payload. Returning
+ *   false drops the job without sending anything
+ * - complete() with the response, also when the request never went out
+ *   (open circuit, client busy)
+ *
+ * While a request is in flight the task prepares the next queued job, so
+ * building a large payload overlaps with waiting for the backend.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "RestClient.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <string>
+
+/**
+ * @brief A request to the backend and the callbacks around it. Copied into
+ * a queue, so everything it points to must outlive the job.
+ */
+struct BackendJob {
+    const char*     endpoint = nullptr; /**< Relative path of the POST */
+    RequestPriority priority = RequestPriority::Bulk;
+    bool (*prepare)(void* context, std::string& payload) = nullptr;
+    void (*complete)(void* context, const RestClientResponse& response) =
+        nullptr;
+    void* context = nullptr; /**< Passed to both callbacks */
+};
+
+/**
+ * @brief Counters since start, for logging and metrics
+ */
+struct BackendIoStats {
+    uint32_t submitted;  /**< Jobs accepted by submit() */
+    uint32_t rejected;   /**< Jobs refused because the queue was full */
+    uint32_t dropped;    /**< Jobs whose prepare() returned false */
+    uint32_t completed;  /**< Jobs whose complete() was called */
+    uint32_t overlapped; /**< Jobs prepared while another was in flight */
+};
+
+/**
+ * @class BackendIoTask
+ * @brief FreeRTOS task owning all backend traffic of the Control Unit
+ */
+class BackendIoTask {
+  public:
+    /**
+     * @brief Constructs the task around an initialized client.
+     *
+     * @param client REST client the requests are sent with.
+     * @param queueLength Jobs that can wait per priority class.
+     */
+    explicit BackendIoTask(RestClient& client, size_t queueLength = 4);
+
+    /**
+     * @brief Stops the task, see stop().
+     */
+    ~BackendIoTask();
+
+    /**
+     * @brief Creates the queues and the FreeRTOS task.
+     *
+     * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the queues or
+     * the task could not be created.
+     */
+    esp_err_t start();
+
+    /**
+     * @brief Lets the request in flight finish and ends the task. Jobs not
+     * sent yet are never completed. Stop everything that submits first.
+     */
+    void stop();
+
+    /**
+     * @brief Queues a job without blocking. Safe to call from any task and
+     * from esp_timer callbacks.
+     *
+     * @return true if the job was queued, false if its queue is full or the
+     * task is not running.
+     */
+    bool submit(const BackendJob& job);
+
+    /**
+     * @brief Returns the job counters.
+     */
+    BackendIoStats stats() const;
+
+  private:
+    static constexpr size_t PRIORITY_CLASSES = 2;
+
+    static void taskEntry(void* pvParameters);
+
+    /**
+     * @brief Main loop, runs jobs until stop() is called.
+     */
+    void run();
+
+    /**
+     * @brief Takes the next job from the queues, Command first.
+     */
+    bool takeNext(BackendJob& job);
+
+    /**
+     * @brief Calls prepare() of a job, counts it if it is dropped.
+     */
+    bool prepare(const BackendJob& job, std::string& payload);
+
+    /**
+     * @brief Sends m_payload for job and, unless hasNext is already set,
+     * prepares the next job into m_nextPayload meanwhile.
+     *
+     * @param next Set to the prepared job.
+     * @param hasNext Set to true once next is prepared.
+     */
+    void execute(const BackendJob& job, BackendJob& next, bool& hasNext);
+
+    RestClient&       m_client;
+    size_t            m_queueLength;
+    QueueHandle_t     m_queues[PRIORITY_CLASSES] = {};
+    SemaphoreHandle_t m_stopped    = nullptr; /**< Given when run() ends */
+    TaskHandle_t      m_taskHandle = nullptr;
+    std::atomic<bool> m_stopping{false};
+
+    // Only touched by the task, kept between jobs to reuse their capacity
+    std::string m_payload;     /**< Payload of the job in flight */
+    std::string m_nextPayload; /**< Payload prepared for the next job */
+
+    std::atomic<uint32_t> m_submitted{0};
+    std::atomic<uint32_t> m_rejected{0};
+    std::atomic<uint32_t> m_dropped{0};
+    std::atomic<uint32_t> m_completed{0};
+    std::atomic<uint32_t> m_overlapped{0};
+
+    static constexpr const char* TAG = "BackendIoTask";
+};
@@ -0,0 +1,77 @@
+/**
+ * @file CircuitBreaker.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the per endpoint circuit breaker
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "CircuitBreaker.h"
+#include <algorithm>
+
+CircuitBreaker::CircuitBreaker(const CircuitBreakerConfig& config)
+    : m_config{config}, m_openUs{config.openUs} {
+    m_config.failureThreshold = std::max<uint32_t>(config.failureThreshold, 1);
+}
+
+bool CircuitBreaker::allowRequest(uint64_t nowUs) {
+    switch (m_state) {
+        case State::Closed:
+            return true;
+        case State::Open:
+            if (nowUs - m_openedAtUs < m_openUs) {
+                return false;
+            }
+            m_state         = State::HalfOpen;
+            m_probeInFlight = true;
+            return true;
+        case State::HalfOpen:
+            if (m_probeInFlight) {
+                return false;
+            }
+            m_probeInFlight = true;
+            return true;
+    }
+    return false;
+}
+
+void CircuitBreaker::onSuccess() {
+    m_state         = State::Closed;
+    m_failures      = 0;
+    m_openUs        = m_config.openUs;
+    m_probeInFlight = false;
+}
+
+void CircuitBreaker::onFailure(uint64_t nowUs) {
+    if (m_state == State::HalfOpen) {
+        // The probe failed, stay away twice as long
+        m_openUs = std::min(m_openUs * 2, m_config.maxOpenUs);
+    } else if (++m_failures < m_config.failureThreshold) {
+        return;
+    }
+    if (m_state != State::Open) {
+        ++m_trips;
+    }
+    m_state         = State::Open;
+    m_openedAtUs    = nowUs;
+    m_probeInFlight = false;
+}
+
+void CircuitBreaker::onAbandoned() {
+    m_probeInFlight = false;
+}
+
+const char* circuitStateToString(CircuitBreaker::State state) {
+    switch (state) {
+        case CircuitBreaker::State::Closed:
+            return "closed";
+        case CircuitBreaker::State::Open:
+            return "open";
+        case CircuitBreaker::State::HalfOpen:
+            return "half_open";
+    }
+    return "unknown";
+}
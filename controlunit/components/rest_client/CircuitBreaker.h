@@ -0,0 +1,86 @@
+/**
+ * @file CircuitBreaker.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Per endpoint circuit breaker used by RestClient
+ *
+ * - Closed: requests go through, consecutive failures are counted
+ * - Open: after failureThreshold failures in a row requests are rejected
+ *   without touching the network until the open time has passed
+ * - Half open: one probe request is let through. Success closes the
+ *   circuit, failure opens it again for twice as long, up to maxOpenUs
+ *
+ * Plain logic, the caller passes the time and serializes the calls.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Settings for a CircuitBreaker, times in microseconds
+ */
+struct CircuitBreakerConfig {
+    uint32_t failureThreshold = 3;           /**< Failures in a row to open */
+    uint64_t openUs           = 30'000'000;  /**< First open time */
+    uint64_t maxOpenUs        = 300'000'000; /**< Longest open time */
+};
+
+/**
+ * @class CircuitBreaker
+ * @brief Closed, open and half open states for one endpoint
+ */
+class CircuitBreaker {
+  public:
+    enum class State { Closed, Open, HalfOpen };
+
+    explicit CircuitBreaker(const CircuitBreakerConfig& config = {});
+
+    /**
+     * @brief Returns true if a request may be sent now
+     *
+     * Moves an open circuit to half open once the open time has passed and
+     * then lets exactly one probe through until its result is reported.
+     *
+     * @param nowUs Current time, e.g. esp_timer_get_time()
+     */
+    bool allowRequest(uint64_t nowUs);
+
+    /**
+     * @brief Reports a successful request, closes the circuit
+     */
+    void onSuccess();
+
+    /**
+     * @brief Reports a failed request, may open the circuit
+     *
+     * @param nowUs Time the request failed
+     */
+    void onFailure(uint64_t nowUs);
+
+    /**
+     * @brief Reports an allowed request that was never sent, so a half open
+     * circuit can let the next probe through
+     */
+    void onAbandoned();
+
+    State    state() const { return m_state; }
+    uint32_t trips() const { return m_trips; } /**< Times it opened */
+
+  private:
+    CircuitBreakerConfig m_config;
+    State                m_state         = State::Closed;
+    uint32_t             m_failures      = 0;
+    uint32_t             m_trips         = 0;
+    uint64_t             m_openedAtUs    = 0;
+    uint64_t             m_openUs        = 0;
+    bool                 m_probeInFlight = false;
+};
+
+/**
+ * @brief Returns the state as a lowercase string for logs and metrics
+ */
+const char* circuitStateToString(CircuitBreaker::State state);
@@ -8,6 +8,13 @@
  * base URL, TLS, JWT token, and timeout settings
  * It uses the bundled TLS certificates that ESP-IDF provides
  *
+ * Tasks hand the client over to each other through one binary semaphore per
+ * priority class, the mutex only guards the short bookkeeping around it.
+ * Only the task that owns the client touches the response buffer.
+ *
+ * Requests, waits, wait timeouts and circuit rejects are exported per
+ * priority class as cu_backend_* metrics with a `class` label.
+ *
  * @date 2025-10-07
  *
  * @copyright Copyright (c) 2025 Erik Dahl
@@ -15,11 +22,58 @@
  *
  */
 #include "RestClient.h"
+#include "LogRateLimit.h"
+#include "Metrics.h"
+#include "esp_timer.h"
+#include <algorithm>
+
+/// Wait for the shared client, from free to twice the request timeout
+static constexpr uint32_t WAIT_BOUNDS_US[] = {
+    1'000, 10'000, 50'000, 100'000, 250'000, 500'000, 1'000'000,
+    2'500'000, 5'000'000, 10'000'000};
+
+/**
+ * @brief Metrics of one priority class, shared by all clients
+ */
+struct RequestClassMetrics {
+    explicit RequestClassMetrics(const char* labels)
+        : requests{"cu_backend_requests_total",
+                   "Backend requests that got the client",
+                   labels},
+          waitTimeouts{"cu_backend_wait_timeouts_total",
+                       "Backend requests that gave up waiting for the client",
+                       labels},
+          circuitRejects{"cu_backend_circuit_rejects_total",
+                         "Backend requests rejected by an open circuit",
+                         labels},
+          wait{"cu_backend_wait_seconds",
+               "Time waiting for the client before a backend request",
+               WAIT_BOUNDS_US,
+               MICROS_TO_SECONDS,
+               labels},
+          maxWait{"cu_backend_wait_max_seconds",
+                  "Longest wait for the client since start",
+                  MICROS_TO_SECONDS,
+                  labels} {}
+
+    Counter   requests;
+    Counter   waitTimeouts;
+    Counter   circuitRejects;
+    Histogram wait;
+    Gauge     maxWait;
+};
+
+/// Indexed by RequestPriority
+static RequestClassMetrics s_classMetrics[] = {
+    RequestClassMetrics{"class=\"command\""},
+    RequestClassMetrics{"class=\"bulk\""}};
 
 RestClient::RestClient(const std::string& baseUrl,
                        const std::string& jwtToken,
-                       int                timeoutMs)
-    : m_baseUrl(baseUrl), m_jwtToken{jwtToken}, m_timeout(timeoutMs) {}
+                       int                timeoutMs,
+                       size_t             maxResponseBytes)
+    : m_baseUrl(baseUrl), m_jwtToken{jwtToken}, m_timeout(timeoutMs),
+      m_maxResponseBytes{maxResponseBytes} {}
 
 esp_err_t RestClient::init() {
 
@@ -27,6 +81,13 @@ esp_err_t RestClient::init() {
     if (m_mutex == nullptr) {
         ESP_LOGE(TAG, "Failed to create mutex");
     }
+    for (auto& turn : m_turn) {
+        turn = xSemaphoreCreateBinary();
+        if (turn == nullptr) {
+            ESP_LOGE(TAG, "Failed to create semaphore");
+        }
+    }
+    m_responseBody.reserve(m_maxResponseBytes);
 
     esp_http_client_config_t config = {};
     config.url                      = m_baseUrl.c_str();
@@ -36,6 +97,7 @@ esp_err_t RestClient::init() {
     config.crt_bundle_attach        = esp_crt_bundle_attach;
     config.event_handler            = &RestClient::httpEventHandler;
     config.user_data                = this;
+    config.is_async                 = true; // postTo() polls until done
 
     m_client = esp_http_client_init(&config);
     if (!m_client) {
@@ -61,16 +123,25 @@ esp_err_t RestClient::httpEventHandler(esp_http_client_event_t *evt) {
     auto* self = static_cast<RestClient*>(evt->user_data);
 
     switch (evt->event_id) {
-        case HTTP_EVENT_ON_DATA:
-            if (!esp_http_client_is_chunked_response(evt->client)) {
-                self->m_responseBody.append(static_cast<const char*>(evt->data), evt->data_len);
+        case HTTP_EVENT_ON_DATA: {
+            // Chunked bodies arrive here already de-chunked, same as plain
+            const char* data = static_cast<const char*>(evt->data);
+            size_t      len  = static_cast<size_t>(evt->data_len);
+            self->m_responseBytes += len;
+            if (self->m_handler.onData) {
+                self->m_handler.onData(self->m_handler.context, data, len);
+                break;
             }
+            size_t room =
+                self->m_maxResponseBytes - self->m_responseBody.size();
+            self->m_responseBody.append(data, std::min(len, room));
             break;
+        }
         case HTTP_EVENT_ON_FINISH:
-            ESP_LOGI(TAG, "Full response: %s", self->m_responseBody.c_str());
+            ESP_LOGV(TAG, "Full response: %s", self->m_responseBody.c_str());
             break;
         case HTTP_EVENT_ERROR:
-            ESP_LOGE(TAG, "HTTP error occurred");
+            CU_LOGE_RATELIMITED(TAG, LOG_RATE_LIMIT_MS, "HTTP error occurred");
             break;
         default:
             break;
@@ -79,47 +150,228 @@ esp_err_t RestClient::httpEventHandler(esp_http_client_event_t *evt) {
 }
 
 
-RestClientResponse RestClient::postTo(const std::string& endpoint,
-                                      const std::string& payload) {
+bool RestClient::acquire(RequestPriority priority, TickType_t maxWait) {
+    size_t cls = static_cast<size_t>(priority);
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    bool higherWaiting = false;
+    for (size_t i = 0; i <= cls; ++i) {
+        higherWaiting |= m_waiting[i] > 0;
+    }
+    if (!m_busy && !higherWaiting) {
+        m_busy = true;
+        xSemaphoreGive(m_mutex);
+        return true;
+    }
+    ++m_waiting[cls];
+    xSemaphoreGive(m_mutex);
+
+    if (xSemaphoreTake(m_turn[cls], maxWait) == pdTRUE) {
+        return true;
+    }
+    // Timed out, but release() may have handed over the client right after
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    bool handedOver = xSemaphoreTake(m_turn[cls], 0) == pdTRUE;
+    if (!handedOver) {
+        --m_waiting[cls];
+    }
+    xSemaphoreGive(m_mutex);
+    return handedOver;
+}
+
+void RestClient::release() {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    for (size_t cls = 0; cls < PRIORITY_CLASSES; ++cls) {
+        if (m_waiting[cls] > 0) {
+            // Stays busy, ownership passes straight to the waiter
+            --m_waiting[cls];
+            xSemaphoreGive(m_turn[cls]);
+            xSemaphoreGive(m_mutex);
+            return;
+        }
+    }
+    m_busy = false;
+    xSemaphoreGive(m_mutex);
+}
+
+RestClientResponse RestClient::postTo(const std::string&     endpoint,
+                                      const std::string&     payload,
+                                      RequestPriority        priority,
+                                      const ResponseHandler& handler) {
+    RestClientResponse response{};
+    response.err = beginPost(endpoint, payload, priority, handler);
+    if (response.err != ESP_OK) {
+        return response;
+    }
+    while (!pollPost(response)) {
+        vTaskDelay(1);
+    }
+    return response;
+}
+
+esp_err_t RestClient::beginPost(const std::string&     endpoint,
+                                const std::string&     payload,
+                                RequestPriority        priority,
+                                const ResponseHandler& handler) {
     if (!m_mutex) {
-        return {ESP_ERR_INVALID_STATE, ""};
+        return ESP_ERR_INVALID_STATE;
     }
-    m_responseBody.clear();
+    size_t               cls     = static_cast<size_t>(priority);
+    RequestClassStats&   stats   = m_stats[cls];
+    RequestClassMetrics& metrics = s_classMetrics[cls];
+
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    CircuitBreaker& breaker = m_breakers[endpoint];
+    if (!breaker.allowRequest(esp_timer_get_time())) {
+        ++stats.circuitRejects;
+        metrics.circuitRejects.add();
+        xSemaphoreGive(m_mutex);
+        CU_LOGW_RATELIMITED(TAG,
+                            LOG_RATE_LIMIT_MS,
+                            "Circuit open, not posting to %s",
+                            endpoint.c_str());
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreGive(m_mutex);
 
-    ESP_LOGI(TAG, "Free heap: %u", esp_get_free_heap_size());
+    int waitMs =
+        priority == RequestPriority::Command ? m_timeout : 2 * m_timeout;
+    uint64_t waitStart = esp_timer_get_time();
+    bool     acquired  = acquire(priority, pdMS_TO_TICKS(waitMs));
+    uint64_t waitedUs  = esp_timer_get_time() - waitStart;
 
-    // Mutex protected
-    ESP_LOGI(TAG, "Taking mutex for POST to %s", endpoint.c_str());
-    if (xSemaphoreTake(m_mutex, portMAX_DELAY) != pdTRUE) {
-        // This will almost never happen since portMAX_DELAY waits forever
-        return {ESP_ERR_TIMEOUT, ""};
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    stats.totalWaitUs += waitedUs;
+    if (waitedUs > stats.maxWaitUs) {
+        stats.maxWaitUs = waitedUs;
+    }
+    metrics.wait.observe(static_cast<uint32_t>(waitedUs));
+    if (waitedUs > static_cast<uint64_t>(metrics.maxWait.value())) {
+        metrics.maxWait.set(static_cast<int32_t>(waitedUs));
+    }
+    if (!acquired) {
+        ++stats.waitTimeouts;
+        metrics.waitTimeouts.add();
+        breaker.onAbandoned();
+    } else {
+        ++stats.requests;
+        metrics.requests.add();
     }
+    xSemaphoreGive(m_mutex);
+    if (!acquired) {
+        CU_LOGW_RATELIMITED(TAG,
+                            LOG_RATE_LIMIT_MS,
+                            "Client busy for %d ms, giving up POST to %s",
+                            waitMs,
+                            endpoint.c_str());
+        return ESP_ERR_TIMEOUT;
+    }
+
+    // Owning the client from here on, the state below is ours
+    m_responseBody.clear();
+    m_responseBytes = 0;
+    m_handler       = handler;
+    m_endpoint      = endpoint;
+    m_breaker       = &breaker; // map nodes do not move
+    m_sentAtUs      = esp_timer_get_time();
     std::string full_url = m_baseUrl + endpoint;
     esp_http_client_set_method(m_client, HTTP_METHOD_POST);
     esp_http_client_set_url(m_client, full_url.c_str());
 
     esp_http_client_set_post_field(m_client, payload.c_str(), payload.length());
+    return ESP_OK;
+}
+
+bool RestClient::pollPost(RestClientResponse& response) {
+    esp_err_t err = esp_http_client_perform(m_client);
+    if (err == ESP_ERR_HTTP_EAGAIN) {
+        return false;
+    }
+    finishPost(err, response);
+    return true;
+}
+
+void RestClient::finishPost(esp_err_t err, RestClientResponse& response) {
+    int      status    = esp_http_client_get_status_code(m_client);
+    uint64_t latencyUs = esp_timer_get_time() - m_sentAtUs;
 
-    esp_err_t   err            = esp_http_client_perform(m_client);
-    int         status         = esp_http_client_get_status_code(m_client);
-        
     esp_http_client_close(
         m_client); // Close the socket but not the client itself
-    xSemaphoreGive(m_mutex);
+    // Copy while owning the client, the next POST clears the body
+    std::string     body      = m_responseBody;
+    size_t          bodyBytes = m_responseBytes;
+    bool            streamed  = m_handler.onData != nullptr;
+    std::string     endpoint  = std::move(m_endpoint);
+    CircuitBreaker& breaker   = *m_breaker;
+    m_handler                 = {};
+    m_breaker                 = nullptr;
+    release();
 
-    if (err == ESP_OK) {
-        ESP_LOGI(TAG, "Response %d from %s", status, endpoint.c_str());
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    if (err != ESP_OK || status >= 500) {
+        breaker.onFailure(esp_timer_get_time());
+        if (breaker.state() == CircuitBreaker::State::Open) {
+            ESP_LOGW(TAG, "Circuit for %s opened", endpoint.c_str());
+        }
     } else {
+        breaker.onSuccess();
+    }
+    xSemaphoreGive(m_mutex);
+
+    if (err == ESP_OK && !streamed && bodyBytes > body.size()) {
         ESP_LOGE(TAG,
-                 "Error at POST to %s: %s",
+                 "Response from %s is %zu bytes, buffer holds %zu",
+                 endpoint.c_str(),
+                 bodyBytes,
+                 m_maxResponseBytes);
+        err = ESP_ERR_INVALID_SIZE;
+    } else if (err == ESP_OK) {
+        ESP_LOGD(TAG,
+                 "Response %d from %s in %llu ms",
+                 status,
                  endpoint.c_str(),
-                 esp_err_to_name(err));
-    }    
-    return {err, m_responseBody};
+                 latencyUs / 1000);
+    } else {
+        CU_LOGE_RATELIMITED(TAG,
+                            LOG_RATE_LIMIT_MS,
+                            "Error at POST to %s: %s",
+                            endpoint.c_str(),
+                            esp_err_to_name(err));
+    }
+    response = {err, std::move(body), status, bodyBytes, latencyUs};
+}
+
+RequestClassStats RestClient::classStats(RequestPriority priority) const {
+    RequestClassStats stats{};
+    if (m_mutex && xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        stats = m_stats[static_cast<size_t>(priority)];
+        xSemaphoreGive(m_mutex);
+    }
+    return stats;
+}
+
+CircuitBreaker::State
+RestClient::circuitState(const std::string& endpoint) const {
+    CircuitBreaker::State state = CircuitBreaker::State::Closed;
+    if (m_mutex && xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        auto it = m_breakers.find(endpoint);
+        if (it != m_breakers.end()) {
+            state = it->second.state();
+        }
+        xSemaphoreGive(m_mutex);
+    }
+    return state;
 }
 
 RestClient::~RestClient() {
     if (m_client) {
         esp_http_client_cleanup(m_client);
     }
+    for (auto& turn : m_turn) {
+        if (turn) {
+            vSemaphoreDelete(turn);
+        }
+    }
+    if (m_mutex) {
+        vSemaphoreDelete(m_mutex);
+    }
 }
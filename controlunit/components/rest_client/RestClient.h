@@ -8,6 +8,19 @@
  * Provides a simple wrapper around the ESP-IDF HTTPS client for sending
  * JSON payloads to a remote server using HTTPS POST
  *
+ * The client is shared between tasks. Requests wait for it in two priority
+ * classes, roster commands go ahead of bulk uploads, and give up after a
+ * bounded wait. Every endpoint has a CircuitBreaker so a dead backend is
+ * not hammered on every tick.
+ *
+ * Response bodies go into a buffer that is allocated once in init() and
+ * never grows. Callers expecting larger bodies pass a ResponseHandler and
+ * get the body streamed to them instead, chunked or not.
+ *
+ * The client runs esp_http_client in async mode. postTo() blocks until the
+ * response is in, beginPost() and pollPost() let one task (BackendIoTask)
+ * do other work while a request is in flight.
+ *
  * @date 2025-10-07
  *
  * @copyright Copyright (c) 2025 Erik Dahl
@@ -15,15 +28,49 @@
  *
  */
 #pragma once
+#include "CircuitBreaker.h"
 #include "esp_crt_bundle.h"
 #include "esp_http_client.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
+#include <map>
 #include <string>
 
 struct RestClientResponse {
   esp_err_t err;
   std::string payload;
+  int status = 0; /**< HTTP status, 0 if no response */
+  size_t bodyBytes = 0; /**< Body size received, also when streamed */
+  uint64_t latencyUs = 0; /**< From sending the request to the response */
+};
+
+/**
+ * @brief Streaming hook for response bodies, called for every piece of the
+ * body as it arrives, already de-chunked. Runs in the task driving the
+ * request.
+ */
+struct ResponseHandler {
+    void (*onData)(void* context, const char* data, size_t len) = nullptr;
+    void* context = nullptr;
+};
+
+/**
+ * @brief Priority classes for requests waiting for the shared client
+ */
+enum class RequestPriority : uint8_t {
+    Command = 0, /**< Small and latency sensitive, e.g. roster polls */
+    Bulk    = 1, /**< Large uploads that can wait, e.g. readings */
+};
+
+/**
+ * @brief Counters for one priority class
+ */
+struct RequestClassStats {
+    uint32_t requests;       /**< Requests sent */
+    uint32_t waitTimeouts;   /**< Gave up waiting for the client */
+    uint32_t circuitRejects; /**< Rejected by an open circuit */
+    uint64_t totalWaitUs;    /**< Time spent waiting for the client */
+    uint64_t maxWaitUs;      /**< Longest wait for the client */
 };
 
 /**
@@ -42,10 +89,12 @@ class RestClient {
      * @param baseUrl Base URL of the remote server.
      * @param jwtToken JWT token for authorization
      * @param timeoutMs Timeout for HTTPS requests in milliseconds.
+     * @param maxResponseBytes Size of the response buffer.
      */
     RestClient(const std::string& baseUrl,
                const std::string& jwtToken,
-               int                timeoutMs = 5000);
+               int                timeoutMs        = 5000,
+               size_t             maxResponseBytes = 1024);
 
     /**
      * @brief Cleans up the internal HTTPS client.
@@ -81,16 +130,89 @@ class RestClient {
      * as a string. If no body is present or an error occurs during reading, 
      * the response string will be empty.
      * 
-     * Mutex protected for safe calling from different tasks
+     * Safe to call from different tasks. Waits for the client at most the
+     * HTTP timeout for Command and twice that for Bulk requests, Command
+     * requests are served first when both are waiting.
      *
      * @param endpoint Relative path to the target endpoint.
      * @param payload JSON-formatted string to be sent in the request body.
+     * @param priority Priority class of the request.
+     * @param handler Optional streaming hook. When set the body is passed to
+     * it instead of being buffered and the payload is left empty.
      * @return RestClientResponse containing the result code, ESP_OK on success, 
-     * and response body (if any).
+     * and response body (if any). ESP_ERR_TIMEOUT if the client did not get
+     * free in time, ESP_ERR_INVALID_STATE if the endpoint's circuit is open,
+     * ESP_ERR_INVALID_SIZE if the body did not fit in the response buffer.
      */
-    RestClientResponse postTo(const std::string& endpoint, const std::string& payload);
+    RestClientResponse postTo(const std::string& endpoint,
+                              const std::string& payload,
+                              RequestPriority priority = RequestPriority::Bulk,
+                              const ResponseHandler& handler = {});
+
+    /**
+     * @brief Starts a POST and returns without waiting for the response.
+     *
+     * Same circuit check and bounded wait for the client as postTo(). On
+     * ESP_OK the caller owns the client and must call pollPost() from the
+     * same task until it returns true.
+     *
+     * @param endpoint Relative path to the target endpoint.
+     * @param payload Request body, must stay valid until pollPost() returns
+     * true.
+     * @param priority Priority class of the request.
+     * @param handler Optional streaming hook, see postTo().
+     * @return esp_err_t ESP_OK if the request was started, otherwise the same
+     * errors as postTo() and no pollPost() is needed.
+     */
+    esp_err_t beginPost(const std::string&     endpoint,
+                        const std::string&     payload,
+                        RequestPriority        priority = RequestPriority::Bulk,
+                        const ResponseHandler& handler  = {});
+
+    /**
+     * @brief Drives the request started by beginPost() a step further.
+     *
+     * @param response Filled in once the request is done, same contents as
+     * postTo() returns.
+     * @return true when the request is done and the client is released,
+     * false while it is still in flight.
+     */
+    bool pollPost(RestClientResponse& response);
+
+    /**
+     * @brief Returns the counters of a priority class for this client.
+     *
+     * The same counts are exported for all clients as cu_backend_* metrics.
+     */
+    RequestClassStats classStats(RequestPriority priority) const;
+
+    /**
+     * @brief Returns the circuit state of an endpoint, closed if it has not
+     * been used yet.
+     */
+    CircuitBreaker::State circuitState(const std::string& endpoint) const;
 
   private:
+    static constexpr size_t PRIORITY_CLASSES = 2;
+
+    /**
+     * @brief Waits until the client is free and this request is next.
+     *
+     * @return true if the caller now owns the client.
+     */
+    bool acquire(RequestPriority priority, TickType_t maxWait);
+
+    /**
+     * @brief Hands the client to the highest priority waiter, or frees it.
+     */
+    void release();
+
+    /**
+     * @brief Releases the client, updates the circuit and fills response
+     * once the request in flight is done.
+     */
+    void finishPost(esp_err_t err, RestClientResponse& response);
+
   static esp_err_t httpEventHandler(esp_http_client_event_t *evt);
     std::string m_baseUrl; /**< Base URL of the remote server. */
     std::string
@@ -98,8 +220,19 @@ class RestClient {
     esp_http_client_handle_t
         m_client;  /**< Handle to the ESP-IDF HTTP client. */
     int m_timeout; /**< Timeout for HTTP requests in milliseconds. */
-    mutable SemaphoreHandle_t m_mutex = nullptr;
-    std::string m_responseBody;
+    mutable SemaphoreHandle_t m_mutex = nullptr; /**< Guards the state below */
+    SemaphoreHandle_t m_turn[PRIORITY_CLASSES] = {}; /**< Hand over per class */
+    bool     m_busy = false; /**< A request owns the client */
+    uint32_t m_waiting[PRIORITY_CLASSES]    = {};
+    RequestClassStats m_stats[PRIORITY_CLASSES] = {};
+    std::map<std::string, CircuitBreaker> m_breakers;
+    size_t      m_maxResponseBytes; /**< Capacity of m_responseBody */
+    std::string m_responseBody;     /**< Reserved once, never grows */
+    size_t      m_responseBytes = 0; /**< Body bytes of the current request */
+    ResponseHandler m_handler;       /**< Hook of the current request */
+    std::string     m_endpoint;      /**< Endpoint of the current request */
+    CircuitBreaker* m_breaker = nullptr; /**< Circuit of the current request */
+    uint64_t        m_sentAtUs = 0;  /**< When the current request started */
     static constexpr const char* TAG =
         "RestClient"; /**< Logging tag for ESP_LOG macros. */
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+/**
+ * @brief Test file for CircuitBreaker.cpp
+ *
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "CircuitBreaker.h"
+
+static constexpr uint64_t SECOND = 1'000'000;
+
+static CircuitBreakerConfig testConfig() {
+    CircuitBreakerConfig config;
+    config.failureThreshold = 3;
+    config.openUs           = 10 * SECOND;
+    config.maxOpenUs        = 30 * SECOND;
+    return config;
+}
+
+static void failTimes(CircuitBreaker& breaker, int times, uint64_t nowUs) {
+    for (int i = 0; i < times; ++i) {
+        TEST_ASSERT_TRUE(breaker.allowRequest(nowUs));
+        breaker.onFailure(nowUs);
+    }
+}
+
+extern "C" void when_failures_below_threshold_then_circuit_stays_closed(void) {
+    CircuitBreaker breaker(testConfig());
+    failTimes(breaker, 2, SECOND);
+    breaker.onSuccess();
+    failTimes(breaker, 2, SECOND);
+    TEST_ASSERT_TRUE(breaker.state() == CircuitBreaker::State::Closed);
+    TEST_ASSERT_TRUE(breaker.allowRequest(SECOND));
+}
+
+extern "C" void when_failures_reach_threshold_then_circuit_opens(void) {
+    CircuitBreaker breaker(testConfig());
+    failTimes(breaker, 3, SECOND);
+    TEST_ASSERT_TRUE(breaker.state() == CircuitBreaker::State::Open);
+    TEST_ASSERT_FALSE(breaker.allowRequest(10 * SECOND));
+    TEST_ASSERT_EQUAL_UINT32(1, breaker.trips());
+}
+
+extern "C" void when_open_time_passed_then_only_one_probe_is_allowed(void) {
+    CircuitBreaker breaker(testConfig());
+    failTimes(breaker, 3, SECOND);
+
+    TEST_ASSERT_TRUE(breaker.allowRequest(11 * SECOND));
+    TEST_ASSERT_TRUE(breaker.state() == CircuitBreaker::State::HalfOpen);
+    TEST_ASSERT_FALSE(breaker.allowRequest(11 * SECOND));
+
+    breaker.onSuccess();
+    TEST_ASSERT_TRUE(breaker.state() == CircuitBreaker::State::Closed);
+    TEST_ASSERT_TRUE(breaker.allowRequest(11 * SECOND));
+}
+
+extern "C" void when_probe_fails_then_open_time_doubles_up_to_max(void) {
+    CircuitBreaker breaker(testConfig());
+    failTimes(breaker, 3, 0);
+
+    TEST_ASSERT_TRUE(breaker.allowRequest(10 * SECOND));
+    breaker.onFailure(10 * SECOND);
+    TEST_ASSERT_FALSE(breaker.allowRequest(29 * SECOND));
+    TEST_ASSERT_TRUE(breaker.allowRequest(30 * SECOND));
+
+    breaker.onFailure(30 * SECOND);
+    TEST_ASSERT_FALSE(breaker.allowRequest(59 * SECOND));
+    TEST_ASSERT_TRUE(breaker.allowRequest(60 * SECOND));
+}
+
+extern "C" void when_probe_abandoned_then_next_probe_is_allowed(void) {
+    CircuitBreaker breaker(testConfig());
+    failTimes(breaker, 3, 0);
+
+    TEST_ASSERT_TRUE(breaker.allowRequest(10 * SECOND));
+    breaker.onAbandoned();
+    TEST_ASSERT_TRUE(breaker.allowRequest(10 * SECOND));
+}
@@ -16,17 +16,22 @@
 #include "RestServer.h"
 #include "ConnectHandler.h"
 #include "TimeHandler.h"
+#include "MetricsHandler.h"
 #include "ReadingsHandler.h"
+#include "ResourcesHandler.h"
+#include "TaskProfile.h"
 #include "esp_log.h"
 
 static const char* TAG = "RestServer";
 
 RestServer::RestServer(uint16_t           port,
                        TimeSyncManager&   timeSyncManager,
-                       SensorUnitManager& sensorUnitManager)
+                       SensorUnitManager& sensorUnitManager,
+                       ResourceMonitor*   resourceMonitor)
     : m_server(nullptr), m_config(HTTPD_DEFAULT_CONFIG()), m_port(port),
       m_timeSyncManager(timeSyncManager),
-      m_sensorUnitManager(sensorUnitManager) {}
+      m_sensorUnitManager(sensorUnitManager),
+      m_resourceMonitor(resourceMonitor) {}
 
 RestServer::~RestServer() {
     stop();
@@ -34,10 +39,18 @@ RestServer::~RestServer() {
 
 bool RestServer::start() {
     ESP_LOGI(TAG, "Starting REST server");
-    m_config.server_port = m_port;
+    m_config.server_port   = m_port;
+    m_config.task_priority = HTTP_SERVER_TASK.priority;
+    m_config.stack_size    = HTTP_SERVER_TASK.stackBytes;
+    m_config.core_id       = taskCore(HTTP_SERVER_TASK);
+    // Sensor units keep their connection open, the oldest gives way when full
+    m_config.lru_purge_enable = true;
 
     if (httpd_start(&m_server, &m_config) == ESP_OK) {
         registerHandlers();
+        // Not created by createTask(), so tracked here
+        m_task = xTaskGetHandle(HTTP_SERVER_TASK.name);
+        trackTask(HTTP_SERVER_TASK, m_task);
         ESP_LOGI(TAG, "Server started");
         return true;
     }
@@ -47,6 +60,10 @@ bool RestServer::start() {
 
 void RestServer::stop() {
     if (m_server) {
+        if (m_task) {
+            untrackTask(m_task);
+            m_task = nullptr;
+        }
         httpd_stop(m_server);
         m_server = nullptr;
         ESP_LOGI(TAG, "Server stopped");
@@ -71,4 +88,8 @@ void RestServer::registerHandlers() {
     registerHandler(std::make_unique<ConnectHandler>("/connect", m_sensorUnitManager));
     registerHandler(std::make_unique<TimeHandler>("/time", m_timeSyncManager));
     registerHandler(std::make_unique<ReadingsHandler>("/readings", m_sensorUnitManager));
+    registerHandler(std::make_unique<MetricsHandler>("/metrics"));
+    if (m_resourceMonitor) {
+        registerHandler(std::make_unique<ResourcesHandler>("/resources", *m_resourceMonitor));
+    }
 }
@@ -15,6 +15,7 @@
  */
 #pragma once
 #include "BaseHandler.h"
+#include "ResourceMonitor.h"
 #include "SensorUnitManager.h"
 #include "TimeSyncManager.h"
 #include "esp_http_server.h"
@@ -34,10 +35,12 @@ class RestServer {
      * @brief Constructs a RestServer instance.
      *
      * Initializes server configuration and prepares handler list.
+     * GET /resources is only served when a resourceMonitor is given.
      */
     RestServer(uint16_t           port,
                TimeSyncManager&   timeSyncManager,
-               SensorUnitManager& sensorUnitManager);
+               SensorUnitManager& sensorUnitManager,
+               ResourceMonitor*   resourceMonitor = nullptr);
     /**
      * @brief Destructor for RestServer.
      *
@@ -72,6 +75,7 @@ class RestServer {
 
     httpd_handle_t m_server; /**< Handle to the ESP-IDF HTTP server instance. */
     httpd_config_t m_config; /**< Configuration for the HTTP server. */
+    TaskHandle_t   m_task = nullptr; /**< httpd task, tracked for its stack */
     uint16_t       m_port;   /**< Port for the HTTP server */
     std::vector<std::unique_ptr<BaseHandler>>
                      m_handlers; /**< List of registered route handlers. */
@@ -80,4 +84,6 @@ class RestServer {
     SensorUnitManager&
         m_sensorUnitManager; /**< SensorUnitManager dependency used by
                                 ConnectHandler and ReadingsHandler */
+    ResourceMonitor*
+        m_resourceMonitor; /**< Optional, used by ResourcesHandler */
 };
\ No newline at end of file
@@ -18,16 +18,18 @@
 #include "ConnectHandler.h"
 #include "JsonParser.h"
 #include "esp_log.h"
+#include <cinttypes>
 
 ConnectHandler::ConnectHandler(const std::string& uri,
-                               const SensorUnitManager& sensorUnitManager)
+                               SensorUnitManager& sensorUnitManager)
     : PostHandler(uri), m_sensorUnitManager(sensorUnitManager) {}
 
 esp_err_t ConnectHandler::processBody(httpd_req_t*       req,
                                       const std::string& body) {
-    ESP_LOGI(TAG, "Processing Sensorunit Connect Request");
+    ESP_LOGD(TAG, "Processing Sensorunit Connect Request");
 
     std::string status;
+    UploadSlot  slot;
     Uuid        sensorunitId = JsonParser::parseSensorunitConnectRequest(body);
 
     if (!sensorunitId.isValid()) {
@@ -35,16 +37,20 @@ esp_err_t ConnectHandler::processBody(httpd_req_t*       req,
         httpd_resp_set_status(req, "400 Bad Request");
         status = "invalid";
     } else if (m_sensorUnitManager.hasUnit(sensorunitId)) {
-        ESP_LOGI(
-            TAG, "Sensor Unit %s connected", sensorunitId.toString().c_str());
+        slot = m_sensorUnitManager.assignUploadSlot(sensorunitId);
+        ESP_LOGD(TAG,
+                 "Sensor Unit %s connected, uploads at %" PRIu32 " s of %" PRIu32,
+                 sensorunitId.toString().c_str(),
+                 slot.offsetS,
+                 slot.periodS);
         status = "connected";
     } else {
-        ESP_LOGI(
+        ESP_LOGD(
             TAG, "Sensor Unit %s pending", sensorunitId.toString().c_str());
         status = "pending";
     }
 
-    std::string payload = JsonParser::composeSensorunitStatusPayload(status);
+    std::string payload = JsonParser::composeSensorunitConnectPayload(status, slot);
 
     httpd_resp_set_type(req, "application/json");
     httpd_resp_send(req, payload.c_str(), HTTPD_RESP_USE_STRLEN);
@@ -6,7 +6,8 @@
  * Defines the ConnectHandler class, which handles incoming POST requests
  * containing sensor unit identifiers. It determines their connection status
  * using SensorUnitManager and responds with a JSON payload indicating
- * whether the unit is connected, pending, or invalid.
+ * whether the unit is connected, pending, or invalid. Connected units also
+ * get their upload window.
  * 
  * @date 2025-10-19
  * 
@@ -35,9 +36,10 @@ public:
     /**
      * @brief Constructs a ConnectHandler with a specific URI and sensor unit manager.
      * @param uri The URI this handler responds to.
-     * @param sensorUnitManager Reference to the sensor unit manager used for status lookup.
+     * @param sensorUnitManager Reference to the sensor unit manager used for status lookup
+     * and upload windows.
      */
-    ConnectHandler(const std::string& uri, const SensorUnitManager& sensorUnitManager);
+    ConnectHandler(const std::string& uri, SensorUnitManager& sensorUnitManager);
 
 protected:
     /**
@@ -54,6 +56,6 @@ protected:
     esp_err_t processBody(httpd_req_t* req, const std::string& body) override;
 
 private: 
-    const SensorUnitManager& m_sensorUnitManager;
+    SensorUnitManager& m_sensorUnitManager;
     static constexpr const char* TAG = "ConnectHandler"; /**< Logging tag for ESP_LOG macros. */
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+/**
+ * @file EndpointMetrics.cpp
+ * @brief Implementation of the per endpoint request metrics
+ *
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ */
+#include "EndpointMetrics.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <vector>
+
+/// Handler latency from a cached GET to a large readings batch, microseconds
+static constexpr uint32_t DURATION_BOUNDS_US[] = {
+    250, 500, 1'000, 2'500, 5'000, 10'000, 25'000, 50'000, 100'000, 250'000,
+    500'000, 1'000'000};
+
+/// Entries are never freed, metrics stay linked for the program lifetime
+static std::vector<EndpointMetrics*> s_endpoints;
+
+/// Created on first use, handlers are created after the scheduler started
+static SemaphoreHandle_t endpointsMutex() {
+    static SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+    return mutex;
+}
+
+EndpointMetrics::EndpointMetrics(std::string labels)
+    : m_labels{std::move(labels)},
+      m_requests{"cu_http_requests_total",
+                 "Requests handled by the REST server",
+                 m_labels.c_str()},
+      m_errors{"cu_http_request_errors_total",
+               "Requests the handler failed with an error",
+               m_labels.c_str()},
+      m_duration{"cu_http_request_duration_seconds",
+                 "Time from routing to the handler returning",
+                 DURATION_BOUNDS_US,
+                 MICROS_TO_SECONDS,
+                 m_labels.c_str()} {}
+
+EndpointMetrics& EndpointMetrics::forEndpoint(const char*        method,
+                                              const std::string& uri) {
+    std::string labels = std::string("method=\"") + method + "\",path=\"" +
+                         uri + "\"";
+    xSemaphoreTake(endpointsMutex(), portMAX_DELAY);
+    for (EndpointMetrics* endpoint : s_endpoints) {
+        if (endpoint->m_labels == labels) {
+            xSemaphoreGive(endpointsMutex());
+            return *endpoint;
+        }
+    }
+    auto* endpoint = new EndpointMetrics(std::move(labels));
+    s_endpoints.push_back(endpoint);
+    xSemaphoreGive(endpointsMutex());
+    return *endpoint;
+}
+
+void EndpointMetrics::record(int64_t startUs, bool failed) {
+    m_requests.add();
+    if (failed) {
+        m_errors.add();
+    }
+    m_duration.observe(static_cast<uint32_t>(esp_timer_get_time() - startUs));
+}
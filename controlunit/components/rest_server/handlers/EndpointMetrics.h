@@ -0,0 +1,51 @@
+/**
+ * @file EndpointMetrics.h
+ * @brief Request counters and latency histogram of one REST endpoint
+ *
+ * PostHandler and GetHandler record every request they handle. Entries are
+ * shared per method and path, so a handler created again after a server
+ * restart keeps counting into the same series.
+ *
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ */
+#pragma once
+#include "Metrics.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @class EndpointMetrics
+ * @brief cu_http_requests_total, cu_http_request_errors_total and
+ * cu_http_request_duration_seconds for one method and path
+ */
+class EndpointMetrics {
+  public:
+    /**
+     * @brief Returns the metrics of an endpoint, created on first use and
+     * kept for the lifetime of the program.
+     *
+     * @param method HTTP method label, e.g. "POST".
+     * @param uri Path label, e.g. "/readings".
+     */
+    static EndpointMetrics& forEndpoint(const char* method, const std::string& uri);
+
+    /**
+     * @brief Records a handled request.
+     *
+     * @param startUs esp_timer_get_time() when handling started.
+     * @param failed true if the handler returned an error.
+     */
+    void record(int64_t startUs, bool failed);
+
+  private:
+    explicit EndpointMetrics(std::string labels);
+
+    std::string m_labels; /**< Label pairs, declared first so it outlives the
+                             metrics pointing to it */
+    Counter     m_requests;
+    Counter     m_errors;
+    Histogram   m_duration;
+};
@@ -14,11 +14,13 @@
  */
 #include "GetHandler.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 static const char* TAG = "GetHandler";
 
 GetHandler::GetHandler(const std::string& uri) 
-    : m_uriString { uri } {
+    : m_uriString { uri },
+      m_metrics { EndpointMetrics::forEndpoint("GET", uri) } {
     m_uri = {
         .uri = m_uriString.c_str(),
         .method = HTTP_GET,
@@ -37,6 +39,9 @@ esp_err_t GetHandler::staticHandler(httpd_req_t* req) {
 }
 
 esp_err_t GetHandler::handle(httpd_req_t* req) {
-    ESP_LOGI(TAG, "Handling GET request for %s", m_uri.uri);
-    return process(req);
+    int64_t startUs = esp_timer_get_time();
+    ESP_LOGD(TAG, "Handling GET request for %s", m_uri.uri);
+    esp_err_t result = process(req);
+    m_metrics.record(startUs, result != ESP_OK);
+    return result;
 }
\ No newline at end of file
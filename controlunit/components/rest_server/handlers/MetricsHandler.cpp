@@ -0,0 +1,26 @@
+/**
+ * @file MetricsHandler.cpp
+ * @brief Implementation of GET /metrics endpoint
+ *
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ */
+#include "MetricsHandler.h"
+#include "Metrics.h"
+#include "esp_log.h"
+
+MetricsHandler::MetricsHandler(const std::string& uri) : GetHandler{uri} {}
+
+esp_err_t MetricsHandler::process(httpd_req_t* req) {
+    std::string payload;
+    payload.reserve(m_lastSize);
+    writePrometheus(payload);
+    m_lastSize = payload.size();
+
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+    httpd_resp_send(req, payload.data(), payload.size());
+    ESP_LOGD(TAG, "Sent %zu bytes of metrics", payload.size());
+    return ESP_OK;
+}
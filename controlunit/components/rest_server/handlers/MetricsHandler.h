@@ -0,0 +1,40 @@
+/**
+ * @file MetricsHandler.h
+ * @brief GET /metrics handler that returns every registered metric as
+ * Prometheus text
+ *
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ */
+#pragma once
+#include "GetHandler.h"
+#include <string>
+
+/**
+ * @class MetricsHandler
+ * @brief Handles GET /metrics requests.
+ */
+class MetricsHandler : public GetHandler {
+  public:
+    /**
+     * @brief Constructs a MetricsHandler for the specified URI.
+     * @param uri URI path to register (e.g., "/metrics").
+     */
+    explicit MetricsHandler(const std::string& uri);
+
+  protected:
+    /**
+     * @brief GET /metrics - Sends the output of writePrometheus()
+     * @param req Pointer to the HTTP request object.
+     * @return ESP_OK
+     */
+    esp_err_t process(httpd_req_t* req) override;
+
+  private:
+    size_t m_lastSize = 0; /**< Size of the previous scrape, reserved up
+                              front for the next one */
+    static constexpr const char* TAG =
+        "MetricsHandler"; /**< Logging tag for ESP_LOG macros. */
+};
@@ -14,12 +14,15 @@
  * @license MIT
  */
 #include "PostHandler.h"
+#include "LogRateLimit.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 static const char* TAG = "PostHandler";
 
 PostHandler::PostHandler(const std::string& uri) 
-    : m_uriString { uri } {
+    : m_uriString { uri },
+      m_metrics { EndpointMetrics::forEndpoint("POST", uri) } {
     m_uri = {
         .uri = m_uriString.c_str(),
         .method = HTTP_POST,
@@ -38,7 +41,8 @@ esp_err_t PostHandler::staticHandler(httpd_req_t* req) {
 }
 
 esp_err_t PostHandler::handle(httpd_req_t* req) {
-    ESP_LOGI(TAG, "Handling POST request for %s", m_uri.uri);
+    int64_t startUs = esp_timer_get_time();
+    ESP_LOGD(TAG, "Handling POST request for %s", m_uri.uri);
 
     int total_len = req->content_len;
     std::string body;
@@ -48,12 +52,16 @@ esp_err_t PostHandler::handle(httpd_req_t* req) {
     int remaining = total_len;
 
     while (remaining > 0) {
-        int to_read = remaining > sizeof(buf) ? sizeof(buf) : remaining;
+        int to_read = remaining > static_cast<int>(sizeof(buf))
+                          ? static_cast<int>(sizeof(buf))
+                          : remaining;
         int received = httpd_req_recv(req, buf, to_read);
 
         if (received <= 0) {
-            ESP_LOGE(TAG, "Failed to receive POST data");
+            CU_LOGE_RATELIMITED(
+                TAG, LOG_RATE_LIMIT_MS, "Failed to receive POST data");
             httpd_resp_send_500(req);
+            m_metrics.record(startUs, true);
             return ESP_FAIL;
         }
 
@@ -61,6 +69,8 @@ esp_err_t PostHandler::handle(httpd_req_t* req) {
         remaining -= received;
     }
 
-    ESP_LOGI(TAG, "Received body: %s", body.c_str());
-    return processBody(req, body);
+    ESP_LOGV(TAG, "Received %d bytes: %s", total_len, body.c_str());
+    esp_err_t result = processBody(req, body);
+    m_metrics.record(startUs, result != ESP_OK);
+    return result;
 }
\ No newline at end of file
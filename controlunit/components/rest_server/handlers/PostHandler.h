@@ -16,6 +16,7 @@
  */
 #pragma once
 #include "BaseHandler.h"
+#include "EndpointMetrics.h"
 #include "esp_http_server.h"
 #include <string>
 
@@ -62,6 +63,7 @@ class PostHandler : public BaseHandler {
     std::string m_uriString; /**< Stores the URI string to ensure ownership and
                                 lifetime. */
     httpd_uri_t m_uri;       /**< ESP-IDF URI configuration for this handler. */
+    EndpointMetrics& m_metrics; /**< Requests and latency of this route. */
     /**
      * @brief Static entry point for the POST handler.
      *
@@ -23,6 +23,7 @@
  */
 #include "ReadingsHandler.h"
 #include "JsonParser.h"
+#include "LogRateLimit.h"
 #include "esp_log.h"
 
 ReadingsHandler::ReadingsHandler(const std::string& uri,
@@ -31,20 +32,24 @@ ReadingsHandler::ReadingsHandler(const std::string& uri,
 
 esp_err_t ReadingsHandler::processBody(httpd_req_t*       req,
                                        const std::string& body) {
-    ESP_LOGI(TAG, "Processing Sensorunit Readings Request");
+    ESP_LOGD(TAG, "Processing Sensorunit Readings Request");
 
     std::string                         status{"connected"};
     std::vector<ca_sensorunit_snapshot> snapshots =
         JsonParser::parseSensorSnapshotGroup(body);
 
     if (snapshots.empty()) {
-        ESP_LOGW(TAG, "No readings present in post to /readings");
+        CU_LOGW_RATELIMITED(
+            TAG, LOG_RATE_LIMIT_MS, "No readings present in post to /readings");
         httpd_resp_set_status(req, "204 No Content");
+        // Sent even when empty, a kept-alive client waits for the response
+        httpd_resp_send(req, nullptr, 0);
         return ESP_OK;
     } else {
-        ESP_LOGI(TAG, "Posting %zu readings", snapshots.size());
+        ESP_LOGD(TAG, "Posting %zu readings", snapshots.size());
         if (!snapshots.at(0).uuid) {
-            ESP_LOGE(TAG, "Invalid Uuid in json Payload");
+            CU_LOGE_RATELIMITED(
+                TAG, LOG_RATE_LIMIT_MS, "Invalid Uuid in json Payload");
             httpd_resp_set_status(req, "400 Bad Request");
         } else {
             status = (m_sensorUnitManager.hasUnit(*snapshots.at(0).uuid))
@@ -53,7 +58,7 @@ esp_err_t ReadingsHandler::processBody(httpd_req_t*       req,
             for (const auto& snapshot : snapshots) {
                 m_sensorUnitManager.storeReading(snapshot);
             }
-            ESP_LOGI(TAG, "Sensor Unit status: %s", status.c_str());
+            ESP_LOGD(TAG, "Sensor Unit status: %s", status.c_str());
         }
     }
 
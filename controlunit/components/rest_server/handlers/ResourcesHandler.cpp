@@ -0,0 +1,25 @@
+/**
+ * @file ResourcesHandler.cpp
+ * @brief Implementation of GET /resources endpoint
+ *
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ */
+#include "ResourcesHandler.h"
+#include "JsonParser.h"
+#include "esp_log.h"
+
+ResourcesHandler::ResourcesHandler(const std::string& uri,
+                                   ResourceMonitor&   resourceMonitor)
+    : GetHandler{uri}, m_resourceMonitor{resourceMonitor} {}
+
+esp_err_t ResourcesHandler::process(httpd_req_t* req) {
+    std::string payload =
+        JsonParser::composeResourcesPayload(m_resourceMonitor.sample());
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, payload.c_str(), HTTPD_RESP_USE_STRLEN);
+    ESP_LOGD(TAG, "Sent %zu bytes of resources", payload.size());
+    return ESP_OK;
+}
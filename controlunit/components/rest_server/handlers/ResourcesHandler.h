@@ -0,0 +1,43 @@
+/**
+ * @file ResourcesHandler.h
+ * @brief GET /resources handler that returns task stacks, heap and
+ * component allocations as JSON
+ *
+ * Takes a fresh sample from ResourceMonitor on every request.
+ *
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ */
+#pragma once
+#include "GetHandler.h"
+#include "ResourceMonitor.h"
+#include <string>
+
+/**
+ * @class ResourcesHandler
+ * @brief Handles GET /resources requests.
+ */
+class ResourcesHandler : public GetHandler {
+  public:
+    /**
+     * @brief Constructs a ResourcesHandler for the specified URI.
+     * @param uri URI path to register (e.g., "/resources").
+     */
+    ResourcesHandler(const std::string& uri, ResourceMonitor& resourceMonitor);
+
+  protected:
+    /**
+     * @brief GET /resources - Sends a sample as composed by
+     * JsonParser::composeResourcesPayload
+     * @param req Pointer to the HTTP request object.
+     * @return ESP_OK
+     */
+    esp_err_t process(httpd_req_t* req) override;
+
+  private:
+    ResourceMonitor& m_resourceMonitor;
+    static constexpr const char* TAG =
+        "ResourcesHandler"; /**< Logging tag for ESP_LOG macros. */
+};
@@ -12,6 +12,7 @@
  */
 #include "TimeHandler.h"
 #include "JsonParser.h"
+#include "LogRateLimit.h"
 #include "esp_log.h"
 #include "time.h"
 
@@ -21,18 +22,21 @@ TimeHandler::TimeHandler(const std::string& uri, TimeSyncManager& timeSyncManage
 esp_err_t TimeHandler::process(httpd_req_t* req) {
 
     if (!m_timeSyncManager.isTimeSynced()) {
-            ESP_LOGE(TAG, "failed GET /time request. Internal time is not synced");
+            CU_LOGE_RATELIMITED(
+                TAG,
+                LOG_RATE_LIMIT_MS,
+                "failed GET /time request. Internal time is not synced");
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Control Unit time is not synced");
             return ESP_FAIL;
     }
     
     time_t now;
     time(&now);
-    ESP_LOGI(TAG,"Control Unit timestamp: %lld", static_cast<long long>(now));    
+    ESP_LOGD(TAG,"Control Unit timestamp: %lld", static_cast<long long>(now));    
     
     std::string payload = JsonParser::composeTimestampPayload(now);
     httpd_resp_set_type(req, "application/json");
     httpd_resp_send(req, payload.c_str(), HTTPD_RESP_USE_STRLEN);
-    ESP_LOGI(TAG, "Sending Control Unit timestamp as double: %.0f", static_cast<double>(now));
+    ESP_LOGV(TAG, "Sending Control Unit timestamp as double: %.0f", static_cast<double>(now));
     return ESP_OK;
 }
\ No newline at end of file
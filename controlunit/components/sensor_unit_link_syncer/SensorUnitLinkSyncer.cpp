@@ -6,11 +6,11 @@
  * This file contains the implementation of the classes declared in
  * SensorUnitLinkSyncer.h:
  *
- * - `SensorUnitLinkSyncer` sets up and coordinates the task and timer trigger.
- * - `SensorUnitLinkSyncTask` defines the FreeRTOS task that collects commands
+ * - `SensorUnitLinkSyncer` sets up and coordinates the job and timer trigger.
+ * - `SensorUnitLinkSyncJob` defines the backend job that collects commands
  * from backend via HTTP and adds/removes Sensor Units from manager.
- * - `SensorUnitLinkSyncTrigger` manages the periodic timer that notifies the
- * task.
+ * - `SensorUnitLinkSyncTrigger` manages the periodic scheduler job that
+ * submits the job.
  *
  * The system is designed to periodically send POSTs to a backend endpoint
  * to get commands for connect/disconnect for sensor units.
@@ -26,22 +26,23 @@
  *
  */
 #include "SensorUnitLinkSyncer.h"
+#include "LogRateLimit.h"
 #include "JsonParser.h"
 
-SensorUnitLinkSyncer::SensorUnitLinkSyncer(RestClient&        client,
+SensorUnitLinkSyncer::SensorUnitLinkSyncer(BackendIoTask&     io,
+                                           JobScheduler&      scheduler,
                                            SensorUnitManager& sensorUnitManager,
                                            uint64_t           intervalUs,
                                            const std::string& controlUnitId)
-    : m_client(client), m_sensorUnitManager(sensorUnitManager),
+    : m_io(io), m_scheduler(scheduler), m_sensorUnitManager(sensorUnitManager),
       m_interval(intervalUs), m_controlUnitId(controlUnitId) {}
 
 esp_err_t SensorUnitLinkSyncer::start() {
-    m_task = std::make_unique<SensorUnitLinkSyncTask>(
-        m_client, m_sensorUnitManager, m_controlUnitId);
-    m_task->start();
+    m_job = std::make_unique<SensorUnitLinkSyncJob>(
+        m_io, m_sensorUnitManager, m_controlUnitId);
 
-    TaskHandle_t handle = m_task->getHandle();
-    m_trigger = std::make_unique<SensorUnitLinkSyncTrigger>(handle, m_interval);
+    m_trigger = std::make_unique<SensorUnitLinkSyncTrigger>(
+        m_scheduler, *m_job, m_interval);
     return m_trigger->start();
 }
 
@@ -50,108 +51,106 @@ void SensorUnitLinkSyncer::stop() {
         m_trigger->stop();
 }
 
-SensorUnitLinkSyncTask::SensorUnitLinkSyncTask(
-    RestClient&        client,
+SensorUnitLinkSyncJob::SensorUnitLinkSyncJob(
+    BackendIoTask&     io,
     SensorUnitManager& sensorUnitManager,
     std::string        controlUnitId)
-    : m_httpClient(client), m_sensorUnitManager(sensorUnitManager),
-      m_controlUnitId(controlUnitId), m_taskHandle(nullptr) {}
-
-void SensorUnitLinkSyncTask::start() {
-    ESP_LOGI(TAG, "Starting task...");
-    xTaskCreate(
-        taskEntry, "SensorUnitLinkSyncTask", 8192, this, 5, &m_taskHandle);
-    ESP_LOGI(TAG, "Task created, handle: %p", m_taskHandle);
+    : m_io(io), m_sensorUnitManager(sensorUnitManager),
+      m_controlUnitId(controlUnitId) {}
+
+void SensorUnitLinkSyncJob::submit() {
+    if (m_pending.exchange(true)) {
+        CU_LOGW_RATELIMITED(TAG,
+                            LOG_RATE_LIMIT_MS,
+                            "Previous status poll still pending, skipping tick");
+        return;
+    }
+    BackendJob job{};
+    job.endpoint = ENDPOINT;
+    job.priority = RequestPriority::Command;
+    job.prepare  = &SensorUnitLinkSyncJob::prepareEntry;
+    job.complete = &SensorUnitLinkSyncJob::completeEntry;
+    job.context  = this;
+    if (!m_io.submit(job)) {
+        m_pending = false;
+    }
 }
 
-TaskHandle_t SensorUnitLinkSyncTask::getHandle() const {
-    return m_taskHandle;
+bool SensorUnitLinkSyncJob::prepareEntry(void* context, std::string& payload) {
+    auto* self = static_cast<SensorUnitLinkSyncJob*>(context);
+    ESP_LOGD(TAG, "Performing Status Polling");
+    payload = JsonParser::composeStatusRequest(self->m_controlUnitId);
+    return true;
 }
 
-void SensorUnitLinkSyncTask::taskEntry(void* pvParameters) {
-    auto* self = static_cast<SensorUnitLinkSyncTask*>(pvParameters);
-    self->run();
+void SensorUnitLinkSyncJob::completeEntry(void*                     context,
+                                          const RestClientResponse& response) {
+    auto* self = static_cast<SensorUnitLinkSyncJob*>(context);
+    self->complete(response);
+    self->m_pending = false;
 }
 
-void SensorUnitLinkSyncTask::run() {
-    ESP_LOGI(TAG, "SensorUnitLinkSyncTask is running");
-    while (true) {
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        ESP_LOGI(TAG, "Performing Status Polling");
-
-        std::string json = JsonParser::composeStatusRequest(m_controlUnitId);
-        RestClientResponse response =
-            m_httpClient.postTo("/api/v1/control-unit/status", json);
-
-        if (response.err != ESP_OK) {
-            ESP_LOGE(TAG, "Error posting to /status");
-            continue;
-        }
-        std::vector<SensorConnectRequest> requests =
-            JsonParser::parseStatusResponse(response.payload);
+void SensorUnitLinkSyncJob::complete(const RestClientResponse& response) {
+    if (response.err != ESP_OK) {
+        CU_LOGE_RATELIMITED(TAG, LOG_RATE_LIMIT_MS, "Error posting to /status");
+        return;
+    }
+    std::vector<SensorConnectRequest> requests =
+        JsonParser::parseStatusResponse(response.payload);
 
-        if (requests.empty()) {
-            ESP_LOGE(TAG, "Invalid json response from /status");
-            continue;
-        }
-        for (auto request : requests) {
-            Uuid sensorUnitId = *request.sensorUuid;
-
-            if (request.request == requestType::CONNECT) {
-                if (m_sensorUnitManager.hasUnit(sensorUnitId)) {
-                    ESP_LOGW(TAG,
-                             "Sensor Unit %s already connected",
-                             sensorUnitId.toString().c_str());
-                } else {
-                    ESP_LOGI(TAG,
-                             "Connecting Sensor Unit %s",
-                             sensorUnitId.toString().c_str());
-                    m_sensorUnitManager.addUnit(sensorUnitId);
-                }
+    if (requests.empty()) {
+        CU_LOGE_RATELIMITED(
+            TAG, LOG_RATE_LIMIT_MS, "Invalid json response from /status");
+        return;
+    }
+    for (auto request : requests) {
+        Uuid sensorUnitId = *request.sensorUuid;
+
+        if (request.request == requestType::CONNECT) {
+            if (m_sensorUnitManager.hasUnit(sensorUnitId)) {
+                ESP_LOGW(TAG,
+                         "Sensor Unit %s already connected",
+                         sensorUnitId.toString().c_str());
+            } else {
+                ESP_LOGI(TAG,
+                         "Connecting Sensor Unit %s",
+                         sensorUnitId.toString().c_str());
+                m_sensorUnitManager.addUnit(sensorUnitId);
             }
+        }
 
-            if (request.request == requestType::DISCONNECT) {
-                if (!m_sensorUnitManager.hasUnit(sensorUnitId)) {
-                    ESP_LOGW(TAG,
-                             "No Sensor Unit %s connected",
-                             sensorUnitId.toString().c_str());
-                } else {
-                    ESP_LOGI(TAG,
-                             "Disconnecting Sensor Unit %s",
-                             sensorUnitId.toString().c_str());
-                    m_sensorUnitManager.removeUnit(sensorUnitId);
-                }
+        if (request.request == requestType::DISCONNECT) {
+            if (!m_sensorUnitManager.hasUnit(sensorUnitId)) {
+                ESP_LOGW(TAG,
+                         "No Sensor Unit %s connected",
+                         sensorUnitId.toString().c_str());
+            } else {
+                ESP_LOGI(TAG,
+                         "Disconnecting Sensor Unit %s",
+                         sensorUnitId.toString().c_str());
+                m_sensorUnitManager.removeUnit(sensorUnitId);
             }
         }
     }
 }
 
-SensorUnitLinkSyncTrigger::SensorUnitLinkSyncTrigger(TaskHandle_t targetTask,
-                                                     uint64_t     intervalUs)
-    : m_taskHandle(targetTask), m_interval(intervalUs), m_timer(nullptr) {}
+SensorUnitLinkSyncTrigger::SensorUnitLinkSyncTrigger(
+    JobScheduler&          scheduler,
+    SensorUnitLinkSyncJob& job,
+    uint64_t               intervalUs)
+    : m_scheduler(scheduler), m_job(job), m_interval(intervalUs),
+      m_jobId(INVALID_JOB) {}
 
 esp_err_t SensorUnitLinkSyncTrigger::start() {
-    if (m_taskHandle == nullptr) {
-        ESP_LOGE(TAG, "Invalid task handle — trigger not started");
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    esp_timer_create_args_t timer_args{};
-    timer_args.callback        = &SensorUnitLinkSyncTrigger::timerCallback;
-    timer_args.arg             = this;
-    timer_args.dispatch_method = ESP_TIMER_TASK;
-    timer_args.name            = "SensorUnitLinkSyncTrigger";
-
-    esp_err_t err = esp_timer_create(&timer_args, &m_timer);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create timer: %s", esp_err_to_name(err));
-        return err;
-    }
-
-    err = esp_timer_start_periodic(m_timer, m_interval);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start timer: %s", esp_err_to_name(err));
-        return err;
+    JobConfig job{};
+    job.name     = "SensorUnitLinkSyncTrigger";
+    job.run      = &SensorUnitLinkSyncTrigger::run;
+    job.context  = this;
+    job.periodUs = m_interval;
+    m_jobId      = m_scheduler.schedule(job);
+    if (m_jobId == INVALID_JOB) {
+        ESP_LOGE(TAG, "Failed to schedule trigger");
+        return ESP_ERR_NO_MEM;
     }
 
     ESP_LOGI(TAG,
@@ -161,22 +160,15 @@ esp_err_t SensorUnitLinkSyncTrigger::start() {
 }
 
 void SensorUnitLinkSyncTrigger::stop() {
-    if (m_timer) {
-        esp_timer_stop(m_timer);
-        esp_timer_delete(m_timer);
-        m_timer = nullptr;
+    if (m_jobId != INVALID_JOB) {
+        m_scheduler.cancel(m_jobId);
+        m_jobId = INVALID_JOB;
         ESP_LOGI(TAG, "SensorUnitLinkSyncTrigger stopped");
     }
 }
 
-void SensorUnitLinkSyncTrigger::timerCallback(void* arg) {
-    ESP_LOGI(TAG, "Timer callback triggered");
+void SensorUnitLinkSyncTrigger::run(void* arg) {
+    ESP_LOGD(TAG, "Trigger run");
     auto* self = static_cast<SensorUnitLinkSyncTrigger*>(arg);
-    ESP_LOGI(TAG,
-             "Timer callback: self=%p, taskHandle=%p",
-             self,
-             self->m_taskHandle);
-    if (self->m_taskHandle) {
-        xTaskNotifyGive(self->m_taskHandle);
-    }
-}
\ No newline at end of file
+    self->m_job.submit();
+}
@@ -7,13 +7,13 @@
  * poll status from remote server and update SensorUnitManager.
  *
  * - `SensorUnitLinkSyncer` is the public-facing orchestrator. It initializes
- * and connects the task and timer components.
+ * and connects the job and timer components.
  *
- * - `SensorUnitLinkSyncTask` is a FreeRTOS task that waits for notifications
- * and performs the actual HTTP posting and updating of state.
+ * - `SensorUnitLinkSyncJob` builds the status request and updates state from
+ * the response. It runs on the BackendIoTask, which does the HTTP posting.
  *
- * - `SensorUnitLinkSyncTrigger` sets up a periodic timer that notifies the task
- * at a configured interval.
+ * - `SensorUnitLinkSyncTrigger` schedules a periodic JobScheduler job that
+ * submits the job at a configured interval.
  *
  *
  * @date 2025-10-07
@@ -23,50 +23,52 @@
  *
  */
 #pragma once
-#include "RestClient.h"
+#include "BackendIoTask.h"
+#include "JobScheduler.h"
 #include "SensorUnitManager.h"
 #include "esp_log.h"
 #include "esp_timer.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
+#include <atomic>
 #include <memory>
 
 // Forward declarations for types used in SensorUnitLinkSyncer
-class SensorUnitLinkSyncTask;
+class SensorUnitLinkSyncJob;
 class SensorUnitLinkSyncTrigger;
 
 /**
  * @class SensorUnitLinkSyncer
  * @brief High-level orchestrator for periodic sensor data dispatch.
  *
- * Combines a task and a timer trigger to periodically collect and send sensor
+ * Combines a job and a timer trigger to periodically collect and send sensor
  * data. Responsible for initializing and coordinating the
- * SensorUnitLinkSyncTask and SensorUnitLinkSyncTrigger.
+ * SensorUnitLinkSyncJob and SensorUnitLinkSyncTrigger.
  */
 class SensorUnitLinkSyncer {
   public:
     /**
-     * @brief Constructs a SensorUnitLinkSyncer with client, sensorUnitManager,
-     * and interval.
+     * @brief Constructs a SensorUnitLinkSyncer with I/O task,
+     * sensorUnitManager, and interval.
      *
-     * @param client Reference to the REST client used for posting data.
+     * @param io Reference to the backend I/O task used for posting data.
+     * @param scheduler Reference to the scheduler running the trigger.
      * @param sensorUnitManager Reference to the control unit manager providing
      * sensor data.
      * @param intervalUs Timer interval in microseconds.
      * @param controlUnitId The Control Unit Uuid of this particular unit.
      * Included in the HTTP POST
      */
-    SensorUnitLinkSyncer(RestClient&        client,
+    SensorUnitLinkSyncer(BackendIoTask&     io,
+                         JobScheduler&      scheduler,
                          SensorUnitManager& sensorUnitManager,
                          uint64_t           intervalUs,
                          const std::string& controlUnitId);
 
     /**
-     * @brief Starts the Sensor Unit Link Syncer by launching the task and
+     * @brief Starts the Sensor Unit Link Syncer by creating the job and
      * trigger.
      *
-     * Creates a SensorUnitLinkSyncTask and a SensorUnitLinkSyncTrigger, and
-     * starts both.
+     * Creates a SensorUnitLinkSyncJob and a SensorUnitLinkSyncTrigger, and
+     * starts the trigger.
      *
      * @return esp_err_t ESP_OK on success, or an error code on failure.
      */
@@ -75,149 +77,127 @@ class SensorUnitLinkSyncer {
     /**
      * @brief Stops the Sensor Unit Link Syncer trigger.
      *
-     * Stops the periodic timer. The task is not stopped immediately.
+     * Cancels the periodic trigger. A job already submitted still runs.
      */
     void stop();
 
   private:
-    RestClient&
-        m_client; /**< Reference to the REST client used for posting data. */
+    BackendIoTask&
+        m_io; /**< Reference to the I/O task used for posting data. */
+    JobScheduler&
+        m_scheduler; /**< Reference to the scheduler running the trigger. */
     SensorUnitManager&
         m_sensorUnitManager; /**< Reference to the sensor unit manager. */
-    std::unique_ptr<SensorUnitLinkSyncTask>
-        m_task; /**< Task responsible for data dispatch. */
+    std::unique_ptr<SensorUnitLinkSyncJob>
+        m_job; /**< Job responsible for status polling. */
     std::unique_ptr<SensorUnitLinkSyncTrigger>
-                m_trigger;  /**< Timer trigger for periodic task activation. */
+                m_trigger;  /**< Trigger for periodic job submission. */
     uint64_t    m_interval; /**< Timer interval in microseconds. */
     std::string m_controlUnitId;
 };
 
 /**
- * @class SensorUnitLinkSyncTask
- * @brief FreeRTOS task responsible for polling by posting data and based on the
- * response updating internal state.
+ * @class SensorUnitLinkSyncJob
+ * @brief Backend job that polls for commands and, based on the response,
+ * updates internal state.
  *
- * This task waits for notifications triggered by a timer, composes a JSON
- * payload with control unit ID sends the data to a remote server using a REST
- * client and parses the response and updates the SensorUnitManager accordingly
- * if a Sensor Unit status has changed
+ * Submitted to the BackendIoTask by the trigger as a Command request. Composes
+ * a JSON payload with control unit ID, parses the response and updates the
+ * SensorUnitManager accordingly if a Sensor Unit status has changed. At most
+ * one job is queued or in flight at a time.
  *
  */
-class SensorUnitLinkSyncTask {
+class SensorUnitLinkSyncJob {
   public:
     /**
-     * @brief Constructs a SensorUnitLinkSyncTask with HTTP client and control
-     * unit manager.
+     * @brief Constructs a SensorUnitLinkSyncJob with I/O task and sensor unit
+     * manager.
      *
-     * @param client Reference to the REST client used for posting data.
+     * @param io Reference to the backend I/O task the job is submitted to.
      * @param sensorUnitManager Reference to the sensor unit manager providing
      * sensor
      * @param controlUnitId Uuid of the ControlUnit. Important to match with
      * unit_id in JWT token
      */
-    SensorUnitLinkSyncTask(RestClient&        client,
-                           SensorUnitManager& sensorUnitManager,
-                           std::string        controlUnitId);
+    SensorUnitLinkSyncJob(BackendIoTask&     io,
+                          SensorUnitManager& sensorUnitManager,
+                          std::string        controlUnitId);
 
     /**
-     * @brief Starts the SensorUnitLinkSyncTask by creating a FreeRTOS task.
+     * @brief Submits the job unless the previous one is still pending.
      *
-     * Creates a task with the specified name and priority, and stores its
-     * handle.
+     * Safe to call from esp_timer callbacks, never blocks.
      */
-    void start();
-
-    /**
-     * @brief Returns the handle of the created task.
-     *
-     * @return TaskHandle_t Handle to the FreeRTOS task.
-     */
-    TaskHandle_t getHandle() const;
+    void submit();
 
   private:
-    /**
-     * @brief Entry point for the SensorUnitLinkSyncTask.
-     *
-     * Casts the parameter to a SensorUnitLinkSyncTask instance and invokes its
-     * run() method.
-     *
-     * @param pvParameters Pointer to the SensorUnitLinkSyncTask instance.
-     */
-    static void taskEntry(void* pvParameters);
+    static bool prepareEntry(void* context, std::string& payload);
+    static void completeEntry(void* context, const RestClientResponse& response);
 
     /**
-     * @brief Main loop of the SensorUnitLinkSyncTask.
-     *
-     * Waits for task notifications, composes a JSON payload with control unit
-     * id, posts the data to the server using the REST client and reads the
-     * response and updates SensorUnitManager state
+     * @brief Reads the response and updates SensorUnitManager state, runs on
+     * the I/O task.
      */
-    void run();
+    void complete(const RestClientResponse& response);
 
-    RestClient& m_httpClient; /**< Reference to the REST client used for HTTP
-                                 communication. */
+    BackendIoTask& m_io; /**< Reference to the I/O task sending the job. */
     SensorUnitManager& m_sensorUnitManager; /**< Reference to the sensor unit
                                       manager providing sensor data. */
-    std::string  m_controlUnitId;
-    TaskHandle_t m_taskHandle; /**< Handle to the created FreeRTOS task. */
+    std::string       m_controlUnitId;
+    std::atomic<bool> m_pending{false}; /**< Submitted and not completed */
 
-    static constexpr const char* TAG = "SensorUnitLinkSyncTask";
+    static constexpr const char* ENDPOINT = "/api/v1/control-unit/status";
+    static constexpr const char* TAG      = "SensorUnitLinkSyncJob";
 };
 
 /**
  * @class SensorUnitLinkSyncTrigger
- * @brief Periodically triggers a task to dispatch sensor readings.
+ * @brief Periodically submits the status polling job.
  *
- * This class sets up a periodic timer using the ESP-IDF timer API. When the
- * timer expires, it notifies a target FreeRTOS task to perform data
- * dispatching.
+ * This class schedules a periodic job on the JobScheduler. Every run submits
+ * the SensorUnitLinkSyncJob to the BackendIoTask.
  */
 class SensorUnitLinkSyncTrigger {
   public:
     /**
-     * @brief Constructs a SensorUnitLinkSyncTrigger with a target task and
-     * interval.
+     * @brief Constructs a SensorUnitLinkSyncTrigger with a job and interval.
      *
-     * @param target_task Handle to the task that will be notified periodically.
-     * @param interval_us Timer interval in microseconds.
+     * @param scheduler Scheduler the trigger runs on.
+     * @param job Job that will be submitted periodically.
+     * @param intervalUs Interval in microseconds.
      */
-    SensorUnitLinkSyncTrigger(TaskHandle_t targetTask, uint64_t intervalUs);
+    SensorUnitLinkSyncTrigger(JobScheduler&          scheduler,
+                              SensorUnitLinkSyncJob& job,
+                              uint64_t               intervalUs);
 
     /**
-     * @brief Initializes and starts the periodic timer for dispatching
-     * readings.
+     * @brief Schedules the periodic scheduler job for status polling.
      *
-     * Verifies that a valid task handle is available, creates a timer with the
-     * specified interval, and starts it. The timer will notify the target task
-     * on each tick.
-     *
-     * @return esp_err_t ESP_OK on success, or an error code on failure.
+     * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the scheduler
+     * has no room for the job.
      */
     esp_err_t start();
 
     /**
-     * @brief Stops and deletes the active timer.
-     *
-     * If the timer is running, it is stopped and deleted. The internal timer
-     * handle is reset to nullptr.
+     * @brief Cancels the scheduler job, waits for a run in progress.
      */
     void stop();
 
   private:
     /**
-     * @brief Callback function triggered by the periodic timer.
+     * @brief Scheduler job callback.
      *
-     * Casts the argument to a SensorUnitLinkSyncTrigger instance and sends a
-     * task notification to the associated task handle, if available.
+     * Casts the argument to a SensorUnitLinkSyncTrigger instance and submits
+     * the associated job.
      *
      * @param arg Pointer to the SensorUnitLinkSyncTrigger instance.
      */
-    static void timerCallback(void* arg);
+    static void run(void* arg);
 
-    TaskHandle_t m_taskHandle;     /**< Handle to the task that will be notified
-                                      periodically. */
-    uint64_t           m_interval; /**< Timer interval in microseconds. */
-    esp_timer_handle_t m_timer;    /**< Handle to the ESP-IDF timer instance. */
+    JobScheduler&          m_scheduler; /**< Scheduler the trigger runs on. */
+    SensorUnitLinkSyncJob& m_job;       /**< Job submitted periodically. */
+    uint64_t               m_interval;  /**< Interval in microseconds. */
+    JobId                  m_jobId; /**< Scheduler job, INVALID_JOB if off */
 
     static constexpr const char* TAG = "SensorUnitLinkSyncTrigger";
 };
\ No newline at end of file
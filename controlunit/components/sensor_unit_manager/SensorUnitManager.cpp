@@ -12,12 +12,26 @@
  * @license MIT
  */
 #include "SensorUnitManager.h"
+#include "AllocCounter.h"
+#include "Metrics.h"
 #include <esp_log.h>
 
+/// Storage of m_all_readings, which keeps its capacity when cleared
+static AllocCounter s_readingAllocs{"readings"};
+
+static Counter s_readingsIngested{"cu_readings_ingested_total",
+                                  "Readings stored from sensor units"};
+static Gauge   s_readingsBuffered{"cu_readings_buffered",
+                                "Readings waiting to be uploaded"};
+
+SensorUnitManager::SensorUnitManager(const UploadSlotConfig& uploadSlots)
+    : m_uploadSlots{uploadSlots} {}
+
 void SensorUnitManager::init() const {
     ESP_LOGI(TAG, "Initializing Sensor Unit Manager");
     m_readingsMutex = xSemaphoreCreateMutex();
-    if (m_readingsMutex == nullptr) {
+    m_slotsMutex    = xSemaphoreCreateMutex();
+    if (m_readingsMutex == nullptr || m_slotsMutex == nullptr) {
         ESP_LOGE(TAG, "Failed to create mutex");
     }
 }
@@ -35,6 +49,10 @@ void SensorUnitManager::removeUnit(const Uuid& uuid) {
     auto it = m_active_units.find(uuid);
     if (it != m_active_units.end()) {
         m_active_units.erase(it);
+        if (xSemaphoreTake(m_slotsMutex, portMAX_DELAY) == pdTRUE) {
+            m_uploadSlots.release(uuid);
+            xSemaphoreGive(m_slotsMutex);
+        }
         ESP_LOGI(TAG, "Removed Sensor Unit %s", uuid.toString().c_str());
     } else {
         ESP_LOGE(TAG, "No Sensor Unit %s in list", uuid.toString().c_str());
@@ -45,17 +63,33 @@ bool SensorUnitManager::hasUnit(const Uuid& uuid) const {
     return (m_active_units.find(uuid) != m_active_units.end());
 }
 
+UploadSlot SensorUnitManager::assignUploadSlot(const Uuid& uuid) {
+    UploadSlot slot;
+    if (xSemaphoreTake(m_slotsMutex, portMAX_DELAY) == pdTRUE) {
+        slot = m_uploadSlots.assign(uuid);
+        xSemaphoreGive(m_slotsMutex);
+    }
+    return slot;
+}
+
 void SensorUnitManager::storeReading(const ca_sensorunit_snapshot& reading) {
-    ESP_LOGI(TAG, "Storing reading, mutex protected");
     if (xSemaphoreTake(m_readingsMutex, portMAX_DELAY) == pdTRUE) {
+        size_t capacity = m_all_readings.capacity();
         m_all_readings.push_back(reading);
+        if (m_all_readings.capacity() != capacity) {
+            s_readingAllocs.replaced(
+                capacity * sizeof(ca_sensorunit_snapshot),
+                m_all_readings.capacity() * sizeof(ca_sensorunit_snapshot));
+        }
+        s_readingsBuffered.set(static_cast<int32_t>(m_all_readings.size()));
         xSemaphoreGive(m_readingsMutex);
+        s_readingsIngested.add();
     }
 }
 
 std::map<time_t, std::vector<ca_sensorunit_snapshot>>
 SensorUnitManager::getGroupedReadings() const {
-    ESP_LOGI(TAG, "Getting grouped readings, mutex protected");
+    ESP_LOGD(TAG, "Getting grouped readings, mutex protected");
     std::map<time_t, std::vector<ca_sensorunit_snapshot>> grouped;
     // Consider copying vector to avoid blocking mutex
     if (xSemaphoreTake(m_readingsMutex, portMAX_DELAY) == pdTRUE) {
@@ -67,16 +101,26 @@ SensorUnitManager::getGroupedReadings() const {
     return grouped;
 }
 
+size_t SensorUnitManager::readingsCount() const {
+    size_t count = 0;
+    if (xSemaphoreTake(m_readingsMutex, portMAX_DELAY) == pdTRUE) {
+        count = m_all_readings.size();
+        xSemaphoreGive(m_readingsMutex);
+    }
+    return count;
+}
+
 void SensorUnitManager::clearReadings() {
-    ESP_LOGI(TAG, "Clearing readings, mutex protected");
+    ESP_LOGD(TAG, "Clearing readings, mutex protected");
     if (xSemaphoreTake(m_readingsMutex, portMAX_DELAY) == pdTRUE) {
         m_all_readings.clear();
+        s_readingsBuffered.set(0);
         xSemaphoreGive(m_readingsMutex);
     }
 }
 
 void SensorUnitManager::clearReadings(size_t amount) {
-    ESP_LOGI(TAG, "Clearing %zu readings, mutex protected", amount);
+    ESP_LOGD(TAG, "Clearing %zu readings, mutex protected", amount);
     if (xSemaphoreTake(m_readingsMutex, portMAX_DELAY) == pdTRUE) {
         if (amount > m_all_readings.size()) {
             ESP_LOGW(
@@ -84,14 +128,15 @@ void SensorUnitManager::clearReadings(size_t amount) {
                 "Trying to delete %zu readings but only %zu present buffer",
                 amount,
                 m_all_readings.size());
-            ESP_LOGI(TAG, "Clearing buffer");
+            ESP_LOGD(TAG, "Clearing buffer");
             m_all_readings.clear();
         } else {
-            ESP_LOGI(TAG, "Clearing %zu readings", amount);
+            ESP_LOGD(TAG, "Clearing %zu readings", amount);
             m_all_readings.erase(m_all_readings.begin(),
                                  m_all_readings.begin() + amount);
         }
-        ESP_LOGI(TAG, "Remaining readings: %zu", m_all_readings.size());
+        ESP_LOGD(TAG, "Remaining readings: %zu", m_all_readings.size());
+        s_readingsBuffered.set(static_cast<int32_t>(m_all_readings.size()));
         xSemaphoreGive(m_readingsMutex);
     }
 }
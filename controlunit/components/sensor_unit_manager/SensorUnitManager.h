@@ -10,6 +10,7 @@
  *
  * Class functionality:
  * - Add or remove sensor units using their UUIDs.
+ * - Assign connecting units an upload window, see UploadSlotPlanner.
  * - Store readings as they arrive.
  * - Retrieve grouped readings for backend dispatch.
  * - Clear stored readings when succesfully dispatched.
@@ -20,6 +21,7 @@
  * @license MIT
  */
 #pragma once
+#include "UploadSlotPlanner.h"
 #include "freertos/FreeRTOS.h"
 #include "sensor_data_types.h"
 #include <map>
@@ -36,10 +38,11 @@
 class SensorUnitManager {
   public:
     /**
-     * @brief Default constructor added just for clarity
+     * @brief Constructs the manager
      *
+     * @param uploadSlots Layout of the upload windows handed out on /connect
      */
-    SensorUnitManager() = default;
+    explicit SensorUnitManager(const UploadSlotConfig& uploadSlots = {});
     /**
      * @brief Class needs to run init in app_main to create the FreeRTOS 
      * mutex needed to protect shared resources. Function is declared as 
@@ -53,7 +56,7 @@ class SensorUnitManager {
      */
     void addUnit(const Uuid& uuid);
     /**
-     * @brief Removes a sensor unit from the registry.
+     * @brief Removes a sensor unit from the registry and frees its upload window.
      * @param uuid Unique identifier of the sensor unit to remove.
      */
     void removeUnit(const Uuid& uuid);
@@ -65,6 +68,13 @@ class SensorUnitManager {
      */
     bool hasUnit(const Uuid& uuid) const;
 
+    /**
+     * @brief Upload window of a registered unit, the same on every call.
+     * @param uuid UUID of a unit that connects.
+     * @return UploadSlot with periodS 0 if windows are disabled.
+     */
+    UploadSlot assignUploadSlot(const Uuid& uuid);
+
     /**
      * @brief Stores a snapshot reading from a sensor unit.
      * @param reading Sensor data including timestamp, temperature, and
@@ -77,6 +87,11 @@ class SensorUnitManager {
      */
     std::map<time_t, std::vector<ca_sensorunit_snapshot>>
     getGroupedReadings() const;
+    /**
+     * @brief Number of stored readings, without copying them.
+     * @return Readings waiting to be dispatched.
+     */
+    size_t readingsCount() const;
     /**
      * @brief Clears all stored sensor readings.
      */
@@ -89,6 +104,8 @@ class SensorUnitManager {
 
   private:
     mutable SemaphoreHandle_t m_readingsMutex = nullptr;
+    mutable SemaphoreHandle_t m_slotsMutex    = nullptr;
+    UploadSlotPlanner         m_uploadSlots; /**< Guarded by m_slotsMutex */
     std::map<Uuid, std::shared_ptr<Uuid>>
         m_active_units; /**< Registered sensor units by UUID. */
     std::vector<ca_sensorunit_snapshot>
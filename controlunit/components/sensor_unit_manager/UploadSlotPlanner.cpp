@@ -0,0 +1,57 @@
+/**
+ * @file UploadSlotPlanner.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the upload window assignment
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "UploadSlotPlanner.h"
+#include <algorithm>
+#include <cinttypes>
+#include <esp_log.h>
+
+UploadSlotPlanner::UploadSlotPlanner(const UploadSlotConfig& config)
+    : m_config{config} {
+    if (m_config.periodS > 0) {
+        m_config.windowS = std::clamp<uint32_t>(m_config.windowS, 1, m_config.periodS);
+        m_unitsIn.assign(m_config.periodS / m_config.windowS, 0);
+    }
+}
+
+UploadSlot UploadSlotPlanner::assign(const Uuid& unit) {
+    if (m_unitsIn.empty()) {
+        return {};
+    }
+    auto it = m_windowOf.find(unit);
+    if (it == m_windowOf.end()) {
+        size_t window = static_cast<size_t>(
+            std::min_element(m_unitsIn.begin(), m_unitsIn.end()) - m_unitsIn.begin());
+        ++m_unitsIn[window];
+        if (m_unitsIn[window] > m_config.unitsPerWindow) {
+            ESP_LOGW(TAG,
+                     "All windows full, %" PRIu32 " units share window %zu",
+                     m_unitsIn[window],
+                     window);
+        }
+        it = m_windowOf.emplace(unit, window).first;
+    }
+    return {m_config.periodS,
+            static_cast<uint32_t>(it->second) * m_config.windowS,
+            m_config.windowS};
+}
+
+void UploadSlotPlanner::release(const Uuid& unit) {
+    auto it = m_windowOf.find(unit);
+    if (it != m_windowOf.end()) {
+        --m_unitsIn[it->second];
+        m_windowOf.erase(it);
+    }
+}
+
+size_t UploadSlotPlanner::capacity() const {
+    return m_unitsIn.size() * m_config.unitsPerWindow;
+}
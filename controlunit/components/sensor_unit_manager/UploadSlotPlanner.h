@@ -0,0 +1,84 @@
+/**
+ * @file UploadSlotPlanner.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Hands out upload windows to sensor units
+ *
+ * The access point takes a few stations at a time (AP_MAX_CONNECTIONS in
+ * wifi_manager.h), far fewer than a container holds sensor units. The
+ * period is split into windows of windowS seconds, and every unit that
+ * connects gets one of them:
+ *
+ * - A unit that already has a window gets the same one again
+ * - A new unit gets the window with the fewest units, the first of them
+ *   on a tie, so the first units spread over the whole period
+ * - When every window has unitsPerWindow units the windows are shared by
+ *   more, which is logged. Units may then find the AP full
+ *
+ * Plain logic without locking, SensorUnitManager guards it.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "connection_data_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/**
+ * @brief Upload window layout, all times in seconds
+ */
+struct UploadSlotConfig {
+    uint32_t periodS        = 60; /**< Time between two windows of a unit, 0 disables */
+    uint32_t windowS        = 5;  /**< Associate, sync, upload and leave */
+    uint32_t unitsPerWindow = 3;  /**< Units associated at once, one AP connection kept free */
+};
+
+/**
+ * @class UploadSlotPlanner
+ * @brief Assigns every unit a window within the period
+ */
+class UploadSlotPlanner {
+  public:
+    /**
+     * @brief Constructs the planner, windowS is clamped to 1 ... periodS
+     *
+     * @param config Window layout
+     */
+    explicit UploadSlotPlanner(const UploadSlotConfig& config = {});
+
+    /**
+     * @brief Window of a unit, assigned on the first call
+     *
+     * @param unit Unit that connects
+     * @return UploadSlot with periodS 0 if disabled
+     */
+    UploadSlot assign(const Uuid& unit);
+
+    /**
+     * @brief Frees the window of a unit, e.g. when it is removed
+     */
+    void release(const Uuid& unit);
+
+    /**
+     * @brief Units that fit without sharing windows beyond unitsPerWindow
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Units with a window
+     */
+    size_t assigned() const {
+        return m_windowOf.size();
+    }
+
+  private:
+    UploadSlotConfig       m_config;
+    std::map<Uuid, size_t> m_windowOf; /**< Window index of every unit */
+    std::vector<uint32_t>  m_unitsIn;  /**< Units per window */
+    static constexpr const char* TAG = "UploadSlotPlanner";
+};
@@ -149,4 +149,17 @@ extern "C" void after_clearing_one_reading_grouped_readings_contains_correct_amo
     manager.clearReadings(1);
     auto grouped_after = manager.getGroupedReadings();
     TEST_ASSERT_EQUAL_UINT(1, grouped_after.size());
-}
\ No newline at end of file
+}
+extern "C" void readingsCount_follows_stored_and_cleared_readings(void) {
+    SensorUnitManager manager;
+    manager.init();
+    TEST_ASSERT_EQUAL_UINT(0, manager.readingsCount());
+
+    manager.storeReading(makeSnapshot("qwe", 1000, 25, 50));
+    manager.storeReading(makeSnapshot("qwe", 1000, 26, 51));
+    manager.storeReading(makeSnapshot("qwe", 2000, 30, 60));
+    TEST_ASSERT_EQUAL_UINT(3, manager.readingsCount());
+
+    manager.clearReadings(2);
+    TEST_ASSERT_EQUAL_UINT(1, manager.readingsCount());
+}
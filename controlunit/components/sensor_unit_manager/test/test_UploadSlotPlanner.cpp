@@ -0,0 +1,65 @@
+/**
+ * @brief Test file for UploadSlotPlanner.cpp
+ *
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "UploadSlotPlanner.h"
+#include <string>
+
+static Uuid unitId(int index) {
+    return Uuid{"5e750000-0000-4000-8000-" + std::to_string(index)};
+}
+
+extern "C" void when_units_connect_then_they_spread_over_the_windows(void) {
+    UploadSlotPlanner planner({60, 5, 3});
+    TEST_ASSERT_EQUAL(36, planner.capacity());
+
+    // The first 12 units get a window each, in order
+    for (int i = 0; i < 12; ++i) {
+        UploadSlot slot = planner.assign(unitId(i));
+        TEST_ASSERT_EQUAL_UINT32(60, slot.periodS);
+        TEST_ASSERT_EQUAL_UINT32(5, slot.windowS);
+        TEST_ASSERT_EQUAL_UINT32(i * 5, slot.offsetS);
+    }
+    // Then the windows fill up evenly
+    int perWindow[12] = {};
+    for (int i = 12; i < 36; ++i) {
+        ++perWindow[planner.assign(unitId(i)).offsetS / 5];
+    }
+    for (int count : perWindow) {
+        TEST_ASSERT_EQUAL(2, count);
+    }
+    TEST_ASSERT_EQUAL(36, planner.assigned());
+}
+
+extern "C" void when_unit_connects_again_then_it_keeps_its_window(void) {
+    UploadSlotPlanner planner({60, 5, 3});
+    planner.assign(unitId(0));
+    UploadSlot first = planner.assign(unitId(1));
+    TEST_ASSERT_EQUAL_UINT32(first.offsetS, planner.assign(unitId(1)).offsetS);
+    TEST_ASSERT_EQUAL(2, planner.assigned());
+
+    // A freed window is the first to be handed out again
+    planner.release(unitId(1));
+    planner.release(unitId(99));
+    TEST_ASSERT_EQUAL(1, planner.assigned());
+    TEST_ASSERT_EQUAL_UINT32(first.offsetS, planner.assign(unitId(2)).offsetS);
+}
+
+extern "C" void when_windows_disabled_or_full_then_units_still_get_an_answer(void) {
+    UploadSlotPlanner disabled({0, 5, 3});
+    TEST_ASSERT_EQUAL_UINT32(0, disabled.assign(unitId(0)).periodS);
+    TEST_ASSERT_EQUAL(0, disabled.capacity());
+
+    // Windows longer than the period are cut to it
+    UploadSlotPlanner one({10, 30, 1});
+    TEST_ASSERT_EQUAL(1, one.capacity());
+    TEST_ASSERT_EQUAL_UINT32(10, one.assign(unitId(0)).windowS);
+    // Over capacity the window is shared
+    UploadSlot shared = one.assign(unitId(1));
+    TEST_ASSERT_EQUAL_UINT32(0, shared.offsetS);
+    TEST_ASSERT_EQUAL(2, one.assigned());
+}
@@ -0,0 +1,96 @@
+/**
+ * @file TaskProfile.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the task placement helpers
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "TaskProfile.h"
+#include "esp_log.h"
+#include "freertos/semphr.h"
+
+static const char* TAG = "TaskProfile";
+
+static TaskRecord s_tracked[MAX_TRACKED_TASKS] = {};
+
+/// Created on first use, tasks are created before anything else runs
+static SemaphoreHandle_t trackingMutex() {
+    static SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+    return mutex;
+}
+
+BaseType_t taskCore(const TaskProfile& profile) {
+#if CONFIG_FREERTOS_UNICORE
+    return tskNO_AFFINITY;
+#else
+    return profile.core;
+#endif
+}
+
+BaseType_t createTask(const TaskProfile& profile,
+                      TaskFunction_t     entry,
+                      void*              arg,
+                      TaskHandle_t*      handle) {
+    TaskHandle_t created = nullptr;
+    BaseType_t   result  = xTaskCreatePinnedToCore(entry,
+                                                  profile.name,
+                                                  profile.stackBytes,
+                                                  arg,
+                                                  profile.priority,
+                                                  &created,
+                                                  taskCore(profile));
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create %s", profile.name);
+        return result;
+    }
+    trackTask(profile, created);
+    if (handle) {
+        *handle = created;
+    }
+    return result;
+}
+
+void trackTask(const TaskProfile& profile, TaskHandle_t handle) {
+    if (handle == nullptr) {
+        return;
+    }
+    xSemaphoreTake(trackingMutex(), portMAX_DELAY);
+    for (auto& record : s_tracked) {
+        if (record.handle == nullptr) {
+            record = {&profile, handle};
+            xSemaphoreGive(trackingMutex());
+            return;
+        }
+    }
+    xSemaphoreGive(trackingMutex());
+    ESP_LOGW(TAG, "Not tracking %s, all slots taken", profile.name);
+}
+
+void untrackTask(TaskHandle_t handle) {
+    if (handle == nullptr) {
+        handle = xTaskGetCurrentTaskHandle();
+    }
+    xSemaphoreTake(trackingMutex(), portMAX_DELAY);
+    for (auto& record : s_tracked) {
+        if (record.handle == handle) {
+            record = {};
+        }
+    }
+    xSemaphoreGive(trackingMutex());
+}
+
+size_t trackedTasks(TaskRecord* records, size_t maxRecords) {
+    size_t count = 0;
+    xSemaphoreTake(trackingMutex(), portMAX_DELAY);
+    for (const auto& record : s_tracked) {
+        if (record.handle != nullptr && count < maxRecords) {
+            records[count++] = record;
+        }
+    }
+    xSemaphoreGive(trackingMutex());
+    return count;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file TaskProfile.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Core, priority and stack of every Control Unit task in one place
+ *
+ * Core 0 runs Wi-Fi, lwIP and the REST server the sensor units post to.
+ * Core 1 runs everything that talks to the backend, so a TLS upload never
+ * takes CPU from ingest. Within a core the latency sensitive task gets the
+ * higher priority:
+ *
+ * | Task | Core | Priority | Stack |
+ * | --- | --- | --- | --- |
+ * | httpd (RestServer) | 0 | 6 | 6144 |
+ * | JobWorker (JobScheduler) | 1 | 5 | 4096 |
+ * | BackendIoTask | 1 | 4 | 8192 |
+ * | TimeResyncTask | 1 | 1 | 4096 |
+ * | LogDrain (DeferredLog) | 1 | 1 | 3072 |
+ *
+ * esp_timer and the Wi-Fi tasks are placed by sdkconfig. On a single core
+ * target every task runs without affinity.
+ *
+ * Tasks created here are tracked until they exit, so ResourceMonitor can
+ * sample their stacks without the trace facility.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Placement of one task
+ */
+struct TaskProfile {
+    const char* name;
+    uint32_t    stackBytes;
+    UBaseType_t priority;
+    BaseType_t  core; /**< 0, 1 or tskNO_AFFINITY */
+};
+
+inline constexpr TaskProfile HTTP_SERVER_TASK = {"httpd", 6144, 6, 0};
+inline constexpr TaskProfile JOB_WORKER_TASK  = {"JobWorker", 4096, 5, 1};
+inline constexpr TaskProfile BACKEND_IO_TASK  = {"BackendIoTask", 8192, 4, 1};
+inline constexpr TaskProfile TIME_RESYNC_TASK = {"TimeResyncTask", 4096, 1, 1};
+inline constexpr TaskProfile LOG_DRAIN_TASK   = {"LogDrain", 3072, 1, 1};
+
+static_assert(HTTP_SERVER_TASK.core != BACKEND_IO_TASK.core,
+              "Uploads must not share a core with ingest");
+static_assert(JOB_WORKER_TASK.priority > BACKEND_IO_TASK.priority,
+              "Jobs only enqueue work and must not wait behind an upload");
+static_assert(LOG_DRAIN_TASK.priority < BACKEND_IO_TASK.priority,
+              "The console write must never delay real work");
+
+/**
+ * @brief Core to pin a task to, tskNO_AFFINITY on a single core target
+ */
+BaseType_t taskCore(const TaskProfile& profile);
+
+/**
+ * @brief Creates a task placed as the profile says
+ *
+ * @return pdPASS on success
+ */
+BaseType_t createTask(const TaskProfile& profile,
+                      TaskFunction_t     entry,
+                      void*              arg,
+                      TaskHandle_t*      handle = nullptr);
+
+/**
+ * @brief A running task and the profile it was created with
+ */
+struct TaskRecord {
+    const TaskProfile* profile;
+    TaskHandle_t       handle;
+};
+
+/// Tasks tracked at the same time
+inline constexpr size_t MAX_TRACKED_TASKS = 12;
+
+/**
+ * @brief Tracks a task created outside createTask(), like the httpd task.
+ * Does nothing for a null handle or when MAX_TRACKED_TASKS are tracked.
+ */
+void trackTask(const TaskProfile& profile, TaskHandle_t handle);
+
+/**
+ * @brief Stops tracking a task, the calling task if handle is null. A task
+ * that deletes itself calls this first.
+ */
+void untrackTask(TaskHandle_t handle = nullptr);
+
+/**
+ * @brief Copies the tracked tasks
+ *
+ * @return Number of records written, at most maxRecords
+ */
+size_t trackedTasks(TaskRecord* records, size_t maxRecords);
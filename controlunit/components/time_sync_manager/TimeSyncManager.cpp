@@ -11,6 +11,7 @@
  * @license MIT
  */
 #include "TimeSyncManager.h"
+#include "TaskProfile.h"
 #include "esp_log.h"
 #include "esp_sntp.h"
 #include <time.h>
@@ -72,14 +73,12 @@ void TimeSyncManager::enableAutoResync() {
     }
 
     ESP_LOGI(TAG, "Starting resync task with interval %d ms", m_syncIntervalMs);
-    xTaskCreate(
+    createTask(
+        TIME_RESYNC_TASK,
         [](void* arg) {
             static_cast<TimeSyncManager*>(arg)->resyncTask();
         },
-        "TimeResyncTask",
-        4096,
         this,
-        1,
         &m_resyncTaskHandle);
     }
 
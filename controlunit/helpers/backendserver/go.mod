@@ -0,0 +1,3 @@
+module backendserver
+
+go 1.24.1
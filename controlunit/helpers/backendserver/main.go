@@ -0,0 +1,245 @@
+// Backend stand-in for dispatcher benchmarks.
+//
+// Emulates the two endpoints the Control Unit posts to, with scriptable
+// latency, partial saves, 5xx bursts and slow bodies. See README.md
+package main
+
+import (
+	"bufio"
+	"encoding/json"
+	"flag"
+	"fmt"
+	"io"
+	"log"
+	"net/http"
+	"os"
+	"os/signal"
+	"strconv"
+	"strings"
+	"syscall"
+	"time"
+)
+
+// Endpoints from ReadingsDispatcher and SensorUnitLinkSyncer. Requests are
+// matched on the suffix so any base URL path works, e.g. /post/api/v1/...
+const (
+	readingsPath = "/api/v1/control-unit"
+	statusPath   = "/api/v1/control-unit/status"
+)
+
+// Payload is what JsonParser::composeGroupedReadings sends
+type Payload struct {
+	ControlUnitID   string `json:"control_unit_id"`
+	TimestampGroups []struct {
+		Timestamp   int64 `json:"timestamp"`
+		SensorUnits []struct {
+			SensorUnitID string `json:"sensor_unit_id"`
+		} `json:"sensor_units"`
+	} `json:"timestamp_groups"`
+}
+
+type Server struct {
+	readings *Script
+	status   *Script
+	stats    *Stats
+	verbose  bool
+}
+
+func (s *Server) ServeHTTP(w http.ResponseWriter, r *http.Request) {
+	switch {
+	case r.Method == http.MethodGet && r.URL.Path == "/stats":
+		s.stats.mu.Lock()
+		data, _ := json.MarshalIndent(s.stats, "", "  ")
+		s.stats.mu.Unlock()
+		w.Header().Set("Content-Type", "application/json")
+		w.Write(data)
+	case r.Method != http.MethodPost:
+		http.Error(w, "Only POST request supported", http.StatusMethodNotAllowed)
+	case strings.HasSuffix(r.URL.Path, statusPath):
+		s.handle(w, r, statusPath, s.status)
+	case strings.HasSuffix(r.URL.Path, readingsPath):
+		s.handle(w, r, readingsPath, s.readings)
+	default:
+		http.NotFound(w, r)
+	}
+}
+
+func (s *Server) handle(w http.ResponseWriter, r *http.Request, endpoint string, script *Script) {
+	start := time.Now()
+	body, err := io.ReadAll(r.Body)
+	if err != nil {
+		return
+	}
+	decision := script.Next()
+	request := Request{Endpoint: endpoint, Step: decision.StepIndex, Bytes: len(body)}
+	defer func() {
+		request.Latency = time.Since(start)
+		s.stats.Record(request)
+		if s.verbose {
+			log.Printf("%s step %d status %d readings %d saved %d in %s",
+				endpoint, request.Step, request.Status, len(request.Readings),
+				request.Saved, request.Latency.Round(time.Millisecond))
+		}
+	}()
+
+	if endpoint == readingsPath {
+		var payload Payload
+		if err := json.Unmarshal(body, &payload); err != nil {
+			request.Status = http.StatusBadRequest
+			http.Error(w, "Invalid JSON format", request.Status)
+			return
+		}
+		for _, group := range payload.TimestampGroups {
+			if request.OldestUnix == 0 || group.Timestamp < request.OldestUnix {
+				request.OldestUnix = group.Timestamp
+			}
+			for _, unit := range group.SensorUnits {
+				request.Readings = append(request.Readings,
+					readingKey{unit.SensorUnitID, group.Timestamp})
+			}
+		}
+	}
+
+	time.Sleep(decision.Latency)
+	if decision.Drop {
+		drop(w)
+		return
+	}
+
+	request.Status = http.StatusOK
+	if decision.Status != 0 {
+		request.Status = decision.Status
+	}
+	if decision.Fail {
+		request.Status = http.StatusInternalServerError
+	}
+	var response []byte
+	switch {
+	case request.Status >= 300:
+		response = []byte(`{"error":"injected failure"}`)
+	case endpoint == readingsPath:
+		apiStatus := "ok"
+		if decision.APIStatus != "" {
+			apiStatus = decision.APIStatus
+		}
+		request.Saved = decision.saved(len(request.Readings))
+		if apiStatus != "ok" {
+			request.Saved = 0
+		}
+		response = readingsResponse(apiStatus, request.Saved, decision.PadBytes)
+	case decision.Command != nil:
+		response, _ = json.Marshal(decision.Command)
+	default:
+		response = []byte(`{}`)
+	}
+	writeResponse(w, request.Status, response, decision.Step)
+}
+
+func readingsResponse(status string, saved, padBytes int) []byte {
+	response := fmt.Sprintf(`{"status":%q,"saved":%d`, status, saved)
+	if padBytes > 0 {
+		response += `,"padding":"` + strings.Repeat("x", padBytes) + `"`
+	}
+	return []byte(response + "}")
+}
+
+// writeResponse sends the body at once, or one byte at a time spread over
+// DripMs to emulate a slow link
+func writeResponse(w http.ResponseWriter, status int, body []byte, step Step) {
+	w.Header().Set("Content-Type", "application/json")
+	if !step.Chunked {
+		w.Header().Set("Content-Length", strconv.Itoa(len(body)))
+	}
+	w.WriteHeader(status)
+	if step.DripMs <= 0 {
+		w.Write(body)
+		return
+	}
+	flusher, _ := w.(http.Flusher)
+	delay := time.Duration(step.DripMs) * time.Millisecond / time.Duration(len(body))
+	for i := range body {
+		if _, err := w.Write(body[i : i+1]); err != nil {
+			return
+		}
+		if flusher != nil {
+			flusher.Flush()
+		}
+		time.Sleep(delay)
+	}
+}
+
+// drop closes the connection without answering, as a crashed backend or a
+// broken link would
+func drop(w http.ResponseWriter) {
+	hijacker, ok := w.(http.Hijacker)
+	if !ok {
+		panic(http.ErrAbortHandler)
+	}
+	conn, _, err := hijacker.Hijack()
+	if err == nil {
+		conn.Close()
+	}
+}
+
+// singleStep builds a one step scenario from the command line options
+func singleStep(latency, jitter, drip int, saveRatio, failRatio float64, chunked bool) []Step {
+	step := Step{LatencyMs: latency, JitterMs: jitter, DripMs: drip,
+		FailRatio: failRatio, Chunked: chunked}
+	if saveRatio < 1 {
+		step.SaveRatio = &saveRatio
+	}
+	return []Step{step}
+}
+
+func main() {
+	addr := flag.String("addr", ":8081", "listen address")
+	scenarioPath := flag.String("scenario", "", "scenario JSON file, overrides the options below")
+	latency := flag.Int("latency", 0, "delay before answering in ms")
+	jitter := flag.Int("jitter", 0, "random extra delay up to this in ms")
+	saveRatio := flag.Float64("save-ratio", 1, "share of readings saved per post")
+	failRatio := flag.Float64("fail-ratio", 0, "chance of answering 500")
+	drip := flag.Int("drip", 0, "send the response body one byte at a time over this many ms")
+	chunked := flag.Bool("chunked", false, "use chunked transfer encoding")
+	seed := flag.Int64("seed", 1, "seed for jitter and failures")
+	logPath := flag.String("log", "", "write one CSV line per request to this file")
+	verbose := flag.Bool("v", false, "log every request")
+	flag.Parse()
+
+	scenario := &Scenario{Seed: *seed,
+		Readings: singleStep(*latency, *jitter, *drip, *saveRatio, *failRatio, *chunked)}
+	if *scenarioPath != "" {
+		var err error
+		if scenario, err = loadScenario(*scenarioPath); err != nil {
+			log.Fatal(err)
+		}
+		if scenario.Seed == 0 {
+			scenario.Seed = *seed
+		}
+	}
+
+	stats, err := NewStats(*logPath)
+	if err != nil {
+		log.Fatal(err)
+	}
+	server := &Server{
+		readings: NewScript(scenario.Readings, scenario.Seed),
+		status:   NewScript(scenario.Status, scenario.Seed+1),
+		stats:    stats,
+		verbose:  *verbose,
+	}
+
+	go func() {
+		signals := make(chan os.Signal, 1)
+		signal.Notify(signals, os.Interrupt, syscall.SIGTERM)
+		<-signals
+		out := bufio.NewWriter(os.Stdout)
+		stats.Print(out)
+		out.Flush()
+		stats.Close()
+		os.Exit(0)
+	}()
+
+	fmt.Printf("Backend stand-in on %s, POST to %s and %s, GET /stats\n",
+		*addr, readingsPath, statusPath)
+	log.Fatal(http.ListenAndServe(*addr, server))
+}
@@ -0,0 +1,133 @@
+package main
+
+import (
+	"encoding/json"
+	"fmt"
+	"math/rand"
+	"os"
+	"sync"
+	"time"
+)
+
+// Command is one entry the status endpoint hands out, same fields as the
+// backend: status in_transit connects a Sensor Unit, delivered disconnects it
+type Command struct {
+	SensorUnitID string `json:"sensor_unit_id"`
+	Status       string `json:"status"`
+}
+
+// Step describes how the emulator answers for a number of requests or
+// seconds. Zero values mean a normal, fast, fully saved answer
+type Step struct {
+	Requests  int       `json:"requests"`   // step length in requests
+	Seconds   float64   `json:"seconds"`    // or in seconds from the step's first request
+	LatencyMs int       `json:"latency_ms"` // delay before answering
+	JitterMs  int       `json:"jitter_ms"`  // plus a random delay up to this
+	Status    int       `json:"status"`     // HTTP status, default 200
+	FailRatio float64   `json:"fail_ratio"` // chance of a 500 instead
+	APIStatus string    `json:"api_status"` // "status" in the body, default "ok"
+	SaveRatio *float64  `json:"save_ratio"` // share of readings saved, default 1
+	SaveMax   *int      `json:"save_max"`   // cap on saved readings
+	DripMs    int       `json:"drip_ms"`    // send the body one byte at a time over this
+	Chunked   bool      `json:"chunked"`    // chunked transfer encoding instead of Content-Length
+	PadBytes  int       `json:"pad_bytes"`  // extra padding field to grow the body
+	Drop      bool      `json:"drop"`       // close the connection without answering
+	Commands  []Command `json:"commands"`   // status endpoint, one per request
+}
+
+// Scenario has one list of steps per endpoint. The last step of a list
+// stays in effect once the list is used up
+type Scenario struct {
+	Seed     int64  `json:"seed"`
+	Readings []Step `json:"readings"`
+	Status   []Step `json:"status"`
+}
+
+func loadScenario(path string) (*Scenario, error) {
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return nil, err
+	}
+	var scenario Scenario
+	if err := json.Unmarshal(data, &scenario); err != nil {
+		return nil, fmt.Errorf("%s: %w", path, err)
+	}
+	return &scenario, nil
+}
+
+// Script walks through the steps of one endpoint. The Control Unit sends
+// one request at a time, so a seeded run always gives the same answers
+type Script struct {
+	mu        sync.Mutex
+	steps     []Step
+	index     int
+	served    int       // requests served in the current step
+	startedAt time.Time // first request in the current step
+	commands  int       // commands handed out in the current step
+	rng       *rand.Rand
+}
+
+func NewScript(steps []Step, seed int64) *Script {
+	if len(steps) == 0 {
+		steps = []Step{{}}
+	}
+	return &Script{steps: steps, rng: rand.New(rand.NewSource(seed))}
+}
+
+// Decision is the answer for one request, resolved from the current step
+type Decision struct {
+	Step
+	StepIndex int
+	Latency   time.Duration
+	Fail      bool
+	Command   *Command
+}
+
+// Next returns the answer for the next request and advances the script
+func (s *Script) Next() Decision {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	now := time.Now()
+	for s.index < len(s.steps)-1 {
+		step := s.steps[s.index]
+		doneByCount := step.Requests > 0 && s.served >= step.Requests
+		doneByTime := step.Seconds > 0 && s.served > 0 &&
+			now.Sub(s.startedAt).Seconds() >= step.Seconds
+		if !doneByCount && !doneByTime {
+			break
+		}
+		s.index++
+		s.served = 0
+		s.commands = 0
+	}
+	if s.served == 0 {
+		s.startedAt = now
+	}
+	s.served++
+
+	step := s.steps[s.index]
+	decision := Decision{Step: step, StepIndex: s.index}
+	decision.Latency = time.Duration(step.LatencyMs) * time.Millisecond
+	if step.JitterMs > 0 {
+		decision.Latency += time.Duration(s.rng.Intn(step.JitterMs)) * time.Millisecond
+	}
+	decision.Fail = step.FailRatio > 0 && s.rng.Float64() < step.FailRatio
+	if s.commands < len(step.Commands) {
+		decision.Command = &step.Commands[s.commands]
+		s.commands++
+	}
+	return decision
+}
+
+// saved returns how many of received readings the step saves
+func (d Decision) saved(received int) int {
+	saved := received
+	if d.SaveRatio != nil {
+		saved = int(float64(received) * *d.SaveRatio)
+	}
+	if d.SaveMax != nil && saved > *d.SaveMax {
+		saved = *d.SaveMax
+	}
+	return saved
+}
@@ -0,0 +1,149 @@
+package main
+
+import (
+	"encoding/csv"
+	"fmt"
+	"io"
+	"os"
+	"strconv"
+	"sync"
+	"time"
+)
+
+// Stats tracks what the Control Unit sent, to measure catch-up and retries
+type Stats struct {
+	mu           sync.Mutex
+	start        time.Time
+	Requests     map[string]int `json:"requests"`
+	Statuses     map[string]int `json:"statuses"` // "endpoint status"
+	Dropped      int            `json:"dropped"`
+	EmptyPosts   int            `json:"empty_posts"` // timestamp_groups: []
+	Received     int            `json:"readings_received"`
+	Saved        int            `json:"readings_saved"`
+	Duplicates   int            `json:"readings_duplicate"` // already saved before
+	MaxBatch     int            `json:"max_batch"`
+	MaxBodyBytes int            `json:"max_body_bytes"`
+	LastSavedAt  float64        `json:"last_saved_s"` // seconds since start
+	saved        map[readingKey]bool
+	log          *csv.Writer
+	logFile      io.Closer
+}
+
+func NewStats(logPath string) (*Stats, error) {
+	s := &Stats{
+		start:    time.Now(),
+		Requests: map[string]int{},
+		Statuses: map[string]int{},
+		saved:    map[readingKey]bool{},
+	}
+	if logPath != "" {
+		file, err := os.Create(logPath)
+		if err != nil {
+			return nil, err
+		}
+		s.logFile = file
+		s.log = csv.NewWriter(file)
+		s.log.Write([]string{"time_s", "endpoint", "step", "status", "bytes",
+			"readings", "saved", "duplicates", "oldest_age_s", "latency_ms"})
+	}
+	return s, nil
+}
+
+// Request is what is known about one request once it has been answered
+type Request struct {
+	Endpoint   string
+	Step       int
+	Status     int // 0 when dropped
+	Bytes      int
+	Readings   []readingKey
+	Saved      int
+	OldestUnix int64
+	Latency    time.Duration
+}
+
+type readingKey struct {
+	unit      string
+	timestamp int64
+}
+
+func (s *Stats) Record(r Request) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	now := time.Since(s.start).Seconds()
+
+	s.Requests[r.Endpoint]++
+	if r.Status == 0 {
+		s.Dropped++
+	} else {
+		s.Statuses[fmt.Sprintf("%s %d", r.Endpoint, r.Status)]++
+	}
+	if r.Bytes > s.MaxBodyBytes {
+		s.MaxBodyBytes = r.Bytes
+	}
+
+	duplicates := 0
+	oldestAge := 0.0
+	if r.Endpoint == readingsPath {
+		if len(r.Readings) == 0 {
+			s.EmptyPosts++
+		}
+		if len(r.Readings) > s.MaxBatch {
+			s.MaxBatch = len(r.Readings)
+		}
+		s.Received += len(r.Readings)
+		for i, key := range r.Readings {
+			if s.saved[key] {
+				duplicates++
+			} else if i < r.Saved {
+				s.saved[key] = true
+			}
+		}
+		s.Duplicates += duplicates
+		s.Saved += r.Saved
+		if r.Saved > 0 {
+			s.LastSavedAt = now
+		}
+		if r.OldestUnix > 0 {
+			oldestAge = float64(time.Now().Unix() - r.OldestUnix)
+		}
+	}
+
+	if s.log != nil {
+		s.log.Write([]string{
+			strconv.FormatFloat(now, 'f', 3, 64),
+			r.Endpoint,
+			strconv.Itoa(r.Step),
+			strconv.Itoa(r.Status),
+			strconv.Itoa(r.Bytes),
+			strconv.Itoa(len(r.Readings)),
+			strconv.Itoa(r.Saved),
+			strconv.Itoa(duplicates),
+			strconv.FormatFloat(oldestAge, 'f', 0, 64),
+			strconv.FormatFloat(float64(r.Latency.Microseconds())/1000, 'f', 1, 64),
+		})
+		s.log.Flush()
+	}
+}
+
+func (s *Stats) Print(w io.Writer) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	fmt.Fprintf(w, "\nAfter %.0fs\n", time.Since(s.start).Seconds())
+	for endpoint, count := range s.Requests {
+		fmt.Fprintf(w, "  %-32s %6d requests\n", endpoint, count)
+	}
+	for status, count := range s.Statuses {
+		fmt.Fprintf(w, "  %-32s %6d\n", status, count)
+	}
+	fmt.Fprintf(w, "  dropped connections %d, empty posts %d\n", s.Dropped, s.EmptyPosts)
+	fmt.Fprintf(w, "  readings received %d, saved %d, duplicates %d, largest batch %d\n",
+		s.Received, s.Saved, s.Duplicates, s.MaxBatch)
+	fmt.Fprintf(w, "  largest body %d bytes, last saved at %.1fs\n", s.MaxBodyBytes, s.LastSavedAt)
+}
+
+func (s *Stats) Close() {
+	if s.logFile != nil {
+		s.log.Flush()
+		s.logFile.Close()
+	}
+}
@@ -0,0 +1,364 @@
+/**
+ * @file host_main.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Entry point for the Linux host build of the Control Unit
+ *
+ * Starts the same components in the same order as app_main in main/main.cpp,
+ * but takes the settings from wifi_config.h as command line options or
+ * environment variables instead. Runs until SIGINT/SIGTERM or --run-seconds
+ * and then shuts everything down so leak checkers get a clean exit.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "BackendIoTask.h"
+#include "ControlUnitManager.h"
+#include "DeferredLog.h"
+#include "JobScheduler.h"
+#include "MockDataGenerator.h"
+#include "ReadingsDispatcher.h"
+#include "ResourceMonitor.h"
+#include "RestClient.h"
+#include "RestServer.h"
+#include "SensorUnitLinkSyncer.h"
+#include "SensorUnitManager.h"
+#include "TimeSyncManager.h"
+#include "host_shim.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <esp_log.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+static constexpr const char* TAG = "HostMain";
+
+/// Same id scheme as UnitID() in sensorunit/helpers/loadgen/payload.go
+static constexpr const char* LOADGEN_UNIT_ID_PREFIX =
+    "5e750000-0000-4000-8000-";
+
+struct HostConfig {
+    uint16_t    port = 8080;
+    std::string backendUrl{"http://localhost:8080/post"};
+    std::string jwt{"host-jwt"};
+    std::string controlUnitId{"f47ac10b-58cc-4372-a567-0e02b2c3d479"};
+    uint64_t    dispatchIntervalMs  = 30'000;
+    bool        adaptiveDispatch    = true;
+    uint64_t    dispatchMinMs       = 2'000;
+    uint64_t    dispatchMaxMs       = 300'000;
+    size_t      dispatchBacklog     = 200;
+    uint64_t    syncIntervalMs      = 8'000;
+    uint64_t    mockIntervalMs      = 0; /**< 0 disables mocked readings */
+    uint64_t    resourcesIntervalMs = 30'000;
+    UploadSlotConfig         uploadSlots;
+    std::vector<std::string> units;
+    int                      loadgenUnits   = 0;
+    int                      runSeconds     = 0; /**< 0 runs until a signal */
+    esp_log_level_t          logLevel       = ESP_LOG_INFO;
+    bool                     deferredLog    = true;
+    size_t                   logBufferBytes = 8192;
+};
+
+static void printUsage(const char* argv0) {
+    std::printf(
+        "Usage: %s [options]\n"
+        "  --port N                 REST server port (CU_HOST_PORT, 8080)\n"
+        "  --backend-url URL        Backend base URL (CU_BACKEND_URL)\n"
+        "  --jwt TOKEN              Backend JWT (CU_JWT)\n"
+        "  --control-unit-id UUID   Control unit id (CU_CONTROL_UNIT_ID)\n"
+        "  --dispatch-interval-ms N Readings dispatch interval (30000)\n"
+        "  --dispatch-mode MODE     fixed|adaptive (adaptive)\n"
+        "  --dispatch-min-ms N      Adaptive min interval (2000)\n"
+        "  --dispatch-max-ms N      Adaptive max backoff (300000)\n"
+        "  --dispatch-backlog N     Adaptive backlog threshold (200)\n"
+        "  --sync-interval-ms N     Sensor unit link sync interval (8000)\n"
+        "  --mock-interval-ms N     Generate mocked readings, 0 is off (0)\n"
+        "  --resources-interval-ms N Resource monitor log interval (30000)\n"
+        "  --upload-period-s N      Upload window period, 0 is off (60)\n"
+        "  --upload-window-s N      Upload window length (5)\n"
+        "  --upload-units N         Units per upload window (3)\n"
+        "  --add-unit UUID          Register a sensor unit, repeatable\n"
+        "  --loadgen-units N        Register the first N loadgen units (0)\n"
+        "  --run-seconds N          Exit after N seconds, 0 runs until "
+        "SIGINT (0)\n"
+        "  --log-level LEVEL        none|error|warn|info|debug|verbose "
+        "(info)\n"
+        "  --deferred-log 0|1       Write the log from the LogDrain task (1)\n"
+        "  --log-buffer-bytes N     Deferred log buffer size (8192)\n",
+        argv0);
+}
+
+static bool parseLogLevel(const char* name, esp_log_level_t& level) {
+    static const std::pair<const char*, esp_log_level_t> levels[] = {
+        {"none", ESP_LOG_NONE},
+        {"error", ESP_LOG_ERROR},
+        {"warn", ESP_LOG_WARN},
+        {"info", ESP_LOG_INFO},
+        {"debug", ESP_LOG_DEBUG},
+        {"verbose", ESP_LOG_VERBOSE},
+    };
+    for (const auto& [levelName, value] : levels) {
+        if (std::strcmp(name, levelName) == 0) {
+            level = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseArgs(int argc, char** argv, HostConfig& config) {
+    if (const char* env = std::getenv("CU_HOST_PORT")) {
+        config.port = static_cast<uint16_t>(std::atoi(env));
+    }
+    if (const char* env = std::getenv("CU_BACKEND_URL")) {
+        config.backendUrl = env;
+    }
+    if (const char* env = std::getenv("CU_JWT")) {
+        config.jwt = env;
+    }
+    if (const char* env = std::getenv("CU_CONTROL_UNIT_ID")) {
+        config.controlUnitId = env;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(EXIT_SUCCESS);
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--port") {
+            config.port = static_cast<uint16_t>(std::atoi(value));
+        } else if (arg == "--backend-url") {
+            config.backendUrl = value;
+        } else if (arg == "--jwt") {
+            config.jwt = value;
+        } else if (arg == "--control-unit-id") {
+            config.controlUnitId = value;
+        } else if (arg == "--dispatch-interval-ms") {
+            config.dispatchIntervalMs = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--dispatch-mode") {
+            if (std::strcmp(value, "fixed") != 0 &&
+                std::strcmp(value, "adaptive") != 0) {
+                std::fprintf(stderr, "Unknown dispatch mode %s\n", value);
+                return false;
+            }
+            config.adaptiveDispatch = std::strcmp(value, "adaptive") == 0;
+        } else if (arg == "--dispatch-min-ms") {
+            config.dispatchMinMs = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--dispatch-max-ms") {
+            config.dispatchMaxMs = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--dispatch-backlog") {
+            config.dispatchBacklog = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--sync-interval-ms") {
+            config.syncIntervalMs = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--mock-interval-ms") {
+            config.mockIntervalMs = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--resources-interval-ms") {
+            config.resourcesIntervalMs = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--upload-period-s") {
+            config.uploadSlots.periodS = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--upload-window-s") {
+            config.uploadSlots.windowS = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--upload-units") {
+            config.uploadSlots.unitsPerWindow = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--add-unit") {
+            config.units.emplace_back(value);
+        } else if (arg == "--loadgen-units") {
+            config.loadgenUnits = std::atoi(value);
+        } else if (arg == "--run-seconds") {
+            config.runSeconds = std::atoi(value);
+        } else if (arg == "--log-level") {
+            if (!parseLogLevel(value, config.logLevel)) {
+                std::fprintf(stderr, "Unknown log level %s\n", value);
+                return false;
+            }
+        } else if (arg == "--deferred-log") {
+            config.deferredLog = std::atoi(value) != 0;
+        } else if (arg == "--log-buffer-bytes") {
+            config.logBufferBytes = std::strtoull(value, nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Blocks until SIGINT/SIGTERM or until runSeconds have passed
+ *
+ * The signals are blocked in every thread before any task is created, so
+ * they are only ever delivered here.
+ */
+static void waitForShutdown(const sigset_t& signals, int runSeconds) {
+    int signal = 0;
+    if (runSeconds > 0) {
+        timespec timeout{runSeconds, 0};
+        signal = sigtimedwait(&signals, nullptr, &timeout);
+    } else {
+        sigwait(&signals, &signal);
+    }
+    if (signal > 0) {
+        ESP_LOGI(TAG, "Received %s, shutting down", strsignal(signal));
+    } else {
+        ESP_LOGI(TAG, "Run time elapsed, shutting down");
+    }
+}
+
+int main(int argc, char** argv) {
+    HostConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    // Line buffered so logs show up right away when piped
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    esp_log_level_set("*", config.logLevel);
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    // As CONFIG_CU_LOG_DEFERRED, first so every later line goes through it
+    DeferredLog deferredLog(config.logBufferBytes);
+    if (config.deferredLog) {
+        deferredLog.start();
+    }
+
+    TimeSyncManager timeSyncManager;
+    timeSyncManager.start();
+
+    SensorUnitManager sensorUnitManager(config.uploadSlots);
+    sensorUnitManager.init();
+    for (const auto& unit : config.units) {
+        sensorUnitManager.addUnit(Uuid(unit));
+    }
+    for (int i = 0; i < config.loadgenUnits; ++i) {
+        char id[40];
+        std::snprintf(id, sizeof(id), "%s%012d", LOADGEN_UNIT_ID_PREFIX, i);
+        sensorUnitManager.addUnit(Uuid(id));
+    }
+
+    // Before the server, which serves the monitor on GET /resources
+    JobScheduler scheduler;
+    scheduler.start();
+    ResourceMonitorConfig monitorConfig;
+    monitorConfig.intervalUs = config.resourcesIntervalMs * 1000;
+    ResourceMonitor resourceMonitor(scheduler, monitorConfig);
+
+    RestServer server(
+        config.port, timeSyncManager, sensorUnitManager, &resourceMonitor);
+    if (!server.start()) {
+        ESP_LOGE(TAG, "Could not start REST server on port %u", config.port);
+        deferredLog.stop();
+        host_shim_shutdown();
+        return EXIT_FAILURE;
+    }
+
+    RestClient client(config.backendUrl, config.jwt);
+    client.init();
+    BackendIoTask backendIo(client);
+    backendIo.start();
+    resourceMonitor.start();
+
+    ControlUnitManager controlUnitManager(sensorUnitManager,
+                                          config.controlUnitId);
+
+    std::unique_ptr<MockDataGenerator> mockdataGenerator;
+    if (config.mockIntervalMs > 0) {
+        mockdataGenerator = std::make_unique<MockDataGenerator>(
+            scheduler, controlUnitManager, config.mockIntervalMs * 1000);
+        mockdataGenerator->start();
+    }
+
+    std::unique_ptr<ReadingsDispatcher> dispatcher;
+    if (config.adaptiveDispatch) {
+        DispatchPolicyConfig policy;
+        policy.baseIntervalUs   = config.dispatchIntervalMs * 1000;
+        policy.minIntervalUs    = config.dispatchMinMs * 1000;
+        policy.maxIntervalUs    = config.dispatchMaxMs * 1000;
+        policy.backlogThreshold = config.dispatchBacklog;
+        dispatcher              = std::make_unique<ReadingsDispatcher>(
+            backendIo, scheduler, controlUnitManager, policy);
+    } else {
+        dispatcher = std::make_unique<ReadingsDispatcher>(
+            backendIo,
+            scheduler,
+            controlUnitManager,
+            config.dispatchIntervalMs * 1000);
+    }
+    dispatcher->start();
+
+    SensorUnitLinkSyncer statusPoller(backendIo,
+                                      scheduler,
+                                      sensorUnitManager,
+                                      config.syncIntervalMs * 1000,
+                                      config.controlUnitId);
+    statusPoller.start();
+
+    waitForShutdown(signals, config.runSeconds);
+
+    // Triggers first so no new work is queued, then the request in flight,
+    // then the scheduler, then the server, then tasks
+    resourceMonitor.stop();
+    statusPoller.stop();
+    dispatcher->stop();
+    if (mockdataGenerator) {
+        mockdataGenerator->stop();
+    }
+    backendIo.stop();
+    scheduler.stop();
+    DispatchMetrics metrics = dispatcher->metrics();
+    ESP_LOGI(TAG,
+             "Dispatcher: %u posts, %u failed, backlog %zu, interval %llu ms",
+             metrics.posts,
+             metrics.failedPosts,
+             metrics.backlog,
+             static_cast<unsigned long long>(metrics.intervalUs / 1000));
+    BackendIoStats ioStats = backendIo.stats();
+    ESP_LOGI(TAG,
+             "BackendIoTask: %u jobs, %u completed, %u dropped, %u rejected, "
+             "%u prepared during a request",
+             ioStats.submitted,
+             ioStats.completed,
+             ioStats.dropped,
+             ioStats.rejected,
+             ioStats.overlapped);
+    for (const JobStats& job : scheduler.stats()) {
+        ESP_LOGI(TAG,
+                 "Job %s: %u runs, %u overruns, latency avg %llu us max %llu "
+                 "us, run max %llu us",
+                 job.name,
+                 job.runs,
+                 job.overruns,
+                 static_cast<unsigned long long>(
+                     job.runs ? job.totalLatencyUs / job.runs : 0),
+                 static_cast<unsigned long long>(job.maxLatencyUs),
+                 static_cast<unsigned long long>(job.maxRunUs));
+    }
+    server.stop();
+    // Last, the lines above are still in the buffer
+    deferredLog.stop();
+    if (config.deferredLog) {
+        DeferredLogStats logStats = deferredLog.stats();
+        ESP_LOGI(TAG,
+                 "DeferredLog: %u lines written, %u dropped",
+                 logStats.written,
+                 logStats.dropped);
+    }
+    host_shim_shutdown();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file esp_crt_bundle.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF certificate bundle
+ *
+ * The host HTTP client only speaks plain HTTP, so there is nothing to attach.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline esp_err_t esp_crt_bundle_attach(void* conf) {
+    (void) conf;
+    return ESP_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+/**
+ * @file esp_heap_caps.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF capability heap API
+ *
+ * Reports the simulated heap of esp_system.h for every capability. The host
+ * heap does not fragment like the device heap, so the largest free block is
+ * the free size.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,206 @@
+/**
+ * @file esp_http_client.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF HTTP client
+ *
+ * Plain HTTP/1.1 over POSIX sockets. TLS is not available on the host, an
+ * https:// URL fails with ESP_ERR_HTTP_CONNECT, so point the backend URL at
+ * an http:// test server. Content-Length, chunked and close delimited
+ * responses are supported, connections are reused between requests until
+ * esp_http_client_close() and ON_DATA delivers decoded body bytes, like
+ * ESP-IDF. Redirects are not followed.
+ *
+ * With is_async set, esp_http_client_perform() runs the request on a helper
+ * thread and returns ESP_ERR_HTTP_EAGAIN until it is done. The event handler
+ * is then called from the helper thread.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_ERR_HTTP_BASE (0x7000)
+#define ESP_ERR_HTTP_MAX_REDIRECT (ESP_ERR_HTTP_BASE + 1)
+#define ESP_ERR_HTTP_CONNECT (ESP_ERR_HTTP_BASE + 2)
+#define ESP_ERR_HTTP_WRITE_DATA (ESP_ERR_HTTP_BASE + 3)
+#define ESP_ERR_HTTP_FETCH_HEADER (ESP_ERR_HTTP_BASE + 4)
+#define ESP_ERR_HTTP_INVALID_TRANSPORT (ESP_ERR_HTTP_BASE + 5)
+#define ESP_ERR_HTTP_CONNECTING (ESP_ERR_HTTP_BASE + 6)
+#define ESP_ERR_HTTP_EAGAIN (ESP_ERR_HTTP_BASE + 7)
+#define ESP_ERR_HTTP_CONNECTION_CLOSED (ESP_ERR_HTTP_BASE + 8)
+
+#define DEFAULT_HTTP_BUF_SIZE (512)
+
+typedef struct esp_http_client* esp_http_client_handle_t;
+
+typedef enum {
+    HTTP_EVENT_ERROR = 0,
+    HTTP_EVENT_ON_CONNECTED,
+    HTTP_EVENT_HEADERS_SENT,
+    HTTP_EVENT_HEADER_SENT = HTTP_EVENT_HEADERS_SENT,
+    HTTP_EVENT_ON_HEADER,
+    HTTP_EVENT_ON_DATA,
+    HTTP_EVENT_ON_FINISH,
+    HTTP_EVENT_DISCONNECTED,
+    HTTP_EVENT_REDIRECT,
+} esp_http_client_event_id_t;
+
+typedef struct esp_http_client_event {
+    esp_http_client_event_id_t event_id;
+    esp_http_client_handle_t   client;
+    void*                      data;
+    int                        data_len;
+    void*                      user_data;
+    char*                      header_key;
+    char*                      header_value;
+} esp_http_client_event_t;
+
+typedef esp_http_client_event_t* esp_http_client_event_handle_t;
+
+typedef esp_err_t (*http_event_handle_cb)(esp_http_client_event_t* evt);
+
+typedef enum {
+    HTTP_TRANSPORT_UNKNOWN = 0x0,
+    HTTP_TRANSPORT_OVER_TCP,
+    HTTP_TRANSPORT_OVER_SSL,
+} esp_http_client_transport_t;
+
+typedef enum {
+    HTTP_METHOD_GET = 0,
+    HTTP_METHOD_POST,
+    HTTP_METHOD_PUT,
+    HTTP_METHOD_PATCH,
+    HTTP_METHOD_DELETE,
+    HTTP_METHOD_HEAD,
+    HTTP_METHOD_MAX,
+} esp_http_client_method_t;
+
+typedef struct {
+    const char*                 url;
+    const char*                 host;
+    int                         port;
+    const char*                 path;
+    const char*                 query;
+    const char*                 cert_pem;
+    esp_http_client_method_t    method;
+    int                         timeout_ms;
+    bool                        disable_auto_redirect;
+    int                         max_redirection_count;
+    http_event_handle_cb        event_handler;
+    esp_http_client_transport_t transport_type;
+    int                         buffer_size;
+    int                         buffer_size_tx;
+    void*                       user_data;
+    bool                        is_async;
+    bool                        use_global_ca_store;
+    bool                        skip_cert_common_name_check;
+    esp_err_t (*crt_bundle_attach)(void* conf);
+    bool keep_alive_enable;
+    int  keep_alive_idle;
+    int  keep_alive_interval;
+    int  keep_alive_count;
+} esp_http_client_config_t;
+
+typedef enum {
+    HttpStatus_Ok                 = 200,
+    HttpStatus_MultipleChoices    = 300,
+    HttpStatus_MovedPermanently   = 301,
+    HttpStatus_Found              = 302,
+    HttpStatus_TemporaryRedirect  = 307,
+    HttpStatus_BadRequest         = 400,
+    HttpStatus_Unauthorized       = 401,
+    HttpStatus_Forbidden          = 403,
+    HttpStatus_NotFound           = 404,
+    HttpStatus_InternalError      = 500,
+    HttpStatus_ServiceUnavailable = 503,
+} HttpStatus_Code;
+
+esp_http_client_handle_t
+esp_http_client_init(const esp_http_client_config_t* config);
+
+/**
+ * @brief Sends the request and reads the whole response
+ *
+ * Connects (or reuses a kept-alive connection), sends headers and the post
+ * field, and feeds the response body to the event handler as ON_DATA.
+ */
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client);
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client,
+                                  const char*              url);
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client,
+                                     esp_http_client_method_t method);
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client,
+                                     const char*              key,
+                                     const char*              value);
+esp_err_t esp_http_client_get_header(esp_http_client_handle_t client,
+                                     const char*              key,
+                                     char**                   value);
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client,
+                                        const char*              key);
+esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t client,
+                                         int                      timeout_ms);
+
+/**
+ * @brief Sets the request body
+ *
+ * The data is not copied and must stay valid until perform() returns.
+ */
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client,
+                                         const char*              data,
+                                         int                      len);
+int       esp_http_client_get_post_field(esp_http_client_handle_t client,
+                                         char**                   data);
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len);
+int       esp_http_client_write(esp_http_client_handle_t client,
+                                const char*              buffer,
+                                int                      len);
+int64_t   esp_http_client_fetch_headers(esp_http_client_handle_t client);
+int       esp_http_client_read(esp_http_client_handle_t client,
+                               char*                    buffer,
+                               int                      len);
+int       esp_http_client_read_response(esp_http_client_handle_t client,
+                                        char*                    buffer,
+                                        int                      len);
+esp_err_t esp_http_client_flush_response(esp_http_client_handle_t client,
+                                         int*                     len);
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t client);
+
+int     esp_http_client_get_status_code(esp_http_client_handle_t client);
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t client);
+bool    esp_http_client_is_chunked_response(esp_http_client_handle_t client);
+esp_err_t esp_http_client_get_chunk_length(esp_http_client_handle_t client,
+                                           int*                     len);
+
+esp_http_client_transport_t
+esp_http_client_get_transport_type(esp_http_client_handle_t client);
+
+esp_err_t esp_http_client_get_user_data(esp_http_client_handle_t client,
+                                        void**                   data);
+esp_err_t esp_http_client_set_user_data(esp_http_client_handle_t client,
+                                        void*                    data);
+
+/**
+ * @brief Closes the connection but keeps the client
+ */
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+
+/**
+ * @brief Closes the connection and frees the client
+ */
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
+
+#ifdef __cplusplus
+}
+#endif
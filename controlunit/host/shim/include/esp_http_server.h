@@ -0,0 +1,207 @@
+/**
+ * @file esp_http_server.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF HTTP server
+ *
+ * Like esp_http_server, one server thread accepts connections, parses
+ * requests and runs every URI handler. It keeps at most max_open_sockets
+ * sessions open, with optional LRU purge, and uses keep-alive. A handler
+ * that returns anything but ESP_OK gets its session closed. Request bodies
+ * must carry a Content-Length, chunked request bodies are not supported.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_ERR_HTTPD_BASE (0xb000)
+#define ESP_ERR_HTTPD_HANDLERS_FULL (ESP_ERR_HTTPD_BASE + 1)
+#define ESP_ERR_HTTPD_HANDLER_EXISTS (ESP_ERR_HTTPD_BASE + 2)
+#define ESP_ERR_HTTPD_INVALID_REQ (ESP_ERR_HTTPD_BASE + 3)
+#define ESP_ERR_HTTPD_RESULT_TRUNC (ESP_ERR_HTTPD_BASE + 4)
+#define ESP_ERR_HTTPD_RESP_HDR (ESP_ERR_HTTPD_BASE + 5)
+#define ESP_ERR_HTTPD_RESP_SEND (ESP_ERR_HTTPD_BASE + 6)
+#define ESP_ERR_HTTPD_ALLOC_MEM (ESP_ERR_HTTPD_BASE + 7)
+#define ESP_ERR_HTTPD_TASK (ESP_ERR_HTTPD_BASE + 8)
+
+#define HTTPD_MAX_REQ_HDR_LEN 1024
+#define HTTPD_MAX_URI_LEN 512
+
+#define HTTPD_RESP_USE_STRLEN -1
+
+#define HTTPD_SOCK_ERR_FAIL -1
+#define HTTPD_SOCK_ERR_INVALID -2
+#define HTTPD_SOCK_ERR_TIMEOUT -3
+
+#define HTTPD_200 "200 OK"
+#define HTTPD_204 "204 No Content"
+#define HTTPD_207 "207 Multi-Status"
+#define HTTPD_400 "400 Bad Request"
+#define HTTPD_404 "404 Not Found"
+#define HTTPD_408 "408 Request Timeout"
+#define HTTPD_500 "500 Internal Server Error"
+
+#define HTTPD_TYPE_JSON "application/json"
+#define HTTPD_TYPE_TEXT "text/html"
+#define HTTPD_TYPE_OCTET "application/octet-stream"
+
+/** Same values as http_parser, which ESP-IDF uses for httpd methods */
+typedef enum {
+    HTTP_DELETE = 0,
+    HTTP_GET    = 1,
+    HTTP_HEAD   = 2,
+    HTTP_POST   = 3,
+    HTTP_PUT    = 4,
+    HTTP_PATCH  = 28,
+    HTTP_ANY    = -1,
+} httpd_method_t;
+
+typedef void* httpd_handle_t;
+
+typedef void (*httpd_free_ctx_fn_t)(void* ctx);
+
+typedef struct httpd_req {
+    httpd_handle_t      handle;      /**< Server the request arrived on */
+    int                 method;      /**< One of httpd_method_t */
+    char                uri[HTTPD_MAX_URI_LEN + 1]; /**< URI incl. query */
+    size_t              content_len; /**< Request body length */
+    void*               aux;         /**< Shim internal request state */
+    void*               user_ctx;    /**< user_ctx of the matched URI */
+    void*               sess_ctx;    /**< Per session context */
+    httpd_free_ctx_fn_t free_ctx;    /**< Frees sess_ctx on close */
+} httpd_req_t;
+
+typedef struct httpd_uri {
+    const char*    uri;
+    httpd_method_t method;
+    esp_err_t (*handler)(httpd_req_t* r);
+    void* user_ctx;
+} httpd_uri_t;
+
+typedef enum {
+    HTTPD_500_INTERNAL_SERVER_ERROR = 0,
+    HTTPD_501_METHOD_NOT_IMPLEMENTED,
+    HTTPD_505_VERSION_NOT_SUPPORTED,
+    HTTPD_400_BAD_REQUEST,
+    HTTPD_401_UNAUTHORIZED,
+    HTTPD_403_FORBIDDEN,
+    HTTPD_404_NOT_FOUND,
+    HTTPD_405_METHOD_NOT_ALLOWED,
+    HTTPD_408_REQ_TIMEOUT,
+    HTTPD_411_LENGTH_REQUIRED,
+    HTTPD_414_URI_TOO_LONG,
+    HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE,
+    HTTPD_ERR_CODE_MAX
+} httpd_err_code_t;
+
+typedef struct httpd_config {
+    unsigned            task_priority;     /**< Recorded only */
+    size_t              stack_size;        /**< Recorded only */
+    BaseType_t          core_id;           /**< Recorded only */
+    uint16_t            server_port;       /**< TCP port to listen on */
+    uint16_t            ctrl_port;         /**< Unused on the host */
+    uint16_t            max_open_sockets;  /**< Max concurrent sessions */
+    uint16_t            max_uri_handlers;  /**< Max registered URIs */
+    uint16_t            max_resp_headers;  /**< Max extra response headers */
+    uint16_t            backlog_conn;      /**< listen() backlog */
+    bool                lru_purge_enable;  /**< Close the least recently used
+                                              session when full */
+    uint16_t            recv_wait_timeout; /**< Seconds */
+    uint16_t            send_wait_timeout; /**< Seconds */
+    void*               global_user_ctx;
+    httpd_free_ctx_fn_t global_user_ctx_free_fn;
+    bool                keep_alive_enable; /**< Recorded only */
+} httpd_config_t;
+
+#define HTTPD_DEFAULT_CONFIG()                                                 \
+    {                                                                          \
+        .task_priority = tskIDLE_PRIORITY + 5, .stack_size = 4096,             \
+        .core_id = tskNO_AFFINITY, .server_port = 80, .ctrl_port = 32768,      \
+        .max_open_sockets = 7, .max_uri_handlers = 8, .max_resp_headers = 8,   \
+        .backlog_conn = 5, .lru_purge_enable = false,                          \
+        .recv_wait_timeout = 5, .send_wait_timeout = 5,                        \
+        .global_user_ctx = NULL, .global_user_ctx_free_fn = NULL,              \
+        .keep_alive_enable = false,                                            \
+    }
+
+esp_err_t httpd_start(httpd_handle_t* handle, const httpd_config_t* config);
+esp_err_t httpd_stop(httpd_handle_t handle);
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t     handle,
+                                     const httpd_uri_t* uri_handler);
+esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
+                                       const char*    uri,
+                                       httpd_method_t method);
+
+void* httpd_get_global_user_ctx(httpd_handle_t handle);
+
+/**
+ * @brief Reads up to buf_len bytes of the request body
+ *
+ * @return int Bytes read, 0 when the body is exhausted, or a negative
+ * HTTPD_SOCK_ERR_* value
+ */
+int httpd_req_recv(httpd_req_t* r, char* buf, size_t buf_len);
+
+size_t    httpd_req_get_hdr_value_len(httpd_req_t* r, const char* field);
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t* r,
+                                      const char*  field,
+                                      char*        val,
+                                      size_t       val_size);
+size_t    httpd_req_get_url_query_len(httpd_req_t* r);
+esp_err_t httpd_req_get_url_query_str(httpd_req_t* r,
+                                      char*        buf,
+                                      size_t       buf_len);
+int       httpd_req_to_sockfd(httpd_req_t* r);
+
+esp_err_t httpd_resp_set_status(httpd_req_t* r, const char* status);
+esp_err_t httpd_resp_set_type(httpd_req_t* r, const char* type);
+esp_err_t httpd_resp_set_hdr(httpd_req_t* r,
+                             const char*  field,
+                             const char*  value);
+esp_err_t httpd_resp_send(httpd_req_t* r, const char* buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_chunk(httpd_req_t* r,
+                                const char*  buf,
+                                ssize_t      buf_len);
+esp_err_t httpd_resp_send_err(httpd_req_t*     req,
+                              httpd_err_code_t error,
+                              const char*      usr_msg);
+
+static inline esp_err_t httpd_resp_sendstr(httpd_req_t* r, const char* str) {
+    return httpd_resp_send(r, str, (str == NULL) ? 0 : HTTPD_RESP_USE_STRLEN);
+}
+
+static inline esp_err_t httpd_resp_sendstr_chunk(httpd_req_t* r,
+                                                 const char*  str) {
+    return httpd_resp_send_chunk(
+        r, str, (str == NULL) ? 0 : HTTPD_RESP_USE_STRLEN);
+}
+
+static inline esp_err_t httpd_resp_send_404(httpd_req_t* r) {
+    return httpd_resp_send_err(r, HTTPD_404_NOT_FOUND, NULL);
+}
+
+static inline esp_err_t httpd_resp_send_408(httpd_req_t* r) {
+    return httpd_resp_send_err(r, HTTPD_408_REQ_TIMEOUT, NULL);
+}
+
+static inline esp_err_t httpd_resp_send_500(httpd_req_t* r) {
+    return httpd_resp_send_err(r, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+}
+
+#ifdef __cplusplus
+}
+#endif
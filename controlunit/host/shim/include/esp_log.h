@@ -0,0 +1,151 @@
+/**
+ * @file esp_log.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF logging API
+ *
+ * Keeps the ESP-IDF output format ("I (1234) TAG: message"), the per tag
+ * runtime levels and the compile time cut-off through LOG_LOCAL_LEVEL, so
+ * logging cost on the host is representative of the device.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_err.h"
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+typedef int (*vprintf_like_t)(const char*, va_list);
+
+#ifndef CONFIG_LOG_MAXIMUM_LEVEL
+#define CONFIG_LOG_MAXIMUM_LEVEL 5
+#endif
+
+#ifndef CONFIG_LOG_DEFAULT_LEVEL
+#define CONFIG_LOG_DEFAULT_LEVEL 3
+#endif
+
+#ifndef LOG_LOCAL_LEVEL
+#define LOG_LOCAL_LEVEL CONFIG_LOG_MAXIMUM_LEVEL
+#endif
+
+/**
+ * @brief Sets the runtime log level for a tag, or for all tags with "*"
+ */
+void esp_log_level_set(const char* tag, esp_log_level_t level);
+
+/**
+ * @brief Returns the runtime log level that applies to a tag
+ */
+esp_log_level_t esp_log_level_get(const char* tag);
+
+/**
+ * @brief Replaces the function used to print log lines
+ *
+ * @return vprintf_like_t The previous function
+ */
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t func);
+
+/**
+ * @brief Milliseconds since the process started
+ */
+uint32_t esp_log_timestamp(void);
+
+/**
+ * @brief Writes a log line if the tag's runtime level allows it
+ *
+ * No printf format attribute here: the components log uint64_t with %llu,
+ * which is correct on the Xtensa target but would warn on x86_64
+ */
+void esp_log_write(esp_log_level_t level,
+                   const char*     tag,
+                   const char*     format,
+                   ...);
+
+/**
+ * @brief va_list version of esp_log_write
+ */
+void esp_log_writev(esp_log_level_t level,
+                    const char*     tag,
+                    const char*     format,
+                    va_list         args);
+
+#define LOG_FORMAT(letter, format) #letter " (%" PRIu32 ") %s: " format "\n"
+
+#define ESP_LOG_LEVEL(level, tag, format, ...)                                 \
+    do {                                                                       \
+        if (level == ESP_LOG_ERROR) {                                          \
+            esp_log_write(ESP_LOG_ERROR,                                       \
+                          tag,                                                 \
+                          LOG_FORMAT(E, format),                               \
+                          esp_log_timestamp(),                                 \
+                          tag,                                                 \
+                          ##__VA_ARGS__);                                      \
+        } else if (level == ESP_LOG_WARN) {                                    \
+            esp_log_write(ESP_LOG_WARN,                                        \
+                          tag,                                                 \
+                          LOG_FORMAT(W, format),                               \
+                          esp_log_timestamp(),                                 \
+                          tag,                                                 \
+                          ##__VA_ARGS__);                                      \
+        } else if (level == ESP_LOG_DEBUG) {                                   \
+            esp_log_write(ESP_LOG_DEBUG,                                       \
+                          tag,                                                 \
+                          LOG_FORMAT(D, format),                               \
+                          esp_log_timestamp(),                                 \
+                          tag,                                                 \
+                          ##__VA_ARGS__);                                      \
+        } else if (level == ESP_LOG_VERBOSE) {                                 \
+            esp_log_write(ESP_LOG_VERBOSE,                                     \
+                          tag,                                                 \
+                          LOG_FORMAT(V, format),                               \
+                          esp_log_timestamp(),                                 \
+                          tag,                                                 \
+                          ##__VA_ARGS__);                                      \
+        } else {                                                               \
+            esp_log_write(ESP_LOG_INFO,                                        \
+                          tag,                                                 \
+                          LOG_FORMAT(I, format),                               \
+                          esp_log_timestamp(),                                 \
+                          tag,                                                 \
+                          ##__VA_ARGS__);                                      \
+        }                                                                      \
+    } while (0)
+
+#define ESP_LOG_LEVEL_LOCAL(level, tag, format, ...)                           \
+    do {                                                                       \
+        if (LOG_LOCAL_LEVEL >= level)                                          \
+            ESP_LOG_LEVEL(level, tag, format, ##__VA_ARGS__);                  \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...)                                             \
+    ESP_LOG_LEVEL_LOCAL(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)                                             \
+    ESP_LOG_LEVEL_LOCAL(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)                                             \
+    ESP_LOG_LEVEL_LOCAL(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)                                             \
+    ESP_LOG_LEVEL_LOCAL(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...)                                             \
+    ESP_LOG_LEVEL_LOCAL(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file esp_sntp.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF SNTP API
+ *
+ * The host clock is already kept in sync by the OS, so these calls do
+ * nothing and the time always counts as synced.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_SNTP_OPMODE_POLL,
+    ESP_SNTP_OPMODE_LISTENONLY,
+} esp_sntp_operatingmode_t;
+
+#define SNTP_OPMODE_POLL ESP_SNTP_OPMODE_POLL
+#define SNTP_OPMODE_LISTENONLY ESP_SNTP_OPMODE_LISTENONLY
+
+typedef enum {
+    SNTP_SYNC_STATUS_RESET,
+    SNTP_SYNC_STATUS_COMPLETED,
+    SNTP_SYNC_STATUS_IN_PROGRESS,
+} sntp_sync_status_t;
+
+static inline void esp_sntp_setoperatingmode(esp_sntp_operatingmode_t mode) {
+    (void) mode;
+}
+
+static inline void esp_sntp_setservername(uint8_t idx, const char* server) {
+    (void) idx;
+    (void) server;
+}
+
+static inline void esp_sntp_init(void) {}
+
+static inline void esp_sntp_stop(void) {}
+
+static inline bool esp_sntp_enabled(void) {
+    return true;
+}
+
+static inline sntp_sync_status_t sntp_get_sync_status(void) {
+    return SNTP_SYNC_STATUS_COMPLETED;
+}
+
+#ifdef __cplusplus
+}
+#endif
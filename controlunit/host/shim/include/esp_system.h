@@ -0,0 +1,58 @@
+/**
+ * @file esp_system.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF system API
+ *
+ * The heap functions report a simulated heap: CONFIG_HOST_HEAP_SIZE minus
+ * the bytes the process has allocated since startup. Absolute numbers
+ * differ from the device but trends and leaks show up the same way in the
+ * logs.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Size of the simulated heap, roughly the free DRAM on an ESP32-S3 */
+#ifndef CONFIG_HOST_HEAP_SIZE
+#define CONFIG_HOST_HEAP_SIZE (320 * 1024)
+#endif
+
+/**
+ * @brief Returns a random 32 bit value
+ */
+uint32_t esp_random(void);
+
+/**
+ * @brief Fills a buffer with random bytes
+ */
+void esp_fill_random(void* buf, size_t len);
+
+/**
+ * @brief Free bytes of the simulated heap
+ */
+uint32_t esp_get_free_heap_size(void);
+
+/**
+ * @brief Lowest free heap seen by esp_get_free_heap_size so far
+ */
+uint32_t esp_get_minimum_free_heap_size(void);
+
+/**
+ * @brief Terminates the process, there is nothing to reboot on the host
+ */
+void esp_restart(void) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
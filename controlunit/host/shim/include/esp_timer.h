@@ -0,0 +1,77 @@
+/**
+ * @file esp_timer.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF high resolution timer API
+ *
+ * All callbacks run one at a time on a single timer thread, like the
+ * esp_timer task with ESP_TIMER_TASK dispatch. ESP_TIMER_ISR is treated the
+ * same way.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct esp_timer* esp_timer_handle_t;
+
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum {
+    ESP_TIMER_TASK,
+    ESP_TIMER_ISR,
+    ESP_TIMER_MAX,
+} esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t       callback;        /**< Called when the timer fires */
+    void*                arg;             /**< Passed to the callback */
+    esp_timer_dispatch_t dispatch_method; /**< Ignored on the host */
+    const char*          name;            /**< Used in log messages */
+    bool skip_unhandled_events; /**< Drop missed periods instead of catching
+                                   up */
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args,
+                           esp_timer_handle_t*            out_handle);
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period);
+
+esp_err_t esp_timer_restart(esp_timer_handle_t timer, uint64_t timeout_us);
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+
+/**
+ * @brief Deletes a stopped timer
+ *
+ * Waits for a callback of this timer that is running right now to finish,
+ * unless called from the callback itself.
+ */
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+bool esp_timer_is_active(esp_timer_handle_t timer);
+
+/**
+ * @brief Microseconds since the process started
+ */
+int64_t esp_timer_get_time(void);
+
+/**
+ * @brief Time of the next alarm in microseconds, or INT64_MAX if none
+ */
+int64_t esp_timer_get_next_alarm(void);
+
+#ifdef __cplusplus
+}
+#endif
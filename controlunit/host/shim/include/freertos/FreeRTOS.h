@@ -0,0 +1,192 @@
+/**
+ * @file FreeRTOS.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the FreeRTOS API used by the Control Unit
+ *
+ * Tasks are std::threads, semaphores and queues are built on a mutex and a
+ * condition variable. Scheduling is left to Linux, so priorities and core
+ * affinity are only recorded. Requested stack sizes are recorded but the
+ * threads get the default host stack, since x86_64 code with glibc printf
+ * needs a lot more stack than the Xtensa build.
+ *
+ * task.h, semphr.h and queue.h all include this file, which declares the
+ * whole API.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_err.h"
+#include "esp_system.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t     TickType_t;
+typedef int          BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define configSTACK_DEPTH_TYPE uint32_t
+
+#define portMAX_DELAY (TickType_t) 0xffffffffUL
+#define portTICK_PERIOD_MS ((TickType_t) 1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs)                                               \
+    ((TickType_t) (((uint64_t) (xTimeInMs) * configTICK_RATE_HZ) / 1000U))
+#define pdTICKS_TO_MS(xTicks)                                                  \
+    ((TickType_t) (((uint64_t) (xTicks) * 1000U) / configTICK_RATE_HZ))
+
+#define pdFALSE ((BaseType_t) 0)
+#define pdTRUE ((BaseType_t) 1)
+#define pdPASS (pdTRUE)
+#define pdFAIL (pdFALSE)
+#define errQUEUE_EMPTY ((BaseType_t) 0)
+#define errQUEUE_FULL ((BaseType_t) 0)
+#define errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY (-1)
+
+#define tskIDLE_PRIORITY ((UBaseType_t) 0U)
+#define tskNO_AFFINITY ((BaseType_t) 0x7FFFFFFF)
+
+#define portYIELD() vPortYield()
+#define taskYIELD() vPortYield()
+
+/* ---------------------------------------------------------------- tasks -- */
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite
+} eNotifyAction;
+
+BaseType_t xTaskCreate(TaskFunction_t               pxTaskCode,
+                       const char*                  pcName,
+                       const configSTACK_DEPTH_TYPE usStackDepth,
+                       void*                        pvParameters,
+                       UBaseType_t                  uxPriority,
+                       TaskHandle_t*                pxCreatedTask);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t               pxTaskCode,
+                                   const char*                  pcName,
+                                   const configSTACK_DEPTH_TYPE usStackDepth,
+                                   void*                        pvParameters,
+                                   UBaseType_t                  uxPriority,
+                                   TaskHandle_t*                pxCreatedTask,
+                                   const BaseType_t             xCoreID);
+
+/**
+ * @brief Ends a task
+ *
+ * Only deleting the calling task (NULL or its own handle) is supported. The
+ * task's stack is unwound and the thread exits.
+ */
+void vTaskDelete(TaskHandle_t xTaskToDelete);
+
+void       vTaskDelay(const TickType_t xTicksToDelay);
+BaseType_t xTaskDelayUntil(TickType_t* const pxPreviousWakeTime,
+                           const TickType_t  xTimeIncrement);
+#define vTaskDelayUntil(pxPreviousWakeTime, xTimeIncrement)                    \
+    ((void) xTaskDelayUntil(pxPreviousWakeTime, xTimeIncrement))
+
+TickType_t   xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char*        pcTaskGetName(TaskHandle_t xTaskToQuery);
+TaskHandle_t xTaskGetHandle(const char* pcNameToQuery);
+UBaseType_t  uxTaskGetStackHighWaterMark(TaskHandle_t xTask);
+UBaseType_t  uxTaskPriorityGet(TaskHandle_t xTask);
+BaseType_t   xTaskGetCoreID(TaskHandle_t xTask);
+void         vPortYield(void);
+
+BaseType_t xTaskGenericNotify(TaskHandle_t  xTaskToNotify,
+                              uint32_t      ulValue,
+                              eNotifyAction eAction);
+uint32_t   ulTaskGenericNotifyTake(BaseType_t xClearCountOnExit,
+                                   TickType_t xTicksToWait);
+BaseType_t xTaskGenericNotifyWait(uint32_t   ulBitsToClearOnEntry,
+                                  uint32_t   ulBitsToClearOnExit,
+                                  uint32_t*  pulNotificationValue,
+                                  TickType_t xTicksToWait);
+
+#define xTaskNotifyGive(xTaskToNotify)                                         \
+    xTaskGenericNotify((xTaskToNotify), 0, eIncrement)
+#define xTaskNotify(xTaskToNotify, ulValue, eAction)                           \
+    xTaskGenericNotify((xTaskToNotify), (ulValue), (eAction))
+#define ulTaskNotifyTake(xClearCountOnExit, xTicksToWait)                      \
+    ulTaskGenericNotifyTake((xClearCountOnExit), (xTicksToWait))
+#define xTaskNotifyWait(                                                       \
+    ulBitsToClearOnEntry, ulBitsToClearOnExit, pulValue, xTicksToWait)         \
+    xTaskGenericNotifyWait((ulBitsToClearOnEntry),                             \
+                           (ulBitsToClearOnExit),                              \
+                           (pulValue),                                         \
+                           (xTicksToWait))
+#define vTaskNotifyGiveFromISR(xTaskToNotify, pxHigherPriorityTaskWoken)       \
+    ((void) (pxHigherPriorityTaskWoken), (void) xTaskNotifyGive(xTaskToNotify))
+
+/* -------------------------------------------------- queues / semaphores -- */
+
+typedef struct QueueDefinition* QueueHandle_t;
+typedef QueueHandle_t           SemaphoreHandle_t;
+
+#define queueSEND_TO_BACK ((BaseType_t) 0)
+#define queueSEND_TO_FRONT ((BaseType_t) 1)
+#define queueOVERWRITE ((BaseType_t) 2)
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize);
+BaseType_t    xQueueGenericSend(QueueHandle_t     xQueue,
+                                const void* const pvItemToQueue,
+                                TickType_t        xTicksToWait,
+                                const BaseType_t  xCopyPosition);
+BaseType_t    xQueueReceive(QueueHandle_t xQueue,
+                            void* const   pvBuffer,
+                            TickType_t    xTicksToWait);
+BaseType_t    xQueuePeek(QueueHandle_t xQueue,
+                         void* const   pvBuffer,
+                         TickType_t    xTicksToWait);
+UBaseType_t   uxQueueMessagesWaiting(const QueueHandle_t xQueue);
+UBaseType_t   uxQueueSpacesAvailable(const QueueHandle_t xQueue);
+BaseType_t    xQueueReset(QueueHandle_t xQueue);
+void          vQueueDelete(QueueHandle_t xQueue);
+
+#define xQueueSend(xQueue, pvItemToQueue, xTicksToWait)                        \
+    xQueueGenericSend((xQueue), (pvItemToQueue), (xTicksToWait),               \
+                      queueSEND_TO_BACK)
+#define xQueueSendToBack(xQueue, pvItemToQueue, xTicksToWait)                  \
+    xQueueGenericSend((xQueue), (pvItemToQueue), (xTicksToWait),               \
+                      queueSEND_TO_BACK)
+#define xQueueSendToFront(xQueue, pvItemToQueue, xTicksToWait)                 \
+    xQueueGenericSend((xQueue), (pvItemToQueue), (xTicksToWait),               \
+                      queueSEND_TO_FRONT)
+#define xQueueOverwrite(xQueue, pvItemToQueue)                                 \
+    xQueueGenericSend((xQueue), (pvItemToQueue), 0, queueOVERWRITE)
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount,
+                                           UBaseType_t uxInitialCount);
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t xSemaphore,
+                                 TickType_t        xBlockTime);
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+BaseType_t        xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex,
+                                          TickType_t        xBlockTime);
+BaseType_t        xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex);
+UBaseType_t       uxSemaphoreGetCount(SemaphoreHandle_t xSemaphore);
+TaskHandle_t      xSemaphoreGetMutexHolder(SemaphoreHandle_t xSemaphore);
+
+#define vSemaphoreDelete(xSemaphore) vQueueDelete((QueueHandle_t) (xSemaphore))
+
+#ifdef __cplusplus
+}
+#endif
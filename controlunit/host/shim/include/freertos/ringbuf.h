@@ -0,0 +1,50 @@
+/**
+ * @file ringbuf.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF ring buffer (esp_ringbuf)
+ *
+ * Only RINGBUF_TYPE_NOSPLIT is implemented. Items take the same space as on
+ * the device, an 8 byte header plus the data rounded up to 4 bytes, so a
+ * buffer fills up after as many items as it would on the target.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void* RingbufHandle_t;
+
+typedef enum {
+    RINGBUF_TYPE_NOSPLIT = 0,
+    RINGBUF_TYPE_ALLOWSPLIT,
+    RINGBUF_TYPE_BYTEBUF,
+    RINGBUF_TYPE_MAX,
+} RingbufferType_t;
+
+/**
+ * @return nullptr for any type but RINGBUF_TYPE_NOSPLIT
+ */
+RingbufHandle_t xRingbufferCreate(size_t xBufferSize, RingbufferType_t xBufferType);
+BaseType_t      xRingbufferSend(RingbufHandle_t xRingbuffer,
+                                const void*     pvItem,
+                                size_t          xItemSize,
+                                TickType_t      xTicksToWait);
+void*           xRingbufferReceive(RingbufHandle_t xRingbuffer,
+                                   size_t*         pxItemSize,
+                                   TickType_t      xTicksToWait);
+void            vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void* pvItem);
+size_t          xRingbufferGetMaxItemSize(RingbufHandle_t xRingbuffer);
+size_t          xRingbufferGetCurFreeSize(RingbufHandle_t xRingbuffer);
+void            vRingbufferDelete(RingbufHandle_t xRingbuffer);
+
+#ifdef __cplusplus
+}
+#endif
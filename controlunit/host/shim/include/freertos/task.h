@@ -0,0 +1,12 @@
+/**
+ * @file task.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim, the whole FreeRTOS API is declared in FreeRTOS.h
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "freertos/FreeRTOS.h"
@@ -0,0 +1,50 @@
+/**
+ * @file host_shim.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host only functions with no ESP-IDF counterpart
+ *
+ * On the device app_main never returns. On the host we want a clean exit so
+ * valgrind, heaptrack and the sanitizers can report, which means every task
+ * thread has to be stopped and joined first.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Stops the esp_timer thread and all tasks, then joins them
+ *
+ * Tasks are stopped at their next blocking FreeRTOS call (delay, notify
+ * wait, semaphore or queue wait) which unwinds the task's stack. Stop the
+ * HTTP server and the triggers before calling this. Blocking calls made by
+ * threads that are not tasks keep working as before.
+ */
+void host_shim_shutdown(void);
+
+/**
+ * @brief Number of tasks created with xTaskCreate that are still running
+ */
+size_t host_shim_running_tasks(void);
+
+/**
+ * @brief Port an httpd instance listens on
+ *
+ * Useful with server_port 0, which lets the OS pick a free port for tests.
+ *
+ * @param server Handle from httpd_start
+ */
+uint16_t host_shim_httpd_port(void* server);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @file nvs_flash.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host shim of the ESP-IDF NVS flash init API
+ *
+ * Nothing in the host build reads NVS, so init and erase always succeed.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_ERR_NVS_BASE 0x1100
+#define ESP_ERR_NVS_NO_FREE_PAGES (ESP_ERR_NVS_BASE + 0x0d)
+#define ESP_ERR_NVS_NEW_VERSION_FOUND (ESP_ERR_NVS_BASE + 0x10)
+
+static inline esp_err_t nvs_flash_init(void) {
+    return ESP_OK;
+}
+
+static inline esp_err_t nvs_flash_erase(void) {
+    return ESP_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
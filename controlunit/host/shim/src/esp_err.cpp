@@ -0,0 +1,55 @@
+/**
+ * @file esp_err.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host implementation of esp_err_to_name
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "esp_err.h"
+#include "esp_http_client.h"
+#include "esp_http_server.h"
+
+#define ERR_TBL_IT(err)                                                        \
+    case err:                                                                  \
+        return #err
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        ERR_TBL_IT(ESP_OK);
+        ERR_TBL_IT(ESP_FAIL);
+        ERR_TBL_IT(ESP_ERR_NO_MEM);
+        ERR_TBL_IT(ESP_ERR_INVALID_ARG);
+        ERR_TBL_IT(ESP_ERR_INVALID_STATE);
+        ERR_TBL_IT(ESP_ERR_INVALID_SIZE);
+        ERR_TBL_IT(ESP_ERR_NOT_FOUND);
+        ERR_TBL_IT(ESP_ERR_NOT_SUPPORTED);
+        ERR_TBL_IT(ESP_ERR_TIMEOUT);
+        ERR_TBL_IT(ESP_ERR_INVALID_RESPONSE);
+        ERR_TBL_IT(ESP_ERR_INVALID_CRC);
+        ERR_TBL_IT(ESP_ERR_INVALID_VERSION);
+        ERR_TBL_IT(ESP_ERR_INVALID_MAC);
+        ERR_TBL_IT(ESP_ERR_NOT_FINISHED);
+        ERR_TBL_IT(ESP_ERR_NOT_ALLOWED);
+        ERR_TBL_IT(ESP_ERR_HTTP_MAX_REDIRECT);
+        ERR_TBL_IT(ESP_ERR_HTTP_CONNECT);
+        ERR_TBL_IT(ESP_ERR_HTTP_WRITE_DATA);
+        ERR_TBL_IT(ESP_ERR_HTTP_FETCH_HEADER);
+        ERR_TBL_IT(ESP_ERR_HTTP_INVALID_TRANSPORT);
+        ERR_TBL_IT(ESP_ERR_HTTP_CONNECTING);
+        ERR_TBL_IT(ESP_ERR_HTTP_EAGAIN);
+        ERR_TBL_IT(ESP_ERR_HTTP_CONNECTION_CLOSED);
+        ERR_TBL_IT(ESP_ERR_HTTPD_HANDLERS_FULL);
+        ERR_TBL_IT(ESP_ERR_HTTPD_HANDLER_EXISTS);
+        ERR_TBL_IT(ESP_ERR_HTTPD_INVALID_REQ);
+        ERR_TBL_IT(ESP_ERR_HTTPD_RESULT_TRUNC);
+        ERR_TBL_IT(ESP_ERR_HTTPD_RESP_HDR);
+        ERR_TBL_IT(ESP_ERR_HTTPD_RESP_SEND);
+        ERR_TBL_IT(ESP_ERR_HTTPD_ALLOC_MEM);
+        ERR_TBL_IT(ESP_ERR_HTTPD_TASK);
+        default:
+            return "UNKNOWN ERROR";
+    }
+}
@@ -0,0 +1,820 @@
+/**
+ * @file esp_http_client.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host implementation of the esp_http_client shim
+ *
+ * A blocking HTTP/1.1 client on POSIX sockets. The response is pulled
+ * through a small receive buffer of buffer_size bytes, the same way the
+ * ESP-IDF client reads through its transport, so the number of reads and
+ * ON_DATA events per response is comparable with the device.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string>
+#include <strings.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+static constexpr const char* TAG = "HTTP_CLIENT";
+
+using HeaderList = std::vector<std::pair<std::string, std::string>>;
+
+struct esp_http_client {
+    // Request
+    std::string                 scheme;
+    std::string                 host;
+    int                         port = 80;
+    std::string                 path;
+    esp_http_client_method_t    method;
+    int                         timeoutMs;
+    int                         bufferSize;
+    bool                        keepAlive; /**< TCP keep-alive probes */
+    bool                        isAsync;
+    http_event_handle_cb        handler;
+    void*                       userData;
+    HeaderList                  headers;
+    const char*                 postData = nullptr;
+    int                         postLen  = 0;
+
+    // Connection
+    int         fd = -1;
+    std::string connectedHost;
+    int         connectedPort = 0;
+
+    // Response
+    int               status        = 0;
+    int64_t           contentLength = 0;
+    bool              chunked       = false;
+    bool              untilClose    = false;
+    bool              serverCloses  = false;
+    bool              complete      = false;
+    bool              finishSent    = false;
+    HeaderList        responseHeaders;
+    std::vector<char> rx; /**< Receive buffer of buffer_size bytes */
+    size_t            rxHead         = 0;
+    size_t            rxTail         = 0;
+    int64_t           bodyRemaining  = 0;
+    int64_t           chunkRemaining = 0;
+    int               chunkLength    = 0;
+
+    // Async perform
+    std::thread       asyncThread;
+    std::atomic<bool> asyncDone{false};
+    bool              asyncRunning = false;
+    esp_err_t         asyncResult  = ESP_OK;
+};
+
+namespace {
+
+void dispatch(esp_http_client_handle_t   client,
+              esp_http_client_event_id_t id,
+              void*                      data  = nullptr,
+              int                        len   = 0,
+              const char*                key   = nullptr,
+              const char*                value = nullptr) {
+    if (client->handler == nullptr) {
+        return;
+    }
+    esp_http_client_event_t event{};
+    event.event_id     = id;
+    event.client       = client;
+    event.data         = data;
+    event.data_len     = len;
+    event.user_data    = client->userData;
+    event.header_key   = const_cast<char*>(key);
+    event.header_value = const_cast<char*>(value);
+    client->handler(&event);
+}
+
+bool parseUrl(esp_http_client_handle_t client, const char* url) {
+    std::string value(url);
+    size_t      schemeEnd = value.find("://");
+    if (schemeEnd == std::string::npos) {
+        return false;
+    }
+    client->scheme = value.substr(0, schemeEnd);
+
+    size_t      hostStart = schemeEnd + 3;
+    size_t      pathStart = value.find('/', hostStart);
+    std::string authority = value.substr(hostStart, pathStart - hostStart);
+    client->path =
+        (pathStart == std::string::npos) ? "/" : value.substr(pathStart);
+
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        client->host = authority.substr(0, colon);
+        client->port = std::atoi(authority.c_str() + colon + 1);
+    } else {
+        client->host = authority;
+        client->port = (client->scheme == "https") ? 443 : 80;
+    }
+    return !client->host.empty() && client->port > 0;
+}
+
+const char* methodName(esp_http_client_method_t method) {
+    switch (method) {
+        case HTTP_METHOD_POST:
+            return "POST";
+        case HTTP_METHOD_PUT:
+            return "PUT";
+        case HTTP_METHOD_PATCH:
+            return "PATCH";
+        case HTTP_METHOD_DELETE:
+            return "DELETE";
+        case HTTP_METHOD_HEAD:
+            return "HEAD";
+        default:
+            return "GET";
+    }
+}
+
+HeaderList::iterator findHeader(HeaderList& headers, const char* key) {
+    return std::find_if(headers.begin(), headers.end(), [key](auto& header) {
+        return strcasecmp(header.first.c_str(), key) == 0;
+    });
+}
+
+void closeConnection(esp_http_client_handle_t client) {
+    if (client->fd >= 0) {
+        ::close(client->fd);
+        client->fd = -1;
+        dispatch(client, HTTP_EVENT_DISCONNECTED);
+    }
+    client->rxHead = client->rxTail = 0;
+}
+
+/**
+ * @brief True if a kept-alive socket was closed by the server
+ */
+bool peerClosed(int fd) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (poll(&pfd, 1, 0) <= 0) {
+        return false;
+    }
+    char probe;
+    return recv(fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT) <= 0;
+}
+
+esp_err_t connectIfNeeded(esp_http_client_handle_t client, bool* reused) {
+    *reused = false;
+    if (client->fd >= 0) {
+        if (client->connectedHost == client->host &&
+            client->connectedPort == client->port && !peerClosed(client->fd)) {
+            *reused = true;
+            return ESP_OK;
+        }
+        closeConnection(client);
+    }
+
+    if (client->scheme == "https") {
+        ESP_LOGE(TAG, "TLS is not available in the host build, use http://");
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    addrinfo  hints{};
+    addrinfo* result = nullptr;
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    std::string port  = std::to_string(client->port);
+    if (getaddrinfo(client->host.c_str(), port.c_str(), &hints, &result) !=
+        0) {
+        ESP_LOGE(TAG, "Couldn't resolve host %s", client->host.c_str());
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    int fd = -1;
+    for (addrinfo* ai = result; ai != nullptr && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        timeval tv{client->timeoutMs / 1000, (client->timeoutMs % 1000) * 1000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (client->keepAlive) {
+            setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+        }
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(result);
+
+    if (fd < 0) {
+        ESP_LOGE(TAG,
+                 "Connection failed to %s:%d",
+                 client->host.c_str(),
+                 client->port);
+        return ESP_ERR_HTTP_CONNECT;
+    }
+    client->fd            = fd;
+    client->connectedHost = client->host;
+    client->connectedPort = client->port;
+    dispatch(client, HTTP_EVENT_ON_CONNECTED);
+    return ESP_OK;
+}
+
+bool sendAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        len -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+/**
+ * @brief Reads more bytes into the receive buffer
+ *
+ * @return ssize_t Bytes received, 0 if the peer closed, -1 on error/timeout
+ */
+ssize_t fillBuffer(esp_http_client_handle_t client) {
+    if (client->rxHead == client->rxTail) {
+        client->rxHead = client->rxTail = 0;
+    } else if (client->rxTail == client->rx.size()) {
+        // Compact so there is room for more data
+        std::memmove(client->rx.data(),
+                     client->rx.data() + client->rxHead,
+                     client->rxTail - client->rxHead);
+        client->rxTail -= client->rxHead;
+        client->rxHead = 0;
+    }
+    if (client->rxTail == client->rx.size()) {
+        return -1; // A single line is longer than the buffer
+    }
+    ssize_t received;
+    do {
+        received = recv(client->fd,
+                        client->rx.data() + client->rxTail,
+                        client->rx.size() - client->rxTail,
+                        0);
+    } while (received < 0 && errno == EINTR);
+    if (received > 0) {
+        client->rxTail += static_cast<size_t>(received);
+    }
+    return received;
+}
+
+bool readLine(esp_http_client_handle_t client, std::string& line) {
+    while (true) {
+        char* begin = client->rx.data() + client->rxHead;
+        char* end   = client->rx.data() + client->rxTail;
+        char* lf    = std::find(begin, end, '\n');
+        if (lf != end) {
+            line.assign(begin, lf);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            client->rxHead += static_cast<size_t>(lf - begin) + 1;
+            return true;
+        }
+        if (fillBuffer(client) <= 0) {
+            return false;
+        }
+    }
+}
+
+void markComplete(esp_http_client_handle_t client) {
+    client->complete = true;
+    if (!client->finishSent) {
+        client->finishSent = true;
+        dispatch(client, HTTP_EVENT_ON_FINISH);
+    }
+}
+
+esp_err_t sendRequest(esp_http_client_handle_t client, int writeLen) {
+    client->status        = 0;
+    client->contentLength = 0;
+    client->chunked       = false;
+    client->untilClose    = false;
+    client->serverCloses  = false;
+    client->complete      = false;
+    client->finishSent    = false;
+    client->chunkLength   = 0;
+    client->responseHeaders.clear();
+
+    std::string request;
+    request.reserve(256);
+    request += methodName(client->method);
+    request += ' ';
+    request += client->path;
+    request += " HTTP/1.1\r\nHost: ";
+    request += client->host;
+    if (client->port != 80) {
+        request += ':' + std::to_string(client->port);
+    }
+    request += "\r\nUser-Agent: ESP32 HTTP Client/1.0\r\n";
+    for (const auto& [key, value] : client->headers) {
+        request += key + ": " + value + "\r\n";
+    }
+    if (writeLen >= 0 && (writeLen > 0 || client->method == HTTP_METHOD_POST ||
+                          client->method == HTTP_METHOD_PUT)) {
+        request += "Content-Length: " + std::to_string(writeLen) + "\r\n";
+    }
+    request += "\r\n";
+
+    if (!sendAll(client->fd, request.data(), request.size())) {
+        return ESP_ERR_HTTP_WRITE_DATA;
+    }
+    dispatch(client, HTTP_EVENT_HEADERS_SENT);
+    return ESP_OK;
+}
+
+/**
+ * @brief Opens the connection and sends the request headers, reconnecting
+ * once if a kept-alive connection turns out to be dead
+ */
+esp_err_t openRequest(esp_http_client_handle_t client, int writeLen) {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool      reused = false;
+        esp_err_t err    = connectIfNeeded(client, &reused);
+        if (err != ESP_OK) {
+            return err;
+        }
+        err = sendRequest(client, writeLen);
+        if (err == ESP_OK || !reused) {
+            return err;
+        }
+        closeConnection(client);
+    }
+    return ESP_ERR_HTTP_WRITE_DATA;
+}
+
+int64_t fetchHeaders(esp_http_client_handle_t client) {
+    std::string line;
+    if (!readLine(client, line) || line.compare(0, 5, "HTTP/") != 0) {
+        return ESP_FAIL;
+    }
+    size_t space   = line.find(' ');
+    client->status = (space == std::string::npos)
+                         ? 0
+                         : std::atoi(line.c_str() + space + 1);
+    bool http10    = line.compare(0, 8, "HTTP/1.0") == 0;
+
+    bool hasLength = false;
+    while (true) {
+        if (!readLine(client, line)) {
+            return ESP_FAIL;
+        }
+        if (line.empty()) {
+            break;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string key   = line.substr(0, colon);
+        size_t      start = line.find_first_not_of(' ', colon + 1);
+        std::string value =
+            (start == std::string::npos) ? "" : line.substr(start);
+
+        if (strcasecmp(key.c_str(), "Content-Length") == 0) {
+            client->contentLength = std::atoll(value.c_str());
+            hasLength             = true;
+        } else if (strcasecmp(key.c_str(), "Transfer-Encoding") == 0 &&
+                   strcasestr(value.c_str(), "chunked") != nullptr) {
+            client->chunked = true;
+        } else if (strcasecmp(key.c_str(), "Connection") == 0 &&
+                   strcasecmp(value.c_str(), "close") == 0) {
+            client->serverCloses = true;
+        }
+        client->responseHeaders.emplace_back(std::move(key), std::move(value));
+        const auto& stored = client->responseHeaders.back();
+        dispatch(client,
+                 HTTP_EVENT_ON_HEADER,
+                 nullptr,
+                 0,
+                 stored.first.c_str(),
+                 stored.second.c_str());
+    }
+    if (http10) {
+        client->serverCloses = true;
+    }
+
+    bool noBody = client->method == HTTP_METHOD_HEAD ||
+                  client->status == 204 || client->status == 304 ||
+                  (client->status >= 100 && client->status < 200);
+    if (noBody) {
+        client->contentLength = 0;
+        client->chunked       = false;
+    } else if (client->chunked) {
+        client->contentLength  = -1;
+        client->chunkRemaining = 0;
+    } else if (!hasLength) {
+        client->untilClose   = true;
+        client->serverCloses = true;
+        client->contentLength = -1;
+    }
+    client->bodyRemaining = client->contentLength;
+    if (!client->chunked && !client->untilClose && client->bodyRemaining == 0) {
+        markComplete(client);
+    }
+    // Like ESP-IDF, 0 when the length is unknown so it is not taken for
+    // ESP_FAIL
+    return std::max<int64_t>(client->contentLength, 0);
+}
+
+/**
+ * @brief Copies up to len buffered or freshly received body bytes
+ *
+ * @return int Bytes copied, 0 at end of stream, -1 on error
+ */
+int takeBytes(esp_http_client_handle_t client, char* buffer, int len) {
+    if (client->rxHead == client->rxTail) {
+        ssize_t received = fillBuffer(client);
+        if (received <= 0) {
+            return static_cast<int>(received);
+        }
+    }
+    int count = std::min<int>(len, client->rxTail - client->rxHead);
+    std::memcpy(buffer, client->rx.data() + client->rxHead, count);
+    client->rxHead += static_cast<size_t>(count);
+    return count;
+}
+
+/**
+ * @brief Reads decoded body bytes and raises ON_DATA for them
+ *
+ * @return int Bytes read, 0 when the body is complete, -1 on error
+ */
+int readBody(esp_http_client_handle_t client, char* buffer, int len) {
+    if (client->complete || len <= 0) {
+        return 0;
+    }
+    int count = 0;
+    if (client->chunked) {
+        if (client->chunkRemaining == 0) {
+            std::string line;
+            if (!readLine(client, line)) {
+                return -1;
+            }
+            if (line.empty() && !readLine(client, line)) {
+                return -1; // CRLF after the previous chunk
+            }
+            client->chunkRemaining = std::strtoll(line.c_str(), nullptr, 16);
+            client->chunkLength    = static_cast<int>(client->chunkRemaining);
+            if (client->chunkRemaining == 0) {
+                // Skip trailers up to the final empty line
+                while (readLine(client, line) && !line.empty()) {
+                }
+                markComplete(client);
+                return 0;
+            }
+        }
+        count = takeBytes(client,
+                          buffer,
+                          std::min<int64_t>(len, client->chunkRemaining));
+        if (count <= 0) {
+            return -1;
+        }
+        client->chunkRemaining -= count;
+    } else if (client->untilClose) {
+        count = takeBytes(client, buffer, len);
+        if (count == 0) {
+            markComplete(client);
+            return 0;
+        }
+        if (count < 0) {
+            return -1;
+        }
+    } else {
+        count = takeBytes(
+            client, buffer, std::min<int64_t>(len, client->bodyRemaining));
+        if (count <= 0) {
+            return -1;
+        }
+        client->bodyRemaining -= count;
+        if (client->bodyRemaining == 0) {
+            dispatch(client, HTTP_EVENT_ON_DATA, buffer, count);
+            markComplete(client);
+            return count;
+        }
+    }
+    dispatch(client, HTTP_EVENT_ON_DATA, buffer, count);
+    return count;
+}
+
+esp_err_t performBlocking(esp_http_client_handle_t client) {
+    int       writeLen = client->postData ? client->postLen : 0;
+    esp_err_t err      = openRequest(client, writeLen);
+    if (err == ESP_OK && writeLen > 0 &&
+        !sendAll(client->fd, client->postData, writeLen)) {
+        err = ESP_ERR_HTTP_WRITE_DATA;
+    }
+    if (err == ESP_OK && fetchHeaders(client) == ESP_FAIL) {
+        err = ESP_ERR_HTTP_FETCH_HEADER;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+        dispatch(client, HTTP_EVENT_ERROR);
+        closeConnection(client);
+        return err;
+    }
+
+    std::vector<char> buffer(client->bufferSize);
+    int               read;
+    while ((read = readBody(client, buffer.data(), client->bufferSize)) > 0) {
+    }
+    if (read < 0) {
+        dispatch(client, HTTP_EVENT_ERROR);
+        closeConnection(client);
+        return ESP_FAIL;
+    }
+    if (client->serverCloses) {
+        closeConnection(client);
+    }
+    return ESP_OK;
+}
+
+} // namespace
+
+esp_http_client_handle_t
+esp_http_client_init(const esp_http_client_config_t* config) {
+    auto* client       = new esp_http_client{};
+    client->method     = config->method;
+    client->timeoutMs  = config->timeout_ms > 0 ? config->timeout_ms : 5000;
+    client->bufferSize =
+        config->buffer_size > 0 ? config->buffer_size : DEFAULT_HTTP_BUF_SIZE;
+    client->keepAlive = config->keep_alive_enable;
+    client->isAsync   = config->is_async;
+    client->handler   = config->event_handler;
+    client->userData  = config->user_data;
+    client->rx.resize(client->bufferSize);
+
+    if (config->url != nullptr) {
+        if (!parseUrl(client, config->url)) {
+            ESP_LOGE(TAG, "Invalid URL %s", config->url);
+            delete client;
+            return nullptr;
+        }
+    } else if (config->host != nullptr) {
+        client->scheme = (config->transport_type == HTTP_TRANSPORT_OVER_SSL)
+                             ? "https"
+                             : "http";
+        client->host   = config->host;
+        client->port   = config->port > 0 ? config->port
+                         : client->scheme == "https" ? 443
+                                                     : 80;
+        client->path   = config->path ? config->path : "/";
+        if (config->query != nullptr) {
+            client->path += std::string("?") + config->query;
+        }
+    } else {
+        delete client;
+        return nullptr;
+    }
+    return client;
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client) {
+    if (client == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!client->isAsync) {
+        return performBlocking(client);
+    }
+    if (!client->asyncRunning) {
+        client->asyncRunning = true;
+        client->asyncDone    = false;
+        client->asyncThread  = std::thread([client] {
+            client->asyncResult = performBlocking(client);
+            client->asyncDone   = true;
+        });
+        return ESP_ERR_HTTP_EAGAIN;
+    }
+    if (!client->asyncDone) {
+        return ESP_ERR_HTTP_EAGAIN;
+    }
+    client->asyncThread.join();
+    client->asyncRunning = false;
+    return client->asyncResult;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client,
+                                  const char*              url) {
+    if (client == nullptr || url == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::string oldHost = client->host;
+    int         oldPort = client->port;
+    if (!parseUrl(client, url)) {
+        ESP_LOGE(TAG, "Invalid URL %s", url);
+        return ESP_FAIL;
+    }
+    if (client->host != oldHost || client->port != oldPort) {
+        closeConnection(client);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client,
+                                     esp_http_client_method_t method) {
+    client->method = method;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client,
+                                     const char*              key,
+                                     const char*              value) {
+    auto it = findHeader(client->headers, key);
+    if (it != client->headers.end()) {
+        it->second = value;
+    } else {
+        client->headers.emplace_back(key, value);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_get_header(esp_http_client_handle_t client,
+                                     const char*              key,
+                                     char**                   value) {
+    auto it = findHeader(client->headers, key);
+    *value  = (it != client->headers.end()) ? it->second.data() : nullptr;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client,
+                                        const char*              key) {
+    auto it = findHeader(client->headers, key);
+    if (it != client->headers.end()) {
+        client->headers.erase(it);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t client,
+                                         int                      timeout_ms) {
+    client->timeoutMs = timeout_ms;
+    if (client->fd >= 0) {
+        timeval tv{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+        setsockopt(client->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(client->fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client,
+                                         const char*              data,
+                                         int                      len) {
+    client->postData = data;
+    client->postLen  = (data != nullptr) ? len : 0;
+    return ESP_OK;
+}
+
+int esp_http_client_get_post_field(esp_http_client_handle_t client,
+                                   char**                   data) {
+    *data = const_cast<char*>(client->postData);
+    return client->postLen;
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len) {
+    esp_err_t err = openRequest(client, write_len);
+    if (err != ESP_OK) {
+        dispatch(client, HTTP_EVENT_ERROR);
+        closeConnection(client);
+    }
+    return err;
+}
+
+int esp_http_client_write(esp_http_client_handle_t client,
+                          const char*              buffer,
+                          int                      len) {
+    if (client->fd < 0) {
+        return -1;
+    }
+    return sendAll(client->fd, buffer, len) ? len : -1;
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client) {
+    if (client->fd < 0) {
+        return ESP_FAIL;
+    }
+    return fetchHeaders(client);
+}
+
+int esp_http_client_read(esp_http_client_handle_t client,
+                         char*                    buffer,
+                         int                      len) {
+    if (client->fd < 0 && !client->complete) {
+        return -1;
+    }
+    return readBody(client, buffer, len);
+}
+
+int esp_http_client_read_response(esp_http_client_handle_t client,
+                                  char*                    buffer,
+                                  int                      len) {
+    int total = 0;
+    while (total < len) {
+        int read = esp_http_client_read(client, buffer + total, len - total);
+        if (read <= 0) {
+            return (read < 0 && total == 0) ? read : total;
+        }
+        total += read;
+    }
+    return total;
+}
+
+esp_err_t esp_http_client_flush_response(esp_http_client_handle_t client,
+                                         int*                     len) {
+    char buffer[DEFAULT_HTTP_BUF_SIZE];
+    int  total = 0;
+    int  read;
+    while ((read = esp_http_client_read(client, buffer, sizeof(buffer))) > 0) {
+        total += read;
+    }
+    if (len != nullptr) {
+        *len = total;
+    }
+    return read < 0 ? ESP_FAIL : ESP_OK;
+}
+
+bool esp_http_client_is_complete_data_received(
+    esp_http_client_handle_t client) {
+    return client->complete;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client) {
+    return client->status;
+}
+
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t client) {
+    return client->contentLength;
+}
+
+bool esp_http_client_is_chunked_response(esp_http_client_handle_t client) {
+    return client->chunked;
+}
+
+esp_err_t esp_http_client_get_chunk_length(esp_http_client_handle_t client,
+                                           int*                     len) {
+    if (!client->chunked) {
+        return ESP_FAIL;
+    }
+    *len = client->chunkLength;
+    return ESP_OK;
+}
+
+esp_http_client_transport_t
+esp_http_client_get_transport_type(esp_http_client_handle_t client) {
+    return client->scheme == "https" ? HTTP_TRANSPORT_OVER_SSL
+                                     : HTTP_TRANSPORT_OVER_TCP;
+}
+
+esp_err_t esp_http_client_get_user_data(esp_http_client_handle_t client,
+                                        void**                   data) {
+    *data = client->userData;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_user_data(esp_http_client_handle_t client,
+                                        void*                    data) {
+    client->userData = data;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client) {
+    if (client == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    closeConnection(client);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client) {
+    if (client == nullptr) {
+        return ESP_FAIL;
+    }
+    if (client->asyncThread.joinable()) {
+        client->asyncThread.join();
+    }
+    closeConnection(client);
+    delete client;
+    return ESP_OK;
+}
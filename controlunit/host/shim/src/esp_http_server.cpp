@@ -0,0 +1,689 @@
+/**
+ * @file esp_http_server.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host implementation of the esp_http_server shim
+ *
+ * The server thread polls the listening socket and all open sessions. When
+ * a session becomes readable the whole request is handled on the server
+ * thread: headers are read with recv_wait_timeout, the matching URI handler
+ * runs and any body it didn't read is discarded. Bytes received past the
+ * end of a request stay in the session buffer for the next one.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "host_shim.h"
+#include "host_shim_internal.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string>
+#include <strings.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+static constexpr const char* TAG = "httpd";
+
+namespace {
+
+using HeaderList = std::vector<std::pair<std::string, std::string>>;
+
+struct Session {
+    int                 fd;
+    uint64_t            lastUsed;
+    std::string         buffer; /**< Received but not yet consumed bytes */
+    void*               ctx     = nullptr;
+    httpd_free_ctx_fn_t freeCtx = nullptr;
+};
+
+struct Route {
+    std::string    uri;
+    httpd_method_t method;
+    esp_err_t (*handler)(httpd_req_t* r);
+    void* userCtx;
+};
+
+struct Server {
+    httpd_config_t       config;
+    int                  listenFd = -1;
+    uint16_t             port     = 0;
+    int                  wakePipe[2]{-1, -1};
+    std::thread          thread;
+    std::atomic<bool>    stopping{false};
+    std::mutex           routesMutex;
+    std::vector<Route>   routes;
+    std::vector<Session> sessions;
+    uint64_t             useCounter = 0;
+};
+
+struct RequestAux {
+    Server*     server;
+    Session*    session;
+    size_t      remaining; /**< Body bytes not yet read by the handler */
+    HeaderList  headers;
+    bool        closeAfter  = false;
+    std::string status      = HTTPD_200;
+    std::string contentType = HTTPD_TYPE_TEXT;
+    HeaderList  responseHeaders;
+    bool        chunkedStarted = false;
+};
+
+RequestAux* auxOf(httpd_req_t* r) {
+    return static_cast<RequestAux*>(r->aux);
+}
+
+int methodFromName(const std::string& name) {
+    static const std::pair<const char*, int> methods[] = {
+        {"GET", HTTP_GET},
+        {"POST", HTTP_POST},
+        {"PUT", HTTP_PUT},
+        {"DELETE", HTTP_DELETE},
+        {"HEAD", HTTP_HEAD},
+        {"PATCH", HTTP_PATCH},
+    };
+    for (const auto& [methodName, value] : methods) {
+        if (name == methodName) {
+            return value;
+        }
+    }
+    return -2;
+}
+
+bool sendAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        len -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+/**
+ * @brief Receives more bytes into the session buffer
+ *
+ * @return ssize_t Bytes received, 0 if the peer closed, negative on error or
+ * timeout
+ */
+ssize_t receiveMore(Session& session, size_t max) {
+    char    chunk[1024];
+    ssize_t received;
+    do {
+        received =
+            recv(session.fd, chunk, std::min(max, sizeof(chunk)), 0);
+    } while (received < 0 && errno == EINTR);
+    if (received > 0) {
+        session.buffer.append(chunk, static_cast<size_t>(received));
+    }
+    return received;
+}
+
+void closeSession(Server& server, size_t index) {
+    Session& session = server.sessions[index];
+    if (session.freeCtx != nullptr) {
+        session.freeCtx(session.ctx);
+    } else {
+        free(session.ctx);
+    }
+    ::close(session.fd);
+    server.sessions.erase(server.sessions.begin() + index);
+}
+
+/**
+ * @brief Sends an error response outside of a URI handler
+ */
+void sendError(Session& session, Server& server, httpd_err_code_t code) {
+    httpd_req_t req{};
+    RequestAux  aux = {};
+
+    aux.server  = &server;
+    aux.session = &session;
+    req.handle  = &server;
+    req.aux     = &aux;
+    httpd_resp_send_err(&req, code, nullptr);
+}
+
+/**
+ * @brief Reads, routes and answers one request on a session
+ *
+ * @return true if the session should stay open
+ */
+bool handleRequest(Server& server, Session& session) {
+    // Read up to the blank line that ends the headers
+    size_t headerEnd;
+    while ((headerEnd = session.buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (session.buffer.size() >= HTTPD_MAX_REQ_HDR_LEN) {
+            sendError(session, server, HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE);
+            return false;
+        }
+        ssize_t received = receiveMore(
+            session, HTTPD_MAX_REQ_HDR_LEN - session.buffer.size());
+        if (received == 0) {
+            return false;
+        }
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                sendError(session, server, HTTPD_408_REQ_TIMEOUT);
+            }
+            return false;
+        }
+    }
+    std::string head = session.buffer.substr(0, headerEnd);
+    session.buffer.erase(0, headerEnd + 4);
+
+    // Request line
+    size_t      lineEnd = head.find("\r\n");
+    std::string line    = head.substr(0, lineEnd);
+    size_t      first   = line.find(' ');
+    size_t      second  = line.find(' ', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+        sendError(session, server, HTTPD_400_BAD_REQUEST);
+        return false;
+    }
+    std::string methodName = line.substr(0, first);
+    std::string uri        = line.substr(first + 1, second - first - 1);
+    int         method     = methodFromName(methodName);
+    if (method < 0) {
+        sendError(session, server, HTTPD_501_METHOD_NOT_IMPLEMENTED);
+        return false;
+    }
+    if (uri.size() > HTTPD_MAX_URI_LEN) {
+        sendError(session, server, HTTPD_414_URI_TOO_LONG);
+        return false;
+    }
+
+    RequestAux aux = {};
+    aux.server     = &server;
+    aux.session    = &session;
+
+    size_t pos = lineEnd;
+    while (pos != std::string::npos && pos < head.size()) {
+        size_t      next   = head.find("\r\n", pos + 2);
+        std::string header = head.substr(pos + 2, next - pos - 2);
+        size_t      colon  = header.find(':');
+        if (colon != std::string::npos) {
+            size_t      start = header.find_first_not_of(' ', colon + 1);
+            std::string value =
+                start == std::string::npos ? "" : header.substr(start);
+            aux.headers.emplace_back(header.substr(0, colon), value);
+        }
+        pos = next;
+    }
+    for (const auto& [key, value] : aux.headers) {
+        if (strcasecmp(key.c_str(), "Content-Length") == 0) {
+            aux.remaining = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (strcasecmp(key.c_str(), "Connection") == 0 &&
+                   strcasecmp(value.c_str(), "close") == 0) {
+            aux.closeAfter = true;
+        }
+    }
+
+    // Routing, exact match on the path without query string
+    std::string path = uri.substr(0, uri.find('?'));
+    Route       route{};
+    bool        uriFound    = false;
+    bool        methodFound = false;
+    {
+        std::lock_guard<std::mutex> lock(server.routesMutex);
+        for (const auto& candidate : server.routes) {
+            if (candidate.uri == path) {
+                uriFound = true;
+                if (candidate.method == method ||
+                    candidate.method == HTTP_ANY) {
+                    route       = candidate;
+                    methodFound = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    httpd_req_t req{};
+    req.handle      = &server;
+    req.method      = method;
+    req.content_len = aux.remaining;
+    req.aux         = &aux;
+    req.sess_ctx    = session.ctx;
+    req.free_ctx    = session.freeCtx;
+    std::strncpy(req.uri, uri.c_str(), HTTPD_MAX_URI_LEN);
+
+    if (!uriFound) {
+        ESP_LOGW(TAG, "URI '%s' not found", uri.c_str());
+        httpd_resp_send_err(&req, HTTPD_404_NOT_FOUND, nullptr);
+        return false;
+    }
+    if (!methodFound) {
+        ESP_LOGW(TAG, "Method not allowed for URI '%s'", uri.c_str());
+        httpd_resp_send_err(&req, HTTPD_405_METHOD_NOT_ALLOWED, nullptr);
+        return false;
+    }
+
+    req.user_ctx     = route.userCtx;
+    esp_err_t result = route.handler(&req);
+    session.ctx      = req.sess_ctx;
+    session.freeCtx  = req.free_ctx;
+    if (result != ESP_OK) {
+        return false;
+    }
+
+    // Throw away any body the handler didn't read
+    char discard[256];
+    while (aux.remaining > 0) {
+        if (httpd_req_recv(&req, discard, sizeof(discard)) <= 0) {
+            return false;
+        }
+    }
+    return !aux.closeAfter;
+}
+
+void acceptSession(Server& server) {
+    int fd = accept(server.listenFd, nullptr, nullptr);
+    if (fd < 0) {
+        return;
+    }
+    if (server.sessions.size() >= server.config.max_open_sockets) {
+        if (!server.config.lru_purge_enable) {
+            ESP_LOGW(TAG, "No free sessions, closing new connection");
+            ::close(fd);
+            return;
+        }
+        auto lru = std::min_element(
+            server.sessions.begin(),
+            server.sessions.end(),
+            [](const Session& a, const Session& b) {
+                return a.lastUsed < b.lastUsed;
+            });
+        ESP_LOGW(TAG, "Purging least recently used session %d", lru->fd);
+        closeSession(server, lru - server.sessions.begin());
+    }
+    timeval rx{server.config.recv_wait_timeout, 0};
+    timeval tx{server.config.send_wait_timeout, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &rx, sizeof(rx));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tx, sizeof(tx));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    Session session  = {};
+    session.fd       = fd;
+    session.lastUsed = ++server.useCounter;
+    server.sessions.push_back(std::move(session));
+}
+
+void serverLoop(Server* server) {
+    std::vector<pollfd> fds;
+    while (!server->stopping) {
+        fds.clear();
+        fds.push_back({server->wakePipe[0], POLLIN, 0});
+        fds.push_back({server->listenFd, POLLIN, 0});
+        for (const auto& session : server->sessions) {
+            // Requests already buffered don't need the socket to be readable
+            short events = session.buffer.empty() ? POLLIN : 0;
+            fds.push_back({session.fd, events, 0});
+        }
+        bool buffered = std::any_of(
+            server->sessions.begin(),
+            server->sessions.end(),
+            [](const Session& session) { return !session.buffer.empty(); });
+        if (poll(fds.data(), fds.size(), buffered ? 0 : -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ESP_LOGE(TAG, "poll failed: %s", strerror(errno));
+            break;
+        }
+        if (server->stopping) {
+            break;
+        }
+
+        // Sessions first, accepting may purge and reorder them
+        for (size_t i = server->sessions.size(); i-- > 0;) {
+            Session& session = server->sessions[i];
+            short    revents = fds[i + 2].revents;
+            if (session.buffer.empty() && revents == 0) {
+                continue;
+            }
+            session.lastUsed = ++server->useCounter;
+            if (!handleRequest(*server, session)) {
+                closeSession(*server, i);
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            acceptSession(*server);
+        }
+    }
+}
+
+} // namespace
+
+esp_err_t httpd_start(httpd_handle_t* handle, const httpd_config_t* config) {
+    if (handle == nullptr || config == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto* server   = new Server{};
+    server->config = *config;
+
+    server->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int one          = 1;
+    setsockopt(server->listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(config->server_port);
+    if (bind(server->listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) <
+            0 ||
+        listen(server->listenFd, config->backlog_conn) < 0 ||
+        pipe(server->wakePipe) < 0) {
+        ESP_LOGE(TAG,
+                 "Failed to listen on port %d: %s",
+                 config->server_port,
+                 strerror(errno));
+        ::close(server->listenFd);
+        delete server;
+        return ESP_ERR_HTTPD_TASK;
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(server->listenFd, reinterpret_cast<sockaddr*>(&addr), &len);
+    server->port = ntohs(addr.sin_port);
+
+    server->thread = std::thread(serverLoop, server);
+    host_shim_set_thread_name(server->thread.native_handle(), "httpd");
+    ESP_LOGI(TAG, "Started server on port: '%d'", server->port);
+    *handle = server;
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle) {
+    auto* server = static_cast<Server*>(handle);
+    if (server == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    server->stopping = true;
+    char wake        = 1;
+    (void) !write(server->wakePipe[1], &wake, 1);
+    server->thread.join();
+
+    while (!server->sessions.empty()) {
+        closeSession(*server, server->sessions.size() - 1);
+    }
+    ::close(server->listenFd);
+    ::close(server->wakePipe[0]);
+    ::close(server->wakePipe[1]);
+    if (server->config.global_user_ctx_free_fn != nullptr) {
+        server->config.global_user_ctx_free_fn(server->config.global_user_ctx);
+    }
+    delete server;
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t     handle,
+                                     const httpd_uri_t* uri_handler) {
+    auto* server = static_cast<Server*>(handle);
+    if (server == nullptr || uri_handler == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(server->routesMutex);
+    if (server->routes.size() >= server->config.max_uri_handlers) {
+        ESP_LOGW(TAG, "No slots left for registering handler");
+        return ESP_ERR_HTTPD_HANDLERS_FULL;
+    }
+    for (const auto& route : server->routes) {
+        if (route.uri == uri_handler->uri &&
+            route.method == uri_handler->method) {
+            return ESP_ERR_HTTPD_HANDLER_EXISTS;
+        }
+    }
+    server->routes.push_back(Route{uri_handler->uri,
+                                   uri_handler->method,
+                                   uri_handler->handler,
+                                   uri_handler->user_ctx});
+    return ESP_OK;
+}
+
+esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
+                                       const char*    uri,
+                                       httpd_method_t method) {
+    auto*                       server = static_cast<Server*>(handle);
+    std::lock_guard<std::mutex> lock(server->routesMutex);
+    auto it = std::find_if(
+        server->routes.begin(), server->routes.end(), [&](const Route& r) {
+            return r.uri == uri && r.method == method;
+        });
+    if (it == server->routes.end()) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    server->routes.erase(it);
+    return ESP_OK;
+}
+
+void* httpd_get_global_user_ctx(httpd_handle_t handle) {
+    return static_cast<Server*>(handle)->config.global_user_ctx;
+}
+
+int httpd_req_recv(httpd_req_t* r, char* buf, size_t buf_len) {
+    RequestAux* aux = auxOf(r);
+    if (aux->remaining == 0 || buf_len == 0) {
+        return 0;
+    }
+    size_t   want    = std::min(buf_len, aux->remaining);
+    Session& session = *aux->session;
+    if (session.buffer.empty()) {
+        ssize_t received = receiveMore(session, want);
+        if (received == 0) {
+            return HTTPD_SOCK_ERR_FAIL;
+        }
+        if (received < 0) {
+            return (errno == EAGAIN || errno == EWOULDBLOCK)
+                       ? HTTPD_SOCK_ERR_TIMEOUT
+                       : HTTPD_SOCK_ERR_FAIL;
+        }
+    }
+    size_t count = std::min(want, session.buffer.size());
+    std::memcpy(buf, session.buffer.data(), count);
+    session.buffer.erase(0, count);
+    aux->remaining -= count;
+    return static_cast<int>(count);
+}
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t* r, const char* field) {
+    for (const auto& [key, value] : auxOf(r)->headers) {
+        if (strcasecmp(key.c_str(), field) == 0) {
+            return value.size();
+        }
+    }
+    return 0;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t* r,
+                                      const char*  field,
+                                      char*        val,
+                                      size_t       val_size) {
+    for (const auto& [key, value] : auxOf(r)->headers) {
+        if (strcasecmp(key.c_str(), field) == 0) {
+            if (val_size == 0) {
+                return ESP_ERR_HTTPD_RESULT_TRUNC;
+            }
+            std::strncpy(val, value.c_str(), val_size - 1);
+            val[val_size - 1] = '\0';
+            return value.size() >= val_size ? ESP_ERR_HTTPD_RESULT_TRUNC
+                                            : ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+size_t httpd_req_get_url_query_len(httpd_req_t* r) {
+    const char* query = std::strchr(r->uri, '?');
+    return query ? std::strlen(query + 1) : 0;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t* r,
+                                      char*        buf,
+                                      size_t       buf_len) {
+    const char* query = std::strchr(r->uri, '?');
+    if (query == nullptr) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (buf_len == 0) {
+        return ESP_ERR_HTTPD_RESULT_TRUNC;
+    }
+    std::strncpy(buf, query + 1, buf_len - 1);
+    buf[buf_len - 1] = '\0';
+    return std::strlen(query + 1) >= buf_len ? ESP_ERR_HTTPD_RESULT_TRUNC
+                                             : ESP_OK;
+}
+
+int httpd_req_to_sockfd(httpd_req_t* r) {
+    return auxOf(r)->session->fd;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t* r, const char* status) {
+    auxOf(r)->status = status;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t* r, const char* type) {
+    auxOf(r)->contentType = type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t* r,
+                             const char*  field,
+                             const char*  value) {
+    RequestAux* aux = auxOf(r);
+    if (aux->responseHeaders.size() >= aux->server->config.max_resp_headers) {
+        return ESP_ERR_HTTPD_RESP_HDR;
+    }
+    aux->responseHeaders.emplace_back(field, value);
+    return ESP_OK;
+}
+
+static std::string statusLineAndHeaders(RequestAux* aux) {
+    std::string head = "HTTP/1.1 " + aux->status +
+                       "\r\nContent-Type: " + aux->contentType + "\r\n";
+    for (const auto& [key, value] : aux->responseHeaders) {
+        head += key + ": " + value + "\r\n";
+    }
+    return head;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t* r, const char* buf, ssize_t buf_len) {
+    RequestAux* aux = auxOf(r);
+    size_t      len = (buf == nullptr)                    ? 0
+                      : (buf_len == HTTPD_RESP_USE_STRLEN) ? std::strlen(buf)
+                                                           : buf_len;
+    std::string head = statusLineAndHeaders(aux);
+    head += "Content-Length: " + std::to_string(len) + "\r\n\r\n";
+
+    int fd = aux->session->fd;
+    if (!sendAll(fd, head.data(), head.size()) ||
+        (len > 0 && !sendAll(fd, buf, len))) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t* r,
+                                const char*  buf,
+                                ssize_t      buf_len) {
+    RequestAux* aux = auxOf(r);
+    int         fd  = aux->session->fd;
+    if (!aux->chunkedStarted) {
+        std::string head = statusLineAndHeaders(aux);
+        head += "Transfer-Encoding: chunked\r\n\r\n";
+        if (!sendAll(fd, head.data(), head.size())) {
+            return ESP_ERR_HTTPD_RESP_SEND;
+        }
+        aux->chunkedStarted = true;
+    }
+    size_t len = (buf == nullptr)                    ? 0
+                 : (buf_len == HTTPD_RESP_USE_STRLEN) ? std::strlen(buf)
+                                                      : buf_len;
+    char   size[16];
+    int    sizeLen = std::snprintf(size, sizeof(size), "%zx\r\n", len);
+    if (!sendAll(fd, size, sizeLen) || (len > 0 && !sendAll(fd, buf, len)) ||
+        !sendAll(fd, "\r\n", 2)) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t*     req,
+                              httpd_err_code_t error,
+                              const char*      usr_msg) {
+    const char* status;
+    const char* msg;
+    switch (error) {
+        case HTTPD_501_METHOD_NOT_IMPLEMENTED:
+            status = "501 Method Not Implemented";
+            msg    = "Server does not support this method";
+            break;
+        case HTTPD_505_VERSION_NOT_SUPPORTED:
+            status = "505 Version Not Supported";
+            msg    = "HTTP version not supported by server";
+            break;
+        case HTTPD_400_BAD_REQUEST:
+            status = "400 Bad Request";
+            msg    = "Bad request syntax";
+            break;
+        case HTTPD_401_UNAUTHORIZED:
+            status = "401 Unauthorized";
+            msg    = "No permission -- see authorization schemes";
+            break;
+        case HTTPD_403_FORBIDDEN:
+            status = "403 Forbidden";
+            msg    = "Request forbidden -- authorization will not help";
+            break;
+        case HTTPD_404_NOT_FOUND:
+            status = "404 Not Found";
+            msg    = "Nothing matches the given URI";
+            break;
+        case HTTPD_405_METHOD_NOT_ALLOWED:
+            status = "405 Method Not Allowed";
+            msg    = "Specified method is invalid for this resource";
+            break;
+        case HTTPD_408_REQ_TIMEOUT:
+            status = "408 Request Timeout";
+            msg    = "Server closed this connection";
+            break;
+        case HTTPD_411_LENGTH_REQUIRED:
+            status = "411 Length Required";
+            msg    = "Chunked encoding not supported";
+            break;
+        case HTTPD_414_URI_TOO_LONG:
+            status = "414 URI Too Long";
+            msg    = "URI is too long";
+            break;
+        case HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE:
+            status = "431 Request Header Fields Too Large";
+            msg    = "Header fields are too long";
+            break;
+        default:
+            status = "500 Internal Server Error";
+            msg    = "Server has encountered an unexpected error";
+            break;
+    }
+    httpd_resp_set_status(req, status);
+    httpd_resp_set_type(req, HTTPD_TYPE_TEXT);
+    return httpd_resp_send(req, usr_msg ? usr_msg : msg, HTTPD_RESP_USE_STRLEN);
+}
+
+uint16_t host_shim_httpd_port(httpd_handle_t handle) {
+    return handle ? static_cast<Server*>(handle)->port : 0;
+}
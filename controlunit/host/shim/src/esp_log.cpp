@@ -0,0 +1,95 @@
+/**
+ * @file esp_log.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host implementation of the esp_log shim
+ *
+ * Per tag levels live in a small map behind a mutex, which is only looked
+ * up once a tag has been given its own level, like the tag cache in ESP-IDF.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "esp_log.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Clock::time_point      s_start = Clock::now();
+std::atomic<esp_log_level_t> s_defaultLevel{
+    static_cast<esp_log_level_t>(CONFIG_LOG_DEFAULT_LEVEL)};
+std::atomic<bool>            s_hasTagLevels{false};
+std::atomic<vprintf_like_t>  s_vprintf{&vprintf};
+
+std::mutex& tagMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::map<std::string, esp_log_level_t>& tagLevels() {
+    static std::map<std::string, esp_log_level_t> levels;
+    return levels;
+}
+
+} // namespace
+
+void esp_log_level_set(const char* tag, esp_log_level_t level) {
+    if (std::string(tag) == "*") {
+        s_defaultLevel = level;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(tagMutex());
+    tagLevels()[tag] = level;
+    s_hasTagLevels   = true;
+}
+
+esp_log_level_t esp_log_level_get(const char* tag) {
+    if (s_hasTagLevels) {
+        std::lock_guard<std::mutex> lock(tagMutex());
+        auto it = tagLevels().find(tag);
+        if (it != tagLevels().end()) {
+            return it->second;
+        }
+    }
+    return s_defaultLevel;
+}
+
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t func) {
+    return s_vprintf.exchange(func);
+}
+
+uint32_t esp_log_timestamp(void) {
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                              s_start)
+            .count());
+}
+
+void esp_log_writev(esp_log_level_t level,
+                    const char*     tag,
+                    const char*     format,
+                    va_list         args) {
+    if (level > esp_log_level_get(tag)) {
+        return;
+    }
+    s_vprintf.load()(format, args);
+}
+
+void esp_log_write(esp_log_level_t level,
+                   const char*     tag,
+                   const char*     format,
+                   ...) {
+    va_list args;
+    va_start(args, format);
+    esp_log_writev(level, tag, format, args);
+    va_end(args);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file esp_system.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host implementation of the esp_system and esp_heap_caps shims
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <atomic>
+#include <malloc.h>
+#include <mutex>
+#include <random>
+
+static constexpr const char* TAG = "esp_system";
+
+static size_t heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+/// What the C++ runtime itself allocated before main, not part of the budget
+static const size_t          s_heapBaseline = heapInUse();
+static std::atomic<uint32_t> s_minimumFreeHeap{CONFIG_HOST_HEAP_SIZE};
+
+uint32_t esp_random(void) {
+    static std::mutex   mutex;
+    static std::mt19937 engine{std::random_device{}()};
+    std::lock_guard<std::mutex> lock(mutex);
+    return engine();
+}
+
+void esp_fill_random(void* buf, size_t len) {
+    auto* bytes = static_cast<uint8_t*>(buf);
+    for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+        uint32_t value = esp_random();
+        for (size_t j = 0; j < sizeof(uint32_t) && i + j < len; ++j) {
+            bytes[i + j] = static_cast<uint8_t>(value >> (8 * j));
+        }
+    }
+}
+
+uint32_t esp_get_free_heap_size(void) {
+    size_t   inUse = heapInUse();
+    size_t   used  = inUse > s_heapBaseline ? inUse - s_heapBaseline : 0;
+    uint32_t free  = used >= CONFIG_HOST_HEAP_SIZE
+                         ? 0
+                         : static_cast<uint32_t>(CONFIG_HOST_HEAP_SIZE - used);
+
+    uint32_t minimum = s_minimumFreeHeap.load();
+    while (free < minimum &&
+           !s_minimumFreeHeap.compare_exchange_weak(minimum, free)) {
+    }
+    return free;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void) {
+    esp_get_free_heap_size();
+    return s_minimumFreeHeap.load();
+}
+
+size_t heap_caps_get_free_size(uint32_t) {
+    return esp_get_free_heap_size();
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t) {
+    return esp_get_minimum_free_heap_size();
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t) {
+    return esp_get_free_heap_size();
+}
+
+void esp_restart(void) {
+    ESP_LOGW(TAG, "esp_restart() called, exiting");
+    exit(0);
+}
@@ -0,0 +1,241 @@
+/**
+ * @file esp_timer.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host implementation of the esp_timer shim
+ *
+ * One service thread sleeps until the earliest alarm and runs the callback
+ * without holding the lock, so callbacks may start and stop timers. Periodic
+ * timers are rescheduled from their previous alarm time, not from when the
+ * callback ran, so they don't drift.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "host_shim_internal.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr const char* TAG = "esp_timer";
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void*          arg;
+    std::string    name;
+    bool           skipUnhandled;
+    bool           active = false;
+    int64_t        alarm  = 0; /**< Absolute time in us */
+    uint64_t       period = 0; /**< 0 for one-shot timers */
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Clock::time_point s_start = Clock::now();
+
+// Never destroyed, see freertos.cpp
+std::mutex&              s_mutex    = *new std::mutex;
+std::condition_variable& s_cv       = *new std::condition_variable;
+std::vector<esp_timer*>& s_active   = *new std::vector<esp_timer*>;
+std::thread*             s_thread   = nullptr;
+esp_timer*               s_running  = nullptr;
+bool                     s_stopping = false;
+
+void removeActive(esp_timer* timer) {
+    std::erase(s_active, timer);
+    timer->active = false;
+}
+
+void serviceLoop() {
+    std::unique_lock<std::mutex> lock(s_mutex);
+    while (!s_stopping) {
+        esp_timer* next = nullptr;
+        for (auto* timer : s_active) {
+            if (next == nullptr || timer->alarm < next->alarm) {
+                next = timer;
+            }
+        }
+        if (next == nullptr) {
+            s_cv.wait(lock);
+            continue;
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (next->alarm > now) {
+            s_cv.wait_for(lock, std::chrono::microseconds(next->alarm - now));
+            continue;
+        }
+
+        if (next->period > 0) {
+            next->alarm += next->period;
+            if (next->skipUnhandled && next->alarm <= now) {
+                next->alarm = now + next->period;
+            }
+        } else {
+            removeActive(next);
+        }
+
+        s_running = next;
+        lock.unlock();
+        next->callback(next->arg);
+        lock.lock();
+        s_running = nullptr;
+        s_cv.notify_all();
+    }
+}
+
+/**
+ * @brief Starts the service thread on first use. Called with s_mutex held
+ */
+void ensureServiceThread() {
+    if (s_thread == nullptr) {
+        s_thread = new std::thread(serviceLoop);
+        host_shim_set_thread_name(s_thread->native_handle(), "esp_timer");
+    }
+}
+
+esp_err_t startTimer(esp_timer_handle_t timer,
+                     uint64_t           timeout,
+                     bool               periodic) {
+    if (timer == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (timer->active || s_stopping) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ensureServiceThread();
+    timer->alarm  = esp_timer_get_time() + static_cast<int64_t>(timeout);
+    timer->period = periodic ? timeout : 0;
+    timer->active = true;
+    s_active.push_back(timer);
+    s_cv.notify_all();
+    return ESP_OK;
+}
+
+} // namespace
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args,
+                           esp_timer_handle_t*            out_handle) {
+    if (create_args == nullptr || create_args->callback == nullptr ||
+        out_handle == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_handle = new esp_timer{create_args->callback,
+                                create_args->arg,
+                                create_args->name ? create_args->name : "",
+                                create_args->skip_unhandled_events};
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    return startTimer(timer, timeout_us, false);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+    if (period == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return startTimer(timer, period, true);
+}
+
+esp_err_t esp_timer_restart(esp_timer_handle_t timer, uint64_t timeout_us) {
+    if (timer == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    bool periodic;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (!timer->active) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        periodic = timer->period > 0;
+        removeActive(timer);
+    }
+    return startTimer(timer, timeout_us, periodic);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (timer == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    removeActive(timer);
+    s_cv.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    if (timer == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    {
+        std::unique_lock<std::mutex> lock(s_mutex);
+        if (timer->active) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (s_thread == nullptr ||
+            s_thread->get_id() != std::this_thread::get_id()) {
+            s_cv.wait(lock, [timer] { return s_running != timer; });
+        }
+    }
+    delete timer;
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return timer != nullptr && timer->active;
+}
+
+int64_t esp_timer_get_time(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                                 s_start)
+        .count();
+}
+
+int64_t esp_timer_get_next_alarm(void) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    int64_t                     next = INT64_MAX;
+    for (auto* timer : s_active) {
+        next = std::min(next, timer->alarm);
+    }
+    return next;
+}
+
+void host_shim_stop_timers() {
+    std::thread* thread;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_stopping = true;
+        if (s_thread == nullptr) {
+            return;
+        }
+        if (!s_active.empty()) {
+            ESP_LOGW(TAG, "Stopping with %zu active timers", s_active.size());
+        }
+        for (auto* timer : s_active) {
+            timer->active = false;
+        }
+        s_active.clear();
+        s_cv.notify_all();
+        thread   = s_thread;
+        s_thread = nullptr;
+    }
+    thread->join();
+    delete thread;
+}
@@ -0,0 +1,798 @@
+/**
+ * @file freertos.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host implementation of the FreeRTOS shim
+ *
+ * Every task is a std::thread with its own control block holding the
+ * notification value. Threads that were not created with xTaskCreate (main,
+ * the esp_timer thread, the httpd thread) get a control block the first time
+ * they need one, so ulTaskNotifyTake() and friends work everywhere.
+ *
+ * Task stacks are painted below the entry frame like FreeRTOS fills a new
+ * stack, so uxTaskGetStackHighWaterMark() measures how deep a task got.
+ * Host frames are not Xtensa frames, compare trends rather than bytes.
+ *
+ * Queues, mutexes and semaphores share one implementation, like in FreeRTOS
+ * where a semaphore is a queue with zero sized items. Ring buffers keep each
+ * item in its own vector and only account for the space it takes.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "esp_log.h"
+#include "host_shim.h"
+#include "host_shim_internal.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr const char* TAG = "freertos";
+
+struct tskTaskControlBlock {
+    std::string    name;
+    UBaseType_t    priority   = 0;
+    uint32_t       stackDepth = 0;
+    BaseType_t     coreId     = tskNO_AFFINITY;
+    TaskFunction_t entry      = nullptr;
+    void*          param      = nullptr;
+    bool           isTask     = false; /**< Created with xTaskCreate */
+    /// Lowest byte of the painted stack, set before xTaskCreate returns
+    std::atomic<const uint8_t*> stackLow{nullptr};
+
+    std::mutex              mutex;
+    std::condition_variable cv;
+    uint32_t                notifyValue   = 0;
+    bool                    notifyPending = false;
+
+    std::thread       thread;
+    std::atomic<bool> finished{false};
+};
+
+struct Ringbuffer;
+
+namespace {
+
+/**
+ * @brief Thrown inside a task to unwind its stack on vTaskDelete(NULL) or
+ * host_shim_shutdown()
+ */
+struct TaskExit {};
+
+using Clock = std::chrono::steady_clock;
+
+const Clock::time_point s_start = Clock::now();
+std::atomic<bool>       s_shutdown{false};
+
+// Never destroyed: task threads may still be running when the process exits
+// without host_shim_shutdown(), and a joinable std::thread must not be
+// destroyed
+std::mutex&                     s_registryMutex = *new std::mutex;
+std::list<tskTaskControlBlock>& s_tasks = *new std::list<tskTaskControlBlock>;
+std::set<QueueHandle_t>&        s_queues = *new std::set<QueueHandle_t>;
+std::set<Ringbuffer*>&          s_ringbufs = *new std::set<Ringbuffer*>;
+
+thread_local tskTaskControlBlock* t_current = nullptr;
+
+tskTaskControlBlock* currentTcb() {
+    if (t_current == nullptr) {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        t_current       = &s_tasks.emplace_back();
+        t_current->name = "host-thread";
+    }
+    return t_current;
+}
+
+bool shouldExit() {
+    return s_shutdown.load() && t_current != nullptr && t_current->isTask;
+}
+
+void exitIfShuttingDown() {
+    if (shouldExit()) {
+        throw TaskExit{};
+    }
+}
+
+/**
+ * @brief Waits on a condition variable for a FreeRTOS tick timeout
+ *
+ * @return true if pred() became true, false on timeout. Throws TaskExit if
+ * the shim is shut down while a task waits.
+ */
+template <typename Lock, typename Pred>
+bool waitTicks(std::condition_variable& cv,
+               Lock&                    lock,
+               TickType_t               ticks,
+               Pred                     pred) {
+    auto wake = [&] { return pred() || shouldExit(); };
+    bool ok;
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lock, wake);
+        ok = true;
+    } else {
+        ok = cv.wait_for(
+            lock, std::chrono::milliseconds(pdTICKS_TO_MS(ticks)), wake);
+    }
+    if (shouldExit()) {
+        throw TaskExit{};
+    }
+    return ok && pred();
+}
+
+/// Byte FreeRTOS fills a new task stack with
+constexpr uint8_t STACK_FILL = 0xa5;
+/// Left unpainted at the top for the frame of paintStack(), counts as used
+constexpr uint32_t STACK_MARGIN = 256;
+
+/**
+ * @brief Paints the stack budget below the caller's frame
+ *
+ * @param top Frame of the trampoline, where the task's stack starts
+ */
+__attribute__((noinline, no_sanitize("address", "thread"))) void
+paintStack(tskTaskControlBlock* tcb, uint8_t* top) {
+    uint32_t          depth = std::max(tcb->stackDepth, STACK_MARGIN);
+    volatile uint8_t* low   = top - depth;
+    // Stop short of this frame and the red zone below it
+    auto* end = std::min(top - STACK_MARGIN,
+                         static_cast<uint8_t*>(__builtin_frame_address(0)) -
+                             128);
+    for (volatile uint8_t* byte = low; byte < end; ++byte) {
+        *byte = STACK_FILL;
+    }
+    tcb->stackLow = top - depth;
+}
+
+// Reads the stack of another running thread, a benign race by design
+__attribute__((no_sanitize("address", "thread"))) UBaseType_t
+unusedStack(const tskTaskControlBlock* tcb) {
+    const volatile uint8_t* low    = tcb->stackLow.load();
+    UBaseType_t             unused = 0;
+    while (unused < tcb->stackDepth && low[unused] == STACK_FILL) {
+        ++unused;
+    }
+    return unused;
+}
+
+void taskTrampoline(tskTaskControlBlock* tcb) {
+    t_current = tcb;
+    paintStack(tcb, static_cast<uint8_t*>(__builtin_frame_address(0)));
+    try {
+        tcb->entry(tcb->param);
+        ESP_LOGE(TAG, "Task %s returned from its function", tcb->name.c_str());
+    } catch (const TaskExit&) {
+    }
+    tcb->finished = true;
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------ tasks */
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t               pxTaskCode,
+                                   const char*                  pcName,
+                                   const configSTACK_DEPTH_TYPE usStackDepth,
+                                   void*                        pvParameters,
+                                   UBaseType_t                  uxPriority,
+                                   TaskHandle_t*                pxCreatedTask,
+                                   const BaseType_t             xCoreID) {
+    if (s_shutdown) {
+        return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+    }
+    tskTaskControlBlock* tcb;
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        tcb = &s_tasks.emplace_back();
+    }
+    tcb->name       = pcName ? pcName : "";
+    tcb->priority   = uxPriority;
+    tcb->stackDepth = usStackDepth;
+    tcb->coreId     = xCoreID;
+    tcb->entry      = pxTaskCode;
+    tcb->param      = pvParameters;
+    tcb->isTask     = true;
+
+    // Publish the handle before the task runs, FreeRTOS does the same when
+    // the new task has a lower priority than the caller
+    if (pxCreatedTask) {
+        *pxCreatedTask = tcb;
+    }
+    tcb->thread = std::thread(taskTrampoline, tcb);
+    host_shim_set_thread_name(tcb->thread.native_handle(), tcb->name.c_str());
+    // FreeRTOS fills the stack before xTaskCreate returns
+    while (tcb->stackLow.load() == nullptr) {
+        std::this_thread::yield();
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t               pxTaskCode,
+                       const char*                  pcName,
+                       const configSTACK_DEPTH_TYPE usStackDepth,
+                       void*                        pvParameters,
+                       UBaseType_t                  uxPriority,
+                       TaskHandle_t*                pxCreatedTask) {
+    return xTaskCreatePinnedToCore(pxTaskCode,
+                                   pcName,
+                                   usStackDepth,
+                                   pvParameters,
+                                   uxPriority,
+                                   pxCreatedTask,
+                                   tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete) {
+    tskTaskControlBlock* self = currentTcb();
+    if (xTaskToDelete != nullptr && xTaskToDelete != self) {
+        ESP_LOGE(TAG,
+                 "vTaskDelete of another task (%s) is not supported on host",
+                 xTaskToDelete->name.c_str());
+        return;
+    }
+    if (!self->isTask) {
+        ESP_LOGE(TAG, "vTaskDelete(NULL) called outside a task");
+        return;
+    }
+    throw TaskExit{};
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay) {
+    exitIfShuttingDown();
+    tskTaskControlBlock*         tcb = currentTcb();
+    std::unique_lock<std::mutex> lock(tcb->mutex);
+    waitTicks(tcb->cv, lock, xTicksToDelay, [] { return false; });
+}
+
+BaseType_t xTaskDelayUntil(TickType_t* const pxPreviousWakeTime,
+                           const TickType_t  xTimeIncrement) {
+    TickType_t wakeTime = *pxPreviousWakeTime + xTimeIncrement;
+    TickType_t now      = xTaskGetTickCount();
+    *pxPreviousWakeTime = wakeTime;
+    if (static_cast<int32_t>(wakeTime - now) <= 0) {
+        exitIfShuttingDown();
+        return pdFALSE;
+    }
+    vTaskDelay(wakeTime - now);
+    return pdTRUE;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now() - s_start);
+    return pdMS_TO_TICKS(elapsed.count());
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return currentTcb();
+}
+
+char* pcTaskGetName(TaskHandle_t xTaskToQuery) {
+    tskTaskControlBlock* tcb = xTaskToQuery ? xTaskToQuery : currentTcb();
+    return tcb->name.data();
+}
+
+TaskHandle_t xTaskGetHandle(const char* pcNameToQuery) {
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    for (auto& tcb : s_tasks) {
+        if (tcb.isTask && !tcb.finished && tcb.name == pcNameToQuery) {
+            return &tcb;
+        }
+    }
+    return nullptr;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask) {
+    tskTaskControlBlock* tcb = xTask ? xTask : currentTcb();
+    // Threads the shim did not create have no painted stack
+    if (tcb->stackLow == nullptr || tcb->finished) {
+        return 0;
+    }
+    return unusedStack(tcb);
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask) {
+    return (xTask ? xTask : currentTcb())->priority;
+}
+
+BaseType_t xTaskGetCoreID(TaskHandle_t xTask) {
+    return (xTask ? xTask : currentTcb())->coreId;
+}
+
+void vPortYield(void) {
+    std::this_thread::yield();
+}
+
+/* ---------------------------------------------------------- notifications */
+
+BaseType_t xTaskGenericNotify(TaskHandle_t  xTaskToNotify,
+                              uint32_t      ulValue,
+                              eNotifyAction eAction) {
+    if (xTaskToNotify == nullptr) {
+        return pdFAIL;
+    }
+    BaseType_t                  result = pdPASS;
+    std::lock_guard<std::mutex> lock(xTaskToNotify->mutex);
+    switch (eAction) {
+        case eNoAction:
+            break;
+        case eSetBits:
+            xTaskToNotify->notifyValue |= ulValue;
+            break;
+        case eIncrement:
+            ++xTaskToNotify->notifyValue;
+            break;
+        case eSetValueWithOverwrite:
+            xTaskToNotify->notifyValue = ulValue;
+            break;
+        case eSetValueWithoutOverwrite:
+            if (xTaskToNotify->notifyPending) {
+                result = pdFAIL;
+            } else {
+                xTaskToNotify->notifyValue = ulValue;
+            }
+            break;
+    }
+    xTaskToNotify->notifyPending = true;
+    xTaskToNotify->cv.notify_all();
+    return result;
+}
+
+uint32_t ulTaskGenericNotifyTake(BaseType_t xClearCountOnExit,
+                                 TickType_t xTicksToWait) {
+    exitIfShuttingDown();
+    tskTaskControlBlock*         tcb = currentTcb();
+    std::unique_lock<std::mutex> lock(tcb->mutex);
+    waitTicks(
+        tcb->cv, lock, xTicksToWait, [tcb] { return tcb->notifyValue != 0; });
+
+    uint32_t value = tcb->notifyValue;
+    if (value != 0) {
+        tcb->notifyValue = xClearCountOnExit ? 0 : value - 1;
+    }
+    tcb->notifyPending = false;
+    return value;
+}
+
+BaseType_t xTaskGenericNotifyWait(uint32_t   ulBitsToClearOnEntry,
+                                  uint32_t   ulBitsToClearOnExit,
+                                  uint32_t*  pulNotificationValue,
+                                  TickType_t xTicksToWait) {
+    exitIfShuttingDown();
+    tskTaskControlBlock*         tcb = currentTcb();
+    std::unique_lock<std::mutex> lock(tcb->mutex);
+    if (!tcb->notifyPending) {
+        tcb->notifyValue &= ~ulBitsToClearOnEntry;
+    }
+    bool received = waitTicks(
+        tcb->cv, lock, xTicksToWait, [tcb] { return tcb->notifyPending; });
+
+    if (pulNotificationValue) {
+        *pulNotificationValue = tcb->notifyValue;
+    }
+    if (received) {
+        tcb->notifyValue &= ~ulBitsToClearOnExit;
+    }
+    tcb->notifyPending = false;
+    return received ? pdTRUE : pdFALSE;
+}
+
+/* ----------------------------------------------------- queues / semaphores */
+
+enum class QueueKind { Queue, Mutex, RecursiveMutex, Binary, Counting };
+
+struct QueueDefinition {
+    QueueKind               kind;
+    UBaseType_t             length;
+    UBaseType_t             itemSize;
+    std::vector<uint8_t>    storage; /**< Ring buffer of length * itemSize */
+    UBaseType_t             head  = 0;
+    UBaseType_t             count = 0;
+    tskTaskControlBlock*    holder    = nullptr; /**< Mutex owner */
+    UBaseType_t             recursion = 0;
+    std::mutex              mutex;
+    std::condition_variable cv;
+};
+
+static QueueHandle_t createQueue(QueueKind   kind,
+                                 UBaseType_t length,
+                                 UBaseType_t itemSize,
+                                 UBaseType_t initialCount) {
+    auto* queue     = new QueueDefinition{};
+    queue->kind     = kind;
+    queue->length   = length;
+    queue->itemSize = itemSize;
+    queue->count    = initialCount;
+    queue->storage.resize(static_cast<size_t>(length) * itemSize);
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    s_queues.insert(queue);
+    return queue;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize) {
+    if (uxQueueLength == 0) {
+        return nullptr;
+    }
+    return createQueue(QueueKind::Queue, uxQueueLength, uxItemSize, 0);
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t     xQueue,
+                             const void* const pvItemToQueue,
+                             TickType_t        xTicksToWait,
+                             const BaseType_t  xCopyPosition) {
+    std::unique_lock<std::mutex> lock(xQueue->mutex);
+    if (xCopyPosition != queueOVERWRITE && xQueue->count == xQueue->length) {
+        if (xTicksToWait == 0) {
+            return errQUEUE_FULL;
+        }
+        exitIfShuttingDown();
+        if (!waitTicks(xQueue->cv, lock, xTicksToWait, [xQueue] {
+                return xQueue->count < xQueue->length;
+            })) {
+            return errQUEUE_FULL;
+        }
+    }
+
+    const size_t size = xQueue->itemSize;
+    UBaseType_t  slot;
+    if (xCopyPosition == queueOVERWRITE && xQueue->count == xQueue->length) {
+        slot = xQueue->head;
+    } else if (xCopyPosition == queueSEND_TO_FRONT) {
+        xQueue->head = (xQueue->head + xQueue->length - 1) % xQueue->length;
+        slot         = xQueue->head;
+        ++xQueue->count;
+    } else {
+        slot = (xQueue->head + xQueue->count) % xQueue->length;
+        ++xQueue->count;
+    }
+    if (size > 0) {
+        std::memcpy(&xQueue->storage[slot * size], pvItemToQueue, size);
+    }
+    xQueue->cv.notify_all();
+    return pdPASS;
+}
+
+static BaseType_t queueReceive(QueueHandle_t xQueue,
+                               void* const   pvBuffer,
+                               TickType_t    xTicksToWait,
+                               bool          remove) {
+    std::unique_lock<std::mutex> lock(xQueue->mutex);
+    if (xQueue->count == 0) {
+        if (xTicksToWait == 0) {
+            return errQUEUE_EMPTY;
+        }
+        exitIfShuttingDown();
+        if (!waitTicks(xQueue->cv, lock, xTicksToWait, [xQueue] {
+                return xQueue->count > 0;
+            })) {
+            return errQUEUE_EMPTY;
+        }
+    }
+
+    const size_t size = xQueue->itemSize;
+    if (size > 0 && pvBuffer != nullptr) {
+        std::memcpy(pvBuffer, &xQueue->storage[xQueue->head * size], size);
+    }
+    if (remove) {
+        xQueue->head = (xQueue->head + 1) % xQueue->length;
+        --xQueue->count;
+        xQueue->cv.notify_all();
+    }
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue,
+                         void* const   pvBuffer,
+                         TickType_t    xTicksToWait) {
+    return queueReceive(xQueue, pvBuffer, xTicksToWait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t xQueue,
+                      void* const   pvBuffer,
+                      TickType_t    xTicksToWait) {
+    return queueReceive(xQueue, pvBuffer, xTicksToWait, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue) {
+    std::lock_guard<std::mutex> lock(xQueue->mutex);
+    return xQueue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(const QueueHandle_t xQueue) {
+    std::lock_guard<std::mutex> lock(xQueue->mutex);
+    return xQueue->length - xQueue->count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue) {
+    std::lock_guard<std::mutex> lock(xQueue->mutex);
+    xQueue->head  = 0;
+    xQueue->count = 0;
+    xQueue->cv.notify_all();
+    return pdPASS;
+}
+
+void vQueueDelete(QueueHandle_t xQueue) {
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        s_queues.erase(xQueue);
+    }
+    delete xQueue;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return createQueue(QueueKind::Mutex, 1, 0, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void) {
+    return createQueue(QueueKind::RecursiveMutex, 1, 0, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return createQueue(QueueKind::Binary, 1, 0, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount,
+                                           UBaseType_t uxInitialCount) {
+    if (uxMaxCount == 0 || uxInitialCount > uxMaxCount) {
+        return nullptr;
+    }
+    return createQueue(QueueKind::Counting, uxMaxCount, 0, uxInitialCount);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime) {
+    if (xSemaphore == nullptr) {
+        return pdFAIL;
+    }
+    if (queueReceive(xSemaphore, nullptr, xBlockTime, true) != pdPASS) {
+        return pdFAIL;
+    }
+    if (xSemaphore->kind == QueueKind::Mutex ||
+        xSemaphore->kind == QueueKind::RecursiveMutex) {
+        tskTaskControlBlock*        self = currentTcb();
+        std::lock_guard<std::mutex> lock(xSemaphore->mutex);
+        xSemaphore->holder    = self;
+        xSemaphore->recursion = 1;
+    }
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore) {
+    if (xSemaphore == nullptr) {
+        return pdFAIL;
+    }
+    // Registry lock before queue lock, see host_shim_stop_tasks()
+    tskTaskControlBlock* self = currentTcb();
+    {
+        std::lock_guard<std::mutex> lock(xSemaphore->mutex);
+        if (xSemaphore->kind == QueueKind::Mutex ||
+            xSemaphore->kind == QueueKind::RecursiveMutex) {
+            // FreeRTOS asserts if anyone but the holder gives a mutex back
+            if (xSemaphore->holder != self) {
+                ESP_LOGE(TAG, "Mutex given by a task that doesn't hold it");
+                return pdFAIL;
+            }
+            xSemaphore->holder    = nullptr;
+            xSemaphore->recursion = 0;
+        }
+        if (xSemaphore->count == xSemaphore->length) {
+            return pdFAIL;
+        }
+    }
+    return xQueueGenericSend(xSemaphore, nullptr, 0, queueSEND_TO_BACK);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex,
+                                   TickType_t        xBlockTime) {
+    tskTaskControlBlock* self = currentTcb();
+    {
+        std::lock_guard<std::mutex> lock(xMutex->mutex);
+        if (xMutex->holder == self) {
+            ++xMutex->recursion;
+            return pdPASS;
+        }
+    }
+    return xSemaphoreTake(xMutex, xBlockTime);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex) {
+    tskTaskControlBlock* self = currentTcb();
+    {
+        std::lock_guard<std::mutex> lock(xMutex->mutex);
+        if (xMutex->holder != self) {
+            return pdFAIL;
+        }
+        if (--xMutex->recursion > 0) {
+            return pdPASS;
+        }
+        xMutex->recursion = 1;
+    }
+    return xSemaphoreGive(xMutex);
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t xSemaphore) {
+    return uxQueueMessagesWaiting(xSemaphore);
+}
+
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t xSemaphore) {
+    std::lock_guard<std::mutex> lock(xSemaphore->mutex);
+    return xSemaphore->holder;
+}
+
+/* ----------------------------------------------------------- ring buffers */
+
+struct Ringbuffer {
+    size_t                           capacity;
+    size_t                           used = 0; /**< Including returned-late items */
+    std::deque<std::vector<uint8_t>> items;    /**< Sent, not received yet */
+    std::list<std::vector<uint8_t>>  received; /**< Received, not returned */
+    std::mutex                       mutex;
+    std::condition_variable          cv;
+};
+
+/// Header and alignment of a no-split item, as in esp_ringbuf
+static size_t ringItemBytes(size_t size) {
+    return 8 + ((size + 3) & ~static_cast<size_t>(3));
+}
+
+RingbufHandle_t xRingbufferCreate(size_t           xBufferSize,
+                                  RingbufferType_t xBufferType) {
+    if (xBufferType != RINGBUF_TYPE_NOSPLIT) {
+        ESP_LOGE(TAG, "Only RINGBUF_TYPE_NOSPLIT is supported");
+        return nullptr;
+    }
+    auto* ring     = new Ringbuffer{};
+    ring->capacity = xBufferSize & ~static_cast<size_t>(3);
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    s_ringbufs.insert(ring);
+    return ring;
+}
+
+size_t xRingbufferGetMaxItemSize(RingbufHandle_t xRingbuffer) {
+    auto* ring = static_cast<Ringbuffer*>(xRingbuffer);
+    return ring->capacity / 2 - 8;
+}
+
+BaseType_t xRingbufferSend(RingbufHandle_t xRingbuffer,
+                           const void*     pvItem,
+                           size_t          xItemSize,
+                           TickType_t      xTicksToWait) {
+    auto* ring = static_cast<Ringbuffer*>(xRingbuffer);
+    if (xItemSize > xRingbufferGetMaxItemSize(xRingbuffer)) {
+        return pdFALSE;
+    }
+    const size_t                 need = ringItemBytes(xItemSize);
+    std::unique_lock<std::mutex> lock(ring->mutex);
+    if (ring->used + need > ring->capacity) {
+        if (xTicksToWait == 0) {
+            return pdFALSE;
+        }
+        if (!waitTicks(ring->cv, lock, xTicksToWait, [ring, need] {
+                return ring->used + need <= ring->capacity;
+            })) {
+            return pdFALSE;
+        }
+    }
+    const auto* bytes = static_cast<const uint8_t*>(pvItem);
+    ring->items.emplace_back(bytes, bytes + xItemSize);
+    ring->used += need;
+    ring->cv.notify_all();
+    return pdTRUE;
+}
+
+void* xRingbufferReceive(RingbufHandle_t xRingbuffer,
+                         size_t*         pxItemSize,
+                         TickType_t      xTicksToWait) {
+    auto*                        ring = static_cast<Ringbuffer*>(xRingbuffer);
+    std::unique_lock<std::mutex> lock(ring->mutex);
+    if (ring->items.empty()) {
+        if (xTicksToWait == 0) {
+            return nullptr;
+        }
+        if (!waitTicks(ring->cv, lock, xTicksToWait, [ring] {
+                return !ring->items.empty();
+            })) {
+            return nullptr;
+        }
+    }
+    ring->received.push_back(std::move(ring->items.front()));
+    ring->items.pop_front();
+    auto& item = ring->received.back();
+    if (pxItemSize) {
+        *pxItemSize = item.size();
+    }
+    // An empty vector has no data pointer to return the item with
+    if (item.empty()) {
+        item.reserve(1);
+    }
+    return item.data();
+}
+
+void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void* pvItem) {
+    auto*                       ring = static_cast<Ringbuffer*>(xRingbuffer);
+    std::lock_guard<std::mutex> lock(ring->mutex);
+    for (auto it = ring->received.begin(); it != ring->received.end(); ++it) {
+        if (it->data() == pvItem) {
+            ring->used -= ringItemBytes(it->size());
+            ring->received.erase(it);
+            ring->cv.notify_all();
+            return;
+        }
+    }
+    ESP_LOGE(TAG, "Returned an item that was not received");
+}
+
+size_t xRingbufferGetCurFreeSize(RingbufHandle_t xRingbuffer) {
+    auto*                       ring = static_cast<Ringbuffer*>(xRingbuffer);
+    std::lock_guard<std::mutex> lock(ring->mutex);
+    size_t free = ring->capacity - ring->used;
+    return free > 8 ? std::min(free - 8, xRingbufferGetMaxItemSize(ring)) : 0;
+}
+
+void vRingbufferDelete(RingbufHandle_t xRingbuffer) {
+    auto* ring = static_cast<Ringbuffer*>(xRingbuffer);
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        s_ringbufs.erase(ring);
+    }
+    delete ring;
+}
+
+/* -------------------------------------------------------------- host only */
+
+void host_shim_stop_tasks() {
+    s_shutdown = true;
+
+    std::vector<tskTaskControlBlock*> tasks;
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        for (auto& tcb : s_tasks) {
+            if (tcb.isTask) {
+                tasks.push_back(&tcb);
+            }
+        }
+    }
+    // Waiters check the shutdown flag whenever they wake up
+    for (auto* tcb : tasks) {
+        std::lock_guard<std::mutex> lock(tcb->mutex);
+        tcb->cv.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        for (auto* queue : s_queues) {
+            std::lock_guard<std::mutex> queueLock(queue->mutex);
+            queue->cv.notify_all();
+        }
+        for (auto* ring : s_ringbufs) {
+            std::lock_guard<std::mutex> ringLock(ring->mutex);
+            ring->cv.notify_all();
+        }
+    }
+    for (auto* tcb : tasks) {
+        if (tcb->thread.joinable() &&
+            tcb->thread.get_id() != std::this_thread::get_id()) {
+            tcb->thread.join();
+        }
+    }
+}
+
+size_t host_shim_running_tasks(void) {
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    return std::count_if(s_tasks.begin(), s_tasks.end(), [](const auto& tcb) {
+        return tcb.isTask && !tcb.finished;
+    });
+}
@@ -0,0 +1,26 @@
+/**
+ * @file host_shim.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Host only shim functions
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "host_shim.h"
+#include "host_shim_internal.h"
+#include <cstring>
+
+void host_shim_set_thread_name(pthread_t thread, const char* name) {
+    char shortName[16];
+    std::strncpy(shortName, name, sizeof(shortName) - 1);
+    shortName[sizeof(shortName) - 1] = '\0';
+    pthread_setname_np(thread, shortName);
+}
+
+void host_shim_shutdown(void) {
+    // Timers first so no callback notifies a task that is going away
+    host_shim_stop_timers();
+    host_shim_stop_tasks();
+}
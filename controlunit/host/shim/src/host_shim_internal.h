@@ -0,0 +1,29 @@
+/**
+ * @file host_shim_internal.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Functions shared between the host shim translation units
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <pthread.h>
+
+/**
+ * @brief Names a thread so it shows up in perf, gdb and top -H
+ *
+ * Linux limits thread names to 15 characters, longer names are truncated.
+ */
+void host_shim_set_thread_name(pthread_t thread, const char* name);
+
+/**
+ * @brief Stops and joins every task created with xTaskCreate
+ */
+void host_shim_stop_tasks();
+
+/**
+ * @brief Stops and joins the esp_timer thread
+ */
+void host_shim_stop_timers();
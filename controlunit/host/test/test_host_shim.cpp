@@ -0,0 +1,142 @@
+/**
+ * @brief Test file for the host FreeRTOS / ESP-IDF shim
+ *
+ * Covers the parts the components depend on: task notifications, mutexes,
+ * periodic esp_timer and an httpd handler answering a RestClient over
+ * loopback.
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "RestClient.h"
+#include "esp_http_client.h"
+#include "esp_http_server.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "host_shim.h"
+#include <atomic>
+#include <string>
+
+static void notifyTwiceTask(void* arg) {
+    auto target = static_cast<TaskHandle_t>(arg);
+    xTaskNotifyGive(target);
+    xTaskNotifyGive(target);
+    vTaskDelete(nullptr);
+}
+
+extern "C" void when_task_notified_twice_then_ulTaskNotifyTake_returns_two(
+    void) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    xTaskCreate(notifyTwiceTask, "NotifyTask", 2048, self, 1, nullptr);
+
+    // Wait for both notifications before taking them in one go
+    vTaskDelay(pdMS_TO_TICKS(50));
+    uint32_t count = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+    TEST_ASSERT_EQUAL_UINT(2, count);
+    TEST_ASSERT_EQUAL_UINT(0, ulTaskNotifyTake(pdTRUE, 0));
+}
+
+extern "C" void when_mutex_taken_then_second_take_times_out(void) {
+    SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+    TEST_ASSERT_NOT_NULL(mutex);
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(mutex, 0));
+    TEST_ASSERT_EQUAL(pdFALSE, xSemaphoreTake(mutex, pdMS_TO_TICKS(10)));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreGive(mutex));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(mutex, 0));
+    xSemaphoreGive(mutex);
+    vSemaphoreDelete(mutex);
+}
+
+static void countingCallback(void* arg) {
+    ++*static_cast<std::atomic<int>*>(arg);
+}
+
+extern "C" void when_periodic_timer_started_then_callback_runs_repeatedly(
+    void) {
+    std::atomic<int>       calls{0};
+    esp_timer_create_args_t args = {};
+    args.callback                = &countingCallback;
+    args.arg                     = &calls;
+    args.name                    = "test_timer";
+    esp_timer_handle_t timer     = nullptr;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_timer_create(&args, &timer));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_timer_start_periodic(timer, 10'000));
+
+    vTaskDelay(pdMS_TO_TICKS(105));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_timer_stop(timer));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_timer_delete(timer));
+    TEST_ASSERT_TRUE(calls >= 8 && calls <= 11);
+}
+
+static esp_err_t echoHandler(httpd_req_t* req) {
+    std::string body(req->content_len, '\0');
+    size_t      received = 0;
+    while (received < body.size()) {
+        int ret =
+            httpd_req_recv(req, body.data() + received, body.size() - received);
+        if (ret <= 0) {
+            return ESP_FAIL;
+        }
+        received += ret;
+    }
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, body.c_str(), body.size());
+}
+
+static httpd_handle_t startEchoServer() {
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port    = 0;
+    httpd_handle_t server = nullptr;
+    if (httpd_start(&server, &config) != ESP_OK) {
+        return nullptr;
+    }
+    httpd_uri_t uri = {};
+    uri.uri         = "/echo";
+    uri.method      = HTTP_POST;
+    uri.handler     = &echoHandler;
+    httpd_register_uri_handler(server, &uri);
+    return server;
+}
+
+extern "C" void when_handler_registered_then_rest_client_receives_response(
+    void) {
+    httpd_handle_t server = startEchoServer();
+    TEST_ASSERT_NOT_NULL(server);
+    std::string baseUrl =
+        "http://127.0.0.1:" + std::to_string(host_shim_httpd_port(server));
+
+    {
+        RestClient client(baseUrl, "test-jwt");
+        TEST_ASSERT_EQUAL(ESP_OK, client.init());
+        // Twice to go through connection reuse as well
+        for (int i = 0; i < 2; ++i) {
+            RestClientResponse response =
+                client.postTo("/echo", "{\"status\":\"ok\"}");
+            TEST_ASSERT_EQUAL(ESP_OK, response.err);
+            TEST_ASSERT_EQUAL_STRING("{\"status\":\"ok\"}",
+                                     response.payload.c_str());
+        }
+    }
+    httpd_stop(server);
+}
+
+extern "C" void when_uri_is_unknown_then_server_responds_404(void) {
+    httpd_handle_t server = startEchoServer();
+    TEST_ASSERT_NOT_NULL(server);
+    std::string url = "http://127.0.0.1:" +
+                      std::to_string(host_shim_httpd_port(server)) +
+                      "/missing";
+
+    esp_http_client_config_t config = {};
+    config.url                      = url.c_str();
+    config.method                   = HTTP_METHOD_POST;
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    esp_http_client_set_post_field(client, "{}", 2);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_perform(client));
+    TEST_ASSERT_EQUAL(404, esp_http_client_get_status_code(client));
+    esp_http_client_cleanup(client);
+    httpd_stop(server);
+}
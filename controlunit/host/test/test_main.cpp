@@ -0,0 +1,287 @@
+/**
+ * @brief main file for the host test runner
+ *
+ * Runs the same component tests as test_runner, natively on Linux, plus the
+ * tests for the host shim. Exits with the number of failed tests so ctest
+ * can pick up the result.
+ *
+ */
+extern "C" {
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+}
+#include "host_shim.h"
+
+#define LOG_TEST_GROUP(name)                                                   \
+    ESP_LOGI("TEST", "========== Testing %s ==========", name)
+
+extern "C" {
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void when_manager_empty_then_hasUnit_returns_false(void);
+void when_unit_added_then_hasUnit_returns_true(void);
+void when_unit_added_and_removed_then_hasUnit_returns_false(void);
+void when_unit_added_twice_then_logs_error(void);
+void when_nonexistent_unit_removed_then_logs_error(void);
+void stress_test_many_units(void);
+void when_reading_stored_then_it_is_grouped_by_timestamp(void);
+void when_storing_multiple_readings_with_same_timestamp_then_grouped_together(
+    void);
+void when_storing_readings_with_different_timestamps_then_grouped_separately(
+    void);
+void after_clearing_readings_grouped_readings_is_empty(void);
+void after_clearing_one_reading_grouped_readings_contains_correct_amount(void);
+void readingsCount_follows_stored_and_cleared_readings(void);
+// UploadSlotPlanner
+void when_units_connect_then_they_spread_over_the_windows(void);
+void when_unit_connects_again_then_it_keeps_its_window(void);
+void when_windows_disabled_or_full_then_units_still_get_an_answer(void);
+// JsonParser
+void when_passed_a_uuid_composeStatusRequest_generates_valid_json(void);
+void when_passed_empty_string_composeStatusRequest_returns_empty_string(void);
+void when_given_valid_json_parseStatusResponse_returns_correct_response(void);
+void when_given_valid_delivered_parseStatusResponse_returns_disconnect_response(void);
+void when_given_invalid_json_parseStatusResponse_returns_empty_vector(void);
+void when_given_valid_json_parseBackendReadingsResponse_returns_correct_value(void);
+void when_given_invalid_json_parseBackendReadingsResponse_returns_zero(void);
+void when_status_not_ok_parseBackendReadingsResponse_returns_zero(void);
+
+void when_readings_are_present_then_parseSensorSnapshotGroup_returns_all_snapshots(
+    void);
+void when_grouped_readings_are_given_then_composeGroupedReadings_returns_expected_json(
+    void);
+void when_valid_connect_json_is_given_then_parseSensorConnectRequest_returns_expected_request(
+    void);
+void when_sensor_uuid_is_missing_then_parseSensorConnectRequest_returns_empty_request(
+    void);
+void when_json_is_invalid_then_parseSensorConnectRequest_returns_empty_request(
+    void);
+void when_valid_disconnect_json_is_given_then_parseSensorConnectRequest_returns_expected_request(
+    void);
+void when_valid_sensor_response_is_given_then_composeSensorConnectResponse_returns_expected_json(
+    void);
+void when_sensor_uuid_is_missing_then_composeSensorConnectResponse_sets_uuid_to_unknown(
+    void);
+void when_connection_status_is_pending_then_composeSensorConnectResponse_serializes_status_correctly(
+    void);
+// connectionStatusToString
+void when_given_connected_status_connectionStatusToString_returns_connected(
+    void);
+void when_given_disconnected_status_connectionStatusToString_returns_disconnected(
+    void);
+void when_given_pending_status_connectionStatusToString_returns_pending(void);
+void when_given_unavailable_status_connectionStatusToString_returns_unavailable(
+    void);
+void when_given_invalid_status_connectionStatusToString_returns_unknown(void);
+
+// composeSensorunitConnectPayload
+void when_slot_is_given_then_composeSensorunitConnectPayload_adds_upload_window(
+    void);
+// composeErrorResponse
+void when_passing_message_to_composeErrorResponse_then_it_should_return_valid_json_string(
+    void);
+// composeResourcesPayload
+void when_resource_snapshot_is_given_then_composeResourcesPayload_returns_expected_json(
+    void);
+
+// DispatchPolicy
+void when_backlog_empty_then_policy_skips_dispatch(void);
+void when_interval_passed_then_policy_dispatches(void);
+void when_backlog_reaches_threshold_then_policy_dispatches_early(void);
+void when_posts_fail_then_policy_backs_off_up_to_max(void);
+void when_jitter_is_max_then_backoff_is_full_interval(void);
+void when_post_succeeds_after_failures_then_interval_resets(void);
+void when_catching_up_then_interval_follows_backend_latency(void);
+
+// CircuitBreaker
+void when_failures_below_threshold_then_circuit_stays_closed(void);
+void when_failures_reach_threshold_then_circuit_opens(void);
+void when_open_time_passed_then_only_one_probe_is_allowed(void);
+void when_probe_fails_then_open_time_doubles_up_to_max(void);
+void when_probe_abandoned_then_next_probe_is_allowed(void);
+
+// TimerWheel
+void when_timers_expire_then_they_fire_once_in_tick_order(void);
+void when_timer_is_rounds_away_then_it_waits_for_its_round(void);
+void when_timer_removed_or_overdue_then_wheel_handles_it(void);
+
+// JobScheduler
+void when_jobs_scheduled_then_periodic_repeat_and_one_shot_runs_once(void);
+void when_job_outlasts_its_period_then_overruns_are_counted(void);
+
+// AllocCounter
+void when_buffers_allocated_and_freed_then_live_and_peak_follow(void);
+void when_counters_listed_then_every_counter_is_included(void);
+
+// ResourceMonitor
+void when_scheduler_runs_then_sample_has_worker_stack_and_heap(void);
+
+// Metrics
+void when_values_observed_then_histogram_buckets_them_by_bound(void);
+void when_sum_passes_32_bits_then_histogram_sum_keeps_counting(void);
+void when_metrics_written_then_output_is_prometheus_text(void);
+
+// LogRateLimit
+void when_lines_repeat_then_limiter_and_sampler_count_them(void);
+
+// DeferredLog
+void when_lines_logged_then_deferred_log_writes_them_in_order(void);
+
+// RestClient
+void when_command_and_bulk_wait_then_command_is_sent_first(void);
+void when_backend_is_down_then_circuit_opens_and_rejects(void);
+void when_response_is_chunked_then_body_is_complete(void);
+void when_response_exceeds_buffer_then_error_is_returned(void);
+void when_handler_given_then_large_body_is_streamed(void);
+void when_jobs_queued_then_command_runs_first_and_is_prepared_early(void);
+void when_prepare_declines_then_job_is_dropped_uncompleted(void);
+
+// Host shim
+void when_task_notified_twice_then_ulTaskNotifyTake_returns_two(void);
+void when_mutex_taken_then_second_take_times_out(void);
+void when_periodic_timer_started_then_callback_runs_repeatedly(void);
+void when_handler_registered_then_rest_client_receives_response(void);
+void when_uri_is_unknown_then_server_responds_404(void);
+} // extern "C"
+
+int main() {
+    esp_log_level_set("*", ESP_LOG_WARN);
+
+    LOG_TEST_GROUP("SensorUnitManager");
+    UNITY_BEGIN();
+    RUN_TEST(when_manager_empty_then_hasUnit_returns_false);
+    RUN_TEST(when_unit_added_then_hasUnit_returns_true);
+    RUN_TEST(when_unit_added_and_removed_then_hasUnit_returns_false);
+    RUN_TEST(when_unit_added_twice_then_logs_error);
+    RUN_TEST(when_nonexistent_unit_removed_then_logs_error);
+    RUN_TEST(stress_test_many_units);
+    RUN_TEST(when_reading_stored_then_it_is_grouped_by_timestamp);
+    RUN_TEST(
+        when_storing_multiple_readings_with_same_timestamp_then_grouped_together);
+    RUN_TEST(
+        when_storing_readings_with_different_timestamps_then_grouped_separately);
+    RUN_TEST(after_clearing_readings_grouped_readings_is_empty);
+    RUN_TEST(after_clearing_one_reading_grouped_readings_contains_correct_amount);
+    RUN_TEST(readingsCount_follows_stored_and_cleared_readings);
+
+    LOG_TEST_GROUP("UploadSlotPlanner");
+    RUN_TEST(when_units_connect_then_they_spread_over_the_windows);
+    RUN_TEST(when_unit_connects_again_then_it_keeps_its_window);
+    RUN_TEST(when_windows_disabled_or_full_then_units_still_get_an_answer);
+
+    LOG_TEST_GROUP("JsonParser");
+    RUN_TEST(when_passed_a_uuid_composeStatusRequest_generates_valid_json);
+    RUN_TEST(when_passed_empty_string_composeStatusRequest_returns_empty_string);
+    RUN_TEST(when_given_valid_json_parseStatusResponse_returns_correct_response);
+    RUN_TEST(when_given_valid_delivered_parseStatusResponse_returns_disconnect_response);
+    RUN_TEST(when_given_invalid_json_parseStatusResponse_returns_empty_vector);
+    RUN_TEST(when_given_valid_json_parseBackendReadingsResponse_returns_correct_value);
+    RUN_TEST(when_given_invalid_json_parseBackendReadingsResponse_returns_zero);
+    RUN_TEST(when_status_not_ok_parseBackendReadingsResponse_returns_zero);
+    RUN_TEST(
+        when_readings_are_present_then_parseSensorSnapshotGroup_returns_all_snapshots);
+    RUN_TEST(
+        when_grouped_readings_are_given_then_composeGroupedReadings_returns_expected_json);
+    RUN_TEST(
+        when_valid_connect_json_is_given_then_parseSensorConnectRequest_returns_expected_request);
+    RUN_TEST(
+        when_sensor_uuid_is_missing_then_parseSensorConnectRequest_returns_empty_request);
+    RUN_TEST(
+        when_json_is_invalid_then_parseSensorConnectRequest_returns_empty_request);
+    RUN_TEST(
+        when_valid_disconnect_json_is_given_then_parseSensorConnectRequest_returns_expected_request);
+    RUN_TEST(
+        when_valid_sensor_response_is_given_then_composeSensorConnectResponse_returns_expected_json);
+    RUN_TEST(
+        when_sensor_uuid_is_missing_then_composeSensorConnectResponse_sets_uuid_to_unknown);
+    RUN_TEST(
+        when_connection_status_is_pending_then_composeSensorConnectResponse_serializes_status_correctly);
+    // connectionStatusToString
+    RUN_TEST(
+        when_given_connected_status_connectionStatusToString_returns_connected);
+    RUN_TEST(
+        when_given_disconnected_status_connectionStatusToString_returns_disconnected);
+    RUN_TEST(
+        when_given_pending_status_connectionStatusToString_returns_pending);
+    RUN_TEST(
+        when_given_unavailable_status_connectionStatusToString_returns_unavailable);
+    RUN_TEST(
+        when_given_invalid_status_connectionStatusToString_returns_unknown);
+
+    // composeSensorunitConnectPayload
+    RUN_TEST(
+        when_slot_is_given_then_composeSensorunitConnectPayload_adds_upload_window);
+    // composeErrorResponse
+    RUN_TEST(
+        when_passing_message_to_composeErrorResponse_then_it_should_return_valid_json_string);
+    // composeResourcesPayload
+    RUN_TEST(
+        when_resource_snapshot_is_given_then_composeResourcesPayload_returns_expected_json);
+
+    LOG_TEST_GROUP("DispatchPolicy");
+    RUN_TEST(when_backlog_empty_then_policy_skips_dispatch);
+    RUN_TEST(when_interval_passed_then_policy_dispatches);
+    RUN_TEST(when_backlog_reaches_threshold_then_policy_dispatches_early);
+    RUN_TEST(when_posts_fail_then_policy_backs_off_up_to_max);
+    RUN_TEST(when_jitter_is_max_then_backoff_is_full_interval);
+    RUN_TEST(when_post_succeeds_after_failures_then_interval_resets);
+    RUN_TEST(when_catching_up_then_interval_follows_backend_latency);
+
+    LOG_TEST_GROUP("CircuitBreaker");
+    RUN_TEST(when_failures_below_threshold_then_circuit_stays_closed);
+    RUN_TEST(when_failures_reach_threshold_then_circuit_opens);
+    RUN_TEST(when_open_time_passed_then_only_one_probe_is_allowed);
+    RUN_TEST(when_probe_fails_then_open_time_doubles_up_to_max);
+    RUN_TEST(when_probe_abandoned_then_next_probe_is_allowed);
+
+    LOG_TEST_GROUP("TimerWheel");
+    RUN_TEST(when_timers_expire_then_they_fire_once_in_tick_order);
+    RUN_TEST(when_timer_is_rounds_away_then_it_waits_for_its_round);
+    RUN_TEST(when_timer_removed_or_overdue_then_wheel_handles_it);
+
+    LOG_TEST_GROUP("JobScheduler");
+    RUN_TEST(when_jobs_scheduled_then_periodic_repeat_and_one_shot_runs_once);
+    RUN_TEST(when_job_outlasts_its_period_then_overruns_are_counted);
+
+    LOG_TEST_GROUP("AllocCounter");
+    RUN_TEST(when_buffers_allocated_and_freed_then_live_and_peak_follow);
+    RUN_TEST(when_counters_listed_then_every_counter_is_included);
+
+    LOG_TEST_GROUP("ResourceMonitor");
+    RUN_TEST(when_scheduler_runs_then_sample_has_worker_stack_and_heap);
+
+    LOG_TEST_GROUP("Metrics");
+    RUN_TEST(when_values_observed_then_histogram_buckets_them_by_bound);
+    RUN_TEST(when_sum_passes_32_bits_then_histogram_sum_keeps_counting);
+    RUN_TEST(when_metrics_written_then_output_is_prometheus_text);
+
+    LOG_TEST_GROUP("LogRateLimit");
+    RUN_TEST(when_lines_repeat_then_limiter_and_sampler_count_them);
+
+    LOG_TEST_GROUP("DeferredLog");
+    RUN_TEST(when_lines_logged_then_deferred_log_writes_them_in_order);
+
+    LOG_TEST_GROUP("RestClient");
+    RUN_TEST(when_command_and_bulk_wait_then_command_is_sent_first);
+    RUN_TEST(when_backend_is_down_then_circuit_opens_and_rejects);
+    RUN_TEST(when_response_is_chunked_then_body_is_complete);
+    RUN_TEST(when_response_exceeds_buffer_then_error_is_returned);
+    RUN_TEST(when_handler_given_then_large_body_is_streamed);
+    RUN_TEST(when_jobs_queued_then_command_runs_first_and_is_prepared_early);
+    RUN_TEST(when_prepare_declines_then_job_is_dropped_uncompleted);
+
+    LOG_TEST_GROUP("Host shim");
+    RUN_TEST(when_task_notified_twice_then_ulTaskNotifyTake_returns_two);
+    RUN_TEST(when_mutex_taken_then_second_take_times_out);
+    RUN_TEST(when_periodic_timer_started_then_callback_runs_repeatedly);
+    RUN_TEST(when_handler_registered_then_rest_client_receives_response);
+    RUN_TEST(when_uri_is_unknown_then_server_responds_404);
+
+    int failures = UNITY_END();
+    host_shim_shutdown();
+    return failures;
+}
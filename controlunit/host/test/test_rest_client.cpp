@@ -0,0 +1,318 @@
+/**
+ * @brief Test file for the RestClient request scheduling
+ *
+ * Runs RestClient against a local httpd: priority order between tasks
+ * waiting for the shared client, the circuit breaker on a dead backend,
+ * chunked, oversized and streamed response bodies and the BackendIoTask
+ * job queue.
+ *
+ */
+extern "C" {
+#include "unity.h"
+}
+#include "BackendIoTask.h"
+#include "Metrics.h"
+#include "RestClient.h"
+#include "esp_http_server.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "host_shim.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::mutex               s_orderMutex;
+static std::vector<std::string> s_order;
+
+static esp_err_t slowHandler(httpd_req_t* req) {
+    std::string body(req->content_len, '\0');
+    httpd_req_recv(req, body.data(), body.size());
+    {
+        std::lock_guard<std::mutex> lock(s_orderMutex);
+        s_order.push_back(body);
+    }
+    vTaskDelay(pdMS_TO_TICKS(300));
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_sendstr(req, "{}");
+}
+
+/// 4096 bytes, four times the default response buffer
+static const std::string s_largeBody(4096, 'x');
+
+static esp_err_t chunkedHandler(httpd_req_t* req) {
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr_chunk(req, "{\"status\":");
+    httpd_resp_sendstr_chunk(req, "\"ok\",");
+    httpd_resp_sendstr_chunk(req, "\"saved\":3}");
+    return httpd_resp_send_chunk(req, nullptr, 0);
+}
+
+static esp_err_t largeHandler(httpd_req_t* req) {
+    return httpd_resp_send(req, s_largeBody.data(), s_largeBody.size());
+}
+
+static esp_err_t largeChunkedHandler(httpd_req_t* req) {
+    for (size_t i = 0; i < s_largeBody.size(); i += 1000) {
+        size_t len = std::min<size_t>(1000, s_largeBody.size() - i);
+        httpd_resp_send_chunk(req, s_largeBody.data() + i, len);
+    }
+    return httpd_resp_send_chunk(req, nullptr, 0);
+}
+
+static httpd_handle_t startServer() {
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port    = 0;
+    httpd_handle_t server = nullptr;
+    if (httpd_start(&server, &config) != ESP_OK) {
+        return nullptr;
+    }
+    static const std::pair<const char*, esp_err_t (*)(httpd_req_t*)>
+        handlers[] = {
+            {"/slow", &slowHandler},
+            {"/chunked", &chunkedHandler},
+            {"/large", &largeHandler},
+            {"/large-chunked", &largeChunkedHandler},
+        };
+    for (const auto& [path, handler] : handlers) {
+        httpd_uri_t uri = {};
+        uri.uri         = path;
+        uri.method      = HTTP_POST;
+        uri.handler     = handler;
+        httpd_register_uri_handler(server, &uri);
+    }
+    return server;
+}
+
+static std::string baseUrl(httpd_handle_t server) {
+    return "http://127.0.0.1:" + std::to_string(host_shim_httpd_port(server));
+}
+
+extern "C" void when_command_and_bulk_wait_then_command_is_sent_first(void) {
+    httpd_handle_t server = startServer();
+    TEST_ASSERT_NOT_NULL(server);
+    s_order.clear();
+
+    {
+        RestClient client(baseUrl(server), "test-jwt");
+        TEST_ASSERT_EQUAL(ESP_OK, client.init());
+
+        // a owns the client, then b (bulk) and c (command) queue up
+        std::thread a([&] { client.postTo("/slow", "a"); });
+        vTaskDelay(pdMS_TO_TICKS(50));
+        std::thread b([&] { client.postTo("/slow", "b"); });
+        vTaskDelay(pdMS_TO_TICKS(50));
+        std::thread c(
+            [&] { client.postTo("/slow", "c", RequestPriority::Command); });
+        a.join();
+        b.join();
+        c.join();
+
+        TEST_ASSERT_EQUAL(3, s_order.size());
+        TEST_ASSERT_EQUAL_STRING("a", s_order[0].c_str());
+        TEST_ASSERT_EQUAL_STRING("c", s_order[1].c_str());
+        TEST_ASSERT_EQUAL_STRING("b", s_order[2].c_str());
+
+        RequestClassStats command = client.classStats(RequestPriority::Command);
+        RequestClassStats bulk    = client.classStats(RequestPriority::Bulk);
+        TEST_ASSERT_EQUAL_UINT32(1, command.requests);
+        TEST_ASSERT_EQUAL_UINT32(2, bulk.requests);
+        // c waited for a, b waited for a and c
+        TEST_ASSERT_TRUE(command.maxWaitUs >= 150'000);
+        TEST_ASSERT_TRUE(bulk.maxWaitUs > command.maxWaitUs);
+    }
+    httpd_stop(server);
+}
+
+extern "C" void when_backend_is_down_then_circuit_opens_and_rejects(void) {
+    // Nothing listens on port 1, every connect is refused
+    RestClient client("http://127.0.0.1:1", "test-jwt", 500);
+    TEST_ASSERT_EQUAL(ESP_OK, client.init());
+
+    for (int i = 0; i < 3; ++i) {
+        TEST_ASSERT_NOT_EQUAL(ESP_OK, client.postTo("/readings", "{}").err);
+    }
+    TEST_ASSERT_TRUE(client.circuitState("/readings") ==
+                     CircuitBreaker::State::Open);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE,
+                      client.postTo("/readings", "{}").err);
+    // Other endpoints have their own circuit
+    TEST_ASSERT_TRUE(client.circuitState("/status") ==
+                     CircuitBreaker::State::Closed);
+
+    RequestClassStats bulk = client.classStats(RequestPriority::Bulk);
+    TEST_ASSERT_EQUAL_UINT32(3, bulk.requests);
+    TEST_ASSERT_EQUAL_UINT32(1, bulk.circuitRejects);
+
+    // Exported per class for /metrics
+    std::string out;
+    writePrometheus(out);
+    TEST_ASSERT_TRUE(
+        out.find("cu_backend_circuit_rejects_total{class=\"bulk\"} ") !=
+        std::string::npos);
+    TEST_ASSERT_TRUE(
+        out.find("cu_backend_wait_seconds_count{class=\"bulk\"} ") !=
+        std::string::npos);
+}
+
+extern "C" void when_response_is_chunked_then_body_is_complete(void) {
+    httpd_handle_t server = startServer();
+    TEST_ASSERT_NOT_NULL(server);
+    {
+        RestClient client(baseUrl(server), "test-jwt");
+        TEST_ASSERT_EQUAL(ESP_OK, client.init());
+        RestClientResponse response = client.postTo("/chunked", "{}");
+        TEST_ASSERT_EQUAL(ESP_OK, response.err);
+        TEST_ASSERT_EQUAL_STRING("{\"status\":\"ok\",\"saved\":3}",
+                                 response.payload.c_str());
+    }
+    httpd_stop(server);
+}
+
+extern "C" void when_response_exceeds_buffer_then_error_is_returned(void) {
+    httpd_handle_t server = startServer();
+    TEST_ASSERT_NOT_NULL(server);
+    {
+        RestClient client(baseUrl(server), "test-jwt", 5000, 1024);
+        TEST_ASSERT_EQUAL(ESP_OK, client.init());
+        for (const char* path : {"/large", "/large-chunked"}) {
+            RestClientResponse response = client.postTo(path, "{}");
+            TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, response.err);
+            TEST_ASSERT_EQUAL(1024, response.payload.size());
+            TEST_ASSERT_EQUAL(s_largeBody.size(), response.bodyBytes);
+        }
+        // The client is still usable afterwards
+        TEST_ASSERT_EQUAL(ESP_OK, client.postTo("/chunked", "{}").err);
+    }
+    httpd_stop(server);
+}
+
+static void appendToString(void* context, const char* data, size_t len) {
+    static_cast<std::string*>(context)->append(data, len);
+}
+
+extern "C" void when_handler_given_then_large_body_is_streamed(void) {
+    httpd_handle_t server = startServer();
+    TEST_ASSERT_NOT_NULL(server);
+    {
+        RestClient client(baseUrl(server), "test-jwt", 5000, 1024);
+        TEST_ASSERT_EQUAL(ESP_OK, client.init());
+        for (const char* path : {"/large", "/large-chunked"}) {
+            std::string     streamed;
+            ResponseHandler handler{&appendToString, &streamed};
+            RestClientResponse response =
+                client.postTo(path, "{}", RequestPriority::Bulk, handler);
+            TEST_ASSERT_EQUAL(ESP_OK, response.err);
+            TEST_ASSERT_TRUE(response.payload.empty());
+            TEST_ASSERT_TRUE(streamed == s_largeBody);
+        }
+    }
+    httpd_stop(server);
+}
+
+/// Job context for the BackendIoTask tests
+struct TestJob {
+    const char*       name;
+    bool              send = true;
+    std::atomic<int>  status{0};
+    std::atomic<bool> completed{false};
+};
+
+static bool prepareTestJob(void* context, std::string& payload) {
+    auto* job = static_cast<TestJob*>(context);
+    payload   = job->name;
+    return job->send;
+}
+
+static void completeTestJob(void* context, const RestClientResponse& response) {
+    auto* job      = static_cast<TestJob*>(context);
+    job->status    = response.status;
+    job->completed = true;
+}
+
+static BackendJob makeJob(TestJob& job, RequestPriority priority) {
+    BackendJob backendJob{};
+    backendJob.endpoint = "/slow";
+    backendJob.priority = priority;
+    backendJob.prepare  = &prepareTestJob;
+    backendJob.complete = &completeTestJob;
+    backendJob.context  = &job;
+    return backendJob;
+}
+
+static bool waitCompleted(const TestJob& job) {
+    for (int i = 0; i < 300 && !job.completed; ++i) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return job.completed;
+}
+
+extern "C" void when_jobs_queued_then_command_runs_first_and_is_prepared_early(
+    void) {
+    httpd_handle_t server = startServer();
+    TEST_ASSERT_NOT_NULL(server);
+    s_order.clear();
+    {
+        RestClient client(baseUrl(server), "test-jwt");
+        TEST_ASSERT_EQUAL(ESP_OK, client.init());
+        BackendIoTask io(client);
+        TEST_ASSERT_EQUAL(ESP_OK, io.start());
+
+        // a is in flight when b (bulk) and c (command) are queued
+        TestJob a{"a"}, b{"b"}, c{"c"};
+        TEST_ASSERT_TRUE(io.submit(makeJob(a, RequestPriority::Bulk)));
+        vTaskDelay(pdMS_TO_TICKS(50));
+        TEST_ASSERT_TRUE(io.submit(makeJob(b, RequestPriority::Bulk)));
+        TEST_ASSERT_TRUE(io.submit(makeJob(c, RequestPriority::Command)));
+        TEST_ASSERT_TRUE(waitCompleted(a));
+        TEST_ASSERT_TRUE(waitCompleted(b));
+        TEST_ASSERT_TRUE(waitCompleted(c));
+        io.stop();
+
+        TEST_ASSERT_EQUAL(3, s_order.size());
+        TEST_ASSERT_EQUAL_STRING("a", s_order[0].c_str());
+        TEST_ASSERT_EQUAL_STRING("c", s_order[1].c_str());
+        TEST_ASSERT_EQUAL_STRING("b", s_order[2].c_str());
+        TEST_ASSERT_EQUAL(200, a.status);
+        TEST_ASSERT_EQUAL(200, c.status);
+
+        BackendIoStats stats = io.stats();
+        TEST_ASSERT_EQUAL_UINT32(3, stats.submitted);
+        TEST_ASSERT_EQUAL_UINT32(3, stats.completed);
+        // c while a was in flight, b while c was
+        TEST_ASSERT_EQUAL_UINT32(2, stats.overlapped);
+    }
+    httpd_stop(server);
+}
+
+extern "C" void when_prepare_declines_then_job_is_dropped_uncompleted(void) {
+    httpd_handle_t server = startServer();
+    TEST_ASSERT_NOT_NULL(server);
+    s_order.clear();
+    {
+        RestClient client(baseUrl(server), "test-jwt");
+        TEST_ASSERT_EQUAL(ESP_OK, client.init());
+        BackendIoTask io(client);
+        TEST_ASSERT_EQUAL(ESP_OK, io.start());
+
+        TestJob skipped{"skipped"}, sent{"sent"};
+        skipped.send = false;
+        TEST_ASSERT_TRUE(io.submit(makeJob(skipped, RequestPriority::Bulk)));
+        TEST_ASSERT_TRUE(io.submit(makeJob(sent, RequestPriority::Bulk)));
+        TEST_ASSERT_TRUE(waitCompleted(sent));
+        io.stop();
+        // Not running any more
+        TEST_ASSERT_FALSE(io.submit(makeJob(sent, RequestPriority::Bulk)));
+
+        TEST_ASSERT_FALSE(skipped.completed);
+        TEST_ASSERT_EQUAL(1, s_order.size());
+        TEST_ASSERT_EQUAL_STRING("sent", s_order[0].c_str());
+        BackendIoStats stats = io.stats();
+        TEST_ASSERT_EQUAL_UINT32(1, stats.dropped);
+        TEST_ASSERT_EQUAL_UINT32(1, stats.completed);
+        TEST_ASSERT_EQUAL_UINT32(1, stats.rejected);
+    }
+    httpd_stop(server);
+}
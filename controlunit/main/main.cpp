@@ -7,8 +7,12 @@
  * @license MIT
  *
  */
+#include "BackendIoTask.h"
+#include "DeferredLog.h"
+#include "JobScheduler.h"
 #include "MockDataGenerator.h"
 #include "ReadingsDispatcher.h"
+#include "ResourceMonitor.h"
 #include "RestClient.h"
 #include "RestServer.h"
 #include "SensorUnitLinkSyncer.h"
@@ -22,6 +26,11 @@
 extern "C" void app_main(void) {
     /// Wait for monitor so we don't miss first part of the log
     vTaskDelay(pdMS_TO_TICKS(500));
+#if CONFIG_CU_LOG_DEFERRED
+    // From here on no task waits for the UART when it logs
+    static DeferredLog deferredLog(CONFIG_CU_LOG_BUFFER_BYTES);
+    deferredLog.start();
+#endif
     nvs_flash_init();
     init_wifi();
 
@@ -29,21 +38,38 @@ extern "C" void app_main(void) {
     static TimeSyncManager timeSyncManager;
     timeSyncManager.start();
 
-    static SensorUnitManager sensorUnitManager;
+    // Units take turns on the AP, one connection stays free for pairing
+    UploadSlotConfig uploadSlots;
+    uploadSlots.unitsPerWindow = AP_MAX_CONNECTIONS - 1;
+    static SensorUnitManager sensorUnitManager(uploadSlots);
     sensorUnitManager.init();
 
 #ifdef MANUALLY_ADD_SENSORUNIT_FOR_TESTING
     sensorUnitManager.addUnit(Uuid(TEST_SENSOR_UNIT_ID));
 #endif
 
-    static RestServer server(
-        CONTROL_UNIT_PORT, timeSyncManager, sensorUnitManager);
+    // All periodic work runs on this scheduler's worker
+    static JobScheduler scheduler;
+    scheduler.start();
+
+    // Stack, heap and allocation sample every 30 s, also on GET /resources
+    static ResourceMonitor resourceMonitor(scheduler);
+    resourceMonitor.start();
+
+    static RestServer server(CONTROL_UNIT_PORT,
+                             timeSyncManager,
+                             sensorUnitManager,
+                             &resourceMonitor);
     if (server.start()) {
     }
 
     static RestClient client(CLIENT_URL, SECRET_JWT);
     client.init();
 
+    // All backend requests go through this one task
+    static BackendIoTask backendIo(client);
+    backendIo.start();
+
     #ifdef CONTROL_UNIT_ID
     static ControlUnitManager controlUnitManager(sensorUnitManager, CONTROL_UNIT_ID);
     #else
@@ -53,18 +79,23 @@ extern "C" void app_main(void) {
     vTaskDelay(pdMS_TO_TICKS(500));
 
 #ifdef GENERATE_MOCKED_SENSOR_DATA
-    static MockDataGenerator mockdataGenerator(controlUnitManager, 5'000'000);
+    static MockDataGenerator mockdataGenerator(
+        scheduler, controlUnitManager, 5'000'000);
     mockdataGenerator.start();
 #endif
 
     vTaskDelay(pdMS_TO_TICKS(200));
 
-    static ReadingsDispatcher dispatcher(client, controlUnitManager, 30'000'000);
+    // Adaptive mode, 30 s normally, sooner on a large backlog, backs off to
+    // 5 min when the backend fails
+    DispatchPolicyConfig dispatchPolicy;
+    static ReadingsDispatcher dispatcher(
+        backendIo, scheduler, controlUnitManager, dispatchPolicy);
     dispatcher.start();
 
     vTaskDelay(pdMS_TO_TICKS(200));
     static SensorUnitLinkSyncer statusPoller(
-        client, sensorUnitManager, 8'000'000, CONTROL_UNIT_ID);
+        backendIo, scheduler, sensorUnitManager, 8'000'000, CONTROL_UNIT_ID);
     statusPoller.start();
 
 #ifdef REMOVE_AND_ADD_SENSORUNIT_WITH_DELAY_FOR_TESTING
@@ -0,0 +1,160 @@
+// Load generator that simulates many Sensor Units against a Control Unit.
+//
+// Every unit runs the real /connect -> /time -> /readings protocol with the
+// same payloads as sensorunit/lib/json_parser. See README.md
+package main
+
+import (
+	"context"
+	"encoding/json"
+	"flag"
+	"fmt"
+	"net/http"
+	"os"
+	"os/signal"
+	"strings"
+	"sync"
+	"syscall"
+	"time"
+)
+
+// Config holds the command line options
+type Config struct {
+	Target           string
+	Units            int
+	FirstUnit        int
+	Duration         time.Duration
+	RampUp           time.Duration
+	ConnectInterval  time.Duration
+	SyncInterval     time.Duration
+	ReadingInterval  time.Duration
+	DispatchInterval time.Duration
+	ResyncInterval   time.Duration
+	Phase            string
+	Jitter           time.Duration
+	Timeout          time.Duration
+	APConnections    int
+	AssociateTime    time.Duration
+	KeepAlive        bool
+	Report           time.Duration
+	JSONPath         string
+	Seed             int64
+}
+
+func parseFlags() (*Config, error) {
+	cfg := &Config{}
+	flag.StringVar(&cfg.Target, "target", "http://127.0.0.1:8080", "Control Unit base URL")
+	flag.IntVar(&cfg.Units, "units", 100, "number of simulated Sensor Units")
+	flag.IntVar(&cfg.FirstUnit, "first-unit", 0, "index of the first unit, for running several generators")
+	flag.DurationVar(&cfg.Duration, "duration", time.Minute, "how long to run, 0 runs until Ctrl+C")
+	flag.DurationVar(&cfg.RampUp, "ramp-up", 5*time.Second, "spread unit start over this time")
+	flag.DurationVar(&cfg.ConnectInterval, "connect-interval", 5*time.Second, "retry interval for /connect")
+	flag.DurationVar(&cfg.SyncInterval, "sync-interval", 5*time.Second, "retry interval for /time before synced")
+	flag.DurationVar(&cfg.ReadingInterval, "reading-interval", 5*time.Second, "time between readings, whole seconds")
+	flag.DurationVar(&cfg.DispatchInterval, "dispatch-interval", 15*time.Second, "time between dispatches, whole seconds")
+	flag.DurationVar(&cfg.ResyncInterval, "resync-interval", 10*time.Minute, "time between /time resyncs, whole seconds")
+	flag.StringVar(&cfg.Phase, "phase", "unit", "dispatch and resync phase: unit (firmware), aligned or random")
+	flag.DurationVar(&cfg.Jitter, "jitter", 0, "random delay up to this before each dispatch")
+	flag.DurationVar(&cfg.Timeout, "timeout", 5*time.Second, "request timeout")
+	flag.IntVar(&cfg.APConnections, "ap-connections", 0, "stations the Control Unit access point takes, 0 unlimited")
+	flag.DurationVar(&cfg.AssociateTime, "associate-time", 2*time.Second, "time to join the access point")
+	flag.BoolVar(&cfg.KeepAlive, "keep-alive", true, "reuse connections like the firmware RestClient, false opens one per request")
+	flag.DurationVar(&cfg.Report, "report", 10*time.Second, "interval between progress reports, 0 disables")
+	flag.StringVar(&cfg.JSONPath, "json", "", "also write the summary as JSON to this file")
+	flag.Int64Var(&cfg.Seed, "seed", 1, "seed for readings, phases and jitter")
+	flag.Parse()
+
+	cfg.Target = strings.TrimRight(cfg.Target, "/")
+	if cfg.Units <= 0 {
+		return nil, fmt.Errorf("-units must be positive")
+	}
+	if cfg.Phase != "unit" && cfg.Phase != "aligned" && cfg.Phase != "random" {
+		return nil, fmt.Errorf("-phase must be unit, aligned or random")
+	}
+	for name, d := range map[string]time.Duration{
+		"-reading-interval":  cfg.ReadingInterval,
+		"-dispatch-interval": cfg.DispatchInterval,
+		"-resync-interval":   cfg.ResyncInterval,
+	} {
+		if d < time.Second || d%time.Second != 0 {
+			return nil, fmt.Errorf("%s must be whole seconds", name)
+		}
+	}
+	return cfg, nil
+}
+
+func newClient(cfg *Config) *http.Client {
+	transport := &http.Transport{
+		DisableKeepAlives:   !cfg.KeepAlive,
+		MaxIdleConnsPerHost: cfg.Units,
+	}
+	return &http.Client{Transport: transport, Timeout: cfg.Timeout}
+}
+
+func main() {
+	cfg, err := parseFlags()
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(2)
+	}
+
+	ctx, cancel := signal.NotifyContext(context.Background(), os.Interrupt, syscall.SIGTERM)
+	defer cancel()
+	if cfg.Duration > 0 {
+		ctx, cancel = context.WithTimeout(ctx, cfg.Duration+cfg.RampUp)
+		defer cancel()
+	}
+
+	fmt.Printf("Simulating %d Sensor Units (%s ... %s) against %s\n",
+		cfg.Units, UnitID(cfg.FirstUnit), UnitID(cfg.FirstUnit+cfg.Units-1), cfg.Target)
+	fmt.Printf("readings every %s, dispatch every %s (%s phase, jitter %s), keep-alive %t\n",
+		cfg.ReadingInterval, cfg.DispatchInterval, cfg.Phase, cfg.Jitter, cfg.KeepAlive)
+	if cfg.APConnections > 0 {
+		fmt.Printf("access point takes %d stations, joining takes %s\n", cfg.APConnections, cfg.AssociateTime)
+	}
+
+	stats := NewStats()
+	client := newClient(cfg)
+	ap := NewAccessPoint(cfg.APConnections)
+	var wg sync.WaitGroup
+	for i := 0; i < cfg.Units; i++ {
+		unit := NewUnit(cfg.FirstUnit+i, cfg, client, ap, stats)
+		delay := cfg.RampUp * time.Duration(i) / time.Duration(cfg.Units)
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			select {
+			case <-ctx.Done():
+				return
+			case <-time.After(delay):
+			}
+			unit.Run(ctx)
+		}()
+	}
+
+	if cfg.Report > 0 {
+		ticker := time.NewTicker(cfg.Report)
+	report:
+		for {
+			select {
+			case <-ctx.Done():
+				break report
+			case <-ticker.C:
+				PrintWindow(os.Stdout, stats.Window(cfg.Units))
+			}
+		}
+		ticker.Stop()
+	}
+	<-ctx.Done()
+	wg.Wait()
+
+	summary := stats.Total(cfg.Units)
+	PrintTotal(os.Stdout, summary)
+	if cfg.JSONPath != "" {
+		data, _ := json.MarshalIndent(summary, "", "  ")
+		if err := os.WriteFile(cfg.JSONPath, data, 0o644); err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(1)
+		}
+	}
+}
@@ -0,0 +1,82 @@
+package main
+
+import (
+	"encoding/json"
+	"fmt"
+)
+
+// UnitIDPrefix is shared with controlunit_host --loadgen-units so the
+// control unit can register the simulated units before they connect
+const UnitIDPrefix = "5e750000-0000-4000-8000-"
+
+// UnitID returns the sensor unit id for simulated unit number index
+func UnitID(index int) string {
+	return fmt.Sprintf("%s%012d", UnitIDPrefix, index)
+}
+
+// Field order matches sensorunit/lib/json_parser so the bytes on the wire
+// are the same as from a real Sensor Unit
+
+type connectRequest struct {
+	SensorUnitID string `json:"sensor_unit_id"`
+}
+
+type reading struct {
+	Timestamp   int64   `json:"timestamp"`
+	Temperature float64 `json:"temperature"`
+	Humidity    float64 `json:"humidity"`
+}
+
+type snapshotGroup struct {
+	SensorUnitID string    `json:"sensor_unit_id"`
+	Readings     []reading `json:"readings"`
+}
+
+type statusResponse struct {
+	Status string `json:"status"`
+}
+
+// connectResponse carries the upload window from a Control Unit that has
+// them, all zero from one that does not
+type connectResponse struct {
+	Status        string `json:"status"`
+	UploadPeriodS int64  `json:"upload_period_s"`
+	UploadOffsetS int64  `json:"upload_offset_s"`
+	UploadWindowS int64  `json:"upload_window_s"`
+}
+
+type timeResponse struct {
+	Timestamp int64 `json:"timestamp"`
+}
+
+func composeConnectRequest(id string) []byte {
+	payload, _ := json.Marshal(connectRequest{SensorUnitID: id})
+	return payload
+}
+
+func composeSensorSnapshotGroup(id string, readings []reading) []byte {
+	payload, _ := json.Marshal(snapshotGroup{SensorUnitID: id, Readings: readings})
+	return payload
+}
+
+func parseStatus(body []byte) string {
+	var response statusResponse
+	if json.Unmarshal(body, &response) != nil {
+		return ""
+	}
+	return response.Status
+}
+
+func parseConnectResponse(body []byte) connectResponse {
+	var response connectResponse
+	json.Unmarshal(body, &response)
+	return response
+}
+
+func parseTimestamp(body []byte) int64 {
+	var response timeResponse
+	if json.Unmarshal(body, &response) != nil {
+		return 0
+	}
+	return response.Timestamp
+}
@@ -0,0 +1,370 @@
+package main
+
+import (
+	"errors"
+	"fmt"
+	"io"
+	"net"
+	"sort"
+	"strings"
+	"sync"
+	"syscall"
+	"time"
+)
+
+// Endpoints in the order they are reported
+var endpoints = []string{"/connect", "/time", "/readings"}
+
+// endpointStats collects the results for one endpoint
+type endpointStats struct {
+	latencies []time.Duration // successful round trips, any HTTP status
+	statuses  map[int]int
+	errors    int            // transport errors and timeouts
+	kinds     map[string]int // errors by errorKind
+}
+
+func newEndpointStats() *endpointStats {
+	return &endpointStats{statuses: map[int]int{}, kinds: map[string]int{}}
+}
+
+// errorKind groups transport errors into what they mean for the server
+func errorKind(err error) string {
+	var netErr net.Error
+	switch {
+	case errors.As(err, &netErr) && netErr.Timeout():
+		return "timeout"
+	case errors.Is(err, syscall.ECONNREFUSED):
+		return "refused"
+	case errors.Is(err, syscall.ECONNRESET), errors.Is(err, syscall.EPIPE):
+		return "reset"
+	case errors.Is(err, io.EOF), errors.Is(err, io.ErrUnexpectedEOF),
+		strings.Contains(err.Error(), "EOF"):
+		return "closed"
+	default:
+		return "other"
+	}
+}
+
+func (s *endpointStats) requests() int {
+	return len(s.latencies) + s.errors
+}
+
+func (s *endpointStats) ok() int {
+	ok := 0
+	for status, count := range s.statuses {
+		if status >= 200 && status < 300 {
+			ok += count
+		}
+	}
+	return ok
+}
+
+// Stats is shared by all simulated units. Every result is recorded both in
+// the totals and in the current report window
+type Stats struct {
+	mu       sync.Mutex
+	total    map[string]*endpointStats
+	window   map[string]*endpointStats
+	accepted int // readings the control unit answered 200 to
+	windowAc int
+	dropped  int // readings overwritten in a full unit buffer
+
+	ages    []int64 // seconds from reading to acceptance
+	refused int     // access point joins refused, it was full
+	missed  int     // dispatches and resyncs skipped, late or not associated
+
+	inFlight int // requests sent and not answered yet
+	maxIn    int // most requests in flight at once
+	windowIn int
+	paired   map[string]bool
+	start    time.Time
+	windowAt time.Time
+}
+
+func NewStats() *Stats {
+	now := time.Now()
+	s := &Stats{
+		total:    map[string]*endpointStats{},
+		window:   map[string]*endpointStats{},
+		paired:   map[string]bool{},
+		start:    now,
+		windowAt: now,
+	}
+	for _, endpoint := range endpoints {
+		s.total[endpoint] = newEndpointStats()
+		s.window[endpoint] = newEndpointStats()
+	}
+	return s
+}
+
+// Record adds one request. status is 0 when err is set
+func (s *Stats) Record(endpoint string, latency time.Duration, status int, err error) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	for _, stats := range []*endpointStats{s.total[endpoint], s.window[endpoint]} {
+		if err != nil {
+			stats.errors++
+			stats.kinds[errorKind(err)]++
+			continue
+		}
+		stats.latencies = append(stats.latencies, latency)
+		stats.statuses[status]++
+	}
+}
+
+// Begin counts a request in flight until End
+func (s *Stats) Begin() {
+	s.mu.Lock()
+	s.inFlight++
+	s.maxIn = max(s.maxIn, s.inFlight)
+	s.windowIn = max(s.windowIn, s.inFlight)
+	s.mu.Unlock()
+}
+
+func (s *Stats) End() {
+	s.mu.Lock()
+	s.inFlight--
+	s.mu.Unlock()
+}
+
+// ReadingsAccepted counts a batch the control unit answered 200 to at unix
+// time now
+func (s *Stats) ReadingsAccepted(batch []reading, now int64) {
+	s.mu.Lock()
+	s.accepted += len(batch)
+	s.windowAc += len(batch)
+	for _, r := range batch {
+		s.ages = append(s.ages, now-r.Timestamp)
+	}
+	s.mu.Unlock()
+}
+
+func (s *Stats) JoinRefused() {
+	s.mu.Lock()
+	s.refused++
+	s.mu.Unlock()
+}
+
+func (s *Stats) WindowMissed() {
+	s.mu.Lock()
+	s.missed++
+	s.mu.Unlock()
+}
+
+func (s *Stats) ReadingDropped() {
+	s.mu.Lock()
+	s.dropped++
+	s.mu.Unlock()
+}
+
+func (s *Stats) SetPaired(id string, paired bool) {
+	s.mu.Lock()
+	s.paired[id] = paired
+	s.mu.Unlock()
+}
+
+func (s *Stats) pairedCount() int {
+	count := 0
+	for _, paired := range s.paired {
+		if paired {
+			count++
+		}
+	}
+	return count
+}
+
+// percentile expects sorted latencies
+func percentile(sorted []time.Duration, p float64) time.Duration {
+	if len(sorted) == 0 {
+		return 0
+	}
+	index := int(p / 100 * float64(len(sorted)-1))
+	return sorted[index]
+}
+
+func ms(d time.Duration) float64 {
+	return float64(d.Microseconds()) / 1000
+}
+
+// EndpointSummary is one row in the report, also used for -json
+type EndpointSummary struct {
+	Endpoint  string         `json:"endpoint"`
+	Requests  int            `json:"requests"`
+	OK        int            `json:"ok"`
+	Errors    int            `json:"errors"`
+	ErrorRate float64        `json:"error_rate"`
+	Statuses  map[int]int    `json:"statuses"`
+	ErrorKind map[string]int `json:"error_kinds"`
+	PerSecond float64        `json:"per_second"`
+	P50Ms     float64        `json:"p50_ms"`
+	P90Ms     float64        `json:"p90_ms"`
+	P99Ms     float64        `json:"p99_ms"`
+	P999Ms    float64        `json:"p999_ms"`
+	MaxMs     float64        `json:"max_ms"`
+}
+
+// Summary is the whole report for a window or the full run
+type Summary struct {
+	Seconds          float64           `json:"seconds"`
+	Units            int               `json:"units"`
+	PairedUnits      int               `json:"paired_units"`
+	Endpoints        []EndpointSummary `json:"endpoints"`
+	ReadingsAccepted int               `json:"readings_accepted"`
+	ReadingsPerSec   float64           `json:"readings_per_second"`
+	ReadingsDropped  int               `json:"readings_dropped"`
+	MaxInFlight      int               `json:"max_in_flight"`
+	ReadingAgeP50S   int64             `json:"reading_age_p50_s"`
+	ReadingAgeP99S   int64             `json:"reading_age_p99_s"`
+	ReadingAgeMaxS   int64             `json:"reading_age_max_s"`
+	JoinsRefused     int               `json:"joins_refused"`
+	WindowsMissed    int               `json:"windows_missed"`
+}
+
+func summarize(stats map[string]*endpointStats, seconds float64) []EndpointSummary {
+	var rows []EndpointSummary
+	for _, endpoint := range endpoints {
+		s := stats[endpoint]
+		sorted := append([]time.Duration(nil), s.latencies...)
+		sort.Slice(sorted, func(i, j int) bool { return sorted[i] < sorted[j] })
+		row := EndpointSummary{
+			Endpoint:  endpoint,
+			Requests:  s.requests(),
+			OK:        s.ok(),
+			Errors:    s.errors,
+			Statuses:  map[int]int{},
+			ErrorKind: map[string]int{},
+			P50Ms:     ms(percentile(sorted, 50)),
+			P90Ms:     ms(percentile(sorted, 90)),
+			P99Ms:     ms(percentile(sorted, 99)),
+			P999Ms:    ms(percentile(sorted, 99.9)),
+		}
+		for status, count := range s.statuses {
+			row.Statuses[status] = count
+		}
+		for kind, count := range s.kinds {
+			row.ErrorKind[kind] = count
+		}
+		if len(sorted) > 0 {
+			row.MaxMs = ms(sorted[len(sorted)-1])
+		}
+		if row.Requests > 0 {
+			row.ErrorRate = float64(row.Requests-row.OK) / float64(row.Requests)
+		}
+		if seconds > 0 {
+			row.PerSecond = float64(row.OK) / seconds
+		}
+		rows = append(rows, row)
+	}
+	return rows
+}
+
+// Window returns the summary since the last call and starts a new window
+func (s *Stats) Window(units int) Summary {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	now := time.Now()
+	seconds := now.Sub(s.windowAt).Seconds()
+	summary := Summary{
+		Seconds:          now.Sub(s.start).Seconds(),
+		Units:            units,
+		PairedUnits:      s.pairedCount(),
+		Endpoints:        summarize(s.window, seconds),
+		ReadingsAccepted: s.windowAc,
+		ReadingsPerSec:   float64(s.windowAc) / seconds,
+		MaxInFlight:      s.windowIn,
+	}
+	for _, endpoint := range endpoints {
+		s.window[endpoint] = newEndpointStats()
+	}
+	s.windowAc = 0
+	s.windowIn = s.inFlight
+	s.windowAt = now
+	return summary
+}
+
+// Total returns the summary for the whole run
+func (s *Stats) Total(units int) Summary {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	seconds := time.Since(s.start).Seconds()
+	ages := append([]int64(nil), s.ages...)
+	sort.Slice(ages, func(i, j int) bool { return ages[i] < ages[j] })
+	summary := Summary{
+		Seconds:          seconds,
+		Units:            units,
+		PairedUnits:      s.pairedCount(),
+		Endpoints:        summarize(s.total, seconds),
+		ReadingsAccepted: s.accepted,
+		ReadingsPerSec:   float64(s.accepted) / seconds,
+		ReadingsDropped:  s.dropped,
+		MaxInFlight:      s.maxIn,
+		JoinsRefused:     s.refused,
+		WindowsMissed:    s.missed,
+	}
+	if len(ages) > 0 {
+		summary.ReadingAgeP50S = ages[(len(ages)-1)/2]
+		summary.ReadingAgeP99S = ages[(len(ages)-1)*99/100]
+		summary.ReadingAgeMaxS = ages[len(ages)-1]
+	}
+	return summary
+}
+
+// PrintWindow writes one line per endpoint that had traffic
+func PrintWindow(w io.Writer, summary Summary) {
+	fmt.Fprintf(w, "[%6.0fs] paired %d/%d, readings %.1f/s, max in flight %d\n",
+		summary.Seconds, summary.PairedUnits, summary.Units, summary.ReadingsPerSec,
+		summary.MaxInFlight)
+	for _, row := range summary.Endpoints {
+		if row.Requests == 0 {
+			continue
+		}
+		fmt.Fprintf(w, "  %-9s %6d req %6.1f/s  err %5.1f%%  p50 %7.2f  p99 %7.2f  max %7.2f ms\n",
+			row.Endpoint, row.Requests, row.PerSecond, 100*row.ErrorRate,
+			row.P50Ms, row.P99Ms, row.MaxMs)
+	}
+}
+
+// PrintTotal writes the final report
+func PrintTotal(w io.Writer, summary Summary) {
+	fmt.Fprintf(w, "\nSummary after %.0fs, %d/%d units paired\n\n",
+		summary.Seconds, summary.PairedUnits, summary.Units)
+	fmt.Fprintf(w, "%-9s %8s %8s %8s %7s %8s %8s %8s %8s %8s %8s\n",
+		"endpoint", "requests", "ok", "errors", "err%", "ok/s",
+		"p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "max ms")
+	for _, row := range summary.Endpoints {
+		fmt.Fprintf(w, "%-9s %8d %8d %8d %6.2f%% %8.1f %8.2f %8.2f %8.2f %8.2f %8.2f\n",
+			row.Endpoint, row.Requests, row.OK, row.Errors, 100*row.ErrorRate,
+			row.PerSecond, row.P50Ms, row.P90Ms, row.P99Ms, row.P999Ms, row.MaxMs)
+	}
+	fmt.Fprintln(w)
+	for _, row := range summary.Endpoints {
+		if row.Requests == 0 {
+			continue
+		}
+		codes := make([]int, 0, len(row.Statuses))
+		for status := range row.Statuses {
+			codes = append(codes, status)
+		}
+		sort.Ints(codes)
+		fmt.Fprintf(w, "%-9s status", row.Endpoint)
+		for _, status := range codes {
+			fmt.Fprintf(w, " %d:%d", status, row.Statuses[status])
+		}
+		kinds := make([]string, 0, len(row.ErrorKind))
+		for kind := range row.ErrorKind {
+			kinds = append(kinds, kind)
+		}
+		sort.Strings(kinds)
+		for _, kind := range kinds {
+			fmt.Fprintf(w, " %s:%d", kind, row.ErrorKind[kind])
+		}
+		fmt.Fprintln(w)
+	}
+	fmt.Fprintf(w, "\nReadings accepted %d (%.1f/s), dropped in unit buffers %d\n",
+		summary.ReadingsAccepted, summary.ReadingsPerSec, summary.ReadingsDropped)
+	fmt.Fprintf(w, "Reading age when accepted p50 %d s, p99 %d s, max %d s\n",
+		summary.ReadingAgeP50S, summary.ReadingAgeP99S, summary.ReadingAgeMaxS)
+	fmt.Fprintf(w, "Requests in flight at once, at most %d\n", summary.MaxInFlight)
+	fmt.Fprintf(w, "Access point joins refused %d, upload windows missed %d\n",
+		summary.JoinsRefused, summary.WindowsMissed)
+}
@@ -0,0 +1,417 @@
+package main
+
+import (
+	"bytes"
+	"context"
+	"hash/fnv"
+	"io"
+	"math"
+	"math/rand"
+	"net/http"
+	"time"
+)
+
+// Buffer sizes from sensorunit/lib/reading_pipeline/ReadingBuffer.h
+const (
+	maxBufferSize = 256
+	maxBatchSize  = 10
+)
+
+// Join limits from finder_config in sensorunit/lib/wifi_link/ControlUnitFinder.h:
+// the timeout when connecting and the failed upload window joins in a row
+// before the unit connects again
+const (
+	joinTimeout      = 10 * time.Second
+	maxMissedWindows = 3
+)
+
+// Trigger offsets of the firmware before the phases came from the unit id,
+// used by -phase aligned
+const (
+	dispatchOffsetSec = 1
+	resyncOffsetSec   = 2
+)
+
+// unitPhase mirrors unitPhase() in sensorunit/lib/deadline/PeriodicDeadline.h,
+// the FNV-1a hash of the id modulo the period
+func unitPhase(id string, period int64) int64 {
+	hash := fnv.New32a()
+	hash.Write([]byte(id))
+	return int64(hash.Sum32() % uint32(period))
+}
+
+// AccessPoint models the station limit of the Control Unit access point,
+// ap.max_connection in controlunit/components/net_utils. nil is unlimited
+type AccessPoint struct {
+	stations chan struct{}
+}
+
+func NewAccessPoint(maxStations int) *AccessPoint {
+	if maxStations <= 0 {
+		return nil
+	}
+	return &AccessPoint{stations: make(chan struct{}, maxStations)}
+}
+
+// join takes a station slot, false when the access point is full
+func (ap *AccessPoint) join() bool {
+	if ap == nil {
+		return true
+	}
+	select {
+	case ap.stations <- struct{}{}:
+		return true
+	default:
+		return false
+	}
+}
+
+func (ap *AccessPoint) leave() {
+	if ap != nil {
+		<-ap.stations
+	}
+}
+
+// Unit simulates one Sensor Unit running the same state machine as
+// sensorunit/src/main.cpp: connect until paired, sync time, then take
+// readings and dispatch them on unix time boundaries
+type Unit struct {
+	id     string
+	cfg    *Config
+	client *http.Client
+	ap     *AccessPoint
+	stats  *Stats
+	rng    *rand.Rand
+
+	paired   bool
+	synced   bool
+	baseTime int64     // unix time from the last /time response
+	baseAt   time.Time // local time when baseTime was received
+	phase    int64     // dispatch offset in seconds within the interval
+	resync   int64     // resync offset in seconds within the interval
+	buffer   []reading
+
+	associated    bool            // holds a station slot of the access point
+	slot          connectResponse // upload window, UploadPeriodS 0 without
+	missedWindows int             // failed joins in a row
+	dispatching   bool            // started and not done, one batch is sent per pass
+
+	lastReading  int64
+	lastDispatch int64
+	lastResync   int64
+}
+
+func NewUnit(index int, cfg *Config, client *http.Client, ap *AccessPoint, stats *Stats) *Unit {
+	u := &Unit{
+		id:     UnitID(index),
+		cfg:    cfg,
+		client: client,
+		ap:     ap,
+		stats:  stats,
+		rng:    rand.New(rand.NewSource(cfg.Seed + int64(index))),
+		phase:  dispatchOffsetSec,
+		resync: resyncOffsetSec,
+	}
+	dispatchSec := int64(cfg.DispatchInterval / time.Second)
+	resyncSec := int64(cfg.ResyncInterval / time.Second)
+	switch cfg.Phase {
+	case "unit":
+		u.phase = unitPhase(u.id, dispatchSec)
+		u.resync = unitPhase(u.id, resyncSec)
+	case "random":
+		u.phase = u.rng.Int63n(dispatchSec)
+		u.resync = u.rng.Int63n(resyncSec)
+	}
+	return u
+}
+
+// Run loops until ctx is done. Triggers are on whole seconds and checked every
+// 100 ms, so they fire at most 100 ms later than in the firmware, which sleeps
+// until the next trigger. While a dispatch is running the next batch follows
+// right away, like the firmware loop that sends one batch per pass
+func (u *Unit) Run(ctx context.Context) {
+	ticker := time.NewTicker(100 * time.Millisecond)
+	defer ticker.Stop()
+	var lastConnect, lastSync time.Time
+
+	for {
+		if u.dispatching && u.paired && u.synced {
+			if ctx.Err() != nil {
+				u.disassociate()
+				return
+			}
+		} else {
+			select {
+			case <-ctx.Done():
+				u.disassociate()
+				return
+			case <-ticker.C:
+			}
+		}
+		now := time.Now()
+		switch {
+		case !u.paired:
+			if now.Sub(lastConnect) >= u.cfg.ConnectInterval {
+				lastConnect = now
+				u.connect(ctx)
+			}
+		case !u.synced:
+			if now.Sub(lastSync) >= u.cfg.SyncInterval {
+				lastSync = now
+				u.syncTime(ctx)
+			}
+		default:
+			u.tick(ctx)
+		}
+	}
+}
+
+func (u *Unit) unixNow() int64 {
+	return u.baseTime + int64(time.Since(u.baseAt)/time.Second)
+}
+
+// inUploadWindow mirrors Scheduler::inUploadWindow
+func (u *Unit) inUploadWindow() bool {
+	return u.timeLeftInUploadWindow() > 0
+}
+
+// timeLeftInUploadWindow mirrors Scheduler::msLeftInUploadWindow
+func (u *Unit) timeLeftInUploadWindow() time.Duration {
+	period := u.slot.UploadPeriodS
+	if period == 0 {
+		return math.MaxInt64
+	}
+	sinceBase := time.Since(u.baseAt)
+	now := u.baseTime + int64(sinceBase/time.Second)
+	into := ((now % period) - u.slot.UploadOffsetS%period + period) % period
+	if into >= u.slot.UploadWindowS {
+		return 0
+	}
+	return time.Duration(u.slot.UploadWindowS-into)*time.Second - sinceBase%time.Second
+}
+
+// associate mirrors ConnectionManager::associate, joining takes
+// -associate-time and fails when the access point is full or the join does
+// not finish in timeout
+func (u *Unit) associate(ctx context.Context, timeout time.Duration) bool {
+	if u.associated {
+		return true
+	}
+	if timeout <= 0 {
+		return false
+	}
+	joined := u.join(ctx, timeout)
+	if u.slot.UploadPeriodS == 0 {
+		return joined
+	}
+	if joined {
+		u.missedWindows = 0
+	} else if u.missedWindows++; u.missedWindows >= maxMissedWindows {
+		// Connects again, which may find another Control Unit
+		u.setPaired(false)
+	}
+	return joined
+}
+
+// join takes a station slot for -associate-time, false when the access point
+// is full or the join takes longer than timeout
+func (u *Unit) join(ctx context.Context, timeout time.Duration) bool {
+	if !u.ap.join() {
+		u.stats.JoinRefused()
+		return false
+	}
+	u.associated = true
+	wait, joined := u.cfg.AssociateTime, true
+	if timeout < wait {
+		wait, joined = timeout, false
+	}
+	select {
+	case <-ctx.Done():
+		return false
+	case <-time.After(wait):
+	}
+	if !joined {
+		u.disassociate()
+	}
+	return joined
+}
+
+func (u *Unit) disassociate() {
+	if u.associated {
+		u.ap.leave()
+		u.associated = false
+	}
+}
+
+func (u *Unit) tick(ctx context.Context) {
+	now := u.unixNow()
+	readingSec := int64(u.cfg.ReadingInterval / time.Second)
+	dispatchSec, dispatchPhase := int64(u.cfg.DispatchInterval/time.Second), u.phase
+	resyncSec, resyncPhase := int64(u.cfg.ResyncInterval/time.Second), u.resync
+	if period := u.slot.UploadPeriodS; period > 0 {
+		// Scheduler::setUploadSlot, resync rounded up to whole periods
+		dispatchSec, dispatchPhase = period, u.slot.UploadOffsetS%period
+		resyncSec, resyncPhase = (resyncSec+period-1)/period*period, dispatchPhase
+	}
+
+	if now%readingSec == 0 && now != u.lastReading {
+		u.lastReading = now
+		u.takeReading(now)
+	}
+	dispatchDue := now%dispatchSec == dispatchPhase && now != u.lastDispatch
+	resyncDue := now%resyncSec == resyncPhase && now != u.lastResync
+	if dispatchDue || resyncDue {
+		u.lastDispatch, u.lastResync = now, now
+		if !u.associate(ctx, u.timeLeftInUploadWindow()) {
+			u.stats.WindowMissed()
+			return
+		}
+	}
+	if dispatchDue {
+		if u.cfg.Jitter > 0 {
+			delay := time.Duration(u.rng.Int63n(int64(u.cfg.Jitter)))
+			select {
+			case <-ctx.Done():
+				return
+			case <-time.After(delay):
+			}
+		}
+		u.dispatching = true
+	}
+	if u.dispatching && !u.step(ctx) {
+		u.setPaired(false)
+		return
+	}
+	if resyncDue {
+		u.syncTime(ctx)
+	}
+	if u.dispatching && !u.inUploadWindow() {
+		// ReadingsDispatcher::stop, the rest waits for the next window
+		u.dispatching = false
+	}
+	if !u.dispatching && u.slot.UploadPeriodS > 0 && u.synced {
+		u.disassociate()
+	}
+}
+
+func (u *Unit) setPaired(paired bool) {
+	u.paired = paired
+	if !paired {
+		// The firmware keeps its buffered readings and sends them once paired again
+		u.synced = false
+		u.missedWindows = 0
+		u.disassociate()
+	}
+	u.stats.SetPaired(u.id, paired)
+}
+
+// takeReading mirrors ReadingBuffer, the oldest reading is overwritten when
+// the buffer is full
+func (u *Unit) takeReading(now int64) {
+	if len(u.buffer) == maxBufferSize {
+		u.buffer = u.buffer[1:]
+		u.stats.ReadingDropped()
+	}
+	round := func(v float64) float64 { return math.Round(v*10) / 10 }
+	u.buffer = append(u.buffer, reading{
+		Timestamp:   now,
+		Temperature: round(18 + 6*u.rng.Float64()),
+		Humidity:    round(30 + 30*u.rng.Float64()),
+	})
+}
+
+// step mirrors ReadingsDispatcher::step, sends one batch of the dispatch the
+// trigger started. Returns false when the control unit answered disconnected
+func (u *Unit) step(ctx context.Context) bool {
+	if len(u.buffer) == 0 {
+		u.dispatching = false
+		return true
+	}
+	batch := u.buffer
+	if len(batch) > maxBatchSize {
+		batch = batch[:maxBatchSize]
+	}
+	payload := composeSensorSnapshotGroup(u.id, batch)
+	status, body, err := u.do(ctx, http.MethodPost, "/readings", payload)
+	if err != nil || status != http.StatusOK {
+		u.dispatching = false
+		return true
+	}
+	u.buffer = u.buffer[len(batch):]
+	u.stats.ReadingsAccepted(batch, u.unixNow())
+	if parseStatus(body) == "disconnected" {
+		u.dispatching = false
+		return false
+	}
+	return true
+}
+
+// connect mirrors ConnectionManager::connect and pair() with the one access
+// point there is, the unit stays associated when paired
+func (u *Unit) connect(ctx context.Context) {
+	if !u.associated && !u.join(ctx, joinTimeout) {
+		return
+	}
+	status, body, err := u.do(ctx, http.MethodPost, "/connect", composeConnectRequest(u.id))
+	if err != nil || status != http.StatusOK {
+		u.disassociate()
+		return
+	}
+	response := parseConnectResponse(body)
+	if response.Status != "connected" {
+		u.disassociate()
+		return
+	}
+	u.slot = response
+	u.setPaired(true)
+}
+
+func (u *Unit) syncTime(ctx context.Context) {
+	status, body, err := u.do(ctx, http.MethodGet, "/time", nil)
+	if err != nil || status != http.StatusOK {
+		return
+	}
+	if timestamp := parseTimestamp(body); timestamp != 0 {
+		u.baseTime = timestamp
+		u.baseAt = time.Now()
+		u.synced = true
+	}
+}
+
+// do sends one request and records it. The firmware only reads a small
+// response body, anything larger is drained and ignored
+func (u *Unit) do(ctx context.Context, method, endpoint string, payload []byte) (int, []byte, error) {
+	var body io.Reader
+	if payload != nil {
+		body = bytes.NewReader(payload)
+	}
+	req, err := http.NewRequestWithContext(ctx, method, u.cfg.Target+endpoint, body)
+	if err != nil {
+		return 0, nil, err
+	}
+	if payload != nil {
+		req.Header.Set("Content-Type", "application/json")
+	}
+
+	start := time.Now()
+	u.stats.Begin()
+	defer u.stats.End()
+	resp, err := u.client.Do(req)
+	if err != nil {
+		if ctx.Err() == nil {
+			u.stats.Record(endpoint, 0, 0, err)
+		}
+		return 0, nil, err
+	}
+	response, err := io.ReadAll(resp.Body)
+	resp.Body.Close()
+	latency := time.Since(start)
+	if err != nil {
+		if ctx.Err() == nil {
+			u.stats.Record(endpoint, 0, 0, err)
+		}
+		return 0, nil, err
+	}
+	u.stats.Record(endpoint, latency, resp.StatusCode, nil)
+	return resp.StatusCode, response, nil
+}
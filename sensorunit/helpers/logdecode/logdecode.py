@@ -0,0 +1,297 @@
+#!/usr/bin/env python3
+"""Decoder for the Sensor Unit binary log (LOG_BINARY in config.h).
+
+The firmware sends a hash of the tag and of the format string instead of the
+text. This script finds every LOG_ERROR/WARN/INFO/DEBUG call in the sources,
+hashes tags and formats the same way as logHash() in lib/logging/BinaryLog.h
+and turns the records back into the usual "I (1234) TAG: message" lines.
+Bytes outside records, e.g. a crash report, are passed through as they are.
+
+  logdecode.py table -o logformats.json       write the table for a build
+  logdecode.py decode --port /dev/ttyACM0     decode from the board
+  logdecode.py decode capture.bin             decode a captured stream
+
+Author: Erik Dahl (erik@iunderlandet.se)
+License: MIT
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+SENSORUNIT_DIR = os.path.normpath(
+    os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", ".."))
+SOURCE_DIRS = ("src", "lib", "include")
+SOURCE_EXTENSIONS = (".cpp", ".h", ".hpp", ".ino")
+
+SYNC = b"\xa5\x5a"
+HEADER = struct.Struct("<BIII")  # level, millis, tag hash, format hash
+DROPPED_ID = 0
+LEVELS = {1: "E", 2: "W", 3: "I", 4: "D"}
+COLORS = {1: "\033[31m", 2: "\033[33m", 3: "\033[32m", 4: "\033[36m"}
+
+STRING = r'"(?:[^"\\\n]|\\.)*"'
+LOG_CALL = re.compile(
+    r"\bLOG_(?:ERROR|WARN|INFO|DEBUG)\s*\(\s*([^,()]+?)\s*,\s*((?:" + STRING +
+    r"\s*)+)")
+TAG_DEFINITION = re.compile(r"\bTAG\s*=\s*(" + STRING + r")")
+STRING_PART = re.compile(STRING)
+C_SPEC = re.compile(
+    r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGcsp%])")
+ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "0": "\0", "\\": "\\", '"': '"',
+           "'": "'"}
+
+
+def fnv1a(data):
+    """Same hash as logHash() in BinaryLog.h."""
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def unescape(literal):
+    """Text of one C string literal, quotes included in literal."""
+    body = literal[1:-1]
+    return re.sub(r"\\(x[0-9a-fA-F]{2}|.)",
+                  lambda m: chr(int(m.group(1)[1:], 16))
+                  if m.group(1).startswith("x")
+                  else ESCAPES.get(m.group(1), m.group(1)), body)
+
+
+def join_literals(text):
+    """Adjacent literals are one string, like in C."""
+    return "".join(unescape(part) for part in STRING_PART.findall(text))
+
+
+def build_table(root):
+    formats, tags = {}, {}
+    for directory in SOURCE_DIRS:
+        for folder, _, files in os.walk(os.path.join(root, directory)):
+            for name in files:
+                if not name.endswith(SOURCE_EXTENSIONS):
+                    continue
+                with open(os.path.join(folder, name), encoding="utf-8",
+                          errors="replace") as source:
+                    text = source.read()
+                for match in TAG_DEFINITION.finditer(text):
+                    tag = unescape(match.group(1))
+                    tags[fnv1a(tag.encode())] = tag
+                for match in LOG_CALL.finditer(text):
+                    tag = match.group(1)
+                    if tag.startswith('"'):
+                        tag = unescape(tag)
+                        tags[fnv1a(tag.encode())] = tag
+                    fmt = join_literals(match.group(2))
+                    key = fnv1a(fmt.encode())
+                    if key in formats and formats[key] != fmt:
+                        print("Hash collision: %r and %r" % (formats[key], fmt),
+                              file=sys.stderr)
+                    formats[key] = fmt
+    return {"formats": {str(k): v for k, v in sorted(formats.items())},
+            "tags": {str(k): v for k, v in sorted(tags.items())}}
+
+
+def load_table(args):
+    if args.table:
+        with open(args.table, encoding="utf-8") as source:
+            table = json.load(source)
+    else:
+        table = build_table(args.src)
+    return ({int(k): v for k, v in table["formats"].items()},
+            {int(k): v for k, v in table["tags"].items()})
+
+
+def parse_args_bytes(data):
+    """Arguments of one record as Python values."""
+    values, at = [], 0
+    while at < len(data):
+        kind = chr(data[at])
+        at += 1
+        if kind in "iu":
+            values.append(struct.unpack_from("<i" if kind == "i" else "<I",
+                                             data, at)[0])
+            at += 4
+        elif kind in "IU":
+            values.append(struct.unpack_from("<q" if kind == "I" else "<Q",
+                                             data, at)[0])
+            at += 8
+        elif kind == "d":
+            values.append(struct.unpack_from("<d", data, at)[0])
+            at += 8
+        elif kind == "s":
+            length = data[at]
+            values.append(data[at + 1:at + 1 + length].decode("utf-8",
+                                                                "replace"))
+            at += 1 + length
+        else:
+            raise ValueError("unknown argument type %r" % kind)
+    return values
+
+
+def format_c(fmt, values):
+    """printf for the conversions the firmware uses."""
+    values = list(values)
+
+    def convert(match):
+        flags, width, precision, _, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        if not values:
+            return "<missing>"
+        if width == "*":
+            width = str(values.pop(0))
+        if precision == "*":
+            precision = str(values.pop(0))
+        value = values.pop(0)
+        spec = "%" + flags + (width or "") + (
+            "." + precision if precision is not None else "")
+        if conversion == "p":
+            return (spec + "s") % ("0x%x" % (value & 0xFFFFFFFF))
+        if conversion == "c":
+            return (spec + "s") % chr(value & 0xFF)
+        if conversion == "s":
+            return (spec + "s") % value
+        if conversion in "uxXo" and isinstance(value, int) and value < 0:
+            value &= 0xFFFFFFFF
+        if conversion in "diu":
+            return (spec + "d") % int(value)
+        if conversion == "F":
+            conversion = "f"
+        return (spec + conversion) % value
+
+    return C_SPEC.sub(convert, fmt)
+
+
+def render(record, formats, tags, colors):
+    level, millis, tag_id, format_id = HEADER.unpack_from(record)
+    values = parse_args_bytes(record[HEADER.size:])
+    if format_id == DROPPED_ID:
+        tag, message = "logging", "%d records dropped" % values[0]
+    else:
+        tag = tags.get(tag_id, "tag-%08x" % tag_id)
+        fmt = formats.get(format_id)
+        try:
+            message = format_c(fmt, values) if fmt is not None else None
+        except (TypeError, ValueError):
+            message = None
+        if message is None:
+            # Sources do not match the firmware
+            message = "unknown format %08x %r" % (format_id, values)
+    line = "%s (%d) %s: %s" % (LEVELS.get(level, "?"), millis, tag, message)
+    if colors:
+        line = COLORS.get(level, "") + line + "\033[0m"
+    return line
+
+
+class Decoder:
+    """Splits a byte stream into records and pass-through text."""
+
+    def __init__(self, formats, tags, out, colors=False):
+        self.formats, self.tags, self.out = formats, tags, out
+        self.colors = colors
+        self.pending = b""
+
+    def feed(self, data):
+        self.pending += data
+        while True:
+            start = self.pending.find(SYNC)
+            if start < 0:
+                # Keep a trailing first sync byte, the rest is text
+                keep = 1 if self.pending.endswith(SYNC[:1]) else 0
+                self.text(self.pending[:len(self.pending) - keep])
+                self.pending = self.pending[len(self.pending) - keep:]
+                return
+            self.text(self.pending[:start])
+            self.pending = self.pending[start:]
+            if len(self.pending) < 3:
+                return
+            length = self.pending[2]
+            if len(self.pending) < 3 + length:
+                return
+            record = self.pending[3:3 + length]
+            try:
+                line = render(record, self.formats, self.tags, self.colors)
+            except (ValueError, struct.error, IndexError):
+                # Not a record after all, e.g. sync bytes inside text
+                self.text(self.pending[:1])
+                self.pending = self.pending[1:]
+                continue
+            self.pending = self.pending[3 + length:]
+            self.out.write(line + "\n")
+            self.out.flush()
+
+    def text(self, data):
+        if data:
+            self.out.write(data.decode("utf-8", "replace"))
+            self.out.flush()
+
+
+def open_input(args):
+    if args.port:
+        try:
+            import serial  # pyserial, shipped with PlatformIO
+        except ImportError:
+            sys.exit("--port needs pyserial: pip install pyserial")
+        port = serial.Serial(args.port, args.baud, timeout=0.1)
+        return lambda: port.read(256)
+    if args.input and args.input != "-":
+        source = open(args.input, "rb")
+    else:
+        source = sys.stdin.buffer
+    return lambda: source.read1(256) if hasattr(source, "read1") \
+        else source.read(256)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--src", default=SENSORUNIT_DIR,
+                        help="sensorunit folder to take the formats from")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    table = commands.add_parser("table", help="write the format table")
+    table.add_argument("-o", "--output", default="-",
+                       help="JSON file, - for stdout")
+
+    decode = commands.add_parser("decode", help="decode a log stream")
+    decode.add_argument("input", nargs="?",
+                        help="captured stream, stdin if left out")
+    decode.add_argument("--table",
+                        help="table from 'table', else read from --src")
+    decode.add_argument("--port", help="serial port of the board")
+    decode.add_argument("--baud", type=int, default=115200)
+    decode.add_argument("--colors", action="store_true",
+                        help="ANSI colors like LOG_COLORS")
+
+    args = parser.parse_args()
+    if args.command == "table":
+        text = json.dumps(build_table(args.src), indent=2,
+                          ensure_ascii=False) + "\n"
+        if args.output == "-":
+            sys.stdout.write(text)
+        else:
+            with open(args.output, "w", encoding="utf-8") as out:
+                out.write(text)
+        return
+
+    formats, tags = load_table(args)
+    decoder = Decoder(formats, tags, sys.stdout, args.colors)
+    read = open_input(args)
+    try:
+        while True:
+            data = read()
+            if not data:
+                if args.port:
+                    continue
+                break
+            decoder.feed(data)
+    except KeyboardInterrupt:
+        pass
+    decoder.text(decoder.pending)
+
+
+if __name__ == "__main__":
+    main()
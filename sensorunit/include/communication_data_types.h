@@ -1,11 +1,25 @@
 #pragma once
 #include <etl/string.h>
+#include <stdint.h>
 
 struct ControlUnitInfo {
     etl::string<32> ssid;
     uint8_t controlUnitId;
 };
 
+/**
+ * @brief Upload window assigned by the Control Unit, in its Unix seconds
+ *
+ * The unit associates at the start of the window, uploads and leaves the
+ * access point again. periodSec 0 means no window, the unit stays associated.
+ */
+struct UploadSlot {
+    uint32_t periodSec; /**< Time between two windows */
+    uint32_t offsetSec; /**< Start of the window, Unix time % periodSec */
+    uint32_t windowSec; /**< Length of the window */
+};
+
 struct ConnectResponse {
-    bool connected;
+    bool       connected;
+    UploadSlot uploadSlot;
 };
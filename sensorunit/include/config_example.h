@@ -35,6 +35,26 @@
  */
 #define LOG_COLORS  
 
+/**
+ * @def LOG_BINARY
+ * @brief Stores log messages as binary records instead of printing them.
+ *
+ * A LOG call then takes microseconds instead of the milliseconds a line takes
+ * at 115200 baud. Records are sent from loop() by logFlush() when Serial has
+ * room, and turned back into text on the computer with
+ * `make logs` (helpers/logdecode/logdecode.py). Leave undefined for text.
+ */
+// #define LOG_BINARY
+
+/**
+ * @def LOG_BUFFER_BYTES
+ * @brief RAM for binary records waiting to be sent, default 512.
+ *
+ * A record is 16 bytes plus 5 to 9 per argument and up to 34 per string.
+ * Records that do not fit are dropped and counted.
+ */
+// #define LOG_BUFFER_BYTES 512
+
 /**
  * @brief Unique identifier for this sensor unit.
  * Used to distinguish devices when sending data to a server or logging.
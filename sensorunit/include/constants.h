@@ -7,5 +7,4 @@ namespace json_config{
     constexpr size_t max_json_doc_size = max_json_size * 2;
     constexpr size_t max_small_json_size = 128;
     constexpr size_t max_small_json_doc_size = max_small_json_size * 2;
-    constexpr size_t max_header_line_size = 128;
 }
\ No newline at end of file
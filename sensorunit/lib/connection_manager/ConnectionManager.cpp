@@ -13,14 +13,21 @@
 #include "ConnectionManager.h"
 #include "JsonParser.h"
 #include "WiFiS3.h"
-#include "etl/algorithm.h"
 #include "logging.h"
 
+#ifdef SU_TEST_NETWORK
+static constexpr const char* control_unit_prefix = SU_TEST_NETWORK;
+#else
+static constexpr const char* control_unit_prefix = "CU-";
+#endif
+
 ConnectionManager::ConnectionManager(const char* controlUnitPassword,
                                      RestClient& restClient,
                                      const char* sensorUnitId)
-    : m_controlUnitPassword(controlUnitPassword), m_restClient(restClient),
-      m_sensorUnitId(sensorUnitId), m_isPaired(false) {}
+    : m_restClient(restClient), m_sensorUnitId(sensorUnitId), m_isPaired(false),
+      m_radio(controlUnitPassword), m_finder(m_radio, control_unit_prefix) {
+    m_restClient.setLinkQuality(&m_link);
+}
 
 void ConnectionManager::init() {
     LOG_INFO(TAG, "Initializing...");
@@ -35,32 +42,30 @@ void ConnectionManager::init() {
 
     WiFi.disconnect();
 
-    // Restore internal status variables
-    m_isPaired = false;
+    // Restore internal status variables, the finder keeps what it knows
+    m_isPaired     = false;
+    m_isAssociated = false;
+    m_uploadSlot   = {};
 
     LOG_INFO(TAG, "ConnectionManager initialized");
 }
 
 void ConnectionManager::connect() {
     LOG_INFO(TAG, "Running connect()");
-    unsigned long       now          = millis();
-    const unsigned long scanInterval = 30'000;
-
-    if (m_candidateSsids.empty() || now - m_latestScan >= scanInterval) {
-        #ifdef SU_TEST_NETWORK
-        scanForUnits(SU_TEST_NETWORK);
-        #else
-        scanForUnits();
-        #endif
+    if (m_isPaired) {
+        return;
     }
-
-    if (!m_isPaired) {
-        tryToConnectControlUnit();
+    unsigned long start = millis();
+    if (m_finder.connect(*this, start)) {
+        LOG_INFO(TAG, "Paired in %lu ms", millis() - start);
+    } else {
+        LOG_WARN(TAG, "Failed to connect to any Control Unit");
     }
 }
 
 void ConnectionManager::disconnect() {
     LOG_INFO(TAG, "Disconnecting unit..");
+    m_restClient.close();
     init();
 }
 
@@ -68,6 +73,76 @@ bool ConnectionManager::isPairedWithControlUnit() const {
     return m_isPaired;
 }
 
+const UploadSlot& ConnectionManager::uploadSlot() const {
+    return m_uploadSlot;
+}
+
+bool ConnectionManager::associate(uint32_t timeoutMs) {
+    if (!m_isPaired || m_uploadSlot.periodSec == 0 || m_isAssociated) {
+        return m_isPaired;
+    }
+    if (timeoutMs == 0) {
+        return false;
+    }
+    LOG_INFO(TAG,
+             "Joining %s for the upload window, %lu ms left",
+             m_finder.last().ssid.c_str(),
+             static_cast<unsigned long>(timeoutMs));
+    m_isAssociated = m_finder.rejoin(timeoutMs);
+    if (!m_isAssociated && m_finder.missedRejoins() >= finder_config::max_missed_rejoins) {
+        // Off, out of range or full, connect() tries it first and then scans
+        LOG_WARN(TAG,
+                 "%s not joined in %lu windows, connecting again",
+                 m_finder.last().ssid.c_str(),
+                 static_cast<unsigned long>(m_finder.missedRejoins()));
+        disconnect();
+    }
+    return m_isAssociated;
+}
+
+void ConnectionManager::disassociate() {
+    if (m_uploadSlot.periodSec == 0 || !m_isAssociated) {
+        return;
+    }
+    LOG_INFO(TAG, "Leaving %s until the next upload window", m_finder.last().ssid.c_str());
+    m_restClient.close();
+    m_radio.leave();
+    m_isAssociated = false;
+}
+
+bool ConnectionManager::roam() {
+    if (!m_isPaired || !m_isAssociated) {
+        return false;
+    }
+    unsigned long now = millis();
+    if (now - m_rssiSampledAtMs >= rssi_interval_ms) {
+        m_rssiSampledAtMs = now;
+        m_link.addRssi(m_radio.rssi());
+    }
+    if (!m_link.isPoor()) {
+        return false;
+    }
+
+    etl::string<32> from = m_finder.last().ssid;
+    int32_t         rssi = m_link.rssi();
+    switch (m_finder.roam(*this, m_link, now)) {
+    case RoamResult::Roamed:
+        LOG_INFO(TAG,
+                 "Roamed from %s at %ld dBm to %s",
+                 from.c_str(),
+                 static_cast<long>(rssi),
+                 m_finder.last().ssid.c_str());
+        return true;
+    case RoamResult::Lost:
+        LOG_WARN(TAG, "Lost %s while roaming", from.c_str());
+        m_isPaired     = false;
+        m_isAssociated = false;
+        return false;
+    default:
+        return false;
+    }
+}
+
 void ConnectionManager::checkFirmwareVersion() {
     const char* fv = WiFi.firmwareVersion();
 
@@ -91,101 +166,38 @@ void ConnectionManager::checkFirmwareVersion() {
     }
 }
 
-bool ConnectionManager::connectToWiFi(const char* ssid) {
-    LOG_INFO(TAG, "Connecting to WiFi...");
-    WiFi.disconnect();
-    WiFi.begin(ssid, m_controlUnitPassword);
-
-    unsigned long startAttemptTime = millis();
-    int           status           = WiFi.status();
-    while (status != WL_CONNECTED && millis() - startAttemptTime < m_timeoutMs) {
-        delay(500);
-        status = WiFi.status();
-    }
-
-    bool connected = (status == WL_CONNECTED);
-    if (connected) {
-        IPAddress localIp = WiFi.localIP();
-        LOG_INFO(TAG,
-                 "WiFi connected with IP: %d.%d.%d.%d",
-                 localIp[0],
-                 localIp[1],
-                 localIp[2],
-                 localIp[3]);
-    } else {
-        LOG_WARN(TAG, "WiFi connection failed with status: %d", WiFi.status());
-    }
-    return connected;
-}
-
-void ConnectionManager::scanForUnits(const char* prefix) {
-    LOG_INFO(TAG, "Scanning for Units...");
-    m_latestScan = millis();
-    m_candidateSsids.clear();
+bool ConnectionManager::pair(const AccessPoint& accessPoint) {
+    // All Control Units have the same IP, never reuse a connection to another one
+    m_restClient.close();
 
-    int numNetworks = WiFi.scanNetworks();
-    LOG_INFO(TAG, "%d networks found", numNetworks);
-    if (numNetworks <= 0) {
-        LOG_WARN(TAG, "No networks found");
-        return;
-    }
-    for (int i = 0; i < numNetworks; ++i) {
-        etl::string<32> ssid = WiFi.SSID(i);
-        int             rssi = WiFi.RSSI(i);
-        if (ssid.starts_with(prefix)) {
-            LOG_INFO(TAG, "Found candidate Control Unit: %s (RSSI: %d)", ssid.c_str(), rssi);
-            if (m_candidateSsids.full()) {
-                LOG_WARN(TAG, "Too many SSID");
-            } else {
-                m_candidateSsids.push_back({ssid, rssi});
-            }
-        }
-    }
-    etl::shell_sort(m_candidateSsids.begin(),
-                    m_candidateSsids.end(),
-                    [](const connection_types::cu_candidate& a,
-                       const connection_types::cu_candidate& b) { return a.rssi > b.rssi; });
-}
-
-void ConnectionManager::tryToConnectControlUnit() {
-    if (m_candidateSsids.empty()) {
-        LOG_WARN(TAG, "No Candidate Control Units available for connection");
-        return;
-    }
     // Could probably be defined as constexpr in constants unless we need to add dynamic element
     etl::string<json_config::max_small_json_size> payload =
         JsonParser::composeConnectRequest(m_sensorUnitId);
+    LOG_DEBUG(TAG, "/connect payload: %s", payload.c_str());
+    RestResponse restResponse = m_restClient.postTo("/connect", payload);
 
-    for (const auto& candidate : m_candidateSsids) {
-        LOG_INFO(TAG, "Trying to connect to candidate: %s", candidate.ssid.c_str());
-
-        if (!connectToWiFi(candidate.ssid.c_str())) {
-            LOG_WARN(TAG, "Failed to connect to SSID: %s", candidate.ssid.c_str());
-            continue;
-        }
-        LOG_DEBUG(TAG, "/connect payload: %s", payload.c_str());
-        RestResponse restResponse = m_restClient.postTo("/connect", payload);
-
-        if (restResponse.status != 200) {
-            LOG_WARN(TAG, "REST /connect failed with status: %d", restResponse.status);
-            WiFi.disconnect();
-            continue;
-        }
-
-        ConnectResponse response = JsonParser::parseConnectResponse(restResponse.payload);
-
-        if (response.connected) {
-            LOG_INFO(TAG, "Successfully paired with Control Unit %s. ", candidate.ssid.c_str());
-            m_isPaired = true;
-            break;
-        } else {
-            LOG_INFO(TAG, "Response from Control Unit %s: Not connected", candidate.ssid.c_str());
-            WiFi.disconnect();
-        }
+    if (restResponse.status != 200) {
+        LOG_WARN(TAG, "REST /connect failed with status: %d", restResponse.status);
+        return false;
     }
 
-    if (!m_isPaired) {
-        LOG_WARN(TAG, "Failed to connect to any Control Unit");
+    ConnectResponse response = JsonParser::parseConnectResponse(restResponse.payload);
+    if (!response.connected) {
+        LOG_INFO(TAG, "Response from Control Unit %s: Not connected", accessPoint.ssid.c_str());
+        return false;
     }
-    return;
-}
\ No newline at end of file
+
+    LOG_INFO(TAG, "Successfully paired with Control Unit %s. ", accessPoint.ssid.c_str());
+    m_isPaired     = true;
+    m_isAssociated = true;
+    m_link.reset();
+    m_uploadSlot   = response.uploadSlot;
+    if (m_uploadSlot.periodSec > 0) {
+        LOG_INFO(TAG,
+                 "Upload window %lu s at %lu s of every %lu s",
+                 m_uploadSlot.windowSec,
+                 m_uploadSlot.offsetSec,
+                 m_uploadSlot.periodSec);
+    }
+    return true;
+}
@@ -7,6 +7,20 @@
  * connects to WiFi and tries to connect with
  * a rest client POST to /connect
  *
+ * ControlUnitFinder picks the access points, the last Control Unit first
+ * and a scan only when the known ones fail. It survives disconnect(), so a
+ * unit that was dropped reconnects without scanning.
+ *
+ * The rest client adds every request to the link quality, and roam() samples
+ * the signal. On a poor link roam() moves to a clearly stronger Control Unit,
+ * see ControlUnitFinder::roam() for the hysteresis.
+ *
+ * A Control Unit with upload windows answers /connect with the window of
+ * this unit. The unit then only holds one of the few AP connections while
+ * it uploads: associate() at the start of the window, disassociate() when
+ * done. The unit stays paired in between. After a few windows in a row
+ * without a join it connects again, which may find another Control Unit.
+ *
  * @date 2025-10-26
  *
  * @copyright Copyright (c) 2025 Erik Dahl
@@ -14,12 +28,13 @@
  *
  */
 #pragma once
+#include "ControlUnitFinder.h"
 #include "RestClient.h"
+#include "WiFiS3Radio.h"
 #include "communication_data_types.h"
 #include "config.h"
 #include <Arduino.h>
 #include <etl/string.h>
-#include <etl/vector.h>
 
 namespace connection_types {
 /**
@@ -32,15 +47,6 @@ struct fw_version {
     int patch;
 };
 
-/**
- * @brief Control Unit Candidates
- * holding SSID (name) and RSSI (signal strength)
- */
-struct cu_candidate {
-    etl::string<32> ssid;
-    int             rssi;
-};
-
 }; // namespace connection_types
 
 /**
@@ -49,7 +55,7 @@ struct cu_candidate {
  * a rest client POST to /connect
  *
  */
-class ConnectionManager {
+class ConnectionManager : private IPairing {
   public:
     /**
      * @brief Construct a Connection Manager object
@@ -68,8 +74,8 @@ class ConnectionManager {
      */
     void init();
     /**
-     * @brief Unified function for scanning for available control units
-     * and connecting to them
+     * @brief Pairs with a Control Unit, the last one first
+     * Scans for available control units only when the known ones fail
      *
      */
     void connect();
@@ -84,19 +90,45 @@ class ConnectionManager {
      * @return true when Sensor Unit is paired with a Control Unit
      */
     bool isPairedWithControlUnit() const;
+    /**
+     * @brief Upload window from the last /connect, periodSec 0 if none
+     */
+    const UploadSlot& uploadSlot() const;
+    /**
+     * @brief Joins the paired Control Unit again for an upload window
+     * Without an upload window the unit never leaves, so nothing is done.
+     * After finder_config::max_missed_rejoins failed joins in a row the unit
+     * disconnects, so the scheduler triggers connect() again
+     *
+     * @param timeoutMs Time left in the window, the join gives up after it
+     * @return true when associated and the Control Unit can be reached
+     */
+    bool associate(uint32_t timeoutMs);
+    /**
+     * @brief Leaves the access point to free the connection for other units
+     * Only with an upload window, the unit stays paired
+     */
+    void disassociate();
+    /**
+     * @brief Moves to a better Control Unit if the link is poor
+     * Call between dispatches, the buffered readings stay in the unit
+     *
+     * @return true when paired with another Control Unit, with a new upload window
+     */
+    bool roam();
 
   private:
-    static void   checkFirmwareVersion();
-    bool          connectToWiFi(const char* ssid);
-    void          scanForUnits(const char* prefix = "CU-");
-    void          tryToConnectControlUnit();
-    const char*   m_controlUnitPassword; /**< Control Unit Password */
-    RestClient&   m_restClient;          /**< Reference to Rest Client */
-    const char*   m_sensorUnitId;        /**< Sensor Unit UUID */
-    bool          m_isPaired;            /**< true if Sensor Unit is paired*/
-    unsigned long m_latestScan{0};       /**< Latest scan. Used by connect to rescan for units */
-    unsigned long m_timeoutMs{10000};    /**< Timeout in Ms for WiFi connection */
-    etl::vector<connection_types::cu_candidate, 8>
-                                 m_candidateSsids; /**< Vector with SSID candidates. Max nr is 8 */
-    static constexpr const char* TAG = "ConnectionManager";
+    static void       checkFirmwareVersion();
+    bool              pair(const AccessPoint& accessPoint) override;
+    RestClient&       m_restClient;          /**< Reference to Rest Client */
+    const char*       m_sensorUnitId;        /**< Sensor Unit UUID */
+    bool              m_isPaired;            /**< true if Sensor Unit is paired*/
+    bool              m_isAssociated{false}; /**< true while joined to the Control Unit AP */
+    WiFiS3Radio       m_radio;               /**< Scans and joins */
+    ControlUnitFinder m_finder;              /**< Last Control Unit and scan results */
+    LinkQuality       m_link;                /**< Quality of the link to the paired unit */
+    unsigned long     m_rssiSampledAtMs{0};  /**< Latest signal sample for m_link */
+    UploadSlot        m_uploadSlot{};        /**< Upload window from /connect */
+    static constexpr unsigned long rssi_interval_ms = 10'000;
+    static constexpr const char*   TAG              = "ConnectionManager";
 };
\ No newline at end of file
@@ -0,0 +1,73 @@
+/**
+ * @file WiFiS3Radio.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of IWiFiRadio on WiFiS3
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "WiFiS3Radio.h"
+#include "WiFiS3.h"
+#include "logging.h"
+
+WiFiS3Radio::WiFiS3Radio(const char* password) : m_password{password} {}
+
+int WiFiS3Radio::scanNetworks() {
+    LOG_INFO(TAG, "Scanning for Units...");
+    unsigned long start = millis();
+    int           count = WiFi.scanNetworks();
+    LOG_INFO(TAG, "%d networks found in %lu ms", count, millis() - start);
+    return count;
+}
+
+void WiFiS3Radio::network(int index, AccessPoint& accessPoint) {
+    accessPoint.ssid    = WiFi.SSID(index);
+    accessPoint.channel = WiFi.channel(index);
+    accessPoint.rssi    = WiFi.RSSI(index);
+    WiFi.BSSID(index, accessPoint.bssid);
+    LOG_DEBUG(TAG,
+              "%s channel %d RSSI %d",
+              accessPoint.ssid.c_str(),
+              accessPoint.channel,
+              accessPoint.rssi);
+}
+
+bool WiFiS3Radio::join(const AccessPoint& accessPoint, uint32_t timeoutMs) {
+    LOG_INFO(TAG, "Joining %s on channel %d...", accessPoint.ssid.c_str(), accessPoint.channel);
+    WiFi.disconnect();
+    unsigned long start = millis();
+    WiFi.begin(accessPoint.ssid.c_str(), m_password);
+
+    int status = WiFi.status();
+    while (status != WL_CONNECTED && millis() - start < timeoutMs) {
+        delay(poll_ms);
+        status = WiFi.status();
+    }
+
+    if (status != WL_CONNECTED) {
+        LOG_WARN(TAG, "WiFi connection failed with status: %d", status);
+        // The module would go on trying and take an AP connection late
+        WiFi.disconnect();
+        return false;
+    }
+    IPAddress localIp = WiFi.localIP();
+    LOG_INFO(TAG,
+             "WiFi connected in %lu ms with IP: %d.%d.%d.%d",
+             millis() - start,
+             localIp[0],
+             localIp[1],
+             localIp[2],
+             localIp[3]);
+    return true;
+}
+
+void WiFiS3Radio::leave() {
+    WiFi.disconnect();
+}
+
+int32_t WiFiS3Radio::rssi() {
+    return WiFi.RSSI();
+}
@@ -0,0 +1,38 @@
+/**
+ * @file WiFiS3Radio.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief IWiFiRadio on the WiFiS3 library of the UNO R4 WiFi
+ *
+ * WiFi.begin() only takes an SSID, so a join cannot be directed to the bssid
+ * and channel of the access point. The module searches for it itself, which
+ * is still far shorter than a scan of all channels.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "IWiFiRadio.h"
+
+class WiFiS3Radio : public IWiFiRadio {
+  public:
+    /**
+     * @brief Constructs the radio
+     *
+     * @param password Password of the Control Unit access points
+     */
+    explicit WiFiS3Radio(const char* password);
+
+    int     scanNetworks() override;
+    void    network(int index, AccessPoint& accessPoint) override;
+    bool    join(const AccessPoint& accessPoint, uint32_t timeoutMs) override;
+    void    leave() override;
+    int32_t rssi() override;
+
+  private:
+    const char*                  m_password;
+    static constexpr uint32_t    poll_ms = 50; /**< WiFi.status() interval while joining */
+    static constexpr const char* TAG     = "WiFiS3Radio";
+};
@@ -0,0 +1,64 @@
+/**
+ * @file PeriodicDeadline.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the periodic deadline
+ *
+ * Times are compared as the signed difference of the unsigned values, which
+ * is right across the wrap of the clock as long as they are less than half
+ * the range apart.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "PeriodicDeadline.h"
+
+PeriodicDeadline::PeriodicDeadline(uint32_t period, uint32_t phase)
+    : m_period{period > 0 ? period : 1}, m_phase{phase % m_period} {}
+
+bool PeriodicDeadline::due(uint32_t now) {
+    if (!m_started || static_cast<int32_t>(m_next - now) > static_cast<int32_t>(m_period)) {
+        m_next    = firstSlotFrom(now);
+        m_started = true;
+    }
+    int32_t behind = static_cast<int32_t>(now - m_next);
+    if (behind < 0) {
+        return false;
+    }
+    uint32_t passed = static_cast<uint32_t>(behind) / m_period;
+    if (passed > 0) {
+        m_skipped += passed;
+    } else if (behind > 0) {
+        ++m_late;
+    }
+    m_next += (passed + 1) * m_period;
+    return true;
+}
+
+uint32_t PeriodicDeadline::untilNext(uint32_t now) const {
+    uint32_t next = m_started ? m_next : firstSlotFrom(now);
+    int32_t  left = static_cast<int32_t>(next - now);
+    if (left <= 0) {
+        return 0;
+    }
+    return left > static_cast<int32_t>(m_period) ? firstSlotFrom(now) - now
+                                                 : static_cast<uint32_t>(left);
+}
+
+void PeriodicDeadline::restart() {
+    m_started = false;
+}
+
+uint32_t PeriodicDeadline::firstSlotFrom(uint32_t now) const {
+    return now + (m_phase + m_period - now % m_period) % m_period;
+}
+
+uint32_t unitPhase(const char* unitId, uint32_t period) {
+    uint32_t hash = 2166136261u;
+    while (*unitId != '\0') {
+        hash = (hash ^ static_cast<uint8_t>(*unitId++)) * 16777619u;
+    }
+    return period > 0 ? hash % period : 0;
+}
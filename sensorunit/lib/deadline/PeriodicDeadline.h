@@ -0,0 +1,97 @@
+/**
+ * @file PeriodicDeadline.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Deadline of a periodic event that is not lost when the caller is late
+ *
+ * The slots of the event are the times where time % period == phase. due()
+ * compares the time with the next deadline instead of matching the slot
+ * exactly, so a slot that passes while loop() is busy is still due at the
+ * next call, late. If the caller was busy for more than a period, the slots
+ * in between are counted in skipped() and only one is due.
+ *
+ * Works with any unsigned 32 bit clock, e.g. Unix seconds or millis(), and
+ * handles the wrap of the clock. A clock that is set back by more than a
+ * period starts over from the new time.
+ *
+ * Units that share a clock and a period would all be due in the same slot.
+ * unitPhase() gives every unit its own phase, derived from its id.
+ *
+ * Has no Arduino dependencies and is tested in the native environment.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <stdint.h>
+
+class PeriodicDeadline {
+  public:
+    /**
+     * @brief Constructs a deadline, the first slot is the first at or after the first call
+     *
+     * @param period Time between slots, in the unit of the clock
+     * @param phase Offset of the slots in the period
+     */
+    explicit PeriodicDeadline(uint32_t period, uint32_t phase = 0);
+
+    /**
+     * @brief Checks if a slot is due and moves on to the next slot if it is
+     *
+     * @param now Current time
+     * @return true once for every slot that is due, late or not
+     */
+    bool due(uint32_t now);
+
+    /**
+     * @brief Time left until the next slot
+     *
+     * @param now Current time
+     * @return uint32_t 0 if a slot is due
+     */
+    uint32_t untilNext(uint32_t now) const;
+
+    /**
+     * @brief Starts over at the first slot after the next call, used when the clock changes
+     */
+    void restart();
+
+    /**
+     * @brief Slots that passed without being due, the caller was busy for over a period
+     */
+    uint32_t skipped() const {
+        return m_skipped;
+    }
+
+    /**
+     * @brief Slots that were due after their time but within the period
+     */
+    uint32_t late() const {
+        return m_late;
+    }
+
+  private:
+    uint32_t firstSlotFrom(uint32_t now) const;
+
+    uint32_t m_period;
+    uint32_t m_phase;
+    uint32_t m_next    = 0;
+    bool     m_started = false;
+    uint32_t m_skipped = 0;
+    uint32_t m_late    = 0;
+};
+
+/**
+ * @brief Phase in a period for a unit, the same on every start of the unit
+ *
+ * Spreads the slots of many units evenly over the period, so they do not
+ * all call the control unit at once. Uses the 32 bit FNV-1a hash of the id,
+ * helpers/loadgen computes the same phases.
+ *
+ * @param unitId Null terminated id, e.g. SENSOR_UNIT_ID
+ * @param period Time between slots
+ * @return uint32_t Phase below period
+ */
+uint32_t unitPhase(const char* unitId, uint32_t period);
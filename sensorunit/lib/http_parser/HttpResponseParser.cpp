@@ -0,0 +1,123 @@
+/**
+ * @file HttpResponseParser.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of HttpResponseParser
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "HttpResponseParser.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/**
+ * @brief Value of a header line if it has the given name
+ *
+ * @param line Header line without line ending
+ * @param name Header name in any case, without colon
+ * @return const char* Value with leading spaces skipped, nullptr for another header
+ */
+static const char* headerValue(const etl::istring& line, const char* name) {
+    size_t length = strlen(name);
+    if (line.size() <= length || line[length] != ':' ||
+        strncasecmp(line.c_str(), name, length) != 0) {
+        return nullptr;
+    }
+    const char* value = line.c_str() + length + 1;
+    while (*value == ' ') {
+        ++value;
+    }
+    return value;
+}
+
+HttpResponseParser::HttpResponseParser(etl::istring& body) : m_body{body} {
+    m_body.clear();
+}
+
+size_t HttpResponseParser::feed(const char* data, size_t size) {
+    size_t used = 0;
+    while (used < size && !done()) {
+        if (m_state == State::Body) {
+            size_t chunk = size - used;
+            if (m_contentLength >= 0) {
+                long left = m_contentLength - m_bodyBytes;
+                chunk     = static_cast<size_t>(left) < chunk ? static_cast<size_t>(left) : chunk;
+            }
+            size_t room = m_body.capacity() - m_body.size();
+            m_body.append(data + used, chunk < room ? chunk : room);
+            m_bodyBytes += static_cast<long>(chunk);
+            used += chunk;
+            if (m_contentLength >= 0 && m_bodyBytes >= m_contentLength) {
+                m_state = State::Complete;
+            }
+            continue;
+        }
+
+        // Status line and headers, copied up to the end of the line at once
+        const char* start = data + used;
+        const char* end   = static_cast<const char*>(memchr(start, '\n', size - used));
+        size_t      chunk = end != nullptr ? static_cast<size_t>(end - start) : size - used;
+        size_t      room  = m_line.capacity() - m_line.size();
+        m_line.append(start, chunk < room ? chunk : room);
+        used += chunk;
+        if (end != nullptr) {
+            ++used;
+            if (!m_line.empty() && m_line.back() == '\r') {
+                m_line.pop_back();
+            }
+            parseLine();
+            m_line.clear();
+        }
+    }
+    m_received += used;
+    return used;
+}
+
+void HttpResponseParser::finish() {
+    if (done()) {
+        return;
+    }
+    if (m_state == State::Body && m_contentLength < 0) {
+        m_state = State::Complete;
+    } else {
+        m_state = State::Failed;
+    }
+}
+
+void HttpResponseParser::parseLine() {
+    if (m_state == State::StatusLine) {
+        // HTTP/1.1 200 OK
+        if (!m_line.starts_with("HTTP/1.") || m_line.size() < 12 || m_line[8] != ' ') {
+            m_state = State::Failed;
+            return;
+        }
+        m_status = atoi(m_line.c_str() + 9);
+        // HTTP/1.0 closes unless the server says otherwise
+        m_keepAlive = m_line[7] != '0';
+        m_state     = State::Headers;
+        return;
+    }
+
+    if (m_line.empty()) {
+        // Empty line ends header, 204 and 304 never have a body
+        if (m_status == 204 || m_status == 304) {
+            m_contentLength = 0;
+        }
+        m_state = m_contentLength == 0 ? State::Complete : State::Body;
+        return;
+    }
+    if (const char* value = headerValue(m_line, "Content-Length")) {
+        m_contentLength = atol(value);
+    } else if (const char* value = headerValue(m_line, "Connection")) {
+        m_keepAlive = strcasecmp(value, "close") != 0;
+    } else if (const char* value = headerValue(m_line, "Transfer-Encoding")) {
+        // Not used by the Control Unit and not supported
+        if (strcasecmp(value, "identity") != 0) {
+            m_state = State::Failed;
+        }
+    }
+}
@@ -0,0 +1,138 @@
+/**
+ * @file HttpResponseParser.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Incremental HTTP/1.1 response parser fed with blocks of bytes
+ *
+ * The parser is a state machine, so a response can arrive in blocks of any
+ * size and be fed as it comes. The body is written straight into the string
+ * of the caller, normally RestResponse::payload, which JsonParser then reads
+ * without another copy. With a Content-Length the response is complete as
+ * soon as the last body byte is fed, without waiting for the server to close
+ * the connection. Without one the body ends with finish().
+ *
+ * Has no Arduino dependencies and is tested in the native environment.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <etl/string.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Sizes used by the parser
+ *
+ */
+namespace http_parser_config {
+constexpr size_t max_header_line_size = 128; // Longer header lines are cut
+constexpr size_t read_block_size      = 128; // Bytes per read from the client
+} // namespace http_parser_config
+
+class HttpResponseParser {
+  public:
+    enum class State { StatusLine, Headers, Body, Complete, Failed };
+
+    /**
+     * @brief Constructs a parser for one response
+     *
+     * @param body Receives the body, bytes that do not fit are counted and dropped
+     */
+    explicit HttpResponseParser(etl::istring& body);
+
+    /**
+     * @brief Parses the next block of the response
+     *
+     * @param data Bytes received
+     * @param size Number of bytes
+     * @return size_t Bytes used, less than size when the response completed before the end
+     */
+    size_t feed(const char* data, size_t size);
+
+    /**
+     * @brief Tells the parser that the connection was closed
+     *
+     * Completes a body without Content-Length, anything else not complete has failed.
+     */
+    void finish();
+
+    /**
+     * @brief Reads what client has available in blocks and feeds it
+     *
+     * @tparam Client WiFiClient or anything with available() and read(uint8_t*, size_t)
+     * @param client Connected client
+     * @return size_t Bytes read, 0 if nothing was available
+     */
+    template <typename Client> size_t readAvailable(Client& client) {
+        size_t total = 0;
+        int    available;
+        while (!done() && (available = client.available()) > 0) {
+            uint8_t block[http_parser_config::read_block_size];
+            size_t  wanted = static_cast<size_t>(available) < sizeof(block)
+                                 ? static_cast<size_t>(available)
+                                 : sizeof(block);
+            int     length = client.read(block, wanted);
+            if (length <= 0) {
+                break;
+            }
+            feed(reinterpret_cast<const char*>(block), static_cast<size_t>(length));
+            total += static_cast<size_t>(length);
+        }
+        return total;
+    }
+
+    State state() const {
+        return m_state;
+    }
+    /**
+     * @brief true when the response is complete or has failed
+     */
+    bool done() const {
+        return m_state == State::Complete || m_state == State::Failed;
+    }
+    /**
+     * @brief Status code from the status line, 0 before it is parsed
+     */
+    int status() const {
+        return m_status;
+    }
+    /**
+     * @brief Value of Content-Length, -1 if the response has none
+     */
+    long contentLength() const {
+        return m_contentLength;
+    }
+    /**
+     * @brief true if the connection can take the next request after this response
+     */
+    bool keepAlive() const {
+        return m_state == State::Complete && m_keepAlive && m_contentLength >= 0;
+    }
+    /**
+     * @brief true if the body did not fit in the string
+     */
+    bool overflow() const {
+        return m_bodyBytes > static_cast<long>(m_body.capacity());
+    }
+    /**
+     * @brief Bytes fed so far
+     */
+    size_t received() const {
+        return m_received;
+    }
+
+  private:
+    void parseLine();
+
+    etl::istring&                                         m_body;
+    etl::string<http_parser_config::max_header_line_size> m_line;
+    State                                                 m_state         = State::StatusLine;
+    int                                                   m_status        = 0;
+    long                                                  m_contentLength = -1;
+    long                                                  m_bodyBytes     = 0;
+    size_t                                                m_received      = 0;
+    bool                                                  m_keepAlive     = true;
+};
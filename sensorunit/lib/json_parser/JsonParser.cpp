@@ -15,23 +15,82 @@
 #include "JsonParser.h"
 #include "logging.h"
 
+/**
+ * @brief Print that only counts the bytes, the measuring pass
+ */
+class CountingPrint : public Print {
+  public:
+    size_t write(uint8_t) override {
+        return 1;
+    }
+    size_t write(const uint8_t*, size_t size) override {
+        return size;
+    }
+};
+
+/**
+ * @brief Print that appends to an etl::string, cut at its capacity
+ */
+class StringPrint : public Print {
+  public:
+    explicit StringPrint(etl::istring& text) : m_text{text} {}
+    size_t write(uint8_t byte) override {
+        return write(&byte, 1);
+    }
+    size_t write(const uint8_t* data, size_t size) override {
+        size_t room = m_text.capacity() - m_text.size();
+        size_t used = size < room ? size : room;
+        m_text.append(reinterpret_cast<const char*>(data), used);
+        return used;
+    }
+
+  private:
+    etl::istring& m_text;
+};
+
 etl::string<json_config::max_json_size> JsonParser::composeSensorSnapshotGroup(
     const etl::vector<CaSensorunitReading, json_config::max_batch_size>& readings,
     const char*                                                          uuid) {
-    StaticJsonDocument<json_config::max_json_doc_size> doc;
-    doc["sensor_unit_id"]   = uuid;
-    JsonArray readingsArray = doc["readings"].to<JsonArray>();
-
-    for (auto reading : readings) {
-        JsonObject readingsEntry     = readingsArray.createNestedObject();
-        readingsEntry["timestamp"]   = reading.timestamp;
-        readingsEntry["temperature"] = reading.temperature;
-        readingsEntry["humidity"]    = reading.humidity;
+    etl::string<json_config::max_json_size> json;
+    StringPrint                             out(json);
+    writeSensorSnapshotGroup(out, readings, uuid);
+    return json;
+}
+
+size_t JsonParser::writeSensorSnapshotGroup(
+    Print&                                                               out,
+    const etl::vector<CaSensorunitReading, json_config::max_batch_size>& readings,
+    const char*                                                          uuid) {
+    // {"sensor_unit_id":"...","readings":[{...},{...}]}, values formatted by ArduinoJson
+    StaticJsonDocument<json_config::max_small_json_doc_size> doc;
+    size_t                                                   written = 0;
+
+    written += out.print("{\"sensor_unit_id\":");
+    doc.set(uuid);
+    written += serializeJson(doc, out);
+    written += out.print(",\"readings\":[");
+
+    bool first = true;
+    for (const auto& reading : readings) {
+        if (!first) {
+            written += out.print(',');
+        }
+        first = false;
+        doc.clear();
+        doc["timestamp"]   = reading.timestamp;
+        doc["temperature"] = reading.temperature;
+        doc["humidity"]    = reading.humidity;
+        written += serializeJson(doc, out);
     }
+    written += out.print("]}");
+    return written;
+}
 
-    char rawOutput[json_config::max_json_size];
-    serializeJson(doc, rawOutput);
-    return etl::string<json_config::max_json_size>(rawOutput);
+size_t JsonParser::measureSensorSnapshotGroup(
+    const etl::vector<CaSensorunitReading, json_config::max_batch_size>& readings,
+    const char*                                                          uuid) {
+    CountingPrint counter;
+    return writeSensorSnapshotGroup(counter, readings, uuid);
 }
 
 etl::string<json_config::max_small_json_size>
@@ -43,12 +102,10 @@ JsonParser::composeConnectRequest(const char* su_uuid) {
     return etl::string<json_config::max_small_json_size>{rawOutput};
 }
 
-ConnectResponse
-JsonParser::parseConnectResponse(etl::string<json_config::max_small_json_size> payload) {
-    const char*                                              json = payload.c_str();
+ConnectResponse JsonParser::parseConnectResponse(const etl::istring& payload) {
     StaticJsonDocument<json_config::max_small_json_doc_size> doc;
     ConnectResponse                                          response{false};
-    DeserializationError                                     error = deserializeJson(doc, json);
+    DeserializationError error = deserializeJson(doc, payload.data(), payload.size());
     if (error) {
         LOG_ERROR(TAG, "DeserializationError: %s", error.c_str());
         return response;
@@ -61,15 +118,18 @@ JsonParser::parseConnectResponse(etl::string<json_config::max_small_json_size> p
     const char* responseStatusText = doc["status"];
     LOG_INFO(TAG, "Connect response: %s", responseStatusText);
     response.connected = (doc["status"] == "connected");
+    // Left out by Control Units without upload windows
+    response.uploadSlot.periodSec = doc["upload_period_s"] | 0u;
+    response.uploadSlot.offsetSec = doc["upload_offset_s"] | 0u;
+    response.uploadSlot.windowSec = doc["upload_window_s"] | 0u;
 
     return response;
 }
 
-bool JsonParser::parseDispatchResponse(etl::string<json_config::max_small_json_size> payload) {
-    const char*                                              json = payload.c_str();
+bool JsonParser::parseDispatchResponse(const etl::istring& payload) {
     StaticJsonDocument<json_config::max_small_json_doc_size> doc;
     bool                                                     response{false};
-    DeserializationError                                     error = deserializeJson(doc, json);
+    DeserializationError error = deserializeJson(doc, payload.data(), payload.size());
     if (error) {
         LOG_ERROR(TAG, "DeserializationError: %s", error.c_str());
         return response;
@@ -86,11 +146,9 @@ bool JsonParser::parseDispatchResponse(etl::string<json_config::max_small_json_s
     return response;
 }
 
-uint32_t JsonParser::parseGetTimeResponse(etl::string<json_config::max_small_json_size> payload) {
-
-    const char*                                              json = payload.c_str();
+uint32_t JsonParser::parseGetTimeResponse(const etl::istring& payload) {
     StaticJsonDocument<json_config::max_small_json_doc_size> doc;
-    DeserializationError                                     error = deserializeJson(doc, json);
+    DeserializationError error = deserializeJson(doc, payload.data(), payload.size());
     if (error) {
         LOG_ERROR(TAG, "DeserializationError: %s", error.c_str());
         return 0;
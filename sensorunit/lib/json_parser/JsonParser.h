@@ -16,6 +16,7 @@
 #include "constants.h"
 #include "sensor_data_types.h"
 #include <ArduinoJson.h>
+#include <Print.h>
 #include <etl/string.h>
 #include <etl/vector.h>
 
@@ -38,6 +39,31 @@ class JsonParser {
     static etl::string<json_config::max_json_size> composeSensorSnapshotGroup(
         const etl::vector<CaSensorunitReading, json_config::max_batch_size>& readings,
         const char*                                                          uuid);
+    /**
+     * @brief Writes the JSON of composeSensorSnapshotGroup straight to out
+     *
+     * Only one reading at a time is held in a JSON document, so the size of
+     * the batch does not decide the RAM used.
+     *
+     * @param out Destination, e.g. the connection to the Control Unit
+     * @param readings
+     * @param uuid
+     * @return size_t Bytes written
+     */
+    static size_t writeSensorSnapshotGroup(
+        Print&                                                               out,
+        const etl::vector<CaSensorunitReading, json_config::max_batch_size>& readings,
+        const char*                                                          uuid);
+    /**
+     * @brief Length of the JSON writeSensorSnapshotGroup writes, for Content-Length
+     *
+     * @param readings
+     * @param uuid
+     * @return size_t Bytes the JSON takes
+     */
+    static size_t measureSensorSnapshotGroup(
+        const etl::vector<CaSensorunitReading, json_config::max_batch_size>& readings,
+        const char*                                                          uuid);
     /**
      * @brief Composes a JSON string for connecting with Control Unit
      *
@@ -50,16 +76,13 @@ class JsonParser {
      * @brief parse a JSON connect response
      *
      * @param payload The JSON payload received from the Control Unit
-     * @return ConnectResponse Struct containing connection status and assigned sensor ID
+     * @return ConnectResponse Struct containing connection status and upload window
      *
      * @example:
-     *   {
-     *     connected = true,
-     *     sensorId = 1
-     *   }
+     *   {"status":"connected","upload_period_s":60,"upload_offset_s":15,"upload_window_s":5}
+     *   gives connected = true, uploadSlot = {60, 15, 5}
      */
-    static ConnectResponse
-    parseConnectResponse(etl::string<json_config::max_small_json_size> payload);
+    static ConnectResponse parseConnectResponse(const etl::istring& payload);
     /**
      * @brief Parse the response of a dispatch to see if Sensor Unit should disconnect
      * Only disconnects if status explicitly says disconnected
@@ -68,14 +91,14 @@ class JsonParser {
      * @return true if still connected
      * @return false if disconnected
      */
-    static bool parseDispatchResponse(etl::string<json_config::max_small_json_size> payload);
+    static bool parseDispatchResponse(const etl::istring& payload);
     /**
      * @brief Parse a JSON response from GET /time
      *
      * @param payload The JSON payload received from the Control Unit
      * @return unsigned long - Unix timestamp with current time
      */
-    static uint32_t parseGetTimeResponse(etl::string<json_config::max_small_json_size> payload);
+    static uint32_t parseGetTimeResponse(const etl::istring& payload);
 
   private:
     static constexpr const char* TAG = "JsonParser";
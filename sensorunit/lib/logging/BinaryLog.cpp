@@ -0,0 +1,96 @@
+/**
+ * @file BinaryLog.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the binary log records and ring buffer
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "BinaryLog.h"
+#include "logging.h"
+#include <algorithm>
+
+LogRecord::LogRecord(uint8_t level, uint32_t timeMs, uint32_t tagId, uint32_t formatId)
+    : m_size{binary_log_config::header_size} {
+    m_data[0] = binary_log_config::sync_first;
+    m_data[1] = binary_log_config::sync_second;
+    m_data[2] = static_cast<uint8_t>(m_size - 3);
+    m_data[3] = level;
+    memcpy(&m_data[4], &timeMs, sizeof(timeMs));
+    memcpy(&m_data[8], &tagId, sizeof(tagId));
+    memcpy(&m_data[12], &formatId, sizeof(formatId));
+}
+
+void LogRecord::addString(const char* text) {
+    if (text == nullptr) {
+        text = "(null)";
+    }
+    size_t length = strnlen(text, binary_log_config::max_string_size);
+    if (m_size + 2 > sizeof(m_data)) {
+        return;
+    }
+    length           = std::min(length, sizeof(m_data) - m_size - 2);
+    m_data[m_size++] = 's';
+    m_data[m_size++] = static_cast<uint8_t>(length);
+    memcpy(&m_data[m_size], text, length);
+    m_size += length;
+    m_data[2] = static_cast<uint8_t>(m_size - 3);
+}
+
+BinaryLog::BinaryLog(uint8_t* storage, size_t size) : m_storage{storage}, m_capacity{size} {}
+
+bool BinaryLog::push(const LogRecord& record) {
+    if (m_droppedSinceNote > 0) {
+        LogRecord note(LOG_WARN, millis(), 0, binary_log_config::dropped_id);
+        note.add(m_droppedSinceNote);
+        if (record.size() + note.size() > m_capacity - m_used) {
+            ++m_droppedSinceNote;
+            ++m_droppedTotal;
+            return false;
+        }
+        store(note.data(), note.size());
+        m_droppedSinceNote = 0;
+    }
+    if (!store(record.data(), record.size())) {
+        ++m_droppedSinceNote;
+        ++m_droppedTotal;
+        return false;
+    }
+    return true;
+}
+
+bool BinaryLog::store(const uint8_t* data, size_t size) {
+    if (size > m_capacity - m_used) {
+        return false;
+    }
+    size_t tail  = (m_head + m_used) % m_capacity;
+    size_t first = std::min(size, m_capacity - tail);
+    memcpy(&m_storage[tail], data, first);
+    memcpy(m_storage, data + first, size - first);
+    m_used += size;
+    return true;
+}
+
+size_t BinaryLog::flush(Print& out, size_t maxBytes) {
+    size_t written = 0;
+    while (m_used > 0 && written < maxBytes) {
+        // At most up to the end of the storage per write
+        size_t chunk = std::min({m_used, m_capacity - m_head, maxBytes - written});
+        size_t sent  = out.write(&m_storage[m_head], chunk);
+        m_head       = (m_head + sent) % m_capacity;
+        m_used -= sent;
+        written += sent;
+        if (sent < chunk) {
+            break;
+        }
+    }
+    return written;
+}
+
+#ifdef LOG_BINARY
+static uint8_t s_binaryLogStorage[LOG_BUFFER_BYTES];
+BinaryLog      binaryLog(s_binaryLogStorage, sizeof(s_binaryLogStorage));
+#endif
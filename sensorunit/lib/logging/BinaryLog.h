@@ -0,0 +1,188 @@
+/**
+ * @file BinaryLog.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Binary log records in a ring buffer, formatted off-device
+ *
+ * With LOG_BINARY defined in config.h the LOG macros do not call printf.
+ * Each call copies the level, a timestamp, a hash of the tag, a hash of the
+ * format string and the raw arguments into a record, which takes a few
+ * microseconds. logFlush() in loop() hands the records to Serial as far as
+ * its transmit buffer has room, so logging never waits for the UART.
+ *
+ * The hashes are computed at compile time. helpers/logdecode/logdecode.py
+ * computes the same hashes from the LOG calls in the sources and turns the
+ * serial stream back into text.
+ *
+ * Record on the wire, little endian:
+ *
+ * | Bytes | Field |
+ * | --- | --- |
+ * | 2 | sync 0xA5 0x5A |
+ * | 1 | length of the rest of the record |
+ * | 1 | level |
+ * | 4 | millis() |
+ * | 4 | tag hash |
+ * | 4 | format hash, 0 for a dropped records note |
+ * | n | arguments, a type byte each followed by the value |
+ *
+ * Argument types: 'i' int32, 'u' uint32, 'I' int64, 'U' uint64, 'd' double,
+ * 's' string as a length byte and the characters.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <Print.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+/**
+ * @brief Sizes and constants of the binary log format
+ *
+ */
+namespace binary_log_config {
+constexpr size_t   max_record_size = 96; // Longer records are cut at an argument
+constexpr size_t   max_string_size = 32; // Longer strings are cut
+constexpr size_t   header_size     = 3 + 1 + 4 + 4 + 4;
+constexpr uint8_t  sync_first      = 0xA5;
+constexpr uint8_t  sync_second     = 0x5A;
+constexpr uint32_t dropped_id      = 0; /**< Format hash of the dropped note */
+} // namespace binary_log_config
+
+/**
+ * @brief 32 bit FNV-1a hash, the same function as in logdecode.py
+ *
+ * @param text Null terminated string
+ * @return uint32_t Hash of the bytes in text
+ */
+constexpr uint32_t logHash(const char* text) {
+    uint32_t hash = 2166136261u;
+    while (*text != '\0') {
+        hash = (hash ^ static_cast<uint8_t>(*text++)) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Builds one record on the stack of the caller
+ */
+class LogRecord {
+  public:
+    LogRecord(uint8_t level, uint32_t timeMs, uint32_t tagId, uint32_t formatId);
+
+    /**
+     * @brief Appends an argument, encoded by its C++ type
+     *
+     * @param value Integer, enum, floating point, string or pointer
+     */
+    template <typename T> void add(T value) {
+        using Type = std::decay_t<T>;
+        if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) {
+            addString(value);
+        } else if constexpr (std::is_floating_point_v<Type>) {
+            addValue('d', static_cast<double>(value));
+        } else if constexpr (std::is_enum_v<Type>) {
+            addValue('i', static_cast<int32_t>(value));
+        } else if constexpr (std::is_integral_v<Type> && sizeof(Type) <= 4) {
+            if constexpr (std::is_signed_v<Type>) {
+                addValue('i', static_cast<int32_t>(value));
+            } else {
+                addValue('u', static_cast<uint32_t>(value));
+            }
+        } else if constexpr (std::is_integral_v<Type>) {
+            if constexpr (std::is_signed_v<Type>) {
+                addValue('I', static_cast<int64_t>(value));
+            } else {
+                addValue('U', static_cast<uint64_t>(value));
+            }
+        } else {
+            static_assert(std::is_pointer_v<Type>, "Unsupported log argument type");
+            addValue('u', static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value)));
+        }
+    }
+
+    const uint8_t* data() const {
+        return m_data;
+    }
+    size_t size() const {
+        return m_size;
+    }
+
+  private:
+    template <typename V> void addValue(char type, V value) {
+        if (m_size + 1 + sizeof(value) > sizeof(m_data)) {
+            return;
+        }
+        m_data[m_size++] = static_cast<uint8_t>(type);
+        memcpy(&m_data[m_size], &value, sizeof(value)); // The target is little endian
+        m_size += sizeof(value);
+        m_data[2] = static_cast<uint8_t>(m_size - 3);
+    }
+    void addString(const char* text);
+
+    uint8_t m_data[binary_log_config::max_record_size];
+    size_t  m_size;
+};
+
+/**
+ * @brief Ring buffer of records, written and flushed from the main loop
+ *
+ * Not for use from interrupts. A record that does not fit is dropped and
+ * counted, the count is sent as a record of its own once there is room.
+ */
+class BinaryLog {
+  public:
+    /**
+     * @brief Constructs a log on caller owned storage
+     *
+     * @param storage Ring buffer memory
+     * @param size Size of storage, at least two records
+     */
+    BinaryLog(uint8_t* storage, size_t size);
+
+    /**
+     * @brief Copies a record into the ring buffer
+     *
+     * @param record Complete record
+     * @return true if it was stored, false if it was dropped
+     */
+    bool push(const LogRecord& record);
+
+    /**
+     * @brief Writes buffered bytes to out without blocking
+     *
+     * @param out Destination, normally Serial
+     * @param maxBytes Bytes out can take right now, e.g. availableForWrite()
+     * @return size_t Bytes written
+     */
+    size_t flush(Print& out, size_t maxBytes);
+
+    /**
+     * @brief Bytes waiting to be flushed
+     */
+    size_t pending() const {
+        return m_used;
+    }
+
+    /**
+     * @brief Records dropped since start
+     */
+    uint32_t dropped() const {
+        return m_droppedTotal;
+    }
+
+  private:
+    bool store(const uint8_t* data, size_t size);
+
+    uint8_t* m_storage;
+    size_t   m_capacity;
+    size_t   m_head = 0; /**< Next byte to flush */
+    size_t   m_used = 0;
+    uint32_t m_droppedSinceNote = 0; /**< Not reported in a record yet */
+    uint32_t m_droppedTotal     = 0;
+};
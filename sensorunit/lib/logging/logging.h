@@ -10,6 +10,9 @@
  * Designed to resemble the ESP-style logging used in the Control Unit repository.
  * Enables consistent tagging and severity-based logging for debugging and runtime diagnostics.
  *
+ * With LOG_BINARY defined the macros store binary records instead of printing,
+ * see BinaryLog.h. Call logFlush() from loop() in both modes.
+ *
  * Depends on the LibPrintf library.
  * To use these macros, add the following to your platformio.ini:
  *     lib_deps = embeddedartistry/LibPrintf@^1.2.13
@@ -44,6 +47,19 @@ enum LogLevel {
 #define LOG_LEVEL LOG_INFO
 #endif
 
+#ifndef LOG_BUFFER_BYTES
+#define LOG_BUFFER_BYTES 512
+#endif
+
+#include "BinaryLog.h"
+
+#ifdef LOG_BINARY
+/**
+ * @brief The log used by the LOG macros, sized by LOG_BUFFER_BYTES
+ */
+extern BinaryLog binaryLog;
+#endif
+
 /**
  * @brief Global variable that defines the current logging verbosity level.
  *
@@ -100,19 +116,67 @@ inline void logMessage(LogLevel level, const char* tag, const char* fmt, Args...
     printf("%s\n", reset);
 }
 
+/**
+ * @brief Stores a binary record for the LOG macros when LOG_BINARY is defined.
+ *
+ * The tag and format are passed as hashes, the strings never leave the flash.
+ *
+ * @param level The severity level of the message.
+ * @param tagId logHash() of the tag.
+ * @param formatId logHash() of the format string.
+ * @param args  Arguments, copied by value. Strings are copied up to
+ * binary_log_config::max_string_size characters.
+ */
+template<typename... Args>
+inline void logRecord(LogLevel level, uint32_t tagId, uint32_t formatId, Args... args) {
+#ifdef LOG_BINARY
+    LogRecord record(level, millis(), tagId, formatId);
+    (record.add(args), ...);
+    binaryLog.push(record);
+#endif
+}
+
+/**
+ * @brief Writes buffered binary records to Serial as far as it has room.
+ *
+ * Call once per loop(). Does nothing unless LOG_BINARY is defined, text
+ * logging writes right away.
+ */
+inline void logFlush() {
+#ifdef LOG_BINARY
+    int room = Serial.availableForWrite();
+    if (room > 0) {
+        binaryLog.flush(Serial, static_cast<size_t>(room));
+    }
+#endif
+}
+
 /**
  * @def LOG(level, tag, fmt, ...)
  * @brief Generic logging macro for formatted output to the serial console.
  *
  * Prints a log message if the specified level is equal to or lower than
- * the currentLogLevel. Includes timestamp, severity, and tag.
+ * the currentLogLevel. Includes timestamp, severity, and tag. With LOG_BINARY
+ * defined the message is stored as a record instead, tag and fmt have to be
+ * compile time constants.
  *
  * @param level The severity level of the message (see LogLevel).
  * @param tag   A short identifier or module name for the log source.
  * @param fmt   A printf-style format string.
  * @param ...   Optional arguments to be formatted into the message.
  */
+#ifdef LOG_BINARY
+#define LOG(level, tag, fmt, ...)                                                                 \
+    do {                                                                                          \
+        if ((level) != LOG_NONE && (level) <= currentLogLevel) {                                  \
+            constexpr uint32_t logTagId    = logHash(tag);                                        \
+            constexpr uint32_t logFormatId = logHash(fmt);                                        \
+            logRecord(level, logTagId, logFormatId, ##__VA_ARGS__);                               \
+        }                                                                                         \
+    } while (0)
+#else
 #define LOG(level, tag, fmt, ...) logMessage(level, tag, fmt, ##__VA_ARGS__)
+#endif
 
 /**
  * @def LOG_ERROR(tag, fmt, ...)
@@ -0,0 +1,50 @@
+/**
+ * @file DataFlashReadingStorage.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the data flash reading storage
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "DataFlashReadingStorage.h"
+#include "logging.h"
+
+DataFlashReadingStorage::DataFlashReadingStorage()
+    : m_device(DataFlashBlockDevice::getInstance()) {}
+
+bool DataFlashReadingStorage::init() {
+    int result = m_device.init();
+    if (result != 0) {
+        LOG_ERROR(TAG, "Data flash init failed with %d", result);
+        return false;
+    }
+    m_ready = true;
+    LOG_INFO(TAG,
+             "Data flash %lu bytes in %lu byte sectors",
+             static_cast<unsigned long>(m_device.size()),
+             static_cast<unsigned long>(m_device.get_erase_size()));
+    return true;
+}
+
+size_t DataFlashReadingStorage::sectorSize() const {
+    return m_ready ? static_cast<size_t>(m_device.get_erase_size()) : 0;
+}
+
+size_t DataFlashReadingStorage::sectorCount() const {
+    return m_ready ? static_cast<size_t>(m_device.size() / m_device.get_erase_size()) : 0;
+}
+
+bool DataFlashReadingStorage::read(uint32_t address, void* data, size_t size) const {
+    return m_ready && m_device.read(data, address, size) == 0;
+}
+
+bool DataFlashReadingStorage::program(uint32_t address, const void* data, size_t size) {
+    return m_ready && m_device.program(data, address, size) == 0;
+}
+
+bool DataFlashReadingStorage::erase(size_t sector) {
+    return m_ready && m_device.erase(sector * sectorSize(), sectorSize()) == 0;
+}
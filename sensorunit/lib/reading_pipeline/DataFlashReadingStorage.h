@@ -0,0 +1,40 @@
+/**
+ * @file DataFlashReadingStorage.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief IReadingStorage on the 8 KB data flash of the RA4M1
+ *
+ * Uses DataFlashBlockDevice of the Renesas Arduino core, eight 1 KB erase
+ * blocks that are rated for 100 000 erase cycles. The data flash is also what
+ * the EEPROM library uses, so the two cannot be used in the same sketch.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "IReadingStorage.h"
+#include <DataFlashBlockDevice.h>
+
+class DataFlashReadingStorage : public IReadingStorage {
+  public:
+    DataFlashReadingStorage();
+    /**
+     * @brief Initializes the flash driver, call in setup() before ReadingBuffer::init()
+     *
+     * @return true if the data flash can be used
+     */
+    bool init();
+
+    size_t sectorSize() const override;
+    size_t sectorCount() const override;
+    bool   read(uint32_t address, void* data, size_t size) const override;
+    bool   program(uint32_t address, const void* data, size_t size) override;
+    bool   erase(size_t sector) override;
+
+  private:
+    DataFlashBlockDevice&        m_device;
+    bool                         m_ready = false;
+    static constexpr const char* TAG     = "DataFlashReadingStorage";
+};
@@ -13,6 +13,9 @@
 
 class IReadingsDispatcher {
   public:
-    virtual bool dispatch() = 0;
-    virtual ~IReadingsDispatcher() = default;
-};
\ No newline at end of file
+    virtual void start()               = 0;
+    virtual bool step()                = 0;
+    virtual void stop()                = 0;
+    virtual bool isDispatching() const = 0;
+    virtual ~IReadingsDispatcher()     = default;
+};
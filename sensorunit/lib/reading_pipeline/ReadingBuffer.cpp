@@ -12,34 +12,117 @@
 #include "ReadingBuffer.h"
 #include "logging.h"
 
+static_assert(buffer_config::commit_batch < buffer_config::max_buffer_size,
+              "Uncommitted readings must never be the oldest in a full buffer");
+
+ReadingBuffer::ReadingBuffer(ReadingBacklog& backlog) : m_backlog{&backlog} {}
+
+void ReadingBuffer::init() {
+    if (m_backlog == nullptr) {
+        return;
+    }
+    if (!m_backlog->begin()) {
+        LOG_ERROR(TAG, "Backlog storage not usable, readings are kept in RAM only");
+        m_backlog = nullptr;
+        return;
+    }
+    LOG_INFO(TAG,
+             "%zu readings in the backlog from before the reset, room for %zu",
+             m_backlog->pending(),
+             m_backlog->capacity());
+}
+
 bool ReadingBuffer::hasReadings() const {
-    return m_buffer.size() >= 1;
+    return size() > 0;
 }
 
 etl::vector<CaSensorunitReading, buffer_config::max_batch_size> ReadingBuffer::getBatch() const {
     etl::vector<CaSensorunitReading, buffer_config::max_batch_size> batch;
-    for (size_t i = 0; i < std::min(m_buffer.size(), buffer_config::max_batch_size); ++i) {
-        batch.push_back(m_buffer[i]); // NOTE: Reads without erasing
+    // Readings only in the backlog are the oldest, read one batch of them
+    size_t fromBacklog = std::min(backlogOnly(), buffer_config::max_batch_size);
+    if (fromBacklog > 0) {
+        batch.resize(fromBacklog);
+        batch.resize(m_backlog->read(batch.data(), fromBacklog));
+        if (batch.size() < fromBacklog) {
+            return batch;
+        }
+    }
+    size_t fromRam = std::min(m_records.size(), buffer_config::max_batch_size - batch.size());
+    for (size_t i = 0; i < fromRam; ++i) {
+        batch.push_back(unpackReading(m_records.at(i), m_epoch)); // NOTE: Reads without erasing
     }
     return batch;
 }
 
 void ReadingBuffer::removeBatch(size_t count) {
-    for (size_t i = 0; i < count && !m_buffer.empty(); ++i) {
-        m_buffer.pop();
+    size_t fromBacklog = std::min(count, backlogOnly());
+    size_t fromRam     = std::min(count - fromBacklog, m_records.size());
+    size_t committed   = m_records.size() - m_uncommitted;
+    for (size_t i = 0; i < fromRam; ++i) {
+        m_records.pop();
+    }
+    if (fromRam > committed) {
+        // Dispatched before they were ever written to the backlog
+        m_uncommitted -= fromRam - committed;
+    }
+    size_t acknowledged = fromBacklog + std::min(fromRam, committed);
+    if (m_backlog != nullptr && acknowledged > 0 && !m_backlog->acknowledge(acknowledged)) {
+        LOG_ERROR(TAG, "Backlog ack failed, readings are kept in RAM only");
+        m_backlog     = nullptr;
+        m_uncommitted = 0;
     }
 }
 
 void ReadingBuffer::push(const CaSensorunitReading& reading) {
-    if (!m_buffer.full()) {
-        m_buffer.push(reading);
-    } else {
-        LOG_WARN(TAG, "Buffer full, overwriting oldest value");
-        m_buffer.pop();
-        m_buffer.push(reading);
+    if (m_records.empty()) {
+        m_epoch = static_cast<uint32_t>(reading.timestamp);
+    }
+    if (m_records.full()) {
+        if (m_backlog != nullptr) {
+            LOG_DEBUG(TAG, "Buffer full, oldest value kept in the backlog only");
+        } else {
+            LOG_WARN(TAG, "Buffer full, overwriting oldest value");
+        }
+        m_records.pop();
+    }
+    m_records.push(packReading(reading, m_epoch));
+    if (m_backlog != nullptr && ++m_uncommitted >= buffer_config::commit_batch) {
+        commit();
     }
 }
 
 size_t ReadingBuffer::size() const {
-    return m_buffer.size();
-}
\ No newline at end of file
+    return m_records.size() + backlogOnly();
+}
+
+void ReadingBuffer::commit() {
+    if (m_backlog == nullptr || m_uncommitted == 0) {
+        return;
+    }
+    CaSensorunitReading readings[buffer_config::commit_batch];
+    size_t              first = m_records.size() - m_uncommitted;
+    for (size_t i = 0; i < m_uncommitted; ++i) {
+        readings[i] = unpackReading(m_records.at(first + i), m_epoch);
+    }
+    if (!m_backlog->append(readings, m_uncommitted)) {
+        LOG_ERROR(TAG, "Backlog append failed, readings are kept in RAM only");
+        m_backlog     = nullptr;
+        m_uncommitted = 0;
+        return;
+    }
+    m_uncommitted = 0;
+    if (m_backlog->lost() != m_lostReported) {
+        LOG_WARN(TAG,
+                 "Backlog full, %lu oldest readings overwritten",
+                 static_cast<unsigned long>(m_backlog->lost() - m_lostReported));
+        m_lostReported = m_backlog->lost();
+    }
+}
+
+size_t ReadingBuffer::backlogOnly() const {
+    if (m_backlog == nullptr) {
+        return 0;
+    }
+    size_t committed = m_records.size() - m_uncommitted;
+    return m_backlog->pending() > committed ? m_backlog->pending() - committed : 0;
+}
@@ -1,13 +1,24 @@
 /**
  * @file ReadingBuffer.h
  * @author Erik Dahl (erik@iunderlandet.se)
- * @brief Reading Buffer that internally uses an ETL circular buffer
+ * @brief Reading Buffer that keeps readings as bit-packed records
  *
  * - push individual readings to the buffer,
  * - get a batch of readings of up to a predefined maximum size,
  * - remove a batch of given size
  * - check size and check if buffer has readings.
  *
+ * Readings are packed when pushed, 58 bits each with the time as an offset
+ * from the first reading in the buffer. They are only turned back into
+ * CaSensorunitReading by getBatch() when dispatched. See PackedReading.h.
+ *
+ * With a ReadingBacklog the readings also survive a reset. Readings not
+ * dispatched are appended to the backlog commit_batch at a time, so while the
+ * unit is connected most readings are dispatched before they are ever
+ * written. When the RAM buffer is full the oldest reading stays in the
+ * backlog only. getBatch() reads those from the backlog first, one batch at
+ * a time, and init() picks up the ones left from before a reset.
+ *
  * @date 2025-10-24
  *
  * @copyright Copyright (c) 2025 Erik Dahl
@@ -15,9 +26,9 @@
  *
  */
 #pragma once
+#include "PackedReadingRing.h"
+#include "ReadingBacklog.h"
 #include "sensor_data_types.h"
-#include <etl/circular_buffer.h>
-#include <etl/string.h>
 #include <etl/vector.h>
 
 /**
@@ -26,8 +37,9 @@
  *
  */
 namespace buffer_config {
-constexpr size_t max_buffer_size = 20; // ~400 bytes in RAM
+constexpr size_t max_buffer_size = 256; // ~1.9 KB in RAM, 21 minutes at 5 s readings
 constexpr size_t max_batch_size  = 10;
+constexpr size_t commit_batch    = 4; // Readings per append to the backlog, lost on a reset
 } // namespace buffer_config
 
 class ReadingBuffer {
@@ -36,6 +48,19 @@ class ReadingBuffer {
      * @brief Default contructor. Nothing to see here.
      */
     ReadingBuffer() = default;
+    /**
+     * @brief Constructs a buffer that keeps undispatched readings in backlog
+     *
+     * @param backlog Non-volatile backlog, read by init()
+     */
+    explicit ReadingBuffer(ReadingBacklog& backlog);
+    /**
+     * @brief Finds readings left in the backlog from before a reset
+     *
+     * They are dispatched before new readings. Without a backlog, or if the
+     * storage cannot be used, the buffer keeps readings in RAM only.
+     */
+    void init();
     /**
      * @brief Get a batch of readings of up to the max_batch_size
      *
@@ -71,8 +96,23 @@ class ReadingBuffer {
      * @return size_t Number of readings in the buffer
      */
     size_t size() const;
+    /**
+     * @brief Appends readings not yet in the backlog, e.g. before a planned reset
+     */
+    void commit();
 
   private:
-    etl::circular_buffer<CaSensorunitReading, buffer_config::max_buffer_size> m_buffer;
-    static constexpr const char*                                              TAG = "ReadingBuffer";
+    /**
+     * @brief Readings that are in the backlog but no longer in RAM, all older than those in RAM
+     */
+    size_t backlogOnly() const;
+
+    PackedReadingRing<buffer_config::max_buffer_size> m_records;
+    /// Unix time the record offsets count from
+    uint32_t        m_epoch   = 0;
+    ReadingBacklog* m_backlog = nullptr;
+    /// Newest readings in RAM that are not in the backlog yet
+    size_t                       m_uncommitted  = 0;
+    uint32_t                     m_lostReported = 0;
+    static constexpr const char* TAG            = "ReadingBuffer";
 };
@@ -13,26 +13,76 @@
 #include "JsonParser.h"
 #include "logging.h"
 
+/**
+ * @brief A batch of readings as JSON, written straight to the connection
+ */
+class SnapshotGroupBody : public IRequestBody {
+  public:
+    SnapshotGroupBody(
+        const etl::vector<CaSensorunitReading, buffer_config::max_batch_size>& readings,
+        const char*                                                            uuid)
+        : m_readings{readings}, m_uuid{uuid} {}
+    size_t size() const override {
+        return JsonParser::measureSensorSnapshotGroup(m_readings, m_uuid);
+    }
+    size_t writeTo(Print& out) const override {
+        return JsonParser::writeSensorSnapshotGroup(out, m_readings, m_uuid);
+    }
+
+  private:
+    const etl::vector<CaSensorunitReading, buffer_config::max_batch_size>& m_readings;
+    const char*                                                            m_uuid;
+};
+
 ReadingsDispatcher::ReadingsDispatcher(IRestClient&   restClient,
                                        ReadingBuffer& readingBuffer,
                                        const char*    sensorUnitId)
     : m_restClient(restClient), m_readingBuffer(readingBuffer), m_sensorUnitId(sensorUnitId) {}
 
-bool ReadingsDispatcher::dispatch() {
+void ReadingsDispatcher::start() {
+    if (m_dispatching) {
+        LOG_DEBUG(TAG, "Dispatch already running");
+        return;
+    }
     LOG_INFO(TAG, "Dispatching readings...");
-    DispatchResponse dispatchResponse {};
-    while (m_readingBuffer.hasReadings()) {
-        dispatchResponse = dispatchBatch();
-        
-        if (dispatchResponse.restStatus != 200) {
-            LOG_WARN(TAG, "Rest Server error %d, Aborting dispatch", (dispatchResponse.restStatus));
-            return true;
-        }
+    m_dispatching = true;
+    m_batchesSent = 0;
+}
+
+bool ReadingsDispatcher::step() {
+    if (!m_dispatching) {
+        return true;
     }
+    if (!m_readingBuffer.hasReadings()) {
+        LOG_INFO(TAG, "Dispatch done after %zu batches", m_batchesSent);
+        m_dispatching = false;
+        return true;
+    }
+    DispatchResponse dispatchResponse = dispatchBatch();
+
+    if (dispatchResponse.restStatus != 200) {
+        LOG_WARN(TAG, "Rest Server error %d, Aborting dispatch", (dispatchResponse.restStatus));
+        m_dispatching = false;
+        return true;
+    }
+    ++m_batchesSent;
     if (!dispatchResponse.connected) {
         LOG_INFO(TAG, "Sensor Unit received disconnect status");
+        m_dispatching = false;
+        return false;
     }
-    return dispatchResponse.connected;
+    return true;
+}
+
+void ReadingsDispatcher::stop() {
+    if (m_dispatching) {
+        LOG_INFO(TAG, "Dispatch stopped after %zu batches", m_batchesSent);
+        m_dispatching = false;
+    }
+}
+
+bool ReadingsDispatcher::isDispatching() const {
+    return m_dispatching;
 }
 
 DispatchResponse ReadingsDispatcher::dispatchBatch() {
@@ -44,11 +94,10 @@ DispatchResponse ReadingsDispatcher::dispatchBatch() {
         m_readingBuffer.getBatch();
     size_t batchSize = batch.size();
 
-    etl::string<json_config::max_json_size> payload =
-        JsonParser::composeSensorSnapshotGroup(batch, m_sensorUnitId);
+    SnapshotGroupBody body(batch, m_sensorUnitId);
 
     LOG_INFO(TAG, "Dispatching batch with %zu readings", batchSize);
-    RestResponse restResponse = m_restClient.postTo("/readings", payload);
+    RestResponse restResponse = m_restClient.postTo("/readings", body);
     DispatchResponse response { restResponse.status, true } ;
 
     if (restResponse.status != 200) {
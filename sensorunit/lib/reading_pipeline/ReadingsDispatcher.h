@@ -4,6 +4,10 @@
  * @brief Class for dispatching batches of sensor readings
  * from the Reading buffer and sending them through Rest Client
  *
+ * A dispatch is a small state machine driven from loop(). start() begins
+ * a dispatch and every step() posts at most one batch, so readings are
+ * still taken on time while a long backlog drains, one batch per loop.
+ *
  * @date 2025-10-24
  *
  * @copyright Copyright (c) 2025 Erik Dahl
@@ -34,15 +38,31 @@ class ReadingsDispatcher : public IReadingsDispatcher {
                        ReadingBuffer& readingBuffer,
                        const char*    sensorUnitId = SENSOR_UNIT_ID);
     /**
-     * @brief Function for dispatching sensor readings
+     * @brief Starts dispatching the readings in the buffer
+     * Does nothing if a dispatch is already running
+     */
+    void start() override;
+    /**
+     * @brief Posts the next batch of a running dispatch
      * Max batch size is set in ReadingBuffer.h
-     * If buffer is larger than that dispatch will POST
-     * several batches of max_batch_size until buffer is empty
+     * The dispatch continues with the next step until the buffer is empty,
+     * a POST fails or the control unit sends disconnected
      *
      * @returns false if response payload disconnected
      * @returns true otherwise
      */
-    bool dispatch() override;
+    bool step() override;
+    /**
+     * @brief Ends a running dispatch, e.g. when the upload window closes
+     * Readings not posted yet stay in the buffer for the next dispatch
+     */
+    void stop() override;
+    /**
+     * @brief Checks if a dispatch is running and step() should be called
+     *
+     * @return true between start() and the end of the dispatch
+     */
+    bool isDispatching() const override;
 
   private:
     /**
@@ -57,5 +77,7 @@ class ReadingsDispatcher : public IReadingsDispatcher {
     IRestClient&                 m_restClient;
     ReadingBuffer&               m_readingBuffer;
     const char*                  m_sensorUnitId;
-    static constexpr const char* TAG = "ReadingsDispatcher";
+    bool                         m_dispatching = false;
+    size_t                       m_batchesSent = 0; /**< Batches posted in this dispatch */
+    static constexpr const char* TAG           = "ReadingsDispatcher";
 };
\ No newline at end of file
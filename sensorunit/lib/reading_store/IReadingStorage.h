@@ -0,0 +1,57 @@
+/**
+ * @file IReadingStorage.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Interface to non-volatile memory for the reading backlog
+ *
+ * Has the semantics of flash: the memory is split into sectors that are
+ * erased as a whole, erased bytes read 0xFF and a byte is programmed once
+ * between erases. DataFlashReadingStorage implements it on the data flash of
+ * the RA4M1, RamReadingStorage in RAM for the native tests.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+class IReadingStorage {
+  public:
+    virtual ~IReadingStorage() = default;
+    /**
+     * @brief Size of the erase unit in bytes
+     */
+    virtual size_t sectorSize() const = 0;
+    /**
+     * @brief Number of sectors
+     */
+    virtual size_t sectorCount() const = 0;
+    /**
+     * @brief Reads bytes
+     *
+     * @param address Offset from the start of the storage
+     * @param data Destination
+     * @param size Number of bytes
+     * @return true if the bytes were read
+     */
+    virtual bool read(uint32_t address, void* data, size_t size) const = 0;
+    /**
+     * @brief Programs erased bytes
+     *
+     * @param address Offset from the start of the storage, a multiple of 8
+     * @param data Bytes to write
+     * @param size Number of bytes, a multiple of 8
+     * @return true if the bytes were written
+     */
+    virtual bool program(uint32_t address, const void* data, size_t size) = 0;
+    /**
+     * @brief Erases a sector to 0xFF
+     *
+     * @param sector Sector index
+     * @return true if the sector was erased
+     */
+    virtual bool erase(size_t sector) = 0;
+};
@@ -0,0 +1,93 @@
+/**
+ * @file PackedReading.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the packed reading conversions and bit layout
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "PackedReading.h"
+#include <math.h>
+
+using namespace packed_reading_config;
+
+/// Rounds value to the nearest integer within [low, high]
+static long roundClamped(double value, long low, long high) {
+    if (isnan(value)) {
+        return 0;
+    }
+    double rounded = round(value);
+    if (rounded < low) {
+        return low;
+    }
+    if (rounded > high) {
+        return high;
+    }
+    return static_cast<long>(rounded);
+}
+
+/// Writes the low count bits of value at bit position
+static void writeBits(uint8_t* bits, size_t position, uint8_t count, uint32_t value) {
+    while (count > 0) {
+        size_t  byte  = position / 8;
+        uint8_t shift = position % 8;
+        uint8_t taken = count < 8 - shift ? count : 8 - shift;
+        uint8_t mask  = static_cast<uint8_t>(((1u << taken) - 1) << shift);
+        bits[byte]    = static_cast<uint8_t>((bits[byte] & ~mask) | ((value << shift) & mask));
+        value >>= taken;
+        position += taken;
+        count -= taken;
+    }
+}
+
+/// Reads count bits at bit position
+static uint32_t readBits(const uint8_t* bits, size_t position, uint8_t count) {
+    uint32_t value = 0;
+    uint8_t  done  = 0;
+    while (done < count) {
+        size_t   byte  = position / 8;
+        uint8_t  shift = position % 8;
+        uint8_t  taken = count - done < 8 - shift ? count - done : 8 - shift;
+        uint32_t part  = (bits[byte] >> shift) & ((1u << taken) - 1);
+        value |= part << done;
+        position += taken;
+        done += taken;
+    }
+    return value;
+}
+
+PackedReading packReading(const CaSensorunitReading& reading, uint32_t epoch) {
+    int64_t offset = static_cast<int64_t>(reading.timestamp) - static_cast<int64_t>(epoch);
+    return {static_cast<int32_t>(roundClamped(static_cast<double>(offset), INT32_MIN, INT32_MAX)),
+            static_cast<int16_t>(roundClamped(reading.temperature * 100.0, INT16_MIN, INT16_MAX)),
+            static_cast<uint16_t>(roundClamped(reading.humidity * 10.0, 0, max_deci_percent))};
+}
+
+CaSensorunitReading unpackReading(const PackedReading& packed, uint32_t epoch) {
+    return {static_cast<time_t>(static_cast<int64_t>(epoch) + packed.timeOffset),
+            packed.centiDegrees / 100.0,
+            packed.deciPercent / 10.0};
+}
+
+void storePackedReading(uint8_t* bits, size_t slot, const PackedReading& packed) {
+    size_t position = slot * record_bits;
+    writeBits(bits, position, time_bits, static_cast<uint32_t>(packed.timeOffset));
+    position += time_bits;
+    writeBits(bits, position, temperature_bits, static_cast<uint16_t>(packed.centiDegrees));
+    position += temperature_bits;
+    writeBits(bits, position, humidity_bits, packed.deciPercent);
+}
+
+PackedReading loadPackedReading(const uint8_t* bits, size_t slot) {
+    size_t        position = slot * record_bits;
+    PackedReading packed;
+    packed.timeOffset = static_cast<int32_t>(readBits(bits, position, time_bits));
+    position += time_bits;
+    packed.centiDegrees = static_cast<int16_t>(readBits(bits, position, temperature_bits));
+    position += temperature_bits;
+    packed.deciPercent = static_cast<uint16_t>(readBits(bits, position, humidity_bits));
+    return packed;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file PackedReading.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Compact record of a reading and its bit-packed layout
+ *
+ * A CaSensorunitReading takes 24 bytes, a time_t and two doubles. Stored
+ * readings are kept as 58 bit records instead:
+ *
+ * | Bits | Field |
+ * | --- | --- |
+ * | 32 | seconds from an epoch, signed |
+ * | 16 | temperature in hundredths of a degree, signed |
+ * | 10 | humidity in tenths of a percent, 0 to 1000 |
+ *
+ * Records are written back to back, least significant bit first, without
+ * padding. Has no Arduino dependencies and is tested in the native environment.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "sensor_data_types.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Bit widths of the packed record
+ *
+ */
+namespace packed_reading_config {
+constexpr uint8_t  time_bits        = 32;
+constexpr uint8_t  temperature_bits = 16;
+constexpr uint8_t  humidity_bits    = 10;
+constexpr size_t   record_bits      = time_bits + temperature_bits + humidity_bits;
+constexpr uint16_t max_deci_percent = 1000;
+} // namespace packed_reading_config
+
+/**
+ * @brief A reading in the units it is stored in
+ */
+struct PackedReading {
+    int32_t  timeOffset;   /**< Seconds from the epoch of the store */
+    int16_t  centiDegrees; /**< Temperature, 22.5 °C is 2250 */
+    uint16_t deciPercent;  /**< Humidity, 45.2 % is 452 */
+};
+
+/**
+ * @brief Converts a reading to the stored units, rounded and clamped to the field range
+ *
+ * @param reading Reading from the sensor
+ * @param epoch Unix time the offset counts from
+ * @return PackedReading
+ */
+PackedReading packReading(const CaSensorunitReading& reading, uint32_t epoch);
+
+/**
+ * @brief Converts a stored reading back, done when readings are dispatched
+ *
+ * @param packed Stored reading
+ * @param epoch Unix time the offset counts from
+ * @return CaSensorunitReading
+ */
+CaSensorunitReading unpackReading(const PackedReading& packed, uint32_t epoch);
+
+/**
+ * @brief Writes a record into slot of a bit-packed array
+ *
+ * @param bits Array of at least (slot + 1) * record_bits bits
+ * @param slot Record index
+ * @param packed Record to write
+ */
+void storePackedReading(uint8_t* bits, size_t slot, const PackedReading& packed);
+
+/**
+ * @brief Reads the record in slot of a bit-packed array
+ *
+ * @param bits Array written by storePackedReading
+ * @param slot Record index
+ * @return PackedReading
+ */
+PackedReading loadPackedReading(const uint8_t* bits, size_t slot);
@@ -0,0 +1,79 @@
+/**
+ * @file PackedReadingRing.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Circular store of bit-packed reading records
+ *
+ * Holds Capacity records of packed_reading_config::record_bits each in one
+ * byte array, 256 readings take 1856 bytes where CaSensorunitReading would
+ * take 6144.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "PackedReading.h"
+
+template <size_t Capacity> class PackedReadingRing {
+  public:
+    /**
+     * @brief Adds a record after the newest
+     *
+     * @param packed Record to add
+     * @return false if the ring is full, pop() first to overwrite the oldest
+     */
+    bool push(const PackedReading& packed) {
+        if (full()) {
+            return false;
+        }
+        storePackedReading(m_bits, (m_head + m_size) % Capacity, packed);
+        ++m_size;
+        return true;
+    }
+
+    /**
+     * @brief Record at index, 0 is the oldest
+     *
+     * @param index Less than size()
+     * @return PackedReading
+     */
+    PackedReading at(size_t index) const {
+        return loadPackedReading(m_bits, (m_head + index) % Capacity);
+    }
+
+    /**
+     * @brief Removes the oldest record
+     */
+    void pop() {
+        if (m_size > 0) {
+            m_head = (m_head + 1) % Capacity;
+            --m_size;
+        }
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+    bool empty() const {
+        return m_size == 0;
+    }
+    bool full() const {
+        return m_size == Capacity;
+    }
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+    /**
+     * @brief RAM used for the records
+     */
+    static constexpr size_t storageBytes() {
+        return sizeof(m_bits);
+    }
+
+  private:
+    uint8_t m_bits[(Capacity * packed_reading_config::record_bits + 7) / 8] = {};
+    size_t  m_head                                                          = 0;
+    size_t  m_size                                                          = 0;
+};
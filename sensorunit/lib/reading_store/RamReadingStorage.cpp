@@ -0,0 +1,45 @@
+/**
+ * @file RamReadingStorage.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the RAM backed reading storage
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "RamReadingStorage.h"
+#include <string.h>
+
+RamReadingStorage::RamReadingStorage(uint8_t* memory, size_t sectorSize, size_t sectorCount)
+    : m_memory{memory}, m_sectorSize{sectorSize}, m_sectorCount{sectorCount} {}
+
+bool RamReadingStorage::read(uint32_t address, void* data, size_t size) const {
+    if (address + size > m_sectorSize * m_sectorCount) {
+        return false;
+    }
+    memcpy(data, &m_memory[address], size);
+    return true;
+}
+
+bool RamReadingStorage::program(uint32_t address, const void* data, size_t size) {
+    if (address + size > m_sectorSize * m_sectorCount || address % 8 != 0 || size % 8 != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if (m_memory[address + i] != 0xFF) {
+            return false;
+        }
+    }
+    memcpy(&m_memory[address], data, size);
+    return true;
+}
+
+bool RamReadingStorage::erase(size_t sector) {
+    if (sector >= m_sectorCount) {
+        return false;
+    }
+    memset(&m_memory[sector * m_sectorSize], 0xFF, m_sectorSize);
+    return true;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file RamReadingStorage.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief IReadingStorage in caller owned RAM, used by the native tests
+ *
+ * Behaves like flash: programming a byte that is not erased fails, so a test
+ * catches a backlog that writes twice between erases. A reset is simulated by
+ * starting a new ReadingBacklog on the same memory.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "IReadingStorage.h"
+
+class RamReadingStorage : public IReadingStorage {
+  public:
+    /**
+     * @brief Constructs a storage on memory, which is used as it is
+     *
+     * @param memory sectorSize * sectorCount bytes, 0xFF when erased
+     * @param sectorSize Erase unit in bytes
+     * @param sectorCount Number of sectors
+     */
+    RamReadingStorage(uint8_t* memory, size_t sectorSize, size_t sectorCount);
+
+    size_t sectorSize() const override {
+        return m_sectorSize;
+    }
+    size_t sectorCount() const override {
+        return m_sectorCount;
+    }
+    bool read(uint32_t address, void* data, size_t size) const override;
+    bool program(uint32_t address, const void* data, size_t size) override;
+    bool erase(size_t sector) override;
+
+  private:
+    uint8_t* m_memory;
+    size_t   m_sectorSize;
+    size_t   m_sectorCount;
+};
@@ -0,0 +1,264 @@
+/**
+ * @file ReadingBacklog.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the non-volatile reading log
+ *
+ * Reading i of the log is the i-th reading record counted from the sector
+ * whose header has first index i - n. An ack record holds the index of the
+ * first reading not dispatched, so the last ack in the log tells where the
+ * pending readings start. Records that are neither, e.g. one cut by a reset
+ * while it was written, are skipped.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "ReadingBacklog.h"
+#include "PackedReading.h"
+
+using namespace backlog_config;
+
+static constexpr uint32_t erased       = 0xFFFFFFFF;
+static constexpr uint32_t type_shift   = 26;
+static constexpr uint32_t type_reading = 0x01;
+static constexpr uint32_t type_ack     = 0x02;
+
+static uint32_t recordType(const uint32_t (&words)[2]) {
+    return words[1] >> type_shift;
+}
+
+ReadingBacklog::ReadingBacklog(IReadingStorage& storage) : m_storage{storage} {}
+
+bool ReadingBacklog::begin() {
+    size_t sectors = m_storage.sectorCount();
+    size_t size    = m_storage.sectorSize();
+    m_ready        = false;
+    m_started      = false;
+    m_slots        = size > header_size ? (size - header_size) / record_size : 0;
+    if (sectors < 2 || m_slots == 0) {
+        return false;
+    }
+
+    bool     found  = false;
+    uint32_t newest = 0;
+    for (size_t sector = 0; sector < sectors; ++sector) {
+        uint32_t header[header_size / 4];
+        if (!m_storage.read(sector * size, header, header_size)) {
+            return false;
+        }
+        if (header[0] == sector_magic && header[1] % sectors == sector &&
+            (!found || header[1] > newest)) {
+            newest = header[1];
+            found  = true;
+        }
+    }
+    m_cursor    = {0, 0};
+    m_nextIndex = 0;
+    m_ackIndex  = 0;
+    m_ready     = true;
+    if (!found) {
+        return true;
+    }
+
+    // Sectors before the newest are still in the log until one is missing
+    uint32_t newestFirst = 0;
+    readHeader(newest, newestFirst);
+    uint32_t oldest      = newest;
+    uint32_t oldestFirst = newestFirst;
+    uint32_t first;
+    while (oldest > 0 && newest - (oldest - 1) < sectors && readHeader(oldest - 1, first)) {
+        --oldest;
+        oldestFirst = first;
+    }
+
+    m_started      = true;
+    m_headSequence = newest;
+    m_headSlot     = m_slots;
+    uint32_t readings = 0;
+    bool     ackFound = false;
+    uint32_t ack      = 0;
+    for (size_t slot = 0; slot < m_slots; ++slot) {
+        uint32_t words[2];
+        if (!readRecord({newest, slot}, words)) {
+            return false;
+        }
+        if (words[0] == erased && words[1] == erased) {
+            m_headSlot = slot;
+            break;
+        }
+        if (recordType(words) == type_reading) {
+            ++readings;
+        } else if (recordType(words) == type_ack) {
+            ack      = words[0];
+            ackFound = true;
+        }
+    }
+    m_nextIndex = newestFirst + readings;
+
+    for (uint32_t sequence = newest; !ackFound && sequence-- > oldest;) {
+        for (size_t slot = 0; slot < m_slots; ++slot) {
+            uint32_t words[2];
+            if (readRecord({sequence, slot}, words) && recordType(words) == type_ack) {
+                ack      = words[0];
+                ackFound = true;
+            }
+        }
+    }
+    m_ackIndex = oldestFirst;
+    if (ackFound && ack > oldestFirst) {
+        m_ackIndex = ack < m_nextIndex ? ack : m_nextIndex;
+    }
+    m_cursor = {oldest, 0};
+    skipReadings(m_cursor, m_ackIndex - oldestFirst);
+    return true;
+}
+
+bool ReadingBacklog::append(const CaSensorunitReading* readings, size_t count) {
+    if (!m_ready) {
+        return false;
+    }
+    for (size_t done = 0; done < count;) {
+        uint32_t words[write_block * 2];
+        size_t   block = count - done < write_block ? count - done : write_block;
+        for (size_t i = 0; i < block; ++i) {
+            PackedReading packed = packReading(readings[done + i], 0);
+            words[i * 2]         = static_cast<uint32_t>(packed.timeOffset);
+            words[i * 2 + 1]     = static_cast<uint16_t>(packed.centiDegrees) |
+                               static_cast<uint32_t>(packed.deciPercent) << 16 |
+                               type_reading << type_shift;
+        }
+        if (!write(words, block, true)) {
+            return false;
+        }
+        done += block;
+    }
+    return true;
+}
+
+size_t ReadingBacklog::read(CaSensorunitReading* out, size_t maxCount) const {
+    size_t   wanted = maxCount < pending() ? maxCount : pending();
+    size_t   count  = 0;
+    Position position = m_cursor;
+    while (count < wanted && !atHead(position)) {
+        if (position.slot == m_slots) {
+            position = {position.sequence + 1, 0};
+            continue;
+        }
+        uint32_t words[2];
+        if (readRecord(position, words) && recordType(words) == type_reading) {
+            PackedReading packed{static_cast<int32_t>(words[0]),
+                                 static_cast<int16_t>(words[1] & 0xFFFF),
+                                 static_cast<uint16_t>((words[1] >> 16) & 0x3FF)};
+            out[count++] = unpackReading(packed, 0);
+        }
+        ++position.slot;
+    }
+    return count;
+}
+
+bool ReadingBacklog::acknowledge(size_t count) {
+    if (!m_ready) {
+        return false;
+    }
+    count = count < pending() ? count : pending();
+    if (count == 0) {
+        return true;
+    }
+    skipReadings(m_cursor, count);
+    m_ackIndex += count;
+    uint32_t words[2] = {m_ackIndex, type_ack << type_shift};
+    return write(words, 1, false);
+}
+
+uint32_t ReadingBacklog::address(const Position& position) const {
+    return (position.sequence % m_storage.sectorCount()) * m_storage.sectorSize() + header_size +
+           position.slot * record_size;
+}
+
+bool ReadingBacklog::readRecord(const Position& position, uint32_t (&words)[2]) const {
+    return m_storage.read(address(position), words, record_size);
+}
+
+bool ReadingBacklog::atHead(const Position& position) const {
+    return !m_started || position.sequence > m_headSequence ||
+           (position.sequence == m_headSequence && position.slot >= m_headSlot);
+}
+
+void ReadingBacklog::skipReadings(Position& position, size_t count) const {
+    while (!atHead(position)) {
+        if (position.slot == m_slots) {
+            position = {position.sequence + 1, 0};
+            continue;
+        }
+        uint32_t words[2];
+        if (readRecord(position, words) && recordType(words) == type_reading) {
+            if (count == 0) {
+                return;
+            }
+            --count;
+        }
+        ++position.slot;
+    }
+}
+
+bool ReadingBacklog::readHeader(uint32_t sequence, uint32_t& firstIndex) const {
+    uint32_t header[header_size / 4];
+    if (!m_storage.read((sequence % m_storage.sectorCount()) * m_storage.sectorSize(),
+                        header,
+                        header_size) ||
+        header[0] != sector_magic || header[1] != sequence) {
+        return false;
+    }
+    firstIndex = header[2];
+    return true;
+}
+
+bool ReadingBacklog::startSector() {
+    uint32_t sequence = m_started ? m_headSequence + 1 : 0;
+    size_t   sectors  = m_storage.sectorCount();
+    if (sequence >= sectors && m_cursor.sequence <= sequence - sectors) {
+        // The oldest sector is reused, its pending readings are lost
+        uint32_t oldest = static_cast<uint32_t>(sequence - sectors + 1);
+        uint32_t firstIndex;
+        if (readHeader(oldest, firstIndex) && firstIndex > m_ackIndex) {
+            m_lost += firstIndex - m_ackIndex;
+            m_ackIndex = firstIndex;
+        }
+        m_cursor = {oldest, 0};
+    }
+
+    size_t   sector = sequence % sectors;
+    uint32_t header[header_size / 4] = {sector_magic, sequence, m_nextIndex, erased};
+    if (!m_storage.erase(sector) ||
+        !m_storage.program(sector * m_storage.sectorSize(), header, header_size)) {
+        m_ready = false;
+        return false;
+    }
+    m_started      = true;
+    m_headSequence = sequence;
+    m_headSlot     = 0;
+    return true;
+}
+
+bool ReadingBacklog::write(const uint32_t* words, size_t records, bool readings) {
+    for (size_t done = 0; done < records;) {
+        if ((!m_started || m_headSlot == m_slots) && !startSector()) {
+            return false;
+        }
+        size_t room  = m_slots - m_headSlot;
+        size_t block = records - done < room ? records - done : room;
+        if (!m_storage.program(
+                address({m_headSequence, m_headSlot}), &words[done * 2], block * record_size)) {
+            m_ready = false;
+            return false;
+        }
+        m_headSlot += block;
+        done += block;
+        if (readings) {
+            m_nextIndex += block;
+        }
+    }
+    return true;
+}
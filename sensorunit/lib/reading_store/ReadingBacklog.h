@@ -0,0 +1,142 @@
+/**
+ * @file ReadingBacklog.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Log of readings in non-volatile storage that survives resets
+ *
+ * The storage is written as a circular log. Every sector starts with a
+ * header, followed by 8 byte records:
+ *
+ * | Bytes | Header field |
+ * | --- | --- |
+ * | 4 | magic "RDLG" |
+ * | 4 | sequence, counts every sector started, the sector is sequence % count |
+ * | 4 | index of the first reading appended to the sector |
+ * | 4 | unused, 0xFFFFFFFF |
+ *
+ * | Bits | Record field |
+ * | --- | --- |
+ * | 32 | reading: Unix time, ack: index of the first reading not dispatched |
+ * | 16 | reading: temperature in hundredths of a degree, signed |
+ * | 10 | reading: humidity in tenths of a percent |
+ * | 6 | type, 0x3F is erased |
+ *
+ * Readings and acks are only appended. When the log reaches the end of a
+ * sector it erases the next one, so all sectors are erased equally often and
+ * the oldest readings are overwritten once the storage is full. begin()
+ * finds the newest sector and the last ack again after a reset.
+ *
+ * Has no Arduino dependencies and is tested in the native environment.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "IReadingStorage.h"
+#include "sensor_data_types.h"
+
+/**
+ * @brief Layout of the log
+ *
+ */
+namespace backlog_config {
+constexpr uint32_t sector_magic = 0x474C4452; // "RDLG" in little endian
+constexpr size_t   header_size  = 16;
+constexpr size_t   record_size  = 8;
+constexpr size_t   write_block  = 8; // Records per program() call
+} // namespace backlog_config
+
+class ReadingBacklog {
+  public:
+    /**
+     * @brief Constructs a backlog on storage, begin() reads what is in it
+     *
+     * @param storage At least two sectors
+     */
+    explicit ReadingBacklog(IReadingStorage& storage);
+
+    /**
+     * @brief Finds the readings that were not acknowledged before the reset
+     *
+     * Reads the sector headers and the records of the newest sector, the
+     * readings themselves stay in the storage until read().
+     *
+     * @return false if the storage cannot be used
+     */
+    bool begin();
+
+    /**
+     * @brief Appends readings after the newest
+     *
+     * @param readings Readings, oldest first
+     * @param count Number of readings
+     * @return false if the storage failed, the backlog then stops writing
+     */
+    bool append(const CaSensorunitReading* readings, size_t count);
+
+    /**
+     * @brief Reads the oldest readings not acknowledged, without removing them
+     *
+     * @param out Destination
+     * @param maxCount Most readings to read
+     * @return size_t Readings read
+     */
+    size_t read(CaSensorunitReading* out, size_t maxCount) const;
+
+    /**
+     * @brief Marks the oldest readings as dispatched, persisted with an ack record
+     *
+     * @param count Readings dispatched, at most pending()
+     * @return false if the ack could not be written
+     */
+    bool acknowledge(size_t count);
+
+    /**
+     * @brief Readings appended and not acknowledged
+     */
+    size_t pending() const {
+        return m_nextIndex - m_ackIndex;
+    }
+
+    /**
+     * @brief Readings overwritten before they were acknowledged
+     */
+    uint32_t lost() const {
+        return m_lost;
+    }
+
+    /**
+     * @brief Readings that fit without overwriting any, 0 before begin()
+     */
+    size_t capacity() const {
+        return m_ready ? (m_storage.sectorCount() - 1) * m_slots : 0;
+    }
+
+  private:
+    /// A record slot in the log
+    struct Position {
+        uint32_t sequence;
+        size_t   slot;
+    };
+
+    uint32_t address(const Position& position) const;
+    bool     readRecord(const Position& position, uint32_t (&words)[2]) const;
+    bool     atHead(const Position& position) const;
+    void     skipReadings(Position& position, size_t count) const;
+    bool     readHeader(uint32_t sequence, uint32_t& firstIndex) const;
+    bool     startSector();
+    bool     write(const uint32_t* words, size_t records, bool readings);
+
+    IReadingStorage& m_storage;
+    size_t           m_slots        = 0; /**< Records per sector */
+    bool             m_ready        = false;
+    bool             m_started      = false; /**< A sector has been written */
+    uint32_t         m_headSequence = 0;
+    size_t           m_headSlot     = 0; /**< Next slot to write in the head sector */
+    Position         m_cursor{};         /**< At or before the oldest pending reading */
+    uint32_t         m_nextIndex = 0;    /**< Index of the next reading appended */
+    uint32_t         m_ackIndex  = 0;    /**< Index of the oldest pending reading */
+    uint32_t         m_lost      = 0;
+};
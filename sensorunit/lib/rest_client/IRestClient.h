@@ -10,6 +10,7 @@
  */
 #pragma once
 #include "constants.h"
+#include <Print.h>
 #include <etl/string.h>
 
 /**
@@ -48,14 +49,28 @@ struct RestResponse {
     etl::string<json_config::max_small_json_size> payload;
 };
 
+/**
+ * @brief A request body written straight to the connection
+ *
+ * Nothing is built in RAM first. size() is a measuring pass for
+ * Content-Length, writeTo() must then write exactly that many bytes.
+ * writeTo() can be called again if the request is sent once more.
+ */
+class IRequestBody {
+  public:
+    virtual size_t size() const              = 0;
+    virtual size_t writeTo(Print& out) const = 0;
+    virtual ~IRequestBody()                  = default;
+};
+
 /**
  * @brief Interface for Rest Client
  *
  */
 class IRestClient {
   public:
-    virtual RestResponse getTo(const char* endpoint)                                   = 0;
-    virtual RestResponse postTo(const char*                                   endpoint,
-                                const etl::string<json_config::max_json_size> payload) = 0;
-    virtual ~IRestClient()                                                             = default;
+    virtual RestResponse getTo(const char* endpoint)                               = 0;
+    virtual RestResponse postTo(const char* endpoint, const etl::istring& payload) = 0;
+    virtual RestResponse postTo(const char* endpoint, const IRequestBody& body)    = 0;
+    virtual ~IRestClient()                                                         = default;
 };
\ No newline at end of file
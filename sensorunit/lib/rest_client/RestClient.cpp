@@ -9,143 +9,221 @@
  * 
  */
 #include "RestClient.h"
+#include "HttpResponseParser.h"
 #include "logging.h"
 
-RestClient::RestClient(const char*   baseUrl,
-                       uint16_t      port,
-                       const char*   jwtToken,
-                       unsigned long timeoutMs)
-    : m_baseUrl{baseUrl}, m_port{port}, m_jwtToken{jwtToken}, m_timeout{timeoutMs} {}
-
-RestResponse RestClient::getTo(const char* endpoint) {
+/**
+ * @brief Collects small writes into one block per write to the WiFi module
+ */
+class BlockPrint : public Print {
+  public:
+    explicit BlockPrint(Print& out) : m_out{out} {}
 
-    LOG_INFO(TAG, "Sending GET request to %s", endpoint);
-    // Open connection
-    if (!m_client.connect(m_baseUrl.c_str(), m_port)) {
-        LOG_ERROR(TAG, "Failed to connect to %s", m_baseUrl.c_str());
-        return {-1, ""};
+    size_t write(uint8_t byte) override {
+        return write(&byte, 1);
+    }
+    size_t write(const uint8_t* data, size_t size) override {
+        size_t written = 0;
+        while (written < size) {
+            size_t chunk = min(size - written, sizeof(m_block) - m_used);
+            memcpy(&m_block[m_used], data + written, chunk);
+            m_used += chunk;
+            written += chunk;
+            if (m_used == sizeof(m_block)) {
+                flushBlock();
+            }
+        }
+        return written;
+    }
+    /**
+     * @brief Writes what is collected, call after the last write
+     */
+    void flushBlock() {
+        if (m_used > 0) {
+            m_out.write(m_block, m_used);
+            m_used = 0;
+        }
     }
 
-    sendGetHeader(endpoint);
+  private:
+    Print&  m_out;
+    uint8_t m_block[256];
+    size_t  m_used = 0;
+};
 
-    RestResponse response = parseResponse();
+/**
+ * @brief An etl::string sent as the body
+ */
+class StringBody : public IRequestBody {
+  public:
+    explicit StringBody(const etl::istring& payload) : m_payload{payload} {}
+    size_t size() const override {
+        return m_payload.size();
+    }
+    size_t writeTo(Print& out) const override {
+        return out.write(reinterpret_cast<const uint8_t*>(m_payload.data()), m_payload.size());
+    }
 
-    LOG_INFO(TAG, "GET %s responded with status %d", endpoint, response.status);
+  private:
+    const etl::istring& m_payload;
+};
 
-    // Close connection
-    m_client.stop();
+RestClient::RestClient(const char*   baseUrl,
+                       uint16_t      port,
+                       const char*   jwtToken,
+                       unsigned long timeoutMs,
+                       bool          keepAlive)
+    : m_baseUrl{baseUrl}, m_port{port}, m_jwtToken{jwtToken}, m_timeout{timeoutMs},
+      m_keepAlive{keepAlive} {}
 
+RestResponse RestClient::getTo(const char* endpoint) {
+    LOG_INFO(TAG, "Sending GET request to %s", endpoint);
+    RestResponse response = request("GET", endpoint, nullptr);
+    LOG_INFO(TAG, "GET %s responded with status %d", endpoint, response.status);
     return response;
 }
 
+RestResponse RestClient::postTo(const char* endpoint, const etl::istring& payload) {
+    return postTo(endpoint, StringBody(payload));
+}
 
-RestResponse RestClient::postTo(const char*                                   endpoint,
-                                const etl::string<json_config::max_json_size> payload) {
-    
+RestResponse RestClient::postTo(const char* endpoint, const IRequestBody& body) {
     LOG_INFO(TAG, "Sending POST request to %s", endpoint);
-    // Open connection
-    if (!m_client.connect(m_baseUrl.c_str(), m_port)) {
-        LOG_ERROR(TAG, "Failed to connect to %s", m_baseUrl.c_str());
-        return {-1, ""};
-    }
-
-    // Send
-    uint16_t contentLength = payload.size();
-    sendPostHeader(endpoint, contentLength);
-    m_client.print(payload.c_str());
-
-    // Get response
-    RestResponse response = parseResponse();
+    RestResponse response = request("POST", endpoint, &body);
     LOG_INFO(TAG, "POST %s responded with status %d", endpoint, response.status);
+    return response;
+}
 
-    // Close connection
+void RestClient::close() {
     m_client.stop();
+}
 
-    return response;
+void RestClient::setLinkQuality(LinkQuality* linkQuality) {
+    m_linkQuality = linkQuality;
 }
 
-int RestClient::extractStatusCode(const etl::string<128>& statusLine) {
-    int protocolEnd   = statusLine.find(' ');
-    int statusCodeEnd = statusLine.find(' ', protocolEnd + 1);
-    if (protocolEnd != etl::string<128>::npos && statusCodeEnd != etl::string<128>::npos) {
-        auto codeStr = statusLine.substr(protocolEnd + 1, statusCodeEnd - protocolEnd - 1);
-        return atoi(codeStr.c_str());
+RestResponse RestClient::request(const char*         method,
+                                 const char*         endpoint,
+                                 const IRequestBody* body) {
+    unsigned long start    = millis();
+    RestResponse  response = exchange(method, endpoint, body);
+    if (m_linkQuality != nullptr) {
+        // Any HTTP answer made it over the link, also an error status
+        bool delivered = response.status != RestClientStatus::WifiNotConnected &&
+                         response.status != RestClientStatus::Timeout &&
+                         response.status != RestClientStatus::RequestFailed &&
+                         response.status != RestClientStatus::InvalidResponse;
+        m_linkQuality->addRequest(delivered, millis() - start);
     }
-    return -1;
+    return response;
 }
 
-void RestClient::sendGetHeader(const char* endpoint) {
-    m_client.print("GET ");
-    m_client.print(endpoint);
-    m_client.println(" HTTP/1.1");
-
-    m_client.print("Host: ");
-    m_client.println(m_baseUrl.c_str());
+RestResponse RestClient::exchange(const char*         method,
+                                  const char*         endpoint,
+                                  const IRequestBody* body) {
+    // Measuring pass, the body is not kept in RAM
+    long contentLength = body != nullptr ? static_cast<long>(body->size()) : -1;
+    bool reused        = m_keepAlive && m_client.connected();
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (!reused) {
+            // Open connection
+            m_client.stop();
+            if (!m_client.connect(m_baseUrl.c_str(), m_port)) {
+                LOG_ERROR(TAG, "Failed to connect to %s", m_baseUrl.c_str());
+                return {RestClientStatus::WifiNotConnected, ""};
+            }
+        }
 
-    m_client.println("Connection: close");
-    m_client.println(); /// Empty line ends header
+        BlockPrint out(m_client);
+        writeHeader(out, method, endpoint, contentLength);
+        if (body != nullptr) {
+            size_t written = body->writeTo(out);
+            if (static_cast<long>(written) != contentLength) {
+                // The server would wait for the rest or read it as the next request
+                LOG_ERROR(TAG, "Body of %zu bytes, measured %ld", written, contentLength);
+                m_client.stop();
+                return {RestClientStatus::ClientSideError, ""};
+            }
+        }
+        out.flushBlock();
+        RestResponse response = parseResponse();
+
+        // Nothing at all on a reused connection, the server closed it while idle
+        if (reused && response.status == RestClientStatus::RequestFailed) {
+            LOG_DEBUG(TAG, "Kept-alive connection closed by server, reconnecting");
+            reused = false;
+            continue;
+        }
+        if (!m_keepAlive) {
+            // Close connection
+            m_client.stop();
+        }
+        return response;
+    }
+    return {RestClientStatus::RequestFailed, ""};
 }
 
-void RestClient::sendPostHeader(const char* endpoint, uint16_t contentLength) {
-    m_client.print("POST ");
-    m_client.print(endpoint);
-    m_client.println(" HTTP/1.1");
-
-    m_client.print("Host: ");
-    m_client.println(m_baseUrl.c_str());
-
-    m_client.println("Content-Type: application/json");
-
-    m_client.print("Content-Length: ");
-    m_client.println(contentLength);
+void RestClient::writeHeader(Print&      out,
+                             const char* method,
+                             const char* endpoint,
+                             long        contentLength) {
+    out.print(method);
+    out.print(' ');
+    out.print(endpoint);
+    out.print(" HTTP/1.1\r\n");
+
+    out.print("Host: ");
+    out.print(m_baseUrl.c_str());
+    out.print("\r\n");
+
+    if (contentLength >= 0) {
+        out.print("Content-Type: application/json\r\n");
+        out.print("Content-Length: ");
+        out.print(contentLength);
+        out.print("\r\n");
+    }
 
-    m_client.println("Connection: close");
-    m_client.println(); /// Empty line ends header
+    out.print("Connection: ");
+    out.print(m_keepAlive ? "keep-alive" : "close");
+    out.print("\r\n\r\n"); /// Empty line ends header
 }
 
 RestResponse RestClient::parseResponse() {
-    RestResponse                                   response;
-    int                                            statusCode{};
-    etl::string<json_config::max_header_line_size> headerLine;
-    etl::string<json_config::max_small_json_size>  body;
-    bool                                           headersEnded = false;
-    unsigned long                                  start        = millis();
-
-    while (m_client.connected() && (millis() - start < m_timeout)) {
-        while (m_client.available()) {
-            char c = m_client.read();
-
-            if (!headersEnded) {
-                if (c == '\n') {
-                    if (headerLine.ends_with("\r"))
-                        headerLine.pop_back();
-                    if (headerLine.empty()) {
-                        headersEnded = true;
-                    } else if (headerLine.starts_with("HTTP/1.")) {
-                        statusCode = extractStatusCode(headerLine);
-                    }
-                    headerLine.clear();
-                } else {
-                    if (!headerLine.full())
-                        headerLine.push_back(c);
-                }
-            } else {
-                if (!body.full()) {
-                    body.push_back(c);                    
-                } else {
-                    LOG_WARN(TAG, "Response body exceeding max size: %d", json_config::max_small_json_size);
-                    break;
-                }
-            }
+    RestResponse       response{0, ""};
+    HttpResponseParser parser(response.payload);
+    unsigned long      start = millis();
+
+    while (!parser.done() && millis() - start < m_timeout) {
+        if (parser.readAvailable(m_client) > 0) {
+            continue;
+        }
+        if (!m_client.connected()) {
+            parser.finish();
+            break;
         }
+        // Nothing yet, give the WiFi module a moment instead of polling it flat out
+        delay(1);
     }
 
-    response.payload = body;
-    if (body.full()) {
-        response.status = -6;        
+    if (parser.received() == 0) {
+        bool timedOut   = millis() - start >= m_timeout;
+        response.status = timedOut ? RestClientStatus::Timeout : RestClientStatus::RequestFailed;
+    } else if (!parser.done()) {
+        LOG_WARN(TAG, "Incomplete response after %lu ms", millis() - start);
+        response.status = RestClientStatus::Timeout;
+    } else if (parser.state() == HttpResponseParser::State::Failed) {
+        LOG_WARN(TAG, "Invalid or truncated response");
+        response.status = RestClientStatus::InvalidResponse;
+    } else if (parser.overflow()) {
+        // The rest of the body was read and dropped, the connection stays in step
+        LOG_WARN(TAG, "Response body exceeding max size: %d", json_config::max_small_json_size);
+        response.status = RestClientStatus::BodyOverflow;
     } else {
-        response.status  = statusCode;
+        response.status = parser.status();
+    }
+
+    if (!parser.keepAlive()) {
+        m_client.stop();
     }
     return response;
 }
-
@@ -2,6 +2,20 @@
  * @file RestClient.h
  * @author Erik Dahl (erik@iunderlandet.se)
  * @brief Lightweight Rest Client for sending GET and POST requests
+ *
+ * In keep-alive mode one TCP connection to the Control Unit is used for all
+ * requests. A response is read up to its Content-Length, so the next request
+ * can follow on the same connection without waiting for the server to close
+ * it. The connection is closed after a response that is incomplete or has
+ * "Connection: close". When the server has closed an idle connection the
+ * request is sent once more on a new one.
+ *
+ * Header and body are collected into blocks before they are written, since
+ * every write to the WiFi module is a round trip.
+ *
+ * With setLinkQuality() the time and outcome of every request are added to
+ * the link quality, which ConnectionManager uses to decide on roaming.
+ *
  * @date 2025-10-15
  *
  * @copyright Copyright (c) 2025 Erik Dahl
@@ -10,15 +24,27 @@
  */
 #pragma once
 #include "IRestClient.h"
+#include "LinkQuality.h"
 #include <WiFiClient.h>
 #include <WiFiS3.h>
 
 class RestClient : public IRestClient {
   public:
+    /**
+     * @brief Constructs a RestClient
+     *
+     * @param baseUrl Host of the server, example: "192.168.4.1"
+     * @param port Port of the server
+     * @param jwtToken Token for the Authorization header
+     * @param timeoutMs Timeout for one request in milliseconds
+     * @param keepAlive true to reuse the connection between requests,
+     * false to open and close a connection per request
+     */
     explicit RestClient(const char*   baseUrl,
                         uint16_t      port      = 8080,
                         const char*   jwtToken  = "currently_not_used",
-                        unsigned long timeoutMs = 5000);
+                        unsigned long timeoutMs = 5000,
+                        bool          keepAlive = true);
 
     /**
      * @brief Send GET request to the server
@@ -35,18 +61,47 @@ class RestClient : public IRestClient {
      * @param payload a formated json string
      * @return RestResponse struct with status and payload
      */
-    RestResponse postTo(const char*                                   endpoint,
-                        const etl::string<json_config::max_json_size> payload) override;
+    RestResponse postTo(const char* endpoint, const etl::istring& payload) override;
+
+    /**
+     * @brief Send POST request with a body written straight to the connection
+     *
+     * @param endpoint should include slash, example: "/readings"
+     * @param body measured for Content-Length, then written in blocks
+     * @return RestResponse struct with status and payload
+     */
+    RestResponse postTo(const char* endpoint, const IRequestBody& body) override;
+
+    /**
+     * @brief Closes a kept-alive connection, e.g. before WiFi is disconnected
+     */
+    void close();
+
+    /**
+     * @brief Adds every request to linkQuality from now on
+     *
+     * @param linkQuality Quality of the current link, nullptr stops it
+     */
+    void setLinkQuality(LinkQuality* linkQuality);
 
   private:
+    RestResponse                 request(const char*         method,
+                                         const char*         endpoint,
+                                         const IRequestBody* body);
+    RestResponse                 exchange(const char*         method,
+                                          const char*         endpoint,
+                                          const IRequestBody* body);
     RestResponse                 parseResponse();
-    static int                   extractStatusCode(const etl::string<128>& statusLine);
-    void                         sendGetHeader(const char* endpoint);
-    void                         sendPostHeader(const char* endpoint, uint16_t contentLength);
+    void                         writeHeader(Print&      out,
+                                             const char* method,
+                                             const char* endpoint,
+                                             long        contentLength);
     etl::string<32>              m_baseUrl;
     uint16_t                     m_port;
     etl::string<64>              m_jwtToken;
     unsigned long                m_timeout; /**< Timeout for HTTP requests in milliseconds. */
+    bool                         m_keepAlive;
     WiFiClient                   m_client;
+    LinkQuality*                 m_linkQuality{nullptr};
     static constexpr const char* TAG = "RestClient";
-};
\ No newline at end of file
+};
@@ -10,6 +10,8 @@
  * 
  */
 #pragma once
+#include "communication_data_types.h"
+#include <stdint.h>
 
 /**
  * @brief Represents the result of a scheduler tick with trigger flags.
@@ -32,5 +34,25 @@ class IScheduler {
      * @return A SchedulerResult containing trigger flags.
      */
     virtual SchedulerResult tick(bool isPaired) = 0;
+    /**
+     * @brief Time until the next trigger, for the main loop to wait instead of spinning.
+     * @return Milliseconds, 0 if a trigger is due.
+     */
+    virtual uint32_t msUntilNextEvent() = 0;
+    /**
+     * @brief Moves dispatch and resync into the upload window from the Control Unit.
+     * @param slot Upload window, periodSec 0 for the intervals of the unit.
+     */
+    virtual void setUploadSlot(const UploadSlot& slot) = 0;
+    /**
+     * @brief Checks if the unit may use the access point now.
+     * @return true within the upload window, or always without one.
+     */
+    virtual bool inUploadWindow() = 0;
+    /**
+     * @brief Time left in the upload window, to bound what is done in it.
+     * @return Milliseconds, 0 outside the window, UINT32_MAX without one.
+     */
+    virtual uint32_t msLeftInUploadWindow() = 0;
     virtual ~IScheduler() = default;
 };
\ No newline at end of file
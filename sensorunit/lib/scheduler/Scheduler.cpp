@@ -20,27 +20,48 @@
 #include "Arduino.h"
 #include "logging.h"
 
+/// Milliseconds until more than interval has passed since last
+static uint32_t msLeft(uint32_t last, uint32_t interval) {
+    uint32_t elapsed = millis() - last;
+    return elapsed > interval ? 0 : interval - elapsed + 1;
+}
+
 Scheduler::Scheduler(ITimeSyncManager& timeSyncManager,
                      uint32_t          connectIntervalMs,
                      uint32_t          syncTimeIntervalMs,
                      uint32_t          readingIntervalSec,
                      uint32_t          dispatchIntervalSec,
-                     uint32_t          resyncTimeIntervalSec)
+                     uint32_t          resyncTimeIntervalSec,
+                     const char*       sensorUnitId)
     : m_timeSyncManager(timeSyncManager), m_connectIntervalMs(connectIntervalMs),
-      m_syncTimeIntervalMs(syncTimeIntervalMs), m_readingIntervalSec(readingIntervalSec),
-      m_dispatchIntervalSec(dispatchIntervalSec), m_resyncTimeIntervalSec(resyncTimeIntervalSec) {}
+      m_syncTimeIntervalMs(syncTimeIntervalMs), m_dispatchIntervalSec(dispatchIntervalSec),
+      m_resyncIntervalSec(resyncTimeIntervalSec), m_sensorUnitId(sensorUnitId),
+      m_readingDeadline(readingIntervalSec),
+      m_dispatchDeadline(dispatchIntervalSec, unitPhase(sensorUnitId, dispatchIntervalSec)),
+      m_resyncDeadline(resyncTimeIntervalSec, unitPhase(sensorUnitId, resyncTimeIntervalSec)) {}
 
 SchedulerResult Scheduler::tick(bool isPaired) {
     SchedulerResult result{};
-    uint32_t        now;
-    if (!isPaired) {
+    Mode            mode = !isPaired                           ? Mode::Unpaired
+                           : !m_timeSyncManager.isTimeSynced() ? Mode::Unsynced
+                                                               : Mode::Synced;
+    if (mode != m_mode) {
+        // Unix time may have changed, the slots start over from it
+        m_readingDeadline.restart();
+        m_dispatchDeadline.restart();
+        m_resyncDeadline.restart();
+        m_mode = mode;
+    }
+
+    uint32_t now;
+    if (mode == Mode::Unpaired) {
         now = millis();
         if (now - m_lastConnectTimeMs > m_connectIntervalMs) {
             LOG_INFO(TAG, "Triggering connect attempt");
             m_lastConnectTimeMs   = now;
             result.connectTrigger = true;
         }
-    } else if (!m_timeSyncManager.isTimeSynced()) {
+    } else if (mode == Mode::Unsynced) {
         LOG_INFO(TAG, "Time not synced");
         now = millis();
         if (now - m_lastSyncTimeMs > m_syncTimeIntervalMs) {
@@ -51,23 +72,76 @@ SchedulerResult Scheduler::tick(bool isPaired) {
     } else {
         now = m_timeSyncManager.getUnixTimeNow();
 
-        if (now % m_readingIntervalSec == 0 && now != m_lastReadingTimeUnix) {
+        if (m_readingDeadline.due(now)) {
             LOG_INFO(TAG, "Triggering sensor reading");
-            m_lastReadingTimeUnix = now;
             result.readingTrigger = true;
+            if (m_readingDeadline.skipped() != m_skippedReported) {
+                LOG_WARN(TAG,
+                         "%lu reading slots skipped, loop() was busy too long",
+                         m_readingDeadline.skipped() - m_skippedReported);
+                m_skippedReported = m_readingDeadline.skipped();
+            }
         }
 
-        if (now % m_dispatchIntervalSec == m_kdispatchOffset && now != m_lastDispatchTimeUnix) {
+        if (m_dispatchDeadline.due(now)) {
             LOG_INFO(TAG, "Triggering readings dispatch");
-            m_lastDispatchTimeUnix = now;
             result.dispatchTrigger = true;
         }
 
-        if (now % m_resyncTimeIntervalSec == m_kresyncOffset && now != m_lastResyncTimeUnix) {
+        if (m_resyncDeadline.due(now)) {
             LOG_INFO(TAG, "Triggering time resync");
-            m_lastResyncTimeUnix = now;
             result.resyncTrigger = true;
         }
     }
     return result;
-}
\ No newline at end of file
+}
+
+uint32_t Scheduler::msUntilNextEvent() {
+    if (m_mode == Mode::Unpaired) {
+        return msLeft(m_lastConnectTimeMs, m_connectIntervalMs);
+    }
+    if (m_mode == Mode::Unsynced) {
+        return msLeft(m_lastSyncTimeMs, m_syncTimeIntervalMs);
+    }
+    uint32_t now     = m_timeSyncManager.getUnixTimeNow();
+    uint32_t seconds = min(m_readingDeadline.untilNext(now),
+                           min(m_dispatchDeadline.untilNext(now), m_resyncDeadline.untilNext(now)));
+    if (seconds == 0) {
+        return 0;
+    }
+    return (seconds - 1) * 1000 + m_timeSyncManager.msUntilNextSecond();
+}
+
+void Scheduler::setUploadSlot(const UploadSlot& slot) {
+    m_uploadSlot = slot;
+    if (slot.periodSec == 0) {
+        m_dispatchDeadline =
+            PeriodicDeadline(m_dispatchIntervalSec, unitPhase(m_sensorUnitId, m_dispatchIntervalSec));
+        m_resyncDeadline =
+            PeriodicDeadline(m_resyncIntervalSec, unitPhase(m_sensorUnitId, m_resyncIntervalSec));
+        return;
+    }
+    // Resync at the start of a window too, the resync interval rounded up to whole periods
+    uint32_t resyncPeriod =
+        (m_resyncIntervalSec + slot.periodSec - 1) / slot.periodSec * slot.periodSec;
+    m_dispatchDeadline = PeriodicDeadline(slot.periodSec, slot.offsetSec);
+    m_resyncDeadline =
+        PeriodicDeadline(resyncPeriod > 0 ? resyncPeriod : slot.periodSec, slot.offsetSec);
+}
+
+bool Scheduler::inUploadWindow() {
+    return msLeftInUploadWindow() > 0;
+}
+
+uint32_t Scheduler::msLeftInUploadWindow() {
+    if (m_uploadSlot.periodSec == 0 || m_mode != Mode::Synced) {
+        return UINT32_MAX;
+    }
+    uint32_t period = m_uploadSlot.periodSec;
+    uint32_t now    = m_timeSyncManager.getUnixTimeNow();
+    uint32_t into   = (now % period + period - m_uploadSlot.offsetSec % period) % period;
+    if (into >= m_uploadSlot.windowSec) {
+        return 0;
+    }
+    return (m_uploadSlot.windowSec - into - 1) * 1000 + m_timeSyncManager.msUntilNextSecond();
+}
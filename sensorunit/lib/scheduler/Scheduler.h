@@ -10,6 +10,19 @@
  *
  * A TimeSyncManager needs to be created first and passed in the constructor
  *
+ * Readings, dispatches and resyncs have slots on the Unix clock, e.g. every
+ * 5 s for readings. Each is a PeriodicDeadline, so a slot that passes while
+ * loop() is busy triggers late at the next tick instead of being lost. Slots
+ * missed because loop() was busy for a whole interval are counted and logged.
+ *
+ * Every unit syncs to the clock of the control unit. Dispatch and resync get
+ * a phase from the unit id, so the units on an access point spread their
+ * calls over the interval instead of all calling in the same second.
+ *
+ * A control unit with upload windows assigns the phase instead. Dispatch is
+ * then due at the start of every window and resync at the start of a window
+ * once per resync interval, the only times the unit is associated.
+ *
  * @date 2025-10-23
  *
  * @copyright Copyright (c) 2025 Erik Dahl
@@ -19,7 +32,17 @@
 #pragma once
 #include "ConnectionManager.h"
 #include "IScheduler.h"
+#include "PeriodicDeadline.h"
 #include "TimeSyncManager.h"
+#include "config.h"
+
+/**
+ * @brief Limits for the main loop
+ *
+ */
+namespace scheduler_config {
+constexpr uint32_t max_idle_ms = 250; // Longest wait in loop(), logFlush() runs in between
+} // namespace scheduler_config
 
 /**
  * @brief Scheduler implementation that triggers periodic actions based on time intervals.
@@ -34,35 +57,58 @@ class Scheduler : public IScheduler {
      * @param readingIntervalSec Interval for sensor readings in seconds.
      * @param dispatchIntervalSec Interval for dispatching readings in seconds.
      * @param resyncTimeIntervalSec Interval for time resynchronization in seconds.
+     * @param sensorUnitId Id that the dispatch and resync phases are derived from.
      */
     explicit Scheduler(ITimeSyncManager& timeSyncManager,
               uint32_t          connectIntervalMs     = 5000,
               uint32_t          syncTimeIntervalMs    = 5000,
               uint32_t          readingIntervalSec    = 5,
               uint32_t          dispatchIntervalSec   = 15,
-              uint32_t          resyncTimeIntervalSec = 10 * 60);
+              uint32_t          resyncTimeIntervalSec = 10 * 60,
+              const char*       sensorUnitId          = SENSOR_UNIT_ID);
     /**
      * @brief Executes a scheduler tick and returns the actions to be triggered.
      * @param isPaired Indicates whether the device is currently paired.
      * @return A SchedulerResult containing trigger flags.
      */
     SchedulerResult tick(bool isPaired) override;
+    /**
+     * @brief Time until the next trigger, based on the state of the last tick.
+     * @return Milliseconds, 0 if a trigger is due.
+     */
+    uint32_t msUntilNextEvent() override;
+    /**
+     * @brief Moves dispatch and resync into the upload window from the Control Unit.
+     * @param slot Upload window, periodSec 0 for the intervals of the unit.
+     */
+    void setUploadSlot(const UploadSlot& slot) override;
+    /**
+     * @brief Checks if the unit may use the access point now.
+     * @return true within the upload window, or always without one or before time sync.
+     */
+    bool inUploadWindow() override;
+    /**
+     * @brief Time left in the upload window, to bound what is done in it.
+     * @return Milliseconds, 0 outside the window, UINT32_MAX without one or before time sync.
+     */
+    uint32_t msLeftInUploadWindow() override;
 
   private:
+    enum class Mode { Unpaired, Unsynced, Synced };
+
     ITimeSyncManager& m_timeSyncManager;   /**< Reference to the time synchronization manager. */
     uint32_t          m_connectIntervalMs; /**< Interval for connection attempts in milliseconds. */
-    uint32_t          m_syncTimeIntervalMs;  /**< Interval for syncing time in milliseconds. */
-    uint32_t          m_readingIntervalSec;  /**< Interval for sensor readings in seconds. */
-    uint32_t          m_dispatchIntervalSec; /**< Interval for dispatching readings in seconds. */
-    uint32_t m_resyncTimeIntervalSec;        /**< Interval for time resynchronization in seconds. */
-    uint32_t m_lastConnectTimeMs{};    /**< Millis Timestamp of the last connection attempt. */
-    uint32_t m_lastSyncTimeMs{};       /**< Millis Timestamp of the last sync time attempt. */
-    uint32_t m_lastReadingTimeUnix{};  /**< Unix Timestamp of the last sensor reading. */
-    uint32_t m_lastDispatchTimeUnix{}; /**< Unix Timestamp of the last data dispatch. */
-    uint32_t m_lastResyncTimeUnix{};   /**< Unix Timestamp of the last time resynchronization. */
-    static constexpr const uint32_t m_kdispatchOffset =
-        1; /**< Offset in seconds for dispatch trigger */
-    static constexpr const uint32_t m_kresyncOffset =
-        2; /**< Offset in seconds for resync trigger */
+    uint32_t          m_syncTimeIntervalMs; /**< Interval for syncing time in milliseconds. */
+    uint32_t m_lastConnectTimeMs{}; /**< Millis Timestamp of the last connection attempt. */
+    uint32_t m_lastSyncTimeMs{};    /**< Millis Timestamp of the last sync time attempt. */
+    uint32_t    m_dispatchIntervalSec; /**< Dispatch interval without upload window. */
+    uint32_t    m_resyncIntervalSec;   /**< Shortest time between resyncs. */
+    const char* m_sensorUnitId;        /**< Source of the phases without upload window. */
+    UploadSlot  m_uploadSlot{};        /**< Upload window, periodSec 0 if none. */
+    PeriodicDeadline m_readingDeadline;  /**< Sensor reading slots in Unix seconds. */
+    PeriodicDeadline m_dispatchDeadline; /**< Dispatch slots in Unix seconds. */
+    PeriodicDeadline m_resyncDeadline;   /**< Time resynchronization slots in Unix seconds. */
+    Mode             m_mode{Mode::Unpaired}; /**< Mode of the last tick. */
+    uint32_t         m_skippedReported{};    /**< Skipped reading slots already logged. */
     static constexpr const char* TAG = "Scheduler";
 };
@@ -35,4 +35,9 @@ public:
      * @return current Unix time.
      */
 	virtual uint32_t getUnixTimeNow() = 0;
+	/**
+     * @brief Should return the time until getUnixTimeNow() counts up.
+     * @return Milliseconds to the next whole second, 1000 if time is not synced.
+     */
+	virtual uint32_t msUntilNextSecond() = 0;
 };
\ No newline at end of file
@@ -53,3 +53,10 @@ uint32_t TimeSyncManager::getUnixTimeNow() {
         return 0;
     }
 }
+
+uint32_t TimeSyncManager::msUntilNextSecond() {
+    if (!isTimeSynced()) {
+        return 1000;
+    }
+    return 1000 - (millis() - m_baseMillis) % 1000;
+}
@@ -42,6 +42,11 @@ class TimeSyncManager : public ITimeSyncManager {
      * @return Estimated current Unix time in seconds.
      */
     uint32_t getUnixTimeNow() override;
+    /**
+     * @brief Returns the time until the Unix time counts up.
+     * @return Milliseconds to the next whole second, 1000 if time is not synced.
+     */
+    uint32_t msUntilNextSecond() override;
 
   private:
     bool                         m_isTimeSynced{false};   /**< True if time has been successfully synced */
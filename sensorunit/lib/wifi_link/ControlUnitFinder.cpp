@@ -0,0 +1,161 @@
+/**
+ * @file ControlUnitFinder.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the Control Unit access point search
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "ControlUnitFinder.h"
+
+using namespace finder_config;
+using namespace link_config;
+
+ControlUnitFinder::ControlUnitFinder(IWiFiRadio& radio, const char* ssidPrefix)
+    : m_radio{radio}, m_ssidPrefix{ssidPrefix} {}
+
+bool ControlUnitFinder::connect(IPairing& pairing, uint32_t nowMs) {
+    m_roamedAtMs   = nowMs;
+    bool triedLast = false;
+    if (m_hasLast) {
+        AccessPoint last = m_last;
+        bool        joined;
+        if (tryAccessPoint(last, pairing, joined)) {
+            return true;
+        }
+        triedLast = true;
+    }
+    bool cached = !m_rescan && !m_candidates.empty() &&
+                  nowMs - m_scannedAtMs < max_candidate_age_ms;
+    if (cached) {
+        if (tryCandidates(pairing, triedLast)) {
+            return true;
+        }
+        if (!m_rescan) {
+            // Reachable but not pairing, e.g. pending, a scan would not help
+            return false;
+        }
+    }
+    scan(nowMs);
+    return tryCandidates(pairing, triedLast);
+}
+
+RoamResult ControlUnitFinder::roam(IPairing& pairing, const LinkQuality& link, uint32_t nowMs) {
+    if (!m_hasLast || !link.isPoor() || nowMs - m_roamedAtMs < roam_holdoff_ms) {
+        return RoamResult::Stayed;
+    }
+    m_roamedAtMs        = nowMs;
+    AccessPoint current = m_last;
+    scan(nowMs);
+    int32_t currentRssi = link.rssi();
+    if (m_hasLast) {
+        // The scan measures all access points the same way
+        currentRssi = m_last.rssi;
+    } else {
+        // Missed by the scan, the unit is still joined to it
+        m_last    = current;
+        m_hasLast = true;
+    }
+
+    const AccessPoint* best = nullptr;
+    for (const AccessPoint& candidate : m_candidates) {
+        if (candidate.ssid != current.ssid) {
+            best = &candidate;
+            break;
+        }
+    }
+    if (best == nullptr || best->rssi < currentRssi + roam_margin_db) {
+        return RoamResult::Stayed;
+    }
+
+    AccessPoint target = *best;
+    bool        joined;
+    if (tryAccessPoint(target, pairing, joined)) {
+        return RoamResult::Roamed;
+    }
+    // Back to the Control Unit that knows the unit
+    AccessPoint previous = m_last;
+    if (tryAccessPoint(previous, pairing, joined)) {
+        return RoamResult::Stayed;
+    }
+    return RoamResult::Lost;
+}
+
+bool ControlUnitFinder::rejoin(uint32_t timeoutMs) {
+    if (m_hasLast && m_radio.join(m_last, timeoutMs)) {
+        m_missedRejoins = 0;
+        return true;
+    }
+    ++m_missedRejoins;
+    return false;
+}
+
+bool ControlUnitFinder::tryAccessPoint(const AccessPoint& accessPoint,
+                                       IPairing&          pairing,
+                                       bool&              joined) {
+    joined = m_radio.join(accessPoint, join_timeout_ms);
+    if (!joined) {
+        return false;
+    }
+    if (pairing.pair(accessPoint)) {
+        m_last          = accessPoint;
+        m_hasLast       = true;
+        m_missedRejoins = 0;
+        return true;
+    }
+    m_radio.leave();
+    return false;
+}
+
+bool ControlUnitFinder::tryCandidates(IPairing& pairing, bool skipLast) {
+    // A candidate that joined but did not pair, e.g. pending, is kept
+    bool joinedAny = false;
+    for (const AccessPoint& candidate : m_candidates) {
+        if (skipLast && candidate.ssid == m_last.ssid) {
+            continue;
+        }
+        bool joined;
+        if (tryAccessPoint(candidate, pairing, joined)) {
+            m_rescan = false;
+            return true;
+        }
+        joinedAny = joinedAny || joined;
+    }
+    m_rescan = !joinedAny;
+    return false;
+}
+
+void ControlUnitFinder::scan(uint32_t nowMs) {
+    m_candidates.clear();
+    m_scannedAtMs = nowMs;
+
+    bool seenLast = false;
+    int  count    = m_radio.scanNetworks();
+    for (int i = 0; i < count; ++i) {
+        AccessPoint found{};
+        m_radio.network(i, found);
+        if (!found.ssid.starts_with(m_ssidPrefix)) {
+            continue;
+        }
+        if (m_hasLast && found.ssid == m_last.ssid) {
+            seenLast = true;
+            m_last   = found; // May have moved to another channel
+        }
+        // Strongest first, the weakest is dropped when full
+        auto position = m_candidates.begin();
+        while (position != m_candidates.end() && position->rssi >= found.rssi) {
+            ++position;
+        }
+        if (m_candidates.full()) {
+            if (position == m_candidates.end()) {
+                continue;
+            }
+            m_candidates.pop_back();
+        }
+        m_candidates.insert(position, found);
+    }
+    m_hasLast = m_hasLast && seenLast;
+}
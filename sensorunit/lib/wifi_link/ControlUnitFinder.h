@@ -0,0 +1,157 @@
+/**
+ * @file ControlUnitFinder.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Finds and joins the access point of a Control Unit
+ *
+ * A scan keeps the radio on for seconds, so connect() tries what it already
+ * knows first:
+ *
+ * - The access point of the last Control Unit that paired, joined by SSID
+ *   first, bssid and channel kept for radios that support a directed join
+ * - The other access points of the last scan, unless none of them could be
+ *   joined or the scan is older than max_candidate_age_ms
+ * - A new scan, strongest signal first
+ *
+ * Nothing is cleared by a disconnect, so a unit that lost its Control Unit
+ * is back without a scan. A scan that does not see the last Control Unit
+ * forgets it.
+ *
+ * rejoin() joins the last Control Unit for an upload window and counts the
+ * failures in a row. After max_missed_rejoins the Control Unit may be off,
+ * out of range or full, and the unit should connect() again.
+ *
+ * roam() moves a paired unit to another Control Unit, with hysteresis so it
+ * does not flip between two of them: only when the link is poor, at most
+ * one scan per roam_holdoff_ms, and only to a Control Unit at least
+ * roam_margin_db stronger. If that one does not pair the unit goes back.
+ *
+ * Has no Arduino dependencies and is tested in the native environment.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include "IWiFiRadio.h"
+#include "LinkQuality.h"
+#include <etl/vector.h>
+
+/**
+ * @brief Limits of the cached scan results
+ *
+ */
+namespace finder_config {
+constexpr size_t   max_candidates       = 8;
+constexpr uint32_t max_candidate_age_ms = 300'000;
+constexpr uint32_t join_timeout_ms      = 10'000; /**< Per access point in connect() and roam() */
+constexpr uint32_t max_missed_rejoins   = 3;      /**< Failed rejoins in a row before connect() */
+} // namespace finder_config
+
+/**
+ * @brief The step after joining, POST /connect to the Control Unit
+ */
+class IPairing {
+  public:
+    virtual ~IPairing() = default;
+    /**
+     * @brief Asks the Control Unit behind the joined access point to pair
+     *
+     * @return true if it answered connected
+     */
+    virtual bool pair(const AccessPoint& accessPoint) = 0;
+};
+
+/**
+ * @brief Outcome of ControlUnitFinder::roam()
+ */
+enum class RoamResult {
+    Stayed, /**< Still paired with the same Control Unit */
+    Roamed, /**< Paired with another Control Unit */
+    Lost    /**< Neither paired, the radio is left */
+};
+
+class ControlUnitFinder {
+  public:
+    /**
+     * @brief Constructs a finder without known access points
+     *
+     * @param radio Radio to scan and join with
+     * @param ssidPrefix Only access points with this prefix are Control Units
+     */
+    ControlUnitFinder(IWiFiRadio& radio, const char* ssidPrefix);
+
+    /**
+     * @brief Joins access points until pairing accepts one
+     *
+     * @param pairing Called with the radio joined to the access point
+     * @param nowMs millis(), for the age of the scan results
+     * @return true when paired, the radio stays joined. false with the radio left
+     */
+    bool connect(IPairing& pairing, uint32_t nowMs);
+
+    /**
+     * @brief Moves to a clearly stronger Control Unit if the link is poor
+     *
+     * Call between requests with the radio joined to last(). Scans, which
+     * keeps the radio busy for seconds, only when a move may be needed.
+     *
+     * @param pairing Called with the radio joined to the other access point
+     * @param link Quality of the current link
+     * @param nowMs millis()
+     * @return RoamResult
+     */
+    RoamResult roam(IPairing& pairing, const LinkQuality& link, uint32_t nowMs);
+
+    /**
+     * @brief Joins the last Control Unit again, e.g. for an upload window
+     *
+     * @param timeoutMs Longest time to try
+     * @return true when joined, false with the radio left
+     */
+    bool rejoin(uint32_t timeoutMs);
+
+    /**
+     * @brief Failed rejoins since the last join or pairing
+     */
+    uint32_t missedRejoins() const {
+        return m_missedRejoins;
+    }
+
+    /**
+     * @brief true when a Control Unit has paired and was not forgotten since
+     */
+    bool hasLast() const {
+        return m_hasLast;
+    }
+
+    /**
+     * @brief Access point of the last Control Unit that paired
+     */
+    const AccessPoint& last() const {
+        return m_last;
+    }
+
+    /**
+     * @brief Control Unit access points from the last scan
+     */
+    size_t candidates() const {
+        return m_candidates.size();
+    }
+
+  private:
+    bool tryAccessPoint(const AccessPoint& accessPoint, IPairing& pairing, bool& joined);
+    bool tryCandidates(IPairing& pairing, bool skipLast);
+    void scan(uint32_t nowMs);
+
+    IWiFiRadio& m_radio;
+    const char* m_ssidPrefix;
+    etl::vector<AccessPoint, finder_config::max_candidates> m_candidates;
+    uint32_t    m_scannedAtMs   = 0;
+    uint32_t    m_roamedAtMs    = 0;     /**< Last connect or roaming scan */
+    uint32_t    m_missedRejoins = 0;     /**< Failed rejoins in a row */
+    bool        m_rescan        = false; /**< None of the candidates could be joined */
+    bool        m_hasLast       = false;
+    AccessPoint m_last{};
+};
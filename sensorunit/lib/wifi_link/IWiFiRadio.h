@@ -0,0 +1,63 @@
+/**
+ * @file IWiFiRadio.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Interface to the WiFi radio of the Sensor Unit
+ *
+ * The calls ControlUnitFinder needs from the radio. WiFiS3Radio implements
+ * it on the UNO R4 WiFi, the native tests use a fake with a simulated clock.
+ * Every call blocks until the radio is done, like the WiFi library.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <etl/string.h>
+#include <stdint.h>
+
+/**
+ * @brief Access point from a scan
+ */
+struct AccessPoint {
+    etl::string<32> ssid;
+    uint8_t         bssid[6]; /**< MAC address of the access point */
+    uint8_t         channel;  /**< 0 if not known */
+    int32_t         rssi;
+};
+
+class IWiFiRadio {
+  public:
+    virtual ~IWiFiRadio() = default;
+    /**
+     * @brief Scans all channels, the radio is on for seconds
+     *
+     * @return int Networks found, read them with network()
+     */
+    virtual int scanNetworks() = 0;
+    /**
+     * @brief Network from the last scan
+     *
+     * @param index 0 ... scanNetworks() - 1
+     * @param accessPoint Filled in
+     */
+    virtual void network(int index, AccessPoint& accessPoint) = 0;
+    /**
+     * @brief Joins an access point, the bssid and channel may be used to skip
+     * the search for it
+     *
+     * @param accessPoint Access point to join
+     * @param timeoutMs Longest time to try
+     * @return true when associated, false with the radio left after timeoutMs
+     */
+    virtual bool join(const AccessPoint& accessPoint, uint32_t timeoutMs) = 0;
+    /**
+     * @brief Leaves the access point
+     */
+    virtual void leave() = 0;
+    /**
+     * @brief Signal strength of the joined access point in dBm
+     */
+    virtual int32_t rssi() = 0;
+};
@@ -0,0 +1,50 @@
+/**
+ * @file LinkQuality.cpp
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Implementation of the link quality averages
+ *
+ * Exponential moving averages in integers, the newest sample weighs 1/4 for
+ * the signal and 1/8 for requests. The first sample is taken as it is.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#include "LinkQuality.h"
+
+using namespace link_config;
+
+static int32_t average(int32_t mean, int32_t sample, int32_t weight) {
+    return mean + (sample - mean) / weight;
+}
+
+void LinkQuality::reset() {
+    *this = LinkQuality{};
+}
+
+void LinkQuality::addRssi(int32_t rssi) {
+    m_rssi16 = m_rssiSamples == 0 ? rssi * 16 : average(m_rssi16, rssi * 16, 4);
+    ++m_rssiSamples;
+}
+
+void LinkQuality::addRequest(bool delivered, uint32_t latencyMs) {
+    int32_t failure = delivered ? 0 : 1000;
+    if (m_requests == 0) {
+        m_latencyMs       = latencyMs;
+        m_failurePermille = failure;
+    } else {
+        m_latencyMs =
+            average(static_cast<int32_t>(m_latencyMs), static_cast<int32_t>(latencyMs), 8);
+        m_failurePermille = average(static_cast<int32_t>(m_failurePermille), failure, 8);
+    }
+    ++m_requests;
+}
+
+bool LinkQuality::isPoor() const {
+    bool weak = m_rssiSamples >= min_rssi_samples && rssi() < poor_rssi_dbm;
+    bool slow = m_requests >= min_requests &&
+                (m_latencyMs >= poor_latency_ms || m_failurePermille >= poor_failure_permille);
+    return weak || slow;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file LinkQuality.h
+ * @author Erik Dahl (erik@iunderlandet.se)
+ * @brief Quality of the link to the paired Control Unit
+ *
+ * Moving averages of the signal strength, the request time and the share of
+ * requests that failed on the way, e.g. timeouts or no connection. HTTP
+ * answers, also errors, count as delivered. ControlUnitFinder::roam() only
+ * looks for another Control Unit when the link is poor.
+ *
+ * Has no Arduino dependencies and is tested in the native environment.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025 Erik Dahl
+ * @license MIT
+ *
+ */
+#pragma once
+#include <stdint.h>
+
+/**
+ * @brief Limits of a poor link and the roaming hysteresis
+ *
+ */
+namespace link_config {
+constexpr int32_t  poor_rssi_dbm         = -75;
+constexpr uint32_t poor_latency_ms       = 1500;
+constexpr uint32_t poor_failure_permille = 200;
+constexpr uint32_t min_requests          = 4; // Before latency and failures count
+constexpr uint32_t min_rssi_samples      = 2;
+constexpr int32_t  roam_margin_db        = 8;       // A candidate must be this much stronger
+constexpr uint32_t roam_holdoff_ms       = 300'000; // Between roaming scans
+} // namespace link_config
+
+class LinkQuality {
+  public:
+    /**
+     * @brief Forgets all samples, for a new link
+     */
+    void reset();
+
+    /**
+     * @brief Adds a signal strength sample of the joined access point
+     */
+    void addRssi(int32_t rssi);
+
+    /**
+     * @brief Adds a request
+     *
+     * @param delivered false if it failed on the way
+     * @param latencyMs Time until the answer or the failure
+     */
+    void addRequest(bool delivered, uint32_t latencyMs);
+
+    /**
+     * @brief true when the signal is weak or requests are slow or fail
+     */
+    bool isPoor() const;
+
+    int32_t rssi() const {
+        return m_rssi16 / 16;
+    }
+    uint32_t latencyMs() const {
+        return m_latencyMs;
+    }
+    uint32_t failurePermille() const {
+        return m_failurePermille;
+    }
+    uint32_t requests() const {
+        return m_requests;
+    }
+
+  private:
+    int32_t  m_rssi16          = 0; /**< 1/16 dBm, so the average reaches the samples */
+    uint32_t m_rssiSamples     = 0;
+    uint32_t m_latencyMs       = 0;
+    uint32_t m_failurePermille = 0;
+    uint32_t m_requests        = 0;
+};
@@ -11,6 +11,7 @@
  * 
  */
 #include "ConnectionManager.h"
+#include "DataFlashReadingStorage.h"
 #include "ReadingProcessor.h"
 #include "ReadingsDispatcher.h"
 #include "RestClient.h"
@@ -22,20 +23,24 @@
 #include "logging.h"
 #include <Arduino.h>
 
-RestClient         restClient(CONTROL_UNIT_IP_ADDR);
-ConnectionManager  connectionManager(CONTROL_UNIT_PASSWORD, restClient);
-TimeSyncManager    timeSyncManager(restClient);
-Scheduler          scheduler(timeSyncManager);
-SensorReader       sensorReader;
-ReadingBuffer      readingBuffer;
-ReadingProcessor   readingProcessor(sensorReader, timeSyncManager, readingBuffer);
-ReadingsDispatcher readingsDispatcher(restClient, readingBuffer);
+RestClient              restClient(CONTROL_UNIT_IP_ADDR);
+ConnectionManager       connectionManager(CONTROL_UNIT_PASSWORD, restClient);
+TimeSyncManager         timeSyncManager(restClient);
+Scheduler               scheduler(timeSyncManager);
+SensorReader            sensorReader;
+DataFlashReadingStorage readingStorage;
+ReadingBacklog          readingBacklog(readingStorage);
+ReadingBuffer           readingBuffer(readingBacklog);
+ReadingProcessor        readingProcessor(sensorReader, timeSyncManager, readingBuffer);
+ReadingsDispatcher      readingsDispatcher(restClient, readingBuffer);
 
 void setup() {
     Serial.begin(115200);
     delay(2000);
 
     sensorReader.init();
+    readingStorage.init();
+    readingBuffer.init();
     connectionManager.init();
 
     LOG_INFO("MAIN", "Setup done");
@@ -47,13 +52,25 @@ void loop() {
         connectionManager.connect();
         if (connectionManager.isPairedWithControlUnit()) {
             timeSyncManager.syncTime();
+            scheduler.setUploadSlot(connectionManager.uploadSlot());
         }
     }
+    if ((triggers.dispatchTrigger || triggers.resyncTrigger) &&
+        !connectionManager.associate(scheduler.msLeftInUploadWindow())) {
+        // Late for the window or the AP is full, the readings wait for the next window
+        LOG_WARN("MAIN", "Upload window missed");
+        triggers.dispatchTrigger = false;
+        triggers.resyncTrigger   = false;
+    }
     if (triggers.readingTrigger) {
         readingProcessor.process();
     }
     if (triggers.dispatchTrigger) {
-        bool stillConnected = readingsDispatcher.dispatch();
+        readingsDispatcher.start();
+    }
+    if (readingsDispatcher.isDispatching() && connectionManager.isPairedWithControlUnit()) {
+        // One batch per loop, readings due in between are taken first
+        bool stillConnected = readingsDispatcher.step();
         if (!stillConnected) {
             connectionManager.disconnect();
         }
@@ -61,4 +78,22 @@ void loop() {
     if (triggers.resyncTrigger) {
         timeSyncManager.syncTime();
     }
+    if (readingsDispatcher.isDispatching() && !scheduler.inUploadWindow()) {
+        // The next units need the AP, the rest is sent in the next window
+        readingsDispatcher.stop();
+    }
+    if (!readingsDispatcher.isDispatching() && connectionManager.roam()) {
+        // Between dispatches, the buffered readings go to the new Control Unit
+        timeSyncManager.syncTime();
+        scheduler.setUploadSlot(connectionManager.uploadSlot());
+    }
+    if (!readingsDispatcher.isDispatching() && timeSyncManager.isTimeSynced()) {
+        // Only leaves the AP with an upload window
+        connectionManager.disassociate();
+    }
+    logFlush();
+    if (!readingsDispatcher.isDispatching()) {
+        // Nothing to do until the next trigger
+        delay(min(scheduler.msUntilNextEvent(), scheduler_config::max_idle_ms));
+    }
 }
\ No newline at end of file
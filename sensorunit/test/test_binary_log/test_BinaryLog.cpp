@@ -0,0 +1,114 @@
+#include "unity.h"
+#include "BinaryLog.h"
+#include "logging.h"
+#include <Arduino.h>
+
+/**
+ * @brief Print that keeps what is written and takes a limited number of bytes
+ */
+class CapturePrint : public Print {
+  public:
+    size_t write(uint8_t byte) override {
+        return write(&byte, 1);
+    }
+    size_t write(const uint8_t* data, size_t size) override {
+        size_t taken = min(size, sizeof(bytes) - length);
+        memcpy(&bytes[length], data, taken);
+        length += taken;
+        return taken;
+    }
+    uint8_t bytes[256];
+    size_t  length = 0;
+};
+
+static uint32_t readU32(const uint8_t* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void when_record_built_then_header_and_arguments_are_encoded() {
+    constexpr uint32_t formatId = logHash("%d %u %s %.1f");
+    LogRecord          record(LOG_WARN, 1234, logHash("Test"), formatId);
+    record.add(-2);
+    record.add(7u);
+    record.add("abc");
+    record.add(1.5f);
+
+    const uint8_t* data = record.data();
+    TEST_ASSERT_EQUAL(0xA5, data[0]);
+    TEST_ASSERT_EQUAL(0x5A, data[1]);
+    TEST_ASSERT_EQUAL(record.size() - 3, data[2]);
+    TEST_ASSERT_EQUAL(LOG_WARN, data[3]);
+    TEST_ASSERT_EQUAL_UINT32(1234, readU32(&data[4]));
+    TEST_ASSERT_EQUAL_UINT32(logHash("Test"), readU32(&data[8]));
+    TEST_ASSERT_EQUAL_UINT32(formatId, readU32(&data[12]));
+    // Same hash as logdecode.py
+    TEST_ASSERT_EQUAL_UINT32(0x811C9DC5, logHash(""));
+    TEST_ASSERT_EQUAL_UINT32(0xE40C292C, logHash("a"));
+
+    const uint8_t* args = &data[binary_log_config::header_size];
+    TEST_ASSERT_EQUAL('i', args[0]);
+    TEST_ASSERT_EQUAL(-2, static_cast<int32_t>(readU32(&args[1])));
+    TEST_ASSERT_EQUAL('u', args[5]);
+    TEST_ASSERT_EQUAL_UINT32(7, readU32(&args[6]));
+    TEST_ASSERT_EQUAL('s', args[10]);
+    TEST_ASSERT_EQUAL(3, args[11]);
+    TEST_ASSERT_EQUAL_MEMORY("abc", &args[12], 3);
+    TEST_ASSERT_EQUAL('d', args[15]);
+    TEST_ASSERT_EQUAL(binary_log_config::header_size + 15 + 9, record.size());
+}
+
+void when_buffer_full_then_records_are_dropped_and_reported() {
+    uint8_t   storage[64];
+    BinaryLog log(storage, sizeof(storage));
+    LogRecord record(LOG_INFO, 0, 1, 2);
+    record.add(42); // 21 bytes, three fit
+
+    for (int i = 0; i < 5; ++i) {
+        log.push(record);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, log.dropped());
+    TEST_ASSERT_EQUAL(3 * record.size(), log.pending());
+
+    // Flushed in pieces as the output has room
+    CapturePrint out;
+    TEST_ASSERT_EQUAL(10, log.flush(out, 10));
+    TEST_ASSERT_EQUAL(3 * record.size() - 10, log.flush(out, 1000));
+    TEST_ASSERT_EQUAL(0, log.pending());
+    TEST_ASSERT_EQUAL_MEMORY(record.data(), out.bytes, record.size());
+
+    // The count comes first once there is room, wrapping the storage
+    TEST_ASSERT_TRUE(log.push(record));
+    TEST_ASSERT_EQUAL(2 * record.size(), log.pending());
+    out.length = 0;
+    log.flush(out, 1000);
+    const uint8_t* note = out.bytes;
+    TEST_ASSERT_EQUAL_UINT32(binary_log_config::dropped_id, readU32(&note[12]));
+    TEST_ASSERT_EQUAL('u', note[16]);
+    TEST_ASSERT_EQUAL_UINT32(2, readU32(&note[17]));
+    TEST_ASSERT_EQUAL_MEMORY(record.data(), &out.bytes[record.size()], record.size());
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(when_record_built_then_header_and_arguments_are_encoded);
+    RUN_TEST(when_buffer_full_then_records_are_dropped_and_reported);
+    return UNITY_END();
+}
+
+void setup() {
+    // Wait ~2 seconds before the Unity test runner
+    // establishes connection with a board Serial interface
+    delay(2000);
+
+    runUnityTests();
+}
+
+void loop() {}
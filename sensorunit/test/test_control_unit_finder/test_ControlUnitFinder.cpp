@@ -0,0 +1,413 @@
+#include "unity.h"
+#include "ControlUnitFinder.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+// Rough radio times of the UNO R4 WiFi
+constexpr uint32_t scan_ms             = 2500; // All channels
+constexpr uint32_t join_ms             = 1500;
+constexpr uint32_t join_timeout_ms     = finder_config::join_timeout_ms;
+constexpr uint32_t pair_ms             = 150;  // POST /connect
+constexpr uint32_t connect_interval_ms = 5000; // Scheduler
+constexpr uint32_t window_ms           = 5000; // Upload window of the Control Unit
+constexpr uint32_t window_period_ms    = 60'000;
+
+/**
+ * @brief Radio with a simulated clock, counts the time the radio is on
+ */
+class FakeRadio : public IWiFiRadio {
+  public:
+    struct Network {
+        AccessPoint accessPoint;
+        bool        up;
+    };
+
+    void add(const char* ssid, int32_t rssi, uint8_t channel) {
+        Network& network = networks[count++];
+        network.accessPoint.ssid = ssid;
+        memset(network.accessPoint.bssid, 0, sizeof(network.accessPoint.bssid));
+        network.accessPoint.bssid[5] = static_cast<uint8_t>(count);
+        network.accessPoint.channel  = channel;
+        network.accessPoint.rssi     = rssi;
+        network.up                   = true;
+    }
+    void setUp(const char* ssid, bool up) {
+        find(ssid)->up = up;
+    }
+    void setRssi(const char* ssid, int32_t rssi) {
+        find(ssid)->accessPoint.rssi = rssi;
+    }
+
+    int scanNetworks() override {
+        ++scans;
+        spend(scan_ms);
+        int visible = 0;
+        for (size_t i = 0; i < count; ++i) {
+            visible += networks[i].up ? 1 : 0;
+        }
+        return visible;
+    }
+    void network(int index, AccessPoint& accessPoint) override {
+        for (size_t i = 0; i < count; ++i) {
+            if (networks[i].up && index-- == 0) {
+                accessPoint = networks[i].accessPoint;
+                return;
+            }
+        }
+    }
+    bool join(const AccessPoint& accessPoint, uint32_t timeoutMs) override {
+        Network* network = find(accessPoint.ssid.c_str());
+        if (network == nullptr || !network->up || timeoutMs < join_ms) {
+            spend(timeoutMs);
+            joined = false;
+            return false;
+        }
+        spend(join_ms);
+        joined        = true;
+        joinedChannel = accessPoint.channel;
+        joinedRssi    = network->accessPoint.rssi;
+        ++joins;
+        return true;
+    }
+    void leave() override {
+        joined = false;
+    }
+    int32_t rssi() override {
+        return joinedRssi;
+    }
+
+    void spend(uint32_t ms) {
+        nowMs += ms;
+        radioOnMs += ms;
+    }
+    void idle(uint32_t ms) {
+        nowMs += ms;
+        radioOnMs += joined ? ms : 0;
+    }
+
+    Network  networks[4];
+    size_t   count         = 0;
+    uint32_t nowMs         = 0;
+    uint32_t radioOnMs     = 0;
+    int      scans         = 0;
+    int      joins         = 0;
+    bool     joined        = false;
+    uint8_t  joinedChannel = 0;
+    int32_t  joinedRssi    = 0;
+
+  private:
+    Network* find(const char* ssid) {
+        for (size_t i = 0; i < count; ++i) {
+            if (networks[i].accessPoint.ssid == ssid) {
+                return &networks[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Control Units that answer /connect, the first answers pending a few times
+ */
+class FakePairing : public IPairing {
+  public:
+    explicit FakePairing(FakeRadio& radio) : radio{radio} {}
+    bool pair(const AccessPoint& accessPoint) override {
+        radio.spend(pair_ms);
+        if (pending > 0) {
+            --pending;
+            return false;
+        }
+        return accessPoint.ssid == accepts[0] || accessPoint.ssid == accepts[1];
+    }
+    FakeRadio&  radio;
+    const char* accepts[2] = {"", ""};
+    int         pending    = 0;
+};
+
+static void report(const char* what, uint32_t timeToPairedMs, uint32_t radioOnMs) {
+    char message[96];
+    snprintf(message,
+             sizeof(message),
+             "%s: paired after %lu ms, radio on %lu ms",
+             what,
+             static_cast<unsigned long>(timeToPairedMs),
+             static_cast<unsigned long>(radioOnMs));
+    TEST_MESSAGE(message);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void when_paired_before_then_reconnect_skips_the_scan() {
+    FakeRadio radio;
+    radio.add("CU-0001", -70, 6);
+    radio.add("CU-0002", -50, 11);
+    radio.add("Office", -40, 1);
+    FakePairing pairing(radio);
+    pairing.accepts[0] = "CU-0001";
+    ControlUnitFinder finder(radio, "CU-");
+
+    // Scan, the stronger CU-0002 does not know the unit
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_EQUAL(1, radio.scans);
+    TEST_ASSERT_EQUAL(2, finder.candidates());
+    TEST_ASSERT_EQUAL_STRING("CU-0001", finder.last().ssid.c_str());
+    TEST_ASSERT_EQUAL_UINT32(scan_ms + 2 * (join_ms + pair_ms), radio.nowMs);
+    report("First start", radio.nowMs, radio.radioOnMs);
+
+    // Control Unit answered disconnected, a minute later the unit connects again
+    radio.leave();
+    radio.idle(60'000);
+    uint32_t startMs   = radio.nowMs;
+    uint32_t radioOnMs = radio.radioOnMs;
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_EQUAL(1, radio.scans);
+    TEST_ASSERT_EQUAL(6, radio.joinedChannel);
+    TEST_ASSERT_EQUAL_UINT32(join_ms + pair_ms, radio.nowMs - startMs);
+    TEST_ASSERT_EQUAL_UINT32(join_ms + pair_ms, radio.radioOnMs - radioOnMs);
+    report("Reconnect", radio.nowMs - startMs, radio.radioOnMs - radioOnMs);
+}
+
+void when_control_unit_gone_then_cached_results_are_tried_before_a_scan() {
+    FakeRadio radio;
+    radio.add("CU-0001", -50, 1);
+    radio.add("CU-0002", -60, 6);
+    FakePairing pairing(radio);
+    pairing.accepts[0] = "CU-0001";
+    pairing.accepts[1] = "CU-0002";
+    ControlUnitFinder finder(radio, "CU-");
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_EQUAL_STRING("CU-0001", finder.last().ssid.c_str());
+
+    // The directed join times out, the other Control Unit is still cached
+    radio.leave();
+    radio.setUp("CU-0001", false);
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_EQUAL(1, radio.scans);
+    TEST_ASSERT_EQUAL_STRING("CU-0002", finder.last().ssid.c_str());
+
+    // Both gone, a new one came up: the cached results fail and a scan finds it
+    radio.leave();
+    radio.setUp("CU-0002", false);
+    radio.add("CU-0003", -70, 11);
+    pairing.accepts[0] = "CU-0003";
+    uint32_t startMs = radio.nowMs;
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_EQUAL(2, radio.scans);
+    TEST_ASSERT_EQUAL_STRING("CU-0003", finder.last().ssid.c_str());
+    TEST_ASSERT_EQUAL_UINT32(2 * join_timeout_ms + scan_ms + join_ms + pair_ms,
+                             radio.nowMs - startMs);
+
+    // Nothing left, the scan forgets the last Control Unit
+    radio.leave();
+    radio.setUp("CU-0003", false);
+    TEST_ASSERT_FALSE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_FALSE(finder.hasLast());
+    TEST_ASSERT_FALSE(radio.joined);
+    TEST_ASSERT_EQUAL(3, radio.scans);
+}
+
+void when_control_unit_answers_pending_then_it_is_retried_without_scans() {
+    FakeRadio radio;
+    radio.add("CU-0001", -50, 1);
+    FakePairing pairing(radio);
+    pairing.accepts[0] = "CU-0001";
+    pairing.pending    = 2; // The backend has not added the unit yet
+    ControlUnitFinder finder(radio, "CU-");
+
+    int attempts = 1;
+    while (!finder.connect(pairing, radio.nowMs)) {
+        TEST_ASSERT_FALSE(radio.joined);
+        radio.idle(connect_interval_ms);
+        ++attempts;
+    }
+    TEST_ASSERT_EQUAL(3, attempts);
+    TEST_ASSERT_EQUAL(1, radio.scans);
+    TEST_ASSERT_EQUAL_UINT32(scan_ms + 3 * (join_ms + pair_ms), radio.radioOnMs);
+    report("Pending twice", radio.nowMs, radio.radioOnMs);
+
+    // Scan results too old to trust are scanned again
+    radio.leave();
+    radio.setUp("CU-0001", false);
+    radio.idle(finder_config::max_candidate_age_ms);
+    TEST_ASSERT_FALSE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_EQUAL(2, radio.scans);
+}
+
+void when_requests_fail_or_signal_fades_then_link_is_poor() {
+    LinkQuality link;
+    link.addRssi(-60);
+    for (int i = 0; i < 3; ++i) {
+        link.addRequest(false, 5000);
+    }
+    // Too few requests to judge
+    TEST_ASSERT_FALSE(link.isPoor());
+    link.addRequest(true, 200);
+    TEST_ASSERT_TRUE(link.isPoor());
+    TEST_ASSERT_EQUAL(4, link.requests());
+
+    // A run of quick answers makes it good again
+    for (int i = 0; i < 20; ++i) {
+        link.addRequest(true, 200);
+    }
+    TEST_ASSERT_TRUE(link.failurePermille() < link_config::poor_failure_permille);
+    TEST_ASSERT_TRUE(link.latencyMs() < link_config::poor_latency_ms);
+    TEST_ASSERT_FALSE(link.isPoor());
+
+    link.reset();
+    link.addRssi(-85);
+    TEST_ASSERT_FALSE(link.isPoor());
+    link.addRssi(-85);
+    TEST_ASSERT_TRUE(link.isPoor());
+    TEST_ASSERT_EQUAL(-85, link.rssi());
+}
+
+void when_link_is_poor_then_unit_roams_only_to_a_clearly_stronger_control_unit() {
+    FakeRadio radio;
+    radio.add("CU-0001", -60, 1);
+    radio.add("CU-0002", -70, 6);
+    FakePairing pairing(radio);
+    pairing.accepts[0] = "CU-0001";
+    pairing.accepts[1] = "CU-0002";
+    ControlUnitFinder finder(radio, "CU-");
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+
+    // A good link is never scanned
+    LinkQuality link;
+    link.addRssi(radio.rssi());
+    link.addRssi(radio.rssi());
+    radio.idle(link_config::roam_holdoff_ms);
+    TEST_ASSERT_TRUE(RoamResult::Stayed == finder.roam(pairing, link, radio.nowMs));
+    TEST_ASSERT_EQUAL(1, radio.scans);
+
+    // Fading, but the other one is not stronger by the margin
+    radio.setRssi("CU-0001", -78);
+    radio.setRssi("CU-0002", -72);
+    for (int i = 0; i < 8; ++i) {
+        link.addRssi(-78);
+    }
+    TEST_ASSERT_TRUE(link.isPoor());
+    int      joins       = radio.joins;
+    uint32_t scannedAtMs = radio.nowMs;
+    TEST_ASSERT_TRUE(RoamResult::Stayed == finder.roam(pairing, link, radio.nowMs));
+    TEST_ASSERT_EQUAL(2, radio.scans);
+    TEST_ASSERT_EQUAL(joins, radio.joins);
+
+    // Held off after a scan even when the other one gets stronger
+    radio.setRssi("CU-0002", -62);
+    radio.idle(scannedAtMs + link_config::roam_holdoff_ms - 1 - radio.nowMs);
+    TEST_ASSERT_TRUE(RoamResult::Stayed == finder.roam(pairing, link, radio.nowMs));
+    TEST_ASSERT_EQUAL(2, radio.scans);
+
+    radio.idle(1);
+    TEST_ASSERT_TRUE(RoamResult::Roamed == finder.roam(pairing, link, radio.nowMs));
+    TEST_ASSERT_EQUAL_STRING("CU-0002", finder.last().ssid.c_str());
+    TEST_ASSERT_EQUAL(-62, radio.rssi());
+}
+
+void when_roaming_target_does_not_pair_then_unit_goes_back() {
+    FakeRadio radio;
+    radio.add("CU-0001", -80, 1);
+    radio.add("CU-0002", -50, 6);
+    FakePairing pairing(radio);
+    pairing.accepts[0] = "CU-0001"; // CU-0002 does not know the unit
+    ControlUnitFinder finder(radio, "CU-");
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_EQUAL_STRING("CU-0001", finder.last().ssid.c_str());
+
+    LinkQuality link;
+    for (int i = 0; i < 4; ++i) {
+        link.addRequest(false, 5000);
+    }
+    radio.idle(link_config::roam_holdoff_ms);
+    TEST_ASSERT_TRUE(RoamResult::Stayed == finder.roam(pairing, link, radio.nowMs));
+    TEST_ASSERT_EQUAL_STRING("CU-0001", finder.last().ssid.c_str());
+    TEST_ASSERT_TRUE(radio.joined);
+    TEST_ASSERT_EQUAL(-80, radio.rssi());
+
+    // The first Control Unit answers pending on the way back
+    radio.idle(link_config::roam_holdoff_ms);
+    pairing.pending = 2;
+    TEST_ASSERT_TRUE(RoamResult::Lost == finder.roam(pairing, link, radio.nowMs));
+    TEST_ASSERT_FALSE(radio.joined);
+    TEST_ASSERT_EQUAL_STRING("CU-0001", finder.last().ssid.c_str());
+    int scans = radio.scans;
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_EQUAL(scans, radio.scans);
+}
+
+void when_control_unit_ap_goes_down_after_pairing_then_unit_connects_again() {
+    FakeRadio radio;
+    radio.add("CU-0001", -50, 1);
+    radio.add("CU-0002", -60, 6);
+    FakePairing pairing(radio);
+    pairing.accepts[0] = "CU-0001";
+    pairing.accepts[1] = "CU-0002";
+    ControlUnitFinder finder(radio, "CU-");
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+    radio.leave();
+
+    // A join that does not fit in the rest of the window gives up in time
+    radio.idle(window_period_ms);
+    uint32_t startMs = radio.nowMs;
+    TEST_ASSERT_FALSE(finder.rejoin(join_ms - 1));
+    TEST_ASSERT_EQUAL_UINT32(join_ms - 1, radio.nowMs - startMs);
+    TEST_ASSERT_FALSE(radio.joined);
+    TEST_ASSERT_EQUAL_UINT32(1, finder.missedRejoins());
+    radio.idle(window_period_ms);
+    TEST_ASSERT_TRUE(finder.rejoin(window_ms));
+    TEST_ASSERT_EQUAL_UINT32(0, finder.missedRejoins());
+    radio.leave();
+
+    // Powered off, every window is missed but never overrun
+    radio.setUp("CU-0001", false);
+    for (uint32_t missed = 1; missed <= finder_config::max_missed_rejoins; ++missed) {
+        radio.idle(window_period_ms);
+        startMs = radio.nowMs;
+        TEST_ASSERT_FALSE(finder.rejoin(window_ms));
+        TEST_ASSERT_EQUAL_UINT32(window_ms, radio.nowMs - startMs);
+        TEST_ASSERT_EQUAL_UINT32(missed, finder.missedRejoins());
+    }
+
+    // ConnectionManager disconnects, connect() scans as the results are too old
+    TEST_ASSERT_TRUE(finder.connect(pairing, radio.nowMs));
+    TEST_ASSERT_EQUAL_STRING("CU-0002", finder.last().ssid.c_str());
+    TEST_ASSERT_EQUAL(2, radio.scans);
+    TEST_ASSERT_EQUAL_UINT32(0, finder.missedRejoins());
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(when_paired_before_then_reconnect_skips_the_scan);
+    RUN_TEST(when_control_unit_gone_then_cached_results_are_tried_before_a_scan);
+    RUN_TEST(when_control_unit_answers_pending_then_it_is_retried_without_scans);
+    RUN_TEST(when_requests_fail_or_signal_fades_then_link_is_poor);
+    RUN_TEST(when_link_is_poor_then_unit_roams_only_to_a_clearly_stronger_control_unit);
+    RUN_TEST(when_roaming_target_does_not_pair_then_unit_goes_back);
+    RUN_TEST(when_control_unit_ap_goes_down_after_pairing_then_unit_connects_again);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // Wait ~2 seconds before the Unity test runner
+    // establishes connection with a board Serial interface
+    delay(2000);
+
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,206 @@
+#include "unity.h"
+#include "PeriodicDeadline.h"
+#include <stdio.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+constexpr uint32_t start_time = 1792380000; // Unix seconds, a multiple of 5
+
+/**
+ * @brief Pseudo random busy times, the same on every run
+ */
+static uint32_t s_seed = 1;
+static uint32_t nextRandom(uint32_t below) {
+    s_seed = s_seed * 1103515245u + 12345u;
+    return (s_seed >> 16) % below;
+}
+
+/**
+ * @brief Number of slots from first to last, both included
+ */
+static uint32_t slotsBetween(uint32_t first, uint32_t last, uint32_t period, uint32_t phase) {
+    uint32_t firstSlot = first + (phase + period - first % period) % period;
+    return last < firstSlot ? 0 : (last - firstSlot) / period + 1;
+}
+
+void setUp(void) {
+    s_seed = 1;
+}
+
+void tearDown(void) {
+}
+
+void when_clock_passes_slots_then_each_is_due_once() {
+    PeriodicDeadline reading(5);
+    PeriodicDeadline dispatch(15, 1);
+    uint32_t         readings = 0, dispatches = 0;
+    for (uint32_t now = start_time + 1; now <= start_time + 60; ++now) {
+        // Called several times within each second
+        for (int call = 0; call < 3; ++call) {
+            if (reading.due(now)) {
+                TEST_ASSERT_EQUAL(0, now % 5);
+                ++readings;
+            }
+            if (dispatch.due(now)) {
+                TEST_ASSERT_EQUAL(1, now % 15);
+                ++dispatches;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(12, readings);
+    TEST_ASSERT_EQUAL(4, dispatches);
+    TEST_ASSERT_EQUAL(0, reading.skipped() + reading.late());
+}
+
+void when_loop_is_busy_less_than_a_period_then_no_slot_is_lost() {
+    // Virtual clock in ms, the loop takes up to 4.9 s per pass doing WiFi,
+    // dispatch and sensor reads, the slots are every 5 s
+    PeriodicDeadline reading(5000);
+    uint32_t         now      = 0;
+    uint32_t         lastPoll = 0;
+    uint32_t         readings = 0;
+    uint32_t         lastSlot = 0;
+    while (now < 3600 * 1000) {
+        lastPoll = now;
+        if (reading.due(now)) {
+            // Late readings belong to the slot just passed
+            uint32_t slot = now / 5000;
+            TEST_ASSERT_TRUE(readings == 0 || slot == lastSlot + 1);
+            lastSlot = slot;
+            ++readings;
+        }
+        now += nextRandom(4900);
+    }
+    TEST_ASSERT_EQUAL(0, reading.skipped());
+    TEST_ASSERT_TRUE(reading.late() > 0);
+    TEST_ASSERT_EQUAL(slotsBetween(0, lastPoll, 5000, 0), readings);
+}
+
+void when_loop_is_busy_longer_than_a_period_then_slots_are_counted() {
+    PeriodicDeadline reading(5);
+    uint32_t         now      = start_time;
+    uint32_t         lastPoll = start_time;
+    uint32_t         readings = 0;
+    while (now < start_time + 24 * 3600) {
+        lastPoll = now;
+        if (reading.due(now)) {
+            ++readings;
+        }
+        // Mostly idle, now and then a 30 s WiFi scan
+        now += nextRandom(20) == 0 ? 30 : 1;
+    }
+    TEST_ASSERT_TRUE(reading.skipped() > 0);
+    // Every slot that passed was either due or skipped
+    TEST_ASSERT_EQUAL(slotsBetween(start_time, lastPoll, 5, 0), readings + reading.skipped());
+}
+
+void when_loop_sleeps_until_next_then_every_slot_is_due_on_time() {
+    PeriodicDeadline reading(5, 0);
+    PeriodicDeadline dispatch(15, 1);
+    PeriodicDeadline resync(600, 2);
+    uint32_t         now      = start_time + 3;
+    uint32_t         lastPoll = now;
+    uint32_t         passes   = 0;
+    uint32_t         fired    = 0;
+    while (now < start_time + 3600) {
+        lastPoll = now;
+        fired += reading.due(now) + dispatch.due(now) + resync.due(now);
+        uint32_t sleep = reading.untilNext(now);
+        if (dispatch.untilNext(now) < sleep) {
+            sleep = dispatch.untilNext(now);
+        }
+        if (resync.untilNext(now) < sleep) {
+            sleep = resync.untilNext(now);
+        }
+        TEST_ASSERT_TRUE(sleep > 0);
+        now += sleep;
+        ++passes;
+    }
+    TEST_ASSERT_EQUAL(0, reading.late() + dispatch.late() + resync.late());
+    TEST_ASSERT_EQUAL(slotsBetween(start_time + 3, lastPoll, 5, 0) +
+                          slotsBetween(start_time + 3, lastPoll, 15, 1) +
+                          slotsBetween(start_time + 3, lastPoll, 600, 2),
+                      fired);
+    // Woken only when an event is due, after the first pass
+    TEST_ASSERT_EQUAL(fired + 1, passes);
+}
+
+void when_clock_wraps_or_is_set_back_then_slots_continue() {
+    // millis() wraps after 49 days
+    PeriodicDeadline connect(5000);
+    uint32_t         now     = 0xFFFFFFFFu - 12000;
+    uint32_t         lastDue = 0;
+    int              due     = 0;
+    for (int i = 0; i < 300; ++i, now += 100) {
+        if (connect.due(now)) {
+            TEST_ASSERT_TRUE(due == 0 || now - lastDue == 5000);
+            lastDue = now;
+            ++due;
+        }
+    }
+    TEST_ASSERT_EQUAL(6, due);
+    TEST_ASSERT_EQUAL(0, connect.skipped());
+
+    PeriodicDeadline reading(5);
+    TEST_ASSERT_TRUE(reading.due(start_time));
+    TEST_ASSERT_EQUAL(5, reading.untilNext(start_time));
+    // Time sync moved the clock back a minute
+    TEST_ASSERT_EQUAL(0, reading.untilNext(start_time - 60));
+    TEST_ASSERT_TRUE(reading.due(start_time - 60));
+    TEST_ASSERT_FALSE(reading.due(start_time - 58));
+    TEST_ASSERT_TRUE(reading.due(start_time - 55));
+
+    reading.restart();
+    TEST_ASSERT_EQUAL(4, reading.untilNext(start_time + 1));
+    TEST_ASSERT_FALSE(reading.due(start_time + 1));
+    TEST_ASSERT_EQUAL(0, reading.skipped());
+}
+
+void when_units_get_phases_from_ids_then_they_spread_over_the_period() {
+    // Same phase on every start, also from helpers/loadgen
+    TEST_ASSERT_EQUAL(unitPhase("5e750000-0000-4000-8000-000000000007", 15),
+                      unitPhase("5e750000-0000-4000-8000-000000000007", 15));
+    TEST_ASSERT_EQUAL(0, unitPhase("any", 1));
+
+    // 300 units with consecutive ids, 20 per second of a 15 s period if even
+    uint32_t perSecond[15] = {};
+    char     id[40];
+    for (int unit = 0; unit < 300; ++unit) {
+        snprintf(id, sizeof(id), "5e750000-0000-4000-8000-%012d", unit);
+        uint32_t phase = unitPhase(id, 15);
+        TEST_ASSERT_TRUE(phase < 15);
+        ++perSecond[phase];
+    }
+    for (uint32_t count : perSecond) {
+        TEST_ASSERT_UINT32_WITHIN(8, 20, count);
+    }
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(when_clock_passes_slots_then_each_is_due_once);
+    RUN_TEST(when_loop_is_busy_less_than_a_period_then_no_slot_is_lost);
+    RUN_TEST(when_loop_is_busy_longer_than_a_period_then_slots_are_counted);
+    RUN_TEST(when_loop_sleeps_until_next_then_every_slot_is_due_on_time);
+    RUN_TEST(when_clock_wraps_or_is_set_back_then_slots_continue);
+    RUN_TEST(when_units_get_phases_from_ids_then_they_spread_over_the_period);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // Wait ~2 seconds before the Unity test runner
+    // establishes connection with a board Serial interface
+    delay(2000);
+
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,236 @@
+#include "unity.h"
+#include "HttpResponseParser.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+static unsigned long nowUs() {
+    return micros();
+}
+#else
+#include <chrono>
+static unsigned long nowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+static const char* response_ok = "HTTP/1.1 200 OK\r\n"
+                                 "Content-Type: application/json\r\n"
+                                 "Content-Length: 24\r\n"
+                                 "\r\n"
+                                 "{\"timestamp\":1792380051}";
+
+/**
+ * @brief WiFiClient stand-in that hands out a response in packets
+ *
+ * Like the WiFi module, bytes of a packet only become available after a
+ * number of polls, and the connection stays open after the response as it
+ * does with keep-alive.
+ */
+class FakeWiFiClient {
+  public:
+    FakeWiFiClient(const char* response, size_t packetSize, int pollsPerPacket, bool closeAtEnd)
+        : m_response{response}, m_size{strlen(response)}, m_packetSize{packetSize},
+          m_pollsPerPacket{pollsPerPacket}, m_closeAtEnd{closeAtEnd} {}
+
+    int available() {
+        ++availableCalls;
+        if (m_ready == m_sent && m_sent < m_size && ++m_polls >= m_pollsPerPacket) {
+            m_polls = 0;
+            m_ready = m_sent + m_packetSize < m_size ? m_sent + m_packetSize : m_size;
+        }
+        return static_cast<int>(m_ready - m_sent);
+    }
+    int read(uint8_t* buffer, size_t size) {
+        ++readCalls;
+        size_t length = m_ready - m_sent < size ? m_ready - m_sent : size;
+        memcpy(buffer, m_response + m_sent, length);
+        m_sent += length;
+        return static_cast<int>(length);
+    }
+    int read() {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+    bool connected() const {
+        return !(m_closeAtEnd && m_sent == m_size);
+    }
+
+    int availableCalls = 0;
+    int readCalls      = 0;
+
+  private:
+    const char* m_response;
+    size_t      m_size;
+    size_t      m_packetSize;
+    int         m_pollsPerPacket;
+    bool        m_closeAtEnd;
+    size_t      m_sent  = 0;
+    size_t      m_ready = 0;
+    int         m_polls = 0;
+};
+
+/**
+ * @brief Runs the read loop of RestClient against a client
+ *
+ * @return int Loop iterations, bounded by maxIterations in place of the timeout
+ */
+static int readResponse(FakeWiFiClient& client, HttpResponseParser& parser, int maxIterations) {
+    int iterations = 0;
+    while (!parser.done() && iterations < maxIterations) {
+        ++iterations;
+        if (parser.readAvailable(client) > 0) {
+            continue;
+        }
+        if (!client.connected()) {
+            parser.finish();
+        }
+    }
+    return iterations;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void when_response_has_content_length_then_it_completes_without_close() {
+    etl::string<128>   body;
+    HttpResponseParser parser(body);
+    TEST_ASSERT_EQUAL(strlen(response_ok), parser.feed(response_ok, strlen(response_ok)));
+
+    TEST_ASSERT_TRUE(parser.state() == HttpResponseParser::State::Complete);
+    TEST_ASSERT_EQUAL(200, parser.status());
+    TEST_ASSERT_EQUAL(24, parser.contentLength());
+    TEST_ASSERT_TRUE(parser.keepAlive());
+    TEST_ASSERT_FALSE(parser.overflow());
+    TEST_ASSERT_EQUAL_STRING("{\"timestamp\":1792380051}", body.c_str());
+}
+
+void when_fed_one_byte_at_a_time_then_result_is_the_same() {
+    etl::string<128>   body;
+    HttpResponseParser parser(body);
+    for (size_t i = 0; i < strlen(response_ok); ++i) {
+        TEST_ASSERT_EQUAL(1, parser.feed(&response_ok[i], 1));
+    }
+    TEST_ASSERT_TRUE(parser.state() == HttpResponseParser::State::Complete);
+    TEST_ASSERT_EQUAL(200, parser.status());
+    TEST_ASSERT_EQUAL_STRING("{\"timestamp\":1792380051}", body.c_str());
+}
+
+void when_body_does_not_fit_then_overflow_and_response_is_still_framed() {
+    const char*        response = "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\n0123456789"
+                                  "HTTP/1.1 204 No Content\r\n\r\n";
+    etl::string<4>     body;
+    HttpResponseParser parser(body);
+    // Stops at the end of the first response
+    TEST_ASSERT_EQUAL(strlen(response) - 27, parser.feed(response, strlen(response)));
+    TEST_ASSERT_TRUE(parser.state() == HttpResponseParser::State::Complete);
+    TEST_ASSERT_TRUE(parser.overflow());
+    TEST_ASSERT_EQUAL_STRING("0123", body.c_str());
+}
+
+void when_no_content_length_then_body_ends_when_connection_closes() {
+    const char*        response = "HTTP/1.0 200 OK\r\n\r\n{\"status\":\"connected\"}";
+    etl::string<128>   body;
+    HttpResponseParser parser(body);
+    parser.feed(response, strlen(response));
+    TEST_ASSERT_FALSE(parser.done());
+
+    parser.finish();
+    TEST_ASSERT_TRUE(parser.state() == HttpResponseParser::State::Complete);
+    TEST_ASSERT_FALSE(parser.keepAlive());
+    TEST_ASSERT_EQUAL_STRING("{\"status\":\"connected\"}", body.c_str());
+}
+
+void when_connection_closes_early_or_response_is_invalid_then_parse_fails() {
+    etl::string<128>   body;
+    HttpResponseParser truncated(body);
+    truncated.feed(response_ok, 40);
+    truncated.finish();
+    TEST_ASSERT_TRUE(truncated.state() == HttpResponseParser::State::Failed);
+
+    HttpResponseParser invalid(body);
+    invalid.feed("SSH-2.0-OpenSSH\r\n", 17);
+    TEST_ASSERT_TRUE(invalid.state() == HttpResponseParser::State::Failed);
+
+    HttpResponseParser chunked(body);
+    const char*        response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+    chunked.feed(response, strlen(response));
+    TEST_ASSERT_TRUE(chunked.state() == HttpResponseParser::State::Failed);
+}
+
+void when_read_from_client_then_blocks_end_at_content_length() {
+    // 32 byte packets, ready after 3 polls each, connection kept open
+    FakeWiFiClient     client(response_ok, 32, 3, false);
+    etl::string<128>   body;
+    HttpResponseParser parser(body);
+
+    unsigned long startUs    = nowUs();
+    int           iterations = readResponse(client, parser, 10'000);
+    unsigned long parseUs    = nowUs() - startUs;
+
+    TEST_ASSERT_TRUE(parser.state() == HttpResponseParser::State::Complete);
+    TEST_ASSERT_EQUAL_STRING("{\"timestamp\":1792380051}", body.c_str());
+    // One read per packet instead of one per byte, done without a close
+    size_t packets = (strlen(response_ok) + 31) / 32;
+    TEST_ASSERT_EQUAL(packets, client.readCalls);
+    TEST_ASSERT_LESS_THAN(10'000, iterations);
+
+    // The byte at a time loop it replaces, ended here by the close
+    FakeWiFiClient bytewise(response_ok, 32, 3, true);
+    int            bytewiseIterations = 0;
+    startUs                           = nowUs();
+    while (bytewise.connected() && bytewiseIterations < 10'000) {
+        ++bytewiseIterations;
+        while (bytewise.available()) {
+            bytewise.read();
+        }
+    }
+    unsigned long bytewiseUs = nowUs() - startUs;
+    TEST_ASSERT_EQUAL(strlen(response_ok), bytewise.readCalls);
+
+    char report[160];
+    snprintf(report,
+             sizeof(report),
+             "blocks: %d reads, %d available, %d loops, %lu us | bytes: %d reads, %d "
+             "available, %lu us",
+             client.readCalls,
+             client.availableCalls,
+             iterations,
+             parseUs,
+             bytewise.readCalls,
+             bytewise.availableCalls,
+             bytewiseUs);
+    TEST_MESSAGE(report);
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(when_response_has_content_length_then_it_completes_without_close);
+    RUN_TEST(when_fed_one_byte_at_a_time_then_result_is_the_same);
+    RUN_TEST(when_body_does_not_fit_then_overflow_and_response_is_still_framed);
+    RUN_TEST(when_no_content_length_then_body_ends_when_connection_closes);
+    RUN_TEST(when_connection_closes_early_or_response_is_invalid_then_parse_fails);
+    RUN_TEST(when_read_from_client_then_blocks_end_at_content_length);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // Wait ~2 seconds before the Unity test runner
+    // establishes connection with a board Serial interface
+    delay(2000);
+
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
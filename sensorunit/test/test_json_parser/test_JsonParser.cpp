@@ -169,6 +169,60 @@ void when_given_large_temperature_and_humidity_values_then_composeSensorSnapshot
 
 
 
+/**
+ * @brief Print that keeps what is written
+ */
+class CapturePrint : public Print {
+  public:
+    size_t write(uint8_t byte) override {
+        return write(&byte, 1);
+    }
+    size_t write(const uint8_t* data, size_t size) override {
+        text.append(reinterpret_cast<const char*>(data), size);
+        return size;
+    }
+    etl::string<json_config::max_json_size> text;
+};
+
+void when_written_to_print_then_writeSensorSnapshotGroup_should_match_compose_and_measure() {
+    etl::vector<CaSensorunitReading, json_config::max_batch_size> readings;
+    for (uint32_t i = 0; i < json_config::max_batch_size; ++i) {
+        readings.push_back(createReading(1726995600 + i * 60, 22.5f + i, 45.2f - i));
+    }
+
+    CapturePrint out;
+    size_t       written = JsonParser::writeSensorSnapshotGroup(out, readings, valid_uuid);
+
+    TEST_ASSERT_EQUAL(out.text.size(), written);
+    TEST_ASSERT_EQUAL(written, JsonParser::measureSensorSnapshotGroup(readings, valid_uuid));
+    TEST_ASSERT_EQUAL_STRING(
+        JsonParser::composeSensorSnapshotGroup(readings, valid_uuid).c_str(), out.text.c_str());
+
+    StaticJsonDocument<json_config::max_json_doc_size> doc;
+    DeserializationError err = deserializeJson(doc, out.text.c_str());
+    TEST_ASSERT_TRUE(err == DeserializationError::Ok);
+    TEST_ASSERT_EQUAL_STRING(valid_uuid, doc["sensor_unit_id"]);
+    JsonArray arr = doc["readings"];
+    TEST_ASSERT_EQUAL(json_config::max_batch_size, arr.size());
+    TEST_ASSERT_EQUAL(1726995600 + 9 * 60, arr[9]["timestamp"]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 31.5f, arr[9]["temperature"]);
+}
+
+void when_connect_response_has_upload_window_then_parseConnectResponse_should_return_it() {
+    ConnectResponse response = JsonParser::parseConnectResponse(etl::string<128>(
+        "{\"status\":\"connected\",\"upload_period_s\":60,\"upload_offset_s\":15,"
+        "\"upload_window_s\":5}"));
+    TEST_ASSERT_TRUE(response.connected);
+    TEST_ASSERT_EQUAL_UINT32(60, response.uploadSlot.periodSec);
+    TEST_ASSERT_EQUAL_UINT32(15, response.uploadSlot.offsetSec);
+    TEST_ASSERT_EQUAL_UINT32(5, response.uploadSlot.windowSec);
+
+    // Control Units without upload windows
+    response = JsonParser::parseConnectResponse(etl::string<128>("{\"status\":\"connected\"}"));
+    TEST_ASSERT_TRUE(response.connected);
+    TEST_ASSERT_EQUAL_UINT32(0, response.uploadSlot.periodSec);
+}
+
 int runUnityTests(void) {
   UNITY_BEGIN();
   RUN_TEST(when_given_valid_readings_then_composeSensorSnapshotGroup_should_return_valid_json);
@@ -178,6 +232,8 @@ int runUnityTests(void) {
   RUN_TEST(when_given_extreme_sensor_values_then_composeSensorSnapshotGroup_should_handle_them_correctly);
   RUN_TEST(when_given_duplicate_timestamps_then_composeSensorSnapshotGroup_should_include_all_entries);
   RUN_TEST(when_given_large_temperature_and_humidity_values_then_composeSensorSnapshotGroup_should_not_overflow);
+  RUN_TEST(when_written_to_print_then_writeSensorSnapshotGroup_should_match_compose_and_measure);
+  RUN_TEST(when_connect_response_has_upload_window_then_parseConnectResponse_should_return_it);
   return UNITY_END();
 }
 
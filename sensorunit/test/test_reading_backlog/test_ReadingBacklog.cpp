@@ -0,0 +1,179 @@
+#include "unity.h"
+#include "RamReadingStorage.h"
+#include "ReadingBacklog.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+constexpr size_t   sector_size  = 128; // 14 records per sector
+constexpr size_t   sector_count = 4;
+constexpr uint32_t epoch        = 1792380000;
+
+/**
+ * @brief RAM storage that counts erases per sector
+ */
+class CountingStorage : public RamReadingStorage {
+  public:
+    CountingStorage(uint8_t* memory) : RamReadingStorage(memory, sector_size, sector_count) {}
+    bool erase(size_t sector) override {
+        ++erases[sector];
+        return RamReadingStorage::erase(sector);
+    }
+    uint32_t erases[sector_count] = {};
+};
+
+static uint8_t memory[sector_size * sector_count];
+
+static CaSensorunitReading reading(uint32_t i) {
+    return {static_cast<time_t>(epoch + i * 5), 20.0 + i / 100.0, 40.0 + i % 50};
+}
+
+static void appendReadings(ReadingBacklog& backlog, uint32_t from, uint32_t count) {
+    for (uint32_t i = from; i < from + count; ++i) {
+        CaSensorunitReading value = reading(i);
+        TEST_ASSERT_TRUE(backlog.append(&value, 1));
+    }
+}
+
+static void assertReadings(ReadingBacklog& backlog, uint32_t from, size_t count) {
+    CaSensorunitReading out[16];
+    TEST_ASSERT_EQUAL(count, backlog.read(out, count));
+    for (size_t i = 0; i < count; ++i) {
+        CaSensorunitReading expected = reading(from + i);
+        TEST_ASSERT_EQUAL_UINT32(expected.timestamp, static_cast<uint32_t>(out[i].timestamp));
+        TEST_ASSERT_FLOAT_WITHIN(0.005, expected.temperature, out[i].temperature);
+        TEST_ASSERT_FLOAT_WITHIN(0.05, expected.humidity, out[i].humidity);
+    }
+}
+
+void setUp(void) {
+    memset(memory, 0xFF, sizeof(memory));
+}
+
+void tearDown(void) {
+}
+
+void when_backlog_restarted_then_unacknowledged_readings_are_replayed() {
+    CountingStorage storage(memory);
+    {
+        ReadingBacklog backlog(storage);
+        TEST_ASSERT_TRUE(backlog.begin());
+        TEST_ASSERT_EQUAL(0, backlog.pending());
+        TEST_ASSERT_EQUAL(3 * 14, backlog.capacity());
+
+        CaSensorunitReading batch[] = {reading(0), reading(1), reading(2), reading(3)};
+        TEST_ASSERT_TRUE(backlog.append(batch, 4));
+        appendReadings(backlog, 4, 16); // Crosses into the second sector
+        TEST_ASSERT_TRUE(backlog.acknowledge(7));
+        TEST_ASSERT_EQUAL(13, backlog.pending());
+        assertReadings(backlog, 7, 10);
+    }
+
+    // Reset
+    ReadingBacklog backlog(storage);
+    TEST_ASSERT_TRUE(backlog.begin());
+    TEST_ASSERT_EQUAL(13, backlog.pending());
+    assertReadings(backlog, 7, 13);
+
+    TEST_ASSERT_TRUE(backlog.acknowledge(10));
+    appendReadings(backlog, 20, 2);
+    assertReadings(backlog, 17, 5);
+    TEST_ASSERT_TRUE(backlog.acknowledge(5));
+    TEST_ASSERT_EQUAL(0, backlog.pending());
+    TEST_ASSERT_EQUAL(0, backlog.read(nullptr, 10));
+
+    ReadingBacklog restarted(storage);
+    TEST_ASSERT_TRUE(restarted.begin());
+    TEST_ASSERT_EQUAL(0, restarted.pending());
+    TEST_ASSERT_EQUAL(0, restarted.lost());
+}
+
+void when_log_wraps_then_sectors_wear_evenly_and_oldest_readings_are_lost() {
+    CountingStorage storage(memory);
+    ReadingBacklog  backlog(storage);
+    TEST_ASSERT_TRUE(backlog.begin());
+
+    // Ten rounds over the storage, what is appended is dispatched
+    uint32_t next = 0;
+    for (int round = 0; round < 40; ++round) {
+        appendReadings(backlog, next, 13);
+        next += 13;
+        TEST_ASSERT_TRUE(backlog.acknowledge(13));
+    }
+    TEST_ASSERT_EQUAL(0, backlog.pending());
+    TEST_ASSERT_EQUAL(0, backlog.lost());
+    for (size_t sector = 0; sector < sector_count; ++sector) {
+        TEST_ASSERT_UINT32_WITHIN(1, storage.erases[0], storage.erases[sector]);
+    }
+    TEST_ASSERT_TRUE(storage.erases[0] >= 10);
+
+    // Undispatched readings beyond the capacity overwrite the oldest
+    uint32_t pendingBefore = backlog.pending();
+    uint32_t lostBefore    = backlog.lost();
+    appendReadings(backlog, next, 60);
+    next += 60;
+    TEST_ASSERT_TRUE(backlog.pending() >= backlog.capacity());
+    TEST_ASSERT_TRUE(backlog.pending() <= sector_count * 14);
+    TEST_ASSERT_EQUAL(pendingBefore + 60, backlog.pending() + backlog.lost() - lostBefore);
+    uint32_t oldest = next - backlog.pending();
+    assertReadings(backlog, oldest, 10);
+
+    ReadingBacklog restarted(storage);
+    TEST_ASSERT_TRUE(restarted.begin());
+    TEST_ASSERT_EQUAL(backlog.pending(), restarted.pending());
+    assertReadings(restarted, oldest, 10);
+}
+
+void when_reset_cut_a_record_then_it_is_skipped() {
+    CountingStorage storage(memory);
+    {
+        ReadingBacklog backlog(storage);
+        TEST_ASSERT_TRUE(backlog.begin());
+        appendReadings(backlog, 0, 3);
+    }
+    // Only the time of a fourth reading made it to the storage
+    uint32_t time = epoch;
+    memcpy(&memory[backlog_config::header_size + 3 * 8], &time, sizeof(time));
+
+    ReadingBacklog backlog(storage);
+    TEST_ASSERT_TRUE(backlog.begin());
+    TEST_ASSERT_EQUAL(3, backlog.pending());
+    appendReadings(backlog, 3, 2);
+    TEST_ASSERT_EQUAL(5, backlog.pending());
+    assertReadings(backlog, 0, 5);
+}
+
+void when_storage_too_small_then_begin_fails() {
+    RamReadingStorage single(memory, sector_size, 1);
+    ReadingBacklog    backlog(single);
+    TEST_ASSERT_FALSE(backlog.begin());
+    CaSensorunitReading value = reading(0);
+    TEST_ASSERT_FALSE(backlog.append(&value, 1));
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(when_backlog_restarted_then_unacknowledged_readings_are_replayed);
+    RUN_TEST(when_log_wraps_then_sectors_wear_evenly_and_oldest_readings_are_lost);
+    RUN_TEST(when_reset_cut_a_record_then_it_is_skipped);
+    RUN_TEST(when_storage_too_small_then_begin_fails);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // Wait ~2 seconds before the Unity test runner
+    // establishes connection with a board Serial interface
+    delay(2000);
+
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
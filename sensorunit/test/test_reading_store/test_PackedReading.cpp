@@ -0,0 +1,110 @@
+#include "unity.h"
+#include "PackedReadingRing.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+constexpr uint32_t epoch = 1792380000;
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void when_reading_packed_then_unpacked_values_are_within_resolution() {
+    CaSensorunitReading reading{epoch + 125, 22.57, 45.23};
+    PackedReading       packed = packReading(reading, epoch);
+    TEST_ASSERT_EQUAL(125, packed.timeOffset);
+    TEST_ASSERT_EQUAL(2257, packed.centiDegrees);
+    TEST_ASSERT_EQUAL(452, packed.deciPercent);
+
+    CaSensorunitReading unpacked = unpackReading(packed, epoch);
+    TEST_ASSERT_EQUAL_UINT32(epoch + 125, static_cast<uint32_t>(unpacked.timestamp));
+    TEST_ASSERT_FLOAT_WITHIN(0.005, 22.57, unpacked.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.05, 45.23, unpacked.humidity);
+
+    // Before the epoch and below zero
+    packed = packReading({epoch - 30, -40.0, 0.0}, epoch);
+    TEST_ASSERT_EQUAL(-30, packed.timeOffset);
+    TEST_ASSERT_EQUAL(-4000, packed.centiDegrees);
+}
+
+void when_value_outside_field_then_it_is_clamped() {
+    PackedReading packed = packReading({epoch, 999999.99, 150.0}, epoch);
+    TEST_ASSERT_EQUAL(INT16_MAX, packed.centiDegrees);
+    TEST_ASSERT_EQUAL(packed_reading_config::max_deci_percent, packed.deciPercent);
+
+    packed = packReading({epoch, -400.0, -5.0}, epoch);
+    TEST_ASSERT_EQUAL(INT16_MIN, packed.centiDegrees);
+    TEST_ASSERT_EQUAL(0, packed.deciPercent);
+}
+
+void when_records_stored_back_to_back_then_neighbours_are_untouched() {
+    uint8_t bits[(3 * packed_reading_config::record_bits + 7) / 8] = {};
+    PackedReading first{-1, INT16_MIN, 1000};
+    PackedReading second{INT32_MAX, -1, 0};
+    PackedReading third{12345, 2250, 452};
+    storePackedReading(bits, 0, first);
+    storePackedReading(bits, 2, third);
+    storePackedReading(bits, 1, second);
+
+    PackedReading loaded[] = {
+        loadPackedReading(bits, 0), loadPackedReading(bits, 1), loadPackedReading(bits, 2)};
+    TEST_ASSERT_EQUAL(-1, loaded[0].timeOffset);
+    TEST_ASSERT_EQUAL(INT16_MIN, loaded[0].centiDegrees);
+    TEST_ASSERT_EQUAL(1000, loaded[0].deciPercent);
+    TEST_ASSERT_EQUAL(INT32_MAX, loaded[1].timeOffset);
+    TEST_ASSERT_EQUAL(-1, loaded[1].centiDegrees);
+    TEST_ASSERT_EQUAL(0, loaded[1].deciPercent);
+    TEST_ASSERT_EQUAL(12345, loaded[2].timeOffset);
+    TEST_ASSERT_EQUAL(2250, loaded[2].centiDegrees);
+    TEST_ASSERT_EQUAL(452, loaded[2].deciPercent);
+}
+
+void when_ring_wraps_then_records_keep_their_order() {
+    PackedReadingRing<5> ring;
+    TEST_ASSERT_EQUAL((5 * 58 + 7) / 8, ring.storageBytes());
+
+    for (int32_t i = 0; i < 5; ++i) {
+        TEST_ASSERT_TRUE(ring.push({i, static_cast<int16_t>(i * 100), 500}));
+    }
+    TEST_ASSERT_TRUE(ring.full());
+    TEST_ASSERT_FALSE(ring.push({5, 500, 500}));
+
+    ring.pop();
+    ring.pop();
+    TEST_ASSERT_TRUE(ring.push({5, 500, 500}));
+    TEST_ASSERT_TRUE(ring.push({6, 600, 500}));
+    TEST_ASSERT_EQUAL(5, ring.size());
+    for (size_t i = 0; i < ring.size(); ++i) {
+        TEST_ASSERT_EQUAL(static_cast<int32_t>(i + 2), ring.at(i).timeOffset);
+        TEST_ASSERT_EQUAL(static_cast<int16_t>((i + 2) * 100), ring.at(i).centiDegrees);
+    }
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(when_reading_packed_then_unpacked_values_are_within_resolution);
+    RUN_TEST(when_value_outside_field_then_it_is_clamped);
+    RUN_TEST(when_records_stored_back_to_back_then_neighbours_are_untouched);
+    RUN_TEST(when_ring_wraps_then_records_keep_their_order);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // Wait ~2 seconds before the Unity test runner
+    // establishes connection with a board Serial interface
+    delay(2000);
+
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(void) {
+    return runUnityTests();
+}
+#endif
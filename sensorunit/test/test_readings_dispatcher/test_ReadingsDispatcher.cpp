@@ -0,0 +1,131 @@
+#include "unity.h"
+#include "ReadingsDispatcher.h"
+#include <Arduino.h>
+
+/**
+ * @brief Rest client that answers every POST with a set status
+ */
+class FakeRestClient : public IRestClient {
+  public:
+    RestResponse getTo(const char*) override {
+        return {NotFound, ""};
+    }
+    RestResponse postTo(const char*, const etl::istring&) override {
+        return respond();
+    }
+    RestResponse postTo(const char*, const IRequestBody&) override {
+        return respond();
+    }
+    int         status     = Ok;
+    const char* payload    = "{\"status\":\"ok\"}";
+    int         posts      = 0;
+    int         failAtPost = -1; /**< Post number answered with Timeout */
+
+  private:
+    RestResponse respond() {
+        ++posts;
+        return {posts == failAtPost ? Timeout : status, payload};
+    }
+};
+
+static void fillBuffer(ReadingBuffer& buffer, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        buffer.push({static_cast<time_t>(1792380000 + i * 5), 21.5, 40.0});
+    }
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void when_dispatch_started_then_each_step_posts_one_batch() {
+    FakeRestClient     client;
+    ReadingBuffer      buffer;
+    ReadingsDispatcher dispatcher(client, buffer);
+    fillBuffer(buffer, 25);
+
+    TEST_ASSERT_FALSE(dispatcher.isDispatching());
+    TEST_ASSERT_TRUE(dispatcher.step());
+    TEST_ASSERT_EQUAL(0, client.posts);
+
+    dispatcher.start();
+    TEST_ASSERT_TRUE(dispatcher.step());
+    TEST_ASSERT_EQUAL(1, client.posts);
+    TEST_ASSERT_EQUAL(15, buffer.size());
+
+    // A reading taken between steps goes out with the same dispatch
+    fillBuffer(buffer, 1);
+    dispatcher.start();
+    TEST_ASSERT_TRUE(dispatcher.step());
+    TEST_ASSERT_TRUE(dispatcher.step());
+    TEST_ASSERT_EQUAL(3, client.posts);
+    TEST_ASSERT_TRUE(dispatcher.isDispatching());
+    TEST_ASSERT_TRUE(dispatcher.step());
+    TEST_ASSERT_EQUAL(3, client.posts);
+    TEST_ASSERT_FALSE(dispatcher.isDispatching());
+    TEST_ASSERT_FALSE(buffer.hasReadings());
+}
+
+void when_post_fails_then_dispatch_stops_and_keeps_the_batch() {
+    FakeRestClient     client;
+    ReadingBuffer      buffer;
+    ReadingsDispatcher dispatcher(client, buffer);
+    fillBuffer(buffer, 25);
+    client.failAtPost = 2;
+
+    dispatcher.start();
+    TEST_ASSERT_TRUE(dispatcher.step());
+    TEST_ASSERT_TRUE(dispatcher.step());
+    TEST_ASSERT_FALSE(dispatcher.isDispatching());
+    TEST_ASSERT_EQUAL(15, buffer.size());
+}
+
+void when_control_unit_disconnects_then_step_returns_false() {
+    FakeRestClient     client;
+    ReadingBuffer      buffer;
+    ReadingsDispatcher dispatcher(client, buffer);
+    fillBuffer(buffer, 25);
+    client.payload = "{\"status\":\"disconnected\"}";
+
+    dispatcher.start();
+    TEST_ASSERT_FALSE(dispatcher.step());
+    TEST_ASSERT_FALSE(dispatcher.isDispatching());
+    TEST_ASSERT_EQUAL(1, client.posts);
+    TEST_ASSERT_EQUAL(15, buffer.size());
+}
+
+void when_upload_window_closes_then_stop_keeps_the_rest() {
+    FakeRestClient     client;
+    ReadingBuffer      buffer;
+    ReadingsDispatcher dispatcher(client, buffer);
+    fillBuffer(buffer, 25);
+
+    dispatcher.start();
+    TEST_ASSERT_TRUE(dispatcher.step());
+    dispatcher.stop();
+    TEST_ASSERT_FALSE(dispatcher.isDispatching());
+    TEST_ASSERT_TRUE(dispatcher.step());
+    TEST_ASSERT_EQUAL(1, client.posts);
+    TEST_ASSERT_EQUAL(15, buffer.size());
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(when_dispatch_started_then_each_step_posts_one_batch);
+    RUN_TEST(when_post_fails_then_dispatch_stops_and_keeps_the_batch);
+    RUN_TEST(when_control_unit_disconnects_then_step_returns_false);
+    RUN_TEST(when_upload_window_closes_then_stop_keeps_the_rest);
+    return UNITY_END();
+}
+
+void setup() {
+    // Wait ~2 seconds before the Unity test runner
+    // establishes connection with a board Serial interface
+    delay(2000);
+
+    runUnityTests();
+}
+
+void loop() {}